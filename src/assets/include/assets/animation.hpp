@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <assets/scene.hpp>
+#include <util/animation_sampler.hpp>
+#include <util/transform_math.hpp>
+
+namespace krypton::assets {
+    // The property of a node an animation track drives. The values match the glTF paths.
+    enum class AnimationPath : uint8_t {
+        Translation = 0,
+        Rotation = 1,
+        Scale = 2,
+        Weights = 3,
+    };
+
+    struct AnimationTarget final {
+        // The node in the SceneHierarchy.
+        uint32_t node = 0;
+        AnimationPath path = AnimationPath::Translation;
+        // The morph target whose weight is animated, only used by AnimationPath::Weights.
+        uint32_t weight = 0;
+    };
+
+    /**
+     * The channels of a glTF animation as keyframe tracks. glTF animates all morph target
+     * weights of a node with a single sampler, which is split into one scalar track per weight
+     * here, so that every track has at most four components.
+     */
+    struct Animation final {
+        std::string name = {};
+        krypton::util::KeyframeTracks tracks;
+        // The target of every track, indexed like tracks.tracks.
+        std::vector<krypton::assets::AnimationTarget> targets;
+    };
+
+    struct Skin final {
+        std::string name = {};
+        // The nodes of the joints in the SceneHierarchy, or noParent for joints outside of the loaded scene.
+        std::vector<uint32_t> joints;
+        // Transforms from the bind pose into the space of every joint, indexed like joints.
+        std::vector<krypton::util::Matrix4> inverseBindMatrices;
+    };
+
+    /**
+     * Writes the sampled tracks of an animation into the local transforms and morph weights of
+     * the hierarchy and marks the animated nodes as dirty, so that the next update of the
+     * hierarchy recomputes their world matrices.
+     */
+    inline void applyAnimation(const Animation& animation, const krypton::util::TrackSamples& samples, SceneHierarchy& hierarchy) noexcept {
+        auto& transforms = hierarchy.nodes.getLocalTransforms();
+        for (std::size_t i = 0; i < animation.targets.size(); ++i) {
+            const auto& target = animation.targets[i];
+            const auto node = target.node;
+            switch (target.path) {
+                case AnimationPath::Translation:
+                    transforms.translationX[node] = samples.values[0][i];
+                    transforms.translationY[node] = samples.values[1][i];
+                    transforms.translationZ[node] = samples.values[2][i];
+                    break;
+                case AnimationPath::Rotation:
+                    transforms.rotationX[node] = samples.values[0][i];
+                    transforms.rotationY[node] = samples.values[1][i];
+                    transforms.rotationZ[node] = samples.values[2][i];
+                    transforms.rotationW[node] = samples.values[3][i];
+                    break;
+                case AnimationPath::Scale:
+                    transforms.scaleX[node] = samples.values[0][i];
+                    transforms.scaleY[node] = samples.values[1][i];
+                    transforms.scaleZ[node] = samples.values[2][i];
+                    break;
+                case AnimationPath::Weights:
+                    hierarchy.morphWeights[hierarchy.morphWeightOffsets[node] + target.weight] = samples.values[0][i];
+                    continue;
+            }
+            hierarchy.nodes.markDirty(node);
+        }
+    }
+} // namespace krypton::assets
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <util/transform_math.hpp>
+
+namespace krypton::assets {
+    // An axis-aligned bounding box in object space. Default constructed boxes are empty.
+    struct BoundingBox final {
+        glm::fvec3 min = glm::fvec3(std::numeric_limits<float>::infinity());
+        glm::fvec3 max = glm::fvec3(-std::numeric_limits<float>::infinity());
+
+        [[nodiscard]] bool empty() const noexcept {
+            return min.x > max.x || min.y > max.y || min.z > max.z;
+        }
+
+        void merge(const BoundingBox& other) noexcept {
+            min = glm::min(min, other.min);
+            max = glm::max(max, other.max);
+        }
+    };
+
+    struct BoundingSphere final {
+        glm::fvec3 center = glm::fvec3(0.0f);
+        float radius = 0.0f;
+    };
+
+    /**
+     * The sphere through the corners of the box. This is looser than a sphere fitted to the
+     * vertices, but it only needs the box, which e.g. glTF already provides for every mesh.
+     */
+    [[nodiscard]] inline auto getBoundingSphere(const BoundingBox& box) noexcept -> BoundingSphere {
+        if (box.empty())
+            return {};
+        return { (box.min + box.max) * 0.5f, glm::length(box.max - box.min) * 0.5f };
+    }
+
+    /**
+     * The boxes and spheres of many objects, with every component in its own array so that
+     * culling kernels can test multiple objects per instruction. The boxes can be passed to
+     * krypton::util::transformAabbs directly.
+     */
+    struct BoundsTable final {
+        krypton::util::AabbSoA boxes;
+        std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;
+
+        void resize(std::size_t size) {
+            boxes.resize(size);
+            sphereX.resize(size);
+            sphereY.resize(size);
+            sphereZ.resize(size);
+            sphereRadius.resize(size);
+        }
+
+        void set(std::size_t index, const BoundingBox& box, const BoundingSphere& sphere) noexcept {
+            boxes.set(index, &box.min.x, &box.max.x);
+            sphereX[index] = sphere.center.x;
+            sphereY[index] = sphere.center.y;
+            sphereZ[index] = sphere.center.z;
+            sphereRadius[index] = sphere.radius;
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t {
+            return boxes.size();
+        }
+    };
+} // namespace krypton::assets
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include <util/index_conversion.hpp>
+
+namespace krypton::assets {
+    enum class IndexType : uint8_t {
+        Uint8 = 0,
+        Uint16 = 1,
+        Uint32 = 2,
+    };
+
+    [[nodiscard]] constexpr auto getIndexSize(IndexType type) noexcept -> std::size_t {
+        switch (type) {
+            case IndexType::Uint8:
+                return 1;
+            case IndexType::Uint16:
+                return 2;
+            case IndexType::Uint32:
+                return 4;
+        }
+        return 0;
+    }
+
+    /**
+     * Returns the narrowest index type that can address the given number of vertices. 8-bit
+     * indices are not supported by every GPU, so they have to be explicitly allowed.
+     */
+    [[nodiscard]] constexpr auto getNarrowestIndexType(std::size_t vertexCount, bool allowUint8 = false) noexcept -> IndexType {
+        if (allowUint8 && vertexCount <= 0x100)
+            return IndexType::Uint8;
+        if (vertexCount <= 0x10000)
+            return IndexType::Uint16;
+        return IndexType::Uint32;
+    }
+
+    /**
+     * Indices stored in a type chosen at runtime, usually the narrowest that fits. The data can
+     * be uploaded to the GPU as is.
+     */
+    class IndexBuffer final {
+        std::vector<std::byte> data;
+        IndexType type = IndexType::Uint32;
+
+    public:
+        explicit IndexBuffer() = default;
+
+        [[nodiscard]] auto getBytes() const noexcept -> std::span<const std::byte> {
+            return data;
+        }
+
+        [[nodiscard]] auto getBytes() noexcept -> std::span<std::byte> {
+            return data;
+        }
+
+        [[nodiscard]] auto getType() const noexcept -> IndexType {
+            return type;
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t {
+            return data.size() / getIndexSize(type);
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return data.empty();
+        }
+
+        // Returns the indices as the given type, which has to match getType().
+        template <typename T>
+        [[nodiscard]] auto as() noexcept -> std::span<T> {
+            return { reinterpret_cast<T*>(data.data()), data.size() / sizeof(T) };
+        }
+
+        template <typename T>
+        [[nodiscard]] auto as() const noexcept -> std::span<const T> {
+            return { reinterpret_cast<const T*>(data.data()), data.size() / sizeof(T) };
+        }
+
+        void clear() noexcept {
+            data.clear();
+        }
+
+        // Discards the contents and makes room for count indices of the given type.
+        void resize(IndexType newType, std::size_t count) {
+            type = newType;
+            data.resize(count * getIndexSize(type));
+        }
+
+        [[nodiscard]] auto operator[](std::size_t index) const noexcept -> uint32_t {
+            switch (type) {
+                case IndexType::Uint8:
+                    return static_cast<uint32_t>(data[index]);
+                case IndexType::Uint16: {
+                    uint16_t value;
+                    std::memcpy(&value, &data[index * 2], sizeof(value));
+                    return value;
+                }
+                case IndexType::Uint32: {
+                    uint32_t value;
+                    std::memcpy(&value, &data[index * 4], sizeof(value));
+                    return value;
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * Stores the given indices as the given type, which has to be able to represent every
+         * index. Use getNarrowestIndexType to pick it.
+         */
+        void assign(std::span<const uint32_t> indices, IndexType newType) {
+            resize(newType, indices.size());
+            switch (type) {
+                case IndexType::Uint8: {
+                    for (std::size_t i = 0; i < indices.size(); ++i)
+                        data[i] = static_cast<std::byte>(indices[i]);
+                    break;
+                }
+                case IndexType::Uint16: {
+                    util::narrowIndices(indices, as<uint16_t>());
+                    break;
+                }
+                case IndexType::Uint32: {
+                    std::memcpy(data.data(), indices.data(), indices.size_bytes());
+                    break;
+                }
+            }
+        }
+
+        // Copies all indices into a vector of 32-bit indices, which is what most processing
+        // algorithms work with.
+        [[nodiscard]] auto toUint32() const -> std::vector<uint32_t> {
+            std::vector<uint32_t> result(size());
+            switch (type) {
+                case IndexType::Uint8:
+                    util::widenIndices(as<uint8_t>(), result);
+                    break;
+                case IndexType::Uint16:
+                    util::widenIndices(as<uint16_t>(), result);
+                    break;
+                case IndexType::Uint32:
+                    std::memcpy(result.data(), data.data(), data.size());
+                    break;
+            }
+            return result;
+        }
+    };
+} // namespace krypton::assets
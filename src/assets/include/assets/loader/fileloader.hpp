@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <vector>
 
 #ifndef GLM_FORCE_INTRINSICS
@@ -9,30 +11,187 @@
 #endif
 #include <glm/glm.hpp>
 
+#include <assets/animation.hpp>
+#include <assets/bounds.hpp>
 #include <assets/material.hpp>
 #include <assets/mesh.hpp>
+#include <assets/processing/mesh_optimizer.hpp>
+#include <assets/processing/mesh_simplifier.hpp>
+#include <assets/processing/meshlet_builder.hpp>
+#include <assets/processing/normal_generator.hpp>
+#include <assets/loader/texture_streamer.hpp>
+#include <assets/processing/texture_compressor.hpp>
+#include <assets/scene.hpp>
 #include <assets/texture.hpp>
 
 namespace fs = std::filesystem;
 
-namespace tinygltf {
-    class Node;
-    class Mesh;
-    class Model;
-} // namespace tinygltf
-
 namespace krypton::assets::loader {
+    struct GltfAsset;
+    struct GltfPrimitive;
+    struct GltfScene;
+    class MeshCache;
+
+    enum class TangentGeneration : uint8_t {
+        Never = 0,
+        // Only for primitives whose material has a normal texture.
+        NormalMapped = 1,
+        Always = 2,
+    };
+
+    struct LoaderOptions final {
+        // The layout all primitives are converted to once they have been loaded.
+        VertexLayout vertexLayout = VertexLayout::Full;
+        // Whether to load the COLOR_0 attribute. With the compact layouts, colors are stored as a
+        // separate RGBA8 stream, so that primitives without colors don't pay for them.
+        bool vertexColors = false;
+        // How normals are generated for primitives without a NORMAL attribute.
+        krypton::assets::processing::NormalGeneration missingNormals = krypton::assets::processing::NormalGeneration::Flat;
+        // Which primitives without a TANGENT attribute get generated tangents.
+        TangentGeneration missingTangents = TangentGeneration::NormalMapped;
+        // Indices are always stored in the narrowest type that fits. 8-bit indices are not
+        // supported by every GPU, so they have to be explicitly allowed. Devices without
+        // DeviceFeatures::indexType8Bit, including every Metal device, need them widened at
+        // upload with rapi::getIndexUploadData.
+        bool allowUint8Indices = false;
+        // Splits primitives with too many vertices for 16-bit indices into multiple primitives.
+        bool splitLargePrimitives = false;
+        // Reorders the triangles and vertices of every primitive for better GPU cache usage.
+        bool optimizeMeshes = false;
+        krypton::assets::processing::MeshOptimizationOptions meshOptimization = {};
+        // Generates simplified levels of detail for every primitive.
+        bool generateLods = false;
+        krypton::assets::processing::LodOptions lods = {};
+        // Partitions every primitive into meshlets.
+        bool buildMeshlets = false;
+        krypton::assets::processing::MeshletOptions meshlets = {};
+        // Generates the full mip chain of every texture.
+        bool generateMips = false;
+        // Block compresses every texture with the format of its role. This is slow, so with
+        // useMeshCache, the compressed textures are also stored as KTX2 files in the cache
+        // directory, named after the hash of their pixels, and reused by every model.
+        bool compressTextures = false;
+        krypton::assets::processing::TextureCompressionOptions textureCompression = {};
+        // Textures loaded from the mesh cache are left without pixels, and textureSources points
+        // at their levels within the cache instead, so that they can be streamed in on demand
+        // with a TextureStreamer.
+        bool streamTextures = false;
+        // Primitives loaded from the mesh cache are left without their vertex, index and meshlet
+        // data, which is only referenced by primitiveSources then, so that it can be uploaded
+        // straight from the mapping without being copied first.
+        bool mapPrimitives = false;
+        // Stores the keyframe values of all animations with 16 bits per component, which halves
+        // their size for a small loss in precision.
+        bool quantizeAnimations = false;
+        // Writes everything loaded from a glTF into a binary cache, which later loads with the
+        // same options map directly instead of parsing and processing the glTF again. This is
+        // off by default, as it writes files next to the assets unless cacheDirectory is set.
+        bool useMeshCache = false;
+        // Where the caches are stored. If empty, each cache is stored next to its source file.
+        fs::path cacheDirectory = {};
+    };
+
+    static constexpr std::size_t maxUint16VertexCount = 0x10000;
+
+    /**
+     * The vertex, index and meshlet data of a primitive within the mesh cache, in the vertex
+     * layout and index types of the primitive. The spans stay valid until the loader loads
+     * another file or is destroyed.
+     */
+    struct PrimitiveSource final {
+        std::span<const std::byte> vertices;
+        std::span<const uint32_t> colors;
+        std::span<const krypton::assets::CompactTangent> tangents;
+        std::span<const std::byte> indices;
+        // The indices of every level of detail.
+        std::vector<std::span<const std::byte>> lodIndices;
+        std::span<const krypton::assets::Meshlet> meshlets;
+        std::span<const krypton::assets::MeshletBounds> meshletBounds;
+        std::span<const uint32_t> meshletVertices;
+        std::span<const uint8_t> meshletTriangles;
+    };
+
+    // A glTF primitive that still has to be decoded into the given output.
+    struct PrimitiveWorkItem final {
+        const GltfPrimitive* primitive = nullptr;
+        krypton::assets::Primitive* output = nullptr;
+    };
+
+    // Decodes the primitive into the full vertex layout.
+    void loadGltfPrimitive(const GltfAsset& asset, const GltfPrimitive& primitive, krypton::assets::Primitive& kPrimitive,
+                           const LoaderOptions& options);
+
+    /**
+     * Splits a triangle list primitive with the full vertex layout into multiple primitives with
+     * at most maxVertexCount vertices each. The triangle order is preserved. Other primitives
+     * are returned unchanged.
+     */
+    [[nodiscard]] auto splitPrimitive(const krypton::assets::Primitive& primitive, std::size_t maxVertexCount, bool allowUint8Indices)
+        -> std::vector<krypton::assets::Primitive>;
+
+    /**
+     * Decodes a PNG, JPEG or any other image supported by stb_image into the texture, with 8 or
+     * 16 bits per channel depending on the image. Images are always expanded to four channels.
+     */
+    [[nodiscard]] bool decodeImage(std::span<const std::byte> encoded, krypton::assets::Texture& texture);
+
+    // Computes the bounds of a primitive with the full vertex layout from its vertices.
+    void computeBounds(krypton::assets::Primitive& primitive);
+
+    /**
+     * Merges the bounds of all primitives into the bounds of the mesh. Primitives that have no
+     * bounds yet get them computed from their vertices first.
+     */
+    void computeBounds(krypton::assets::Mesh& mesh);
+
+    /**
+     * Converts all primitives of the mesh that still use VertexLayout::Full into the given layout.
+     * For VertexLayout::Quantized, this also computes the dequantization parameters of the mesh.
+     * If all primitives were loaded from the same 8 or 16-bit integer type, its grid is reused
+     * as it is. Otherwise, positions are quantized to the bounds of the mesh, which are computed
+     * first if they are still empty, and UVs to the range of all UVs.
+     * Processing steps that need full precision vertices should run before this.
+     */
+    void compactVertices(krypton::assets::Mesh& mesh, krypton::assets::VertexLayout layout);
+
     class FileLoader final {
-        void loadGltfMesh(tinygltf::Model& model, const tinygltf::Mesh& mesh, const tinygltf::Node& node, glm::mat4 parentMatrix);
-        void loadGltfNode(tinygltf::Model& model, uint32_t nodeIndex, glm::mat4 matrix);
+        // Maps each glTF mesh to its index in meshes, or -1 if it has not been referenced yet.
+        std::vector<int32_t> gltfMeshIndices;
+        // Maps each glTF node to its index in the hierarchy, or noParent if it is not part of the scene.
+        std::vector<uint32_t> gltfNodeIndices;
+        // The external files of the last loaded glTF, relative to it, which the mesh cache depends on.
+        std::vector<fs::path> dependencies;
+        // The cache the last file was loaded from, which primitiveSources point into.
+        std::shared_ptr<MeshCache> meshCache;
+        LoaderOptions options;
+
+        // Builds the hierarchy from the nodes of the scene. Without a scene, the hierarchy is empty.
+        void collectGltfNodes(const GltfAsset& asset, const GltfScene* scene, std::vector<PrimitiveWorkItem>& workItems);
+        void loadGltfSkins(const GltfAsset& asset);
+        void loadGltfAnimations(const GltfAsset& asset);
         [[nodiscard]] bool loadGltfFile(const fs::path& path);
+        void compressTextures(const fs::path& path);
 
     public:
         std::vector<std::shared_ptr<krypton::assets::Mesh>> meshes;
+        std::vector<krypton::assets::MeshInstance> instances;
+        // The nodes of the scene. The transforms of the instances are the world matrices of their nodes.
+        krypton::assets::SceneHierarchy hierarchy;
+        // Animations and skins only reference nodes of the hierarchy. Channels of nodes outside of
+        // the loaded scene are dropped.
+        std::vector<krypton::assets::Animation> animations;
+        std::vector<krypton::assets::Skin> skins;
+        // The bounds of every mesh, indexed like meshes.
+        krypton::assets::BoundsTable meshBounds;
         std::vector<krypton::assets::Material> materials;
         std::vector<krypton::assets::Texture> textures;
+        // Indexed like textures. Only textures without pixels have a source to stream them from.
+        std::vector<TextureLevelSource> textureSources;
+        // Indexed like meshes and their primitives. Only filled if the file was loaded from the mesh cache.
+        std::vector<std::vector<PrimitiveSource>> primitiveSources;
 
         explicit FileLoader() = default;
+        explicit FileLoader(LoaderOptions options) noexcept;
 
         [[nodiscard]] bool loadFile(const fs::path& path);
     };
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <util/json.hpp>
+#include <util/mapped_file.hpp>
+#include <util/strided_copy.hpp>
+
+namespace krypton::assets::loader {
+    /**
+     * The parts of a glTF document the loader reads, decoded straight from the JSON. All
+     * strings point into the GltfAsset they belong to, and all indices are -1 if missing.
+     * Indices are validated while parsing, so that the loader can use them as they are.
+     */
+    struct GltfBuffer final {
+        // Points into the GLB, a mapped .bin file or a decoded data URI.
+        std::span<const std::byte> data;
+        std::string_view uri;
+    };
+
+    struct GltfBufferView final {
+        int32_t buffer = -1;
+        std::size_t byteOffset = 0;
+        std::size_t byteLength = 0;
+        // 0 if the elements are tightly packed.
+        std::size_t byteStride = 0;
+        // Points into the buffer, or into the decoded data if compressed with EXT_meshopt_compression.
+        std::span<const std::byte> data;
+    };
+
+    // The elements of an accessor that differ from its buffer view, or from zero without one.
+    struct GltfSparseAccessor final {
+        std::size_t count = 0;
+        int32_t indicesBufferView = -1;
+        std::size_t indicesByteOffset = 0;
+        krypton::util::ComponentType indicesComponentType = krypton::util::ComponentType::Uint32;
+        int32_t valuesBufferView = -1;
+        std::size_t valuesByteOffset = 0;
+    };
+
+    struct GltfAccessor final {
+        int32_t bufferView = -1;
+        std::size_t byteOffset = 0;
+        std::size_t count = 0;
+        krypton::util::ComponentType componentType = krypton::util::ComponentType::Float;
+        // 1 to 4 for SCALAR to VEC4, and 4, 9 and 16 for the matrices.
+        uint32_t componentCount = 0;
+        bool normalized = false;
+        // The first four components of min and max, which are only required for positions.
+        uint32_t boundsComponentCount = 0;
+        float min[4] = {};
+        float max[4] = {};
+        GltfSparseAccessor sparse = {};
+    };
+
+    struct GltfAttribute final {
+        std::string_view name;
+        int32_t accessor = -1;
+    };
+
+    struct GltfPrimitive final {
+        std::vector<GltfAttribute> attributes;
+        // The POSITION and NORMAL attributes of every morph target.
+        std::vector<std::vector<GltfAttribute>> targets;
+        int32_t indices = -1;
+        int32_t material = -1;
+        // 0 to 6 for points, lines, line loops, line strips, triangles, triangle strips and
+        // triangle fans. Triangles by default.
+        uint32_t mode = 4;
+
+        // Returns the accessor of the attribute or -1.
+        [[nodiscard]] static auto findAttribute(std::span<const GltfAttribute> attributes, std::string_view name) noexcept -> int32_t;
+        [[nodiscard]] auto findAttribute(std::string_view name) const noexcept -> int32_t;
+    };
+
+    struct GltfMesh final {
+        std::string_view name;
+        std::vector<GltfPrimitive> primitives;
+        std::vector<float> weights;
+    };
+
+    struct GltfNode final {
+        std::string_view name;
+        int32_t mesh = -1;
+        int32_t skin = -1;
+        std::vector<uint32_t> children;
+        std::vector<float> weights;
+        // Either the matrix or TRS is used, as glTF doesn't allow both.
+        bool hasMatrix = false;
+        float matrix[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+        float translation[3] = { 0, 0, 0 };
+        float rotation[4] = { 0, 0, 0, 1 };
+        float scale[3] = { 1, 1, 1 };
+    };
+
+    struct GltfScene final {
+        std::string_view name;
+        std::vector<uint32_t> nodes;
+    };
+
+    struct GltfSkin final {
+        std::string_view name;
+        std::vector<uint32_t> joints;
+        // Always a float MAT4 accessor, or -1 if there is none or it has another type.
+        int32_t inverseBindMatrices = -1;
+    };
+
+    struct GltfAnimationSampler final {
+        int32_t input = -1;
+        int32_t output = -1;
+        std::string_view interpolation = "LINEAR";
+    };
+
+    struct GltfAnimationChannel final {
+        int32_t sampler = -1;
+        int32_t node = -1;
+        std::string_view path;
+    };
+
+    struct GltfAnimation final {
+        std::string_view name;
+        std::vector<GltfAnimationChannel> channels;
+        std::vector<GltfAnimationSampler> samplers;
+    };
+
+    struct GltfMaterial final {
+        std::string_view name;
+        float baseColorFactor[4] = { 1, 1, 1, 1 };
+        float metallicFactor = 1.0f;
+        float roughnessFactor = 1.0f;
+        int32_t baseColorTexture = -1;
+        int32_t metallicRoughnessTexture = -1;
+        int32_t normalTexture = -1;
+        int32_t occlusionTexture = -1;
+        int32_t emissiveTexture = -1;
+    };
+
+    struct GltfTexture final {
+        std::string_view name;
+        int32_t source = -1;
+    };
+
+    struct GltfImage final {
+        std::string_view name;
+        // Either an external file or a data URI, if there is no buffer view.
+        std::string_view uri;
+        int32_t bufferView = -1;
+    };
+
+    /**
+     * A parsed glTF or GLB file. Buffers are never copied: GLB binary chunks and external .bin
+     * files are memory mapped, and only data URIs and compressed buffer views are decoded into
+     * memory owned by the asset.
+     * The asset therefore has to stay alive while anything reads from the buffers.
+     */
+    struct GltfAsset final {
+        std::vector<GltfBuffer> buffers;
+        std::vector<GltfBufferView> bufferViews;
+        std::vector<GltfAccessor> accessors;
+        std::vector<GltfMesh> meshes;
+        std::vector<GltfNode> nodes;
+        std::vector<GltfScene> scenes;
+        std::vector<GltfSkin> skins;
+        std::vector<GltfAnimation> animations;
+        std::vector<GltfMaterial> materials;
+        std::vector<GltfTexture> textures;
+        std::vector<GltfImage> images;
+        int32_t defaultScene = -1;
+
+        // The storage everything above points into.
+        krypton::util::JsonDocument json;
+        krypton::util::MappedFile file;
+        std::vector<std::unique_ptr<krypton::util::MappedFile>> bufferFiles;
+        std::vector<std::vector<std::byte>> decodedUris;
+        std::vector<std::vector<std::byte>> decodedBufferViews;
+
+        [[nodiscard]] auto getBufferViewData(int32_t bufferView) const noexcept -> std::span<const std::byte>;
+        // An empty source for accessors without a buffer view.
+        [[nodiscard]] auto getStridedSource(int32_t accessor) const noexcept -> krypton::util::StridedSource;
+    };
+
+    [[nodiscard]] bool isDataUri(std::string_view uri) noexcept;
+
+    /**
+     * Decodes a base64 data URI like data:application/octet-stream;base64,... Returns false for
+     * anything else, including URIs that aren't base64 encoded.
+     */
+    [[nodiscard]] bool decodeDataUri(std::string_view uri, std::vector<std::byte>& data);
+
+    // Resolves the percent-encoding of a relative URI, e.g. of spaces in file names.
+    [[nodiscard]] auto decodeUriPath(std::string_view uri) -> std::filesystem::path;
+
+    /**
+     * Parses a .gltf or .glb file and all of its buffers, but not its images, into an empty asset.
+     * Errors are logged. KHR_mesh_quantization is supported, as the accessors keep their component
+     * types, and buffer views compressed with EXT_meshopt_compression are decoded while parsing.
+     * KHR_draco_mesh_compression is only supported through its fallback, so files that require
+     * it are rejected. Other unknown required extensions only cause a warning.
+     */
+    [[nodiscard]] bool parseGltf(const std::filesystem::path& path, GltfAsset& asset);
+} // namespace krypton::assets::loader
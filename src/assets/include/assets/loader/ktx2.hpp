@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include <assets/loader/texture_streamer.hpp>
+#include <assets/texture.hpp>
+
+namespace krypton::assets::loader {
+    // The VkFormat values of the formats we read and write.
+    enum class Ktx2Format : uint32_t {
+        Undefined = 0,
+        BC1_RGBA_UNORM = 133,
+        BC1_RGBA_SRGB = 134,
+        BC3_UNORM = 137,
+        BC3_SRGB = 138,
+        BC4_UNORM = 139,
+        BC5_UNORM = 141,
+        BC7_UNORM = 145,
+        BC7_SRGB = 146,
+    };
+
+    // Has to be increased whenever the texture encoders change, which invalidates all cached textures.
+    static constexpr uint32_t textureCacheVersion = 1;
+
+    struct Ktx2Header final {
+        uint8_t identifier[12];
+        Ktx2Format format;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct Ktx2Level final {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    static_assert(sizeof(Ktx2Header) == 80);
+    static_assert(sizeof(Ktx2Level) == 24);
+
+    [[nodiscard]] auto getKtx2Format(krypton::util::BlockCompression compression, bool srgb) noexcept -> Ktx2Format;
+
+    /**
+     * Writes a block compressed texture with all of its mip levels into a KTX2 container, which
+     * other tools can open as well. Like the mesh cache, the file is first written under a
+     * temporary name and then renamed.
+     */
+    [[nodiscard]] bool writeKtx2(const std::filesystem::path& path, const krypton::assets::Texture& texture);
+
+    /**
+     * Maps a KTX2 file with one of the formats of Ktx2Format, without supercompression, and only
+     * reads its header into the texture, which is left without pixels. The source points at
+     * every level within the mapping, so that the levels can be streamed in by a TextureStreamer.
+     */
+    [[nodiscard]] bool openKtx2(const std::filesystem::path& path, krypton::assets::Texture& texture, TextureLevelSource& source);
+
+    /**
+     * Reads a KTX2 file with one of the formats of Ktx2Format, without supercompression, into
+     * the pixels and format of the texture. The name, path and role of the texture are kept.
+     */
+    [[nodiscard]] bool readKtx2(const std::filesystem::path& path, krypton::assets::Texture& texture);
+} // namespace krypton::assets::loader
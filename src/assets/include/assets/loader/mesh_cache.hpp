@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <assets/loader/fileloader.hpp>
+#include <util/mapped_file.hpp>
+
+namespace krypton::assets::loader {
+    // "KMC\0", stored little-endian.
+    static constexpr uint32_t meshCacheMagic = 0x00434D4B;
+    // Has to be increased whenever the layout of the cache or of any stored struct changes.
+    static constexpr uint32_t meshCacheVersion = 7;
+    // Every section and every data blob starts at a multiple of this, so that the data can be
+    // handed to uploads or SIMD code as it is.
+    static constexpr std::size_t meshCacheAlignment = 64;
+
+    enum class MeshCacheSection : uint32_t {
+        // CachedRanges of the paths of all files the source depends on, relative to the source.
+        Dependencies = 0,
+        Meshes = 1,
+        Primitives = 2,
+        Lods = 3,
+        Instances = 4,
+        Materials = 5,
+        Textures = 6,
+        // The vertex, index and pixel data and the strings, referenced by the other sections.
+        Data = 7,
+        // The nodes of the hierarchy, in the order they are stored in the TransformHierarchy.
+        Nodes = 8,
+        // The node index of every instance.
+        InstanceNodes = 9,
+        // The skin index of every instance, or SceneHierarchy::noSkin.
+        InstanceSkins = 10,
+        // SceneHierarchy::morphWeightOffsets and SceneHierarchy::morphWeights.
+        MorphWeightOffsets = 11,
+        MorphWeights = 12,
+        Animations = 13,
+        Skins = 14,
+        // The sparse morph targets of all primitives.
+        MorphTargets = 15,
+        // A CachedFileStamp of the source followed by one of every dependency.
+        FileStamps = 16,
+        Count = 17,
+    };
+
+    // A range of bytes within the cache file.
+    struct CachedRange final {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    // The size and modification time of a source file, which are compared before its contents.
+    struct CachedFileStamp final {
+        uint64_t size = 0;
+        int64_t modificationTime = 0;
+    };
+
+    struct MeshCacheHeader final {
+        uint32_t magic = meshCacheMagic;
+        uint32_t version = meshCacheVersion;
+        // The hash of the source file and all of its dependencies.
+        uint64_t sourceHash = 0;
+        // The hash of the loader options the cache was written with.
+        uint64_t optionsHash = 0;
+        uint64_t fileSize = 0;
+        CachedRange sections[static_cast<std::size_t>(MeshCacheSection::Count)] = {};
+    };
+
+    struct CachedBounds final {
+        float min[3];
+        float max[3];
+        float sphereCenter[3];
+        float sphereRadius;
+    };
+
+    struct CachedMesh final {
+        CachedRange name;
+        uint32_t firstPrimitive;
+        uint32_t primitiveCount;
+        float positionOffset[3];
+        float positionScale[3];
+        float uvOffset[2];
+        float uvScale[2];
+        CachedBounds bounds;
+    };
+
+    struct CachedPrimitive final {
+        VertexLayout vertexLayout;
+        IndexType indexType;
+        uint8_t hasTangents;
+        PrimitiveTopology topology;
+        Index materialIndex;
+        uint32_t firstLod;
+        uint32_t lodCount;
+        CachedBounds bounds;
+        // The vertices in the format given by vertexLayout.
+        CachedRange vertices = {};
+        CachedRange colors = {};
+        CachedRange tangents = {};
+        CachedRange indices = {};
+        CachedRange meshlets = {};
+        CachedRange meshletBounds = {};
+        CachedRange meshletVertices = {};
+        CachedRange meshletTriangles = {};
+        // VertexInfluences, empty if the primitive isn't skinned.
+        CachedRange influences = {};
+        uint32_t firstMorphTarget = 0;
+        uint32_t morphTargetCount = 0;
+    };
+
+    struct CachedLod final {
+        CachedRange indices;
+        IndexType indexType;
+        uint8_t padding[3];
+        float error;
+    };
+
+    struct CachedTexture final {
+        CachedRange name;
+        CachedRange filePath;
+        CachedRange pixels;
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        uint32_t mipLevels;
+        uint8_t bitsPerPixel;
+        uint8_t srgb;
+        TextureRole role;
+        krypton::util::BlockCompression compression;
+        uint8_t padding[4];
+    };
+
+    struct CachedNode final {
+        CachedRange name;
+        uint32_t parent;
+        float translation[3];
+        float rotation[4];
+        float scale[3];
+        uint8_t padding[4];
+    };
+
+    // The tracks and their pools are stored as they are in KeyframeTracks.
+    struct CachedAnimation final {
+        CachedRange name;
+        CachedRange tracks;
+        CachedRange targets;
+        CachedRange times;
+        CachedRange values[4];
+        CachedRange quantizedValues[4];
+    };
+
+    struct CachedSkin final {
+        CachedRange name;
+        CachedRange joints;
+        CachedRange inverseBindMatrices;
+    };
+
+    struct CachedMorphTarget final {
+        CachedRange vertices;
+        CachedRange positionDeltas;
+        CachedRange normalDeltas;
+    };
+
+    static_assert(sizeof(MeshCacheHeader) == 304);
+    static_assert(sizeof(CachedMesh) == 104);
+    static_assert(sizeof(CachedPrimitive) == 208);
+    static_assert(sizeof(CachedLod) == 24);
+    static_assert(sizeof(CachedTexture) == 72);
+    static_assert(sizeof(CachedNode) == 64);
+    static_assert(sizeof(CachedAnimation) == 192);
+    static_assert(sizeof(CachedSkin) == 48);
+    static_assert(sizeof(CachedMorphTarget) == 48);
+
+    /**
+     * A memory-mapped mesh cache. All spans point straight into the mapping, so vertex and index
+     * data can be uploaded without being copied or converted first. They stay valid as long as
+     * the cache is open.
+     */
+    class MeshCache final {
+        std::shared_ptr<krypton::util::MappedFile> file;
+
+        [[nodiscard]] bool isValidRange(const CachedRange& range, std::size_t alignment) const noexcept;
+        [[nodiscard]] bool validate() const;
+
+    public:
+        explicit MeshCache() = default;
+
+        // Maps the cache and checks that its header and all ranges are valid.
+        [[nodiscard]] bool open(const fs::path& path);
+        void close() noexcept;
+
+        /**
+         * Whether the cache was written from the current state of the source with the same
+         * options. The source and its dependencies are only hashed if their size or modification
+         * time changed.
+         */
+        [[nodiscard]] bool isUpToDate(const fs::path& source, uint64_t optionsHash) const;
+
+        [[nodiscard]] auto getHeader() const noexcept -> const MeshCacheHeader&;
+        [[nodiscard]] auto getBytes(const CachedRange& range) const noexcept -> std::span<const std::byte>;
+        [[nodiscard]] auto getString(const CachedRange& range) const noexcept -> std::string_view;
+        // The mapping, which stays valid for as long as it is referenced, even after the cache is closed.
+        [[nodiscard]] auto getFile() const noexcept -> std::shared_ptr<const krypton::util::MappedFile>;
+
+        template <typename T>
+        [[nodiscard]] auto getSection(MeshCacheSection section) const noexcept -> std::span<const T> {
+            auto bytes = getBytes(getHeader().sections[static_cast<std::size_t>(section)]);
+            return { reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T) };
+        }
+
+        template <typename T>
+        [[nodiscard]] auto getArray(const CachedRange& range) const noexcept -> std::span<const T> {
+            auto bytes = getBytes(range);
+            return { reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T) };
+        }
+    };
+
+    // The cache of the given source file, either next to it or in LoaderOptions::cacheDirectory.
+    [[nodiscard]] auto getMeshCachePath(const fs::path& source, const LoaderOptions& options) -> fs::path;
+
+    // Hashes every option that changes the loaded data.
+    [[nodiscard]] auto hashLoaderOptions(const LoaderOptions& options) noexcept -> uint64_t;
+
+    /**
+     * Hashes the source file and all of its dependencies, which are given relative to the
+     * directory of the source. Returns false if any of the files can't be read.
+     */
+    [[nodiscard]] bool hashSourceFiles(const fs::path& source, std::span<const fs::path> dependencies, uint64_t& hash);
+
+    // Gets the stamps of the source file and all of its dependencies, like hashSourceFiles.
+    [[nodiscard]] bool getSourceFileStamps(const fs::path& source, std::span<const fs::path> dependencies,
+                                           std::vector<CachedFileStamp>& stamps);
+
+    /**
+     * Writes everything the loader has loaded into a cache. The stamps have to be taken before
+     * the source files are hashed, so that changes in between are detected later. The file is
+     * first written under a temporary name and then renamed, so that a failed write never
+     * leaves a broken cache.
+     */
+    [[nodiscard]] bool writeMeshCache(const fs::path& path, const FileLoader& loader, std::span<const fs::path> dependencies,
+                                      std::span<const CachedFileStamp> stamps, uint64_t sourceHash, uint64_t optionsHash);
+
+    /**
+     * Replaces the contents of the loader with the contents of the cache. The primitive sources
+     * of the loader point at the data of every primitive within the cache, which therefore has to
+     * stay open for as long as they are used. With mapPrimitives, that data is not copied into
+     * the primitives. With streamTextures, the pixels of the textures are not copied, and the
+     * texture sources of the loader point at their levels within the cache instead.
+     */
+    void readMeshCache(const MeshCache& cache, FileLoader& loader, bool streamTextures = false, bool mapPrimitives = false);
+} // namespace krypton::assets::loader
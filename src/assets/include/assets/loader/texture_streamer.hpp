@@ -0,0 +1,123 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <assets/texture.hpp>
+#include <util/mapped_file.hpp>
+
+namespace krypton::assets::loader {
+    // A range of bytes within the file of a TextureLevelSource.
+    struct TextureLevelRange final {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    // Where the mip levels of a texture are stored, so that they can be read one at a time.
+    struct TextureLevelSource final {
+        std::shared_ptr<const krypton::util::MappedFile> file;
+        // The range of every level, starting with the full resolution level.
+        std::vector<TextureLevelRange> levels;
+    };
+
+    // The mip levels of a streamed texture that are currently in memory.
+    struct ResidentTexture final {
+        // The levels [firstLevel, mipLevels) of the texture are resident.
+        uint32_t firstLevel = 0;
+        // The size of the first resident level, and how many levels follow it.
+        uint32_t width = 0, height = 0, levelCount = 0;
+        // The resident levels, tightly packed like Texture::pixels, so that they can be uploaded
+        // as the full mip chain of a texture with the size of the first resident level. The data
+        // stays alive as long as it is referenced, even if the levels are evicted meanwhile.
+        std::shared_ptr<const std::vector<std::byte>> pixels;
+        // Increases whenever levels are added or evicted, so that renderers know when to upload.
+        uint64_t version = 0;
+    };
+
+    struct TextureStreamerOptions final {
+        // How much memory all resident levels may use together. The tails are always resident,
+        // even if they alone exceed the budget.
+        std::size_t memoryBudget = 256 * 1024 * 1024;
+        // The levels that are at most this large are read when a texture is added and are never
+        // evicted, so that every texture can be used right away.
+        uint32_t tailExtent = 64;
+        // After this many frames without a request, a texture only wants its tail, so that its
+        // other levels are the first to be evicted.
+        uint32_t unusedFrameCount = 120;
+        // How many levels are read in the background at the same time.
+        uint32_t maxPendingLoads = 8;
+    };
+
+    /**
+     * Keeps the mip levels of many textures in memory, within a budget. Textures start out with
+     * only their smallest levels, and every frame, the textures that have been requested at a
+     * higher resolution than what is resident get their next larger level read on the
+     * Scheduler, the largest deficit first. When the budget is exhausted, levels that are larger
+     * than requested are evicted first, then those of the least recently requested textures.
+     *
+     * All functions are thread-safe. Levels are read from memory mapped files, so reading them
+     * in the background only blocks the worker thread on the page faults.
+     */
+    class TextureStreamer final {
+        struct StreamedTexture final {
+            // Only the description, the pixels are always empty.
+            krypton::assets::Texture texture;
+            TextureLevelSource source;
+            uint32_t tailLevel = 0;
+            uint32_t residentLevel = 0;
+            uint32_t requestedLevel = 0;
+            uint64_t lastRequestFrame = 0;
+            bool loading = false;
+            std::shared_ptr<const std::vector<std::byte>> pixels;
+            uint64_t version = 0;
+        };
+
+        TextureStreamerOptions options;
+        std::vector<StreamedTexture> textures;
+        uint64_t frame = 0;
+        std::size_t residentSize = 0;
+        std::size_t pendingSize = 0;
+        uint32_t pendingLoads = 0;
+        mutable std::mutex mutex;
+        std::condition_variable loadFinished;
+
+        void evictLevel(StreamedTexture& streamed);
+        void finishLoad(uint32_t index, uint32_t level, std::shared_ptr<const std::vector<std::byte>> pixels);
+
+    public:
+        explicit TextureStreamer() = default;
+        explicit TextureStreamer(TextureStreamerOptions options) noexcept;
+        TextureStreamer(const TextureStreamer&) = delete;
+        // Waits for all pending loads.
+        ~TextureStreamer();
+
+        auto operator=(const TextureStreamer&) -> TextureStreamer& = delete;
+
+        /**
+         * Adds a texture whose levels are stored in the source, and reads its tail right away.
+         * Fails if the source doesn't have a valid range for every level of the texture.
+         */
+        [[nodiscard]] bool addTexture(const krypton::assets::Texture& texture, TextureLevelSource source, uint32_t& index);
+
+        /**
+         * Requests the texture to be shown with the given size in pixels, e.g. the size of the
+         * largest object using it when projected onto the screen. Multiple requests within a
+         * frame are combined into the largest one.
+         */
+        void requestExtent(uint32_t index, uint32_t extent);
+
+        // Evicts levels and starts reading new ones. Should be called once per frame.
+        void update();
+
+        // Blocks until all levels that are currently being read have been added.
+        void waitForPendingLoads();
+
+        [[nodiscard]] auto getResidentTexture(uint32_t index) const -> ResidentTexture;
+        // The memory used by all resident levels together.
+        [[nodiscard]] auto getResidentSize() const -> std::size_t;
+    };
+} // namespace krypton::assets::loader
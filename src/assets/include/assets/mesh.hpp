@@ -10,6 +10,23 @@ namespace krypton::assets {
     struct Mesh final {
         std::string name = {};
         std::vector<krypton::assets::Primitive> primitives;
+
+        // The bounds of all primitives together.
+        krypton::assets::BoundingBox boundingBox = {};
+        krypton::assets::BoundingSphere boundingSphere = {};
+
+        // Restore the positions and UVs of VertexLayout::Quantized primitives:
+        // position = positionOffset + positionScale * (quantized / 65535), and likewise for UVs.
+        glm::fvec3 positionOffset = glm::fvec3(0.0f);
+        glm::fvec3 positionScale = glm::fvec3(1.0f);
+        glm::fvec2 uvOffset = glm::fvec2(0.0f);
+        glm::fvec2 uvScale = glm::fvec2(1.0f);
+    };
+
+    // A placement of a mesh in the world. Many instances can share the same mesh, so that its
+    // geometry is only loaded and stored once.
+    struct MeshInstance final {
+        uint32_t meshIndex = 0;
         glm::mat4x4 transform = glm::mat4(1.0);
     };
 } // namespace krypton::assets
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace krypton::assets {
+    static constexpr uint32_t maxMeshletVertices = 64;
+    static constexpr uint32_t maxMeshletTriangles = 124;
+
+    /**
+     * A small cluster of triangles. The meshlet references vertexCount entries of
+     * MeshletBuffer::vertices starting at vertexOffset, which are indices into the vertices of
+     * the primitive. Each triangle consists of three 8-bit indices into those, starting at
+     * triangleOffset in MeshletBuffer::triangles. 16 bytes.
+     */
+    struct Meshlet final {
+        uint32_t vertexOffset = 0;
+        uint32_t triangleOffset = 0;
+        uint32_t vertexCount = 0;
+        uint32_t triangleCount = 0;
+    };
+
+    /**
+     * The bounding sphere and normal cone of a meshlet, laid out so that it can be uploaded as an
+     * array of three float4s. The meshlet is entirely backfacing if
+     * dot(normalize(coneApex - cameraPosition), coneAxis) >= coneCutoff. 48 bytes.
+     */
+    struct alignas(16) MeshletBounds final {
+        float center[3] = {};
+        float radius = 0.0f;
+        float coneApex[3] = {};
+        // The sine of the half angle of the normal cone. A cutoff of 1 disables cone culling.
+        float coneCutoff = 1.0f;
+        float coneAxis[3] = {};
+        float padding = 0.0f;
+    };
+
+    static_assert(sizeof(Meshlet) == 16);
+    static_assert(sizeof(MeshletBounds) == 48);
+
+    // The meshlets of a primitive in flat arrays that can be uploaded as they are.
+    struct MeshletBuffer final {
+        std::vector<krypton::assets::Meshlet> meshlets = {};
+        std::vector<krypton::assets::MeshletBounds> bounds = {};
+        std::vector<uint32_t> vertices = {};
+        // The triangles of every meshlet start at a multiple of four bytes.
+        std::vector<uint8_t> triangles = {};
+
+        [[nodiscard]] bool empty() const noexcept {
+            return meshlets.empty();
+        }
+    };
+
+    [[nodiscard]] inline bool isMeshletBackfacing(const MeshletBounds& bounds, const float* cameraPosition) noexcept {
+        float direction[3] = { bounds.coneApex[0] - cameraPosition[0], bounds.coneApex[1] - cameraPosition[1],
+                               bounds.coneApex[2] - cameraPosition[2] };
+        auto length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+        auto cosine = direction[0] * bounds.coneAxis[0] + direction[1] * bounds.coneAxis[1] + direction[2] * bounds.coneAxis[2];
+        return cosine >= bounds.coneCutoff * length;
+    }
+} // namespace krypton::assets
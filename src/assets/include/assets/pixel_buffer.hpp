@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace krypton::assets {
+    /**
+     * The pixels of a texture. Unlike a std::vector, the memory always comes from std::malloc,
+     * so that the output of image decoders using the C allocator can be adopted instead of being
+     * copied, and growing the buffer, e.g. for mip levels, can extend it in place.
+     */
+    class PixelBuffer final {
+        struct FreeDeleter final {
+            void operator()(std::byte* bytes) const noexcept {
+                std::free(bytes);
+            }
+        };
+
+        std::unique_ptr<std::byte[], FreeDeleter> bytes;
+        std::size_t byteCount = 0;
+
+    public:
+        // Not explicit, so that textures can still be initialized with designated initializers.
+        PixelBuffer() = default;
+
+        PixelBuffer(const PixelBuffer& other) {
+            assign(other);
+        }
+
+        PixelBuffer(PixelBuffer&& other) noexcept : bytes(std::move(other.bytes)), byteCount(std::exchange(other.byteCount, 0)) {}
+
+        auto operator=(const PixelBuffer& other) -> PixelBuffer& {
+            if (this != &other)
+                assign(other);
+            return *this;
+        }
+
+        auto operator=(PixelBuffer&& other) noexcept -> PixelBuffer& {
+            bytes = std::move(other.bytes);
+            byteCount = std::exchange(other.byteCount, 0);
+            return *this;
+        }
+
+        /**
+         * Takes ownership of size bytes that were allocated with std::malloc or std::realloc,
+         * which are freed with std::free.
+         */
+        void adopt(void* data, std::size_t size) noexcept {
+            bytes.reset(static_cast<std::byte*>(data));
+            byteCount = data != nullptr ? size : 0;
+        }
+
+        void assign(std::span<const std::byte> data) {
+            resize(data.size());
+            if (!data.empty())
+                std::memcpy(bytes.get(), data.data(), data.size());
+        }
+
+        void clear() noexcept {
+            bytes.reset();
+            byteCount = 0;
+        }
+
+        // Keeps the current contents and zeroes the new bytes, like std::vector.
+        void resize(std::size_t size) {
+            if (size == byteCount)
+                return;
+            if (size == 0) {
+                clear();
+                return;
+            }
+            auto* resized = static_cast<std::byte*>(std::realloc(bytes.get(), size));
+            if (resized == nullptr)
+                throw std::bad_alloc();
+            static_cast<void>(bytes.release());
+            bytes.reset(resized);
+            if (size > byteCount)
+                std::memset(resized + byteCount, 0, size - byteCount);
+            byteCount = size;
+        }
+
+        [[nodiscard]] auto data() noexcept -> std::byte* {
+            return bytes.get();
+        }
+
+        [[nodiscard]] auto data() const noexcept -> const std::byte* {
+            return bytes.get();
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t {
+            return byteCount;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return byteCount == 0;
+        }
+
+        [[nodiscard]] auto begin() noexcept -> std::byte* {
+            return bytes.get();
+        }
+
+        [[nodiscard]] auto begin() const noexcept -> const std::byte* {
+            return bytes.get();
+        }
+
+        [[nodiscard]] auto end() noexcept -> std::byte* {
+            return bytes.get() + byteCount;
+        }
+
+        [[nodiscard]] auto end() const noexcept -> const std::byte* {
+            return bytes.get() + byteCount;
+        }
+
+        [[nodiscard]] auto operator[](std::size_t index) noexcept -> std::byte& {
+            return bytes[index];
+        }
+
+        [[nodiscard]] auto operator[](std::size_t index) const noexcept -> const std::byte& {
+            return bytes[index];
+        }
+
+        [[nodiscard]] bool operator==(const PixelBuffer& other) const noexcept {
+            return std::equal(begin(), end(), other.begin(), other.end());
+        }
+    };
+} // namespace krypton::assets
@@ -1,15 +1,115 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+#include <assets/bounds.hpp>
+#include <assets/index_buffer.hpp>
+#include <assets/meshlet.hpp>
 #include <assets/vertex.hpp>
+#include <util/skinning.hpp>
+#include <util/strided_copy.hpp>
 
 namespace krypton::assets {
+    // A simplified version of a primitive, which uses the vertices of the full primitive.
+    struct PrimitiveLod final {
+        krypton::assets::IndexBuffer indices;
+        // The geometric error relative to the full primitive, in object space units.
+        float error = 0.0f;
+    };
+
+    /**
+     * How the indices of a primitive are assembled. Strips, loops and fans are converted into
+     * lists when loading, so that everything after loading only has to deal with lists.
+     */
+    enum class PrimitiveTopology : uint8_t {
+        Triangles = 0,
+        Lines = 1,
+        Points = 2,
+    };
+
+    /**
+     * How a vertex attribute was stored in the file it was loaded from. VertexLayout::Quantized
+     * reuses the grid of 8 and 16-bit integers, so that already quantized data, e.g. from
+     * KHR_mesh_quantization, is stored as it is instead of being quantized a second time.
+     */
+    struct SourceEncoding final {
+        krypton::util::ComponentType componentType = krypton::util::ComponentType::Float;
+        bool normalized = false;
+
+        bool operator==(const SourceEncoding& other) const noexcept = default;
+    };
+
     struct Primitive final {
+        // Only one of the vertex vectors is filled, depending on the layout.
+        VertexLayout vertexLayout = VertexLayout::Full;
+        PrimitiveTopology topology = PrimitiveTopology::Triangles;
         std::vector<krypton::assets::Vertex> vertices = {};
-        std::vector<krypton::assets::Index> indices = {};
+        std::vector<krypton::assets::CompactVertex> compactVertices = {};
+        std::vector<krypton::assets::QuantizedVertex> quantizedVertices = {};
+        // An optional stream of RGBA8 colors, one per vertex. Only used with the compact layouts,
+        // as Vertex contains its own color.
+        std::vector<uint32_t> colors = {};
+        // Whether the optional stream of tangents, one per vertex, is filled.
+        bool hasTangents = false;
+        std::vector<krypton::assets::CompactTangent> tangents = {};
+        // The joints and weights of every vertex, if the primitive is skinned.
+        std::vector<krypton::util::VertexInfluences> influences = {};
+        std::vector<krypton::util::SparseMorphTarget> morphTargets = {};
+        // Only used while compacting the vertices, and therefore not cached.
+        SourceEncoding positionEncoding = {};
+        SourceEncoding uvEncoding = {};
+
+        krypton::assets::IndexBuffer indices;
+        // Optional levels of detail, from the most to the least detailed.
+        std::vector<krypton::assets::PrimitiveLod> lods = {};
+        // Optional clusters of the full primitive for cluster culling or mesh shaders.
+        krypton::assets::MeshletBuffer meshlets = {};
+        // The bounds of the vertices in object space.
+        krypton::assets::BoundingBox boundingBox = {};
+        krypton::assets::BoundingSphere boundingSphere = {};
         Index materialIndex = 0;
+
+        [[nodiscard]] bool isTriangleList() const noexcept {
+            return topology == PrimitiveTopology::Triangles && indices.size() % 3 == 0;
+        }
+
+        [[nodiscard]] auto getVertexCount() const noexcept -> std::size_t {
+            switch (vertexLayout) {
+                case VertexLayout::Full:
+                    return vertices.size();
+                case VertexLayout::Compact:
+                    return compactVertices.size();
+                case VertexLayout::Quantized:
+                    return quantizedVertices.size();
+            }
+            return 0;
+        }
     };
+
+    /**
+     * Copies the influences and morph targets of src into dst, for vertices of dst that are
+     * copies of the vertices sourceVertices of src. This is used by everything that reorders or
+     * duplicates vertices, and src and dst may be the same primitive.
+     */
+    inline void gatherDeformation(const Primitive& src, std::span<const uint32_t> sourceVertices, Primitive& dst) {
+        std::vector<krypton::util::VertexInfluences> influences;
+        if (!src.influences.empty()) {
+            influences.resize(sourceVertices.size());
+            for (std::size_t i = 0; i < sourceVertices.size(); ++i)
+                influences[i] = src.influences[sourceVertices[i]];
+        }
+
+        std::vector<krypton::util::SparseMorphTarget> morphTargets;
+        morphTargets.reserve(src.morphTargets.size());
+        for (const auto& target : src.morphTargets)
+            morphTargets.push_back(target.gatherVertices(sourceVertices));
+
+        dst.influences = std::move(influences);
+        dst.morphTargets = std::move(morphTargets);
+    }
 } // namespace krypton::assets
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <assets/animation.hpp>
+#include <assets/primitive.hpp>
+#include <util/transform_math.hpp>
+
+namespace krypton::assets::processing {
+    /**
+     * Computes the matrix of every joint of a skin, i.e. the world matrix of the joint node
+     * times its inverse bind matrix. Joints outside of the loaded scene use the identity.
+     */
+    void computeJointMatrices(const Skin& skin, std::span<const krypton::util::Matrix4> worldMatrices,
+                              std::vector<krypton::util::Matrix4>& out);
+
+    /**
+     * Applies the morph targets and the skin of a primitive to its rest pose and writes the
+     * result as CompactVertex, e.g. for CPU skinning or for computing animated bounds. Without
+     * influences or jointMatrices, only the morph targets are applied and the vertices stay in
+     * object space; otherwise they are in the space of the joint matrices, which is world space
+     * for glTF. Tangents are not deformed. Returns false for VertexLayout::Quantized, which
+     * would need the mesh bounds to restore its positions.
+     */
+    bool deformPrimitive(const Primitive& primitive, std::span<const krypton::util::Matrix4> jointMatrices,
+                         std::span<const float> morphWeights, std::vector<CompactVertex>& out);
+} // namespace krypton::assets::processing
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include <assets/mesh.hpp>
+
+namespace krypton::assets::processing {
+    /**
+     * The result of simulating a FIFO post-transform vertex cache over an index buffer. We use
+     * a FIFO, as that is the closest model of what most current GPUs do.
+     */
+    struct VertexCacheStatistics final {
+        std::size_t vertexCount = 0;
+        std::size_t triangleCount = 0;
+        std::size_t transformedVertexCount = 0;
+
+        // The average cache miss ratio, i.e. transformed vertices per triangle. This ranges
+        // from about 0.5 for regular grids to 3.
+        [[nodiscard]] auto getAcmr() const noexcept -> float;
+        // The average transform to vertex ratio. 1 means every vertex is transformed once.
+        [[nodiscard]] auto getAtvr() const noexcept -> float;
+
+        auto operator+=(const VertexCacheStatistics& other) noexcept -> VertexCacheStatistics&;
+    };
+
+    struct MeshOptimizationStatistics final {
+        VertexCacheStatistics before;
+        VertexCacheStatistics after;
+
+        auto operator+=(const MeshOptimizationStatistics& other) noexcept -> MeshOptimizationStatistics&;
+    };
+
+    struct MeshOptimizationOptions final {
+        // Merges vertices whose attributes are bitwise identical.
+        bool weldVertices = true;
+        // Reorders clusters of triangles so that outward facing ones are drawn first.
+        bool optimizeOverdraw = false;
+        // How much the ACMR may get worse by splitting the triangles into more clusters for
+        // the overdraw optimization. 1.0 only splits where the cache is cold anyway.
+        float overdrawThreshold = 1.05f;
+    };
+
+    static constexpr uint32_t defaultAnalysisCacheSize = 16;
+
+    [[nodiscard]] auto analyzeVertexCache(std::span<const uint32_t> indices, std::size_t vertexCount,
+                                          uint32_t cacheSize = defaultAnalysisCacheSize) -> VertexCacheStatistics;
+
+    /**
+     * Rewrites the indices so that duplicate vertices all reference the first occurrence. The
+     * vertices themselves are not removed; optimizeVertexFetch takes care of that. Colors,
+     * tangents and influences are compared too if they are given. Returns the number of unique
+     * vertices.
+     */
+    auto weldVertices(std::span<uint32_t> indices, std::span<const Vertex> vertices, std::span<const uint32_t> colors,
+                      std::span<const CompactTangent> tangents = {}, std::span<const krypton::util::VertexInfluences> influences = {})
+        -> std::size_t;
+
+    /**
+     * Reorders the triangles of a triangle list to improve the post-transform vertex cache hit
+     * rate, using Tom Forsyth's linear-speed algorithm. The result is written to dst, which
+     * has to be as large as indices.
+     */
+    void optimizeVertexCache(std::span<const uint32_t> indices, std::size_t vertexCount, std::span<uint32_t> dst);
+
+    /**
+     * Splits the cache-optimized triangle list into clusters and sorts them front-to-back from
+     * the outside of the mesh, which reduces overdraw from every direction. The triangle order
+     * within each cluster is kept.
+     */
+    void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold);
+
+    /**
+     * Reorders the vertices in the order they are first referenced and removes all unreferenced
+     * vertices. The LODs of the primitive are remapped as well. This only works with the full
+     * vertex layout.
+     */
+    void optimizeVertexFetch(Primitive& primitive, std::span<uint32_t> indices);
+
+    /**
+     * Runs all enabled optimizations on a triangle list primitive using VertexLayout::Full.
+     * Other primitives are left unchanged.
+     */
+    auto optimizePrimitive(Primitive& primitive, const MeshOptimizationOptions& options) -> MeshOptimizationStatistics;
+    auto optimizeMesh(Mesh& mesh, const MeshOptimizationOptions& options) -> MeshOptimizationStatistics;
+
+    // Optimizes all primitives of the meshes in parallel on the Scheduler.
+    auto optimizeMeshes(std::span<const std::shared_ptr<Mesh>> meshes, const MeshOptimizationOptions& options)
+        -> MeshOptimizationStatistics;
+} // namespace krypton::assets::processing
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <assets/mesh.hpp>
+
+namespace krypton::assets::processing {
+    struct SimplifyOptions final {
+        // How much differences in normals and UVs add to the cost of a collapse, relative to the
+        // squared length of the collapsed edge.
+        float attributeWeight = 0.5f;
+        // Simplification stops once the next collapse would exceed this error, in object space
+        // units.
+        float maxError = std::numeric_limits<float>::max();
+    };
+
+    struct LodOptions final {
+        // The triangle count of each level relative to the full primitive.
+        std::vector<float> triangleRatios = { 0.5f, 0.25f, 0.125f };
+        SimplifyOptions simplify = {};
+    };
+
+    /**
+     * Simplifies a triangle list using edge collapses ordered by a quadric error metric. Every
+     * vertex is collapsed onto one of its neighbours, so the result only references existing
+     * vertices and can share the vertex buffer of the input. Vertices on borders and on UV or
+     * normal seams are never moved. Returns the new indices and writes the geometric error of
+     * the result in object space units into error.
+     */
+    [[nodiscard]] auto simplify(std::span<const uint32_t> indices, std::span<const Vertex> vertices, std::size_t targetTriangleCount,
+                                const SimplifyOptions& options, float& error) -> std::vector<uint32_t>;
+
+    /**
+     * Replaces the LODs of a triangle list primitive using VertexLayout::Full. Each level is
+     * simplified from the previous one, and levels that no longer reduce the triangle count are
+     * dropped. The result only depends on the primitive and the options. Other primitives get
+     * no LODs.
+     */
+    void generateLods(Primitive& primitive, const LodOptions& options);
+
+    // Generates the LODs of all primitives of the meshes in parallel on the Scheduler.
+    void generateLods(std::span<const std::shared_ptr<Mesh>> meshes, const LodOptions& options);
+
+    /**
+     * Returns the coarsest level whose projected error stays below maxError, where 0 is the full
+     * primitive and i is lods[i - 1]. errorScale converts an object space error into the unit of
+     * maxError, e.g. pixels per unit at the distance of the primitive.
+     */
+    [[nodiscard]] auto selectLod(const Primitive& primitive, float errorScale, float maxError) noexcept -> std::size_t;
+} // namespace krypton::assets::processing
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include <assets/mesh.hpp>
+#include <assets/meshlet.hpp>
+
+namespace krypton::assets::processing {
+    struct MeshletOptions final {
+        // At most 254, as meshlets use 8-bit local indices and the builder reserves 255.
+        uint32_t maxVertices = maxMeshletVertices;
+        uint32_t maxTriangles = maxMeshletTriangles;
+    };
+
+    /**
+     * Partitions a triangle list into meshlets. Each meshlet is grown from a seed triangle by
+     * repeatedly adding the adjacent triangle that needs the fewest new vertices, which keeps
+     * the meshlets compact and reuses as many vertices as possible. The bounds are left empty.
+     */
+    [[nodiscard]] auto buildMeshlets(std::span<const uint32_t> indices, std::size_t vertexCount, const MeshletOptions& options)
+        -> MeshletBuffer;
+
+    // Computes the bounding sphere and normal cone of every meshlet.
+    void computeMeshletBounds(MeshletBuffer& buffer, std::span<const Vertex> vertices);
+
+    // Replaces the meshlets of a triangle list primitive using VertexLayout::Full. Other primitives get no meshlets.
+    void buildMeshlets(Primitive& primitive, const MeshletOptions& options);
+
+    // Builds the meshlets of all primitives of the meshes in parallel on the Scheduler.
+    void buildMeshlets(std::span<const std::shared_ptr<Mesh>> meshes, const MeshletOptions& options);
+} // namespace krypton::assets::processing
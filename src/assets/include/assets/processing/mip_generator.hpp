@@ -0,0 +1,18 @@
+#pragma once
+
+#include <span>
+
+#include <assets/texture.hpp>
+
+namespace krypton::assets::processing {
+    /**
+     * Replaces the pixels of a texture with its full mip chain, down to 1x1. Levels are computed
+     * one after another from the previous level, with the rows of each level split across the
+     * Scheduler. Only textures with 8 or 16 bits per channel and a single level are supported,
+     * everything else is left as it is. Returns whether mips were generated.
+     */
+    bool generateMips(Texture& texture);
+
+    // Generates the mip chains of all textures in parallel on the Scheduler.
+    void generateMips(std::span<Texture> textures);
+} // namespace krypton::assets::processing
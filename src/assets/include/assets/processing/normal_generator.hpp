@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include <assets/primitive.hpp>
+
+namespace krypton::assets::processing {
+    enum class NormalGeneration : uint8_t {
+        // Every triangle gets its own vertices with the face normal, as required by glTF.
+        Flat = 0,
+        // Averages the face normals around every position, weighted by the corner angles.
+        Smooth = 1,
+    };
+
+    /**
+     * Computes smooth normals. Vertices that share a position also share their normal, so
+     * that UV seams don't show up as lighting seams.
+     */
+    void generateSmoothNormals(std::span<const uint32_t> indices, std::span<Vertex> vertices);
+
+    /**
+     * Computes tangents from the UV derivatives of the triangles. Just like MikkTSpace, the
+     * contributions of the triangles around a vertex are weighted by their corner angles, the
+     * tangent is orthogonalized against the normal and the bitangent sign is stored in w.
+     * tangents needs one element per vertex. This never splits vertices, so the triangles
+     * around every vertex have to agree on the handedness of their UVs. The overload for
+     * primitives takes care of that.
+     */
+    void generateTangents(std::span<const uint32_t> indices, std::span<const Vertex> vertices, std::span<CompactTangent> tangents);
+
+    // Replaces the normals of a triangle list primitive using VertexLayout::Full. Other primitives are left unchanged.
+    void generateNormals(Primitive& primitive, NormalGeneration mode);
+
+    /**
+     * Replaces the tangents of a triangle list primitive using VertexLayout::Full. Other primitives
+     * are left unchanged. Like MikkTSpace, vertices shared by triangles with mirrored and
+     * unmirrored UVs, e.g. along the seam of a symmetric model, are split first, so that each
+     * copy gets the tangent and bitangent sign of its side. The copies are appended to the
+     * vertices, so existing indices stay valid.
+     */
+    void generateTangents(Primitive& primitive);
+} // namespace krypton::assets::processing
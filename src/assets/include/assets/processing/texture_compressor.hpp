@@ -0,0 +1,30 @@
+#pragma once
+
+#include <span>
+
+#include <assets/texture.hpp>
+
+namespace krypton::assets::processing {
+    struct TextureCompressionOptions final {
+        // Color textures use BC7, which has twice the size of BC1, but far better quality and
+        // alpha support. Otherwise BC1 is used for opaque and BC3 for transparent textures.
+        bool useBc7 = true;
+    };
+
+    /**
+     * Picks the format for a texture from its role: BC5 for normal maps, BC4 for occlusion and
+     * BC7, or BC1 and BC3, for everything else. Returns BlockCompression::None for textures that
+     * can't be compressed, i.e. anything but uncompressed RGBA8.
+     */
+    [[nodiscard]] auto selectBlockCompression(const Texture& texture, const TextureCompressionOptions& options)
+        -> krypton::util::BlockCompression;
+
+    /**
+     * Compresses every mip level of an RGBA8 texture, with the block rows split across the
+     * Scheduler. Returns whether the texture was compressed.
+     */
+    bool compressTexture(Texture& texture, krypton::util::BlockCompression compression);
+
+    // Compresses all textures with the formats of their roles in parallel on the Scheduler.
+    void compressTextures(std::span<Texture> textures, const TextureCompressionOptions& options);
+} // namespace krypton::assets::processing
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include <assets/vertex.hpp>
+#include <util/flat_map.hpp>
+#include <util/hash.hpp>
+
+namespace krypton::assets::processing {
+    // The triangles referencing each vertex, stored as one array with per-vertex offsets.
+    struct TriangleAdjacency final {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+
+        void build(std::span<const uint32_t> indices, std::size_t vertexCount) {
+            offsets.assign(vertexCount + 1, 0);
+            for (auto index : indices)
+                ++offsets[index + 1];
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            triangles.resize(indices.size());
+            std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+            for (std::size_t i = 0; i < indices.size(); ++i)
+                triangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        [[nodiscard]] auto get(uint32_t vertex) const noexcept -> std::span<const uint32_t> {
+            return { triangles.data() + offsets[vertex], offsets[vertex + 1] - offsets[vertex] };
+        }
+    };
+
+    /**
+     * Assigns an id to every distinct position, so that vertices which only differ in their
+     * attributes can be recognized as the same point of the surface.
+     */
+    [[nodiscard]] inline auto getPositionIds(std::span<const Vertex> vertices) -> std::vector<uint32_t> {
+        util::FlatMap<uint64_t, uint32_t> firstOccurrences;
+        firstOccurrences.reserve(vertices.size());
+
+        std::vector<uint32_t> ids(vertices.size());
+        for (uint32_t i = 0; i < vertices.size(); ++i) {
+            const auto& position = vertices[i].pos;
+            auto hash = util::hashBytes(&position, sizeof(float) * 3);
+            auto [first, inserted] = firstOccurrences.insert(hash, i);
+            bool same = !inserted && std::memcmp(&vertices[*first].pos, &position, sizeof(float) * 3) == 0;
+            ids[i] = same ? ids[*first] : i;
+        }
+        return ids;
+    }
+} // namespace krypton::assets::processing
@@ -1,13 +1,62 @@
 #pragma once
 
+#include <bit>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
+#include <assets/bounds.hpp>
 #include <assets/mesh.hpp>
+#include <util/transform_hierarchy.hpp>
 
 namespace krypton::assets {
+    /**
+     * The node tree of a scene, flattened so that nodes can be moved or animated after loading
+     * and all world matrices can be recomputed in parallel.
+     */
+    struct SceneHierarchy final {
+        krypton::util::TransformHierarchy nodes;
+        std::vector<std::string> nodeNames;
+        // The node of every instance, whose world matrix is the transform of the instance.
+        std::vector<uint32_t> instanceNodes;
+        // The skin of every instance, or noSkin.
+        std::vector<uint32_t> instanceSkins;
+        // The morph target weights of node i are morphWeights[morphWeightOffsets[i], morphWeightOffsets[i + 1]), so there is
+        // one more offset than there are nodes.
+        std::vector<uint32_t> morphWeightOffsets;
+        std::vector<float> morphWeights;
+
+        static constexpr uint32_t noSkin = ~0U;
+
+        void clear() noexcept {
+            nodes.clear();
+            nodeNames.clear();
+            instanceNodes.clear();
+            instanceSkins.clear();
+            morphWeightOffsets.clear();
+            morphWeights.clear();
+        }
+
+        [[nodiscard]] auto getMorphWeights(uint32_t node) noexcept -> std::span<float> {
+            return std::span(morphWeights).subspan(morphWeightOffsets[node], morphWeightOffsets[node + 1] - morphWeightOffsets[node]);
+        }
+
+        // Recomputes the world matrices of all changed nodes and copies them into the instances.
+        void update(std::span<krypton::assets::MeshInstance> instances) {
+            nodes.update();
+            const auto worldMatrices = nodes.getWorldMatrices();
+            for (std::size_t i = 0; i < instances.size(); ++i)
+                instances[i].transform = std::bit_cast<glm::mat4>(worldMatrices[instanceNodes[i]]);
+        }
+    };
+
     struct Scene final {
         std::string name = {};
         std::vector<krypton::assets::Mesh> meshes;
+        std::vector<krypton::assets::MeshInstance> instances;
+        // The bounds of every mesh, indexed like meshes.
+        krypton::assets::BoundsTable meshBounds;
+        krypton::assets::SceneHierarchy hierarchy;
     };
 } // namespace krypton::assets
@@ -1,16 +1,45 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
-#include <vector>
+
+#include <assets/pixel_buffer.hpp>
+#include <util/block_compression.hpp>
 
 namespace krypton::assets {
+    // What a texture is used for, which decides how it can be compressed.
+    enum class TextureRole : uint8_t {
+        // Base color and emissive textures, and textures not used by any material.
+        Color = 0,
+        Normal = 1,
+        // Occlusion only uses the red channel.
+        Occlusion = 2,
+        // Roughness and metallic are stored in the green and blue channels.
+        MetallicRoughness = 3,
+    };
+
     struct Texture final {
         std::filesystem::path filePath;
         std::string name;
         uint32_t width = 0, height = 0, channels = 0;
         uint32_t mipLevels = 0;
         uint8_t bitsPerPixel = 8; // We should only really allow 6-bits, but that's not possible...
-        std::vector<std::byte> pixels = {};
+        // Whether the color channels are sRGB encoded, as with base color and emissive textures.
+        bool srgb = false;
+        TextureRole role = TextureRole::Color;
+        // If compressed, the pixels hold 4x4 blocks instead, with partial blocks at the edges.
+        krypton::util::BlockCompression compression = krypton::util::BlockCompression::None;
+        // The mip levels, starting with the full resolution level, tightly packed one after another.
+        krypton::assets::PixelBuffer pixels = {};
     };
+
+    // The size of a single mip level of the texture in bytes.
+    [[nodiscard]] inline auto getTextureLevelSize(const Texture& texture, uint32_t level) noexcept -> std::size_t {
+        const auto width = krypton::util::getMipExtent(texture.width, level);
+        const auto height = krypton::util::getMipExtent(texture.height, level);
+        if (texture.compression != krypton::util::BlockCompression::None)
+            return krypton::util::getCompressedImageSize(width, height, texture.compression);
+        return static_cast<std::size_t>(width) * height * texture.channels * texture.bitsPerPixel / 8;
+    }
 } // namespace krypton::assets
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <glm/glm.hpp>
 
 namespace krypton::assets {
@@ -17,4 +19,49 @@ namespace krypton::assets {
     };
 
     static constexpr uint32_t VERTEX_STRIDE = sizeof(Vertex);
+
+    enum class VertexLayout : uint8_t {
+        // Uses Vertex.
+        Full = 0,
+        // Uses CompactVertex.
+        Compact = 1,
+        // Uses QuantizedVertex.
+        Quantized = 2,
+    };
+
+    /**
+     * A vertex with a full precision position, an octahedral-encoded snorm16 normal and a
+     * half-float UV. 20 bytes.
+     */
+    struct CompactVertex final {
+        float position[3];
+        int16_t normal[2];
+        uint16_t uv[2];
+    };
+
+    /**
+     * Like CompactVertex, but with each position and UV component quantized to unorm16 on a grid
+     * shared by the whole mesh. Positions are restored with Mesh::positionOffset and
+     * Mesh::positionScale, and UVs with Mesh::uvOffset and Mesh::uvScale. The fourth position
+     * component is only padding. 16 bytes.
+     */
+    struct QuantizedVertex final {
+        uint16_t position[4];
+        int16_t normal[2];
+        uint16_t uv[2];
+    };
+
+    /**
+     * A snorm16 tangent with the sign of the bitangent in w, as defined by glTF. Tangents are
+     * kept in their own stream with every layout, so that primitives without normal maps don't
+     * pay for them.
+     */
+    struct CompactTangent final {
+        int16_t tangent[4];
+    };
+
+    static_assert(sizeof(Vertex) == 64);
+    static_assert(sizeof(CompactVertex) == 20);
+    static_assert(sizeof(QuantizedVertex) == 16);
+    static_assert(sizeof(CompactTangent) == 8);
 } // namespace krypton::assets
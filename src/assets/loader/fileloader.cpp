@@ -1,242 +1,1022 @@
-#define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_WRITE_IMPLEMENTATION
+// Decoded images are adopted by PixelBuffer, which frees them with std::free.
+#define STBI_MALLOC(size) std::malloc(size)
+#define STBI_REALLOC(pointer, size) std::realloc(pointer, size)
+#define STBI_FREE(pointer) std::free(pointer)
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <numeric>
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/quaternion.hpp>
-#include <tiny_gltf.h>
+#include <stb_image.h>
+
+#include <fmt/format.h>
 
 #include <Tracy.hpp>
 
 #include <assets/loader/fileloader.hpp>
+#include <assets/loader/gltf.hpp>
+#include <assets/loader/ktx2.hpp>
+#include <assets/loader/mesh_cache.hpp>
+#include <assets/processing/mip_generator.hpp>
+#include <assets/processing/normal_generator.hpp>
+#include <util/animation_sampler.hpp>
+#include <util/hash.hpp>
+#include <util/index_conversion.hpp>
 #include <util/logging.hpp>
+#include <util/mapped_file.hpp>
+#include <util/numeric_conversion.hpp>
+#include <util/scheduler.hpp>
+#include <util/strided_copy.hpp>
+#include <util/transform_math.hpp>
 
 namespace krypton::assets::loader {
-    struct PrimitiveBufferValue {
-        const float* data = nullptr;
-        uint64_t stride = 0;
-        uint64_t count = 0;
-    };
-
-    glm::mat4 getTransformMatrix(const tinygltf::Node& node, glm::mat4x4& base) {
+    /**
+     * The local transform of a node as translation, rotation and scale. Matrices are decomposed,
+     * which glTF allows as they must not have any skew or shear.
+     */
+    void getNodeTransform(const GltfNode& node, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) {
         /** Both a matrix and TRS values are not allowed
          * to exist at the same time according to the spec */
-        if (node.matrix.size() == 16) {
-            return base * glm::mat4x4(glm::make_mat4x4(node.matrix.data()));
-        } else {
-            auto translation = glm::vec3(0.0f);
-            auto rotation = glm::quat();
-            auto scale = glm::vec3(1.0f);
+        if (node.hasMatrix) {
+            const auto matrix = glm::make_mat4x4(node.matrix);
+            const auto x = glm::vec3(matrix[0]), y = glm::vec3(matrix[1]), z = glm::vec3(matrix[2]);
+            translation = glm::vec3(matrix[3]);
+            scale = glm::vec3(glm::length(x), glm::length(y), glm::length(z));
+            // Mirroring is represented by a negative scale.
+            if (glm::determinant(glm::mat3(x, y, z)) < 0.0f)
+                scale.x = -scale.x;
+            rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            if (scale.x != 0.0f && scale.y != 0.0f && scale.z != 0.0f)
+                rotation = glm::quat_cast(glm::mat3(x / scale.x, y / scale.y, z / scale.z));
+            return;
+        }
 
-            if (node.translation.size() == 3)
-                translation = glm::make_vec3(node.translation.data());
+        translation = glm::make_vec3(node.translation);
+        // glTF stores quaternions as xyzw, while glm's constructor takes wxyz.
+        rotation = glm::quat(node.rotation[3], node.rotation[0], node.rotation[1], node.rotation[2]);
+        scale = glm::make_vec3(node.scale);
+    }
+
+    /**
+     * Reads every element of an accessor with at most four components as floats. Unlike
+     * getStridedSource, this also supports sparse accessors, which are common for morph targets.
+     * Returns the number of components per element.
+     */
+    auto readAccessor(const GltfAsset& asset, int32_t accessorIndex, std::vector<float>& out) -> uint32_t {
+        const auto& accessor = asset.accessors[accessorIndex];
+        const auto componentCount = accessor.componentCount;
+        out.clear();
+        if (componentCount == 0 || componentCount > 4)
+            return componentCount;
+
+        // Sparse accessors without a buffer view are initialized with zeros.
+        out.resize(accessor.count * componentCount, 0.0f);
+        auto source = asset.getStridedSource(accessorIndex);
+        if (source.count != 0)
+            util::gatherStrided(source, out.data(), componentCount * sizeof(float), componentCount);
+        const auto& sparse = accessor.sparse;
+        if (sparse.count == 0)
+            return componentCount;
+
+        const util::StridedSource values = {
+            .data = asset.getBufferViewData(sparse.valuesBufferView).data() + sparse.valuesByteOffset,
+            .stride = util::getComponentSize(accessor.componentType) * componentCount,
+            .count = sparse.count,
+            .componentType = accessor.componentType,
+            .componentCount = componentCount,
+            .normalized = accessor.normalized,
+        };
+        std::vector<float> sparseValues(values.count * componentCount);
+        util::gatherStrided(values, sparseValues.data(), componentCount * sizeof(float), componentCount);
+
+        const auto* indices = asset.getBufferViewData(sparse.indicesBufferView).data() + sparse.indicesByteOffset;
+        const auto indexSize = util::getComponentSize(sparse.indicesComponentType);
+        for (std::size_t i = 0; i < values.count; ++i) {
+            uint32_t index = 0;
+            if (indexSize == 1) {
+                index = static_cast<uint8_t>(indices[i]);
+            } else if (indexSize == 2) {
+                uint16_t value;
+                std::memcpy(&value, indices + i * 2, sizeof(value));
+                index = value;
+            } else {
+                std::memcpy(&index, indices + i * 4, sizeof(index));
+            }
+            if (index < accessor.count)
+                std::copy_n(&sparseValues[i * componentCount], componentCount, &out[index * componentCount]);
+        }
+        return componentCount;
+    }
 
-            if (node.rotation.size() == 4)
-                rotation = glm::make_quat(node.rotation.data());
+    /**
+     * Reads the joints, weights and morph targets of a primitive. This has to happen before
+     * anything reorders or duplicates the vertices.
+     */
+    void loadGltfDeformation(const GltfAsset& asset, const GltfPrimitive& primitive, krypton::assets::Primitive& kPrimitive) {
+        ZoneScoped;
+        const auto vertexCount = kPrimitive.vertices.size();
+        const auto jointsAttribute = primitive.findAttribute("JOINTS_0");
+        const auto weightsAttribute = primitive.findAttribute("WEIGHTS_0");
+        std::vector<float> joints, weights;
+        if (jointsAttribute >= 0 && weightsAttribute >= 0 && readAccessor(asset, jointsAttribute, joints) == 4 &&
+            readAccessor(asset, weightsAttribute, weights) == 4 &&
+            joints.size() >= vertexCount * 4 && weights.size() >= vertexCount * 4) {
+            kPrimitive.influences.resize(vertexCount);
+            for (std::size_t i = 0; i < vertexCount; ++i) {
+                auto& influences = kPrimitive.influences[i];
+                float sum = 0.0f;
+                for (std::size_t k = 0; k < 4; ++k)
+                    sum += std::max(weights[i * 4 + k], 0.0f);
+                for (std::size_t k = 0; k < 4; ++k) {
+                    influences.joints[k] = static_cast<uint16_t>(std::clamp(joints[i * 4 + k], 0.0f, 65535.0f));
+                    influences.weights[k] = sum > 0.0f ? util::floatToUnorm16(std::max(weights[i * 4 + k], 0.0f) / sum) : uint16_t(0);
+                }
+            }
+        }
 
-            if (node.scale.size() == 3)
-                scale = glm::make_vec3(node.scale.data());
+        // Only the vertices a target actually moves are kept.
+        std::vector<float> positionDeltas, normalDeltas;
+        for (const auto& target : primitive.targets) {
+            auto& kTarget = kPrimitive.morphTargets.emplace_back();
+            const auto position = GltfPrimitive::findAttribute(target, "POSITION");
+            const auto normal = GltfPrimitive::findAttribute(target, "NORMAL");
+            if (position < 0 || readAccessor(asset, position, positionDeltas) != 3 || positionDeltas.size() < vertexCount * 3)
+                positionDeltas.assign(vertexCount * 3, 0.0f);
+            const bool hasNormals = normal >= 0 && readAccessor(asset, normal, normalDeltas) == 3 && normalDeltas.size() >= vertexCount * 3;
 
-            return base * glm::translate(glm::mat4(1.0f), translation) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
+            for (uint32_t v = 0; v < vertexCount; ++v) {
+                const float* p = &positionDeltas[v * 3];
+                const float* n = hasNormals ? &normalDeltas[v * 3] : nullptr;
+                const bool moved = p[0] != 0.0f || p[1] != 0.0f || p[2] != 0.0f ||
+                                   (n != nullptr && (n[0] != 0.0f || n[1] != 0.0f || n[2] != 0.0f));
+                if (!moved)
+                    continue;
+                kTarget.vertices.push_back(v);
+                kTarget.positionDeltas.insert(kTarget.positionDeltas.end(), p, p + 3);
+                if (hasNormals)
+                    kTarget.normalDeltas.insert(kTarget.normalDeltas.end(), n, n + 3);
+            }
         }
     }
 
-    int32_t getTinyGltfTypeSizeInBytes(uint32_t type) {
-        return tinygltf::GetNumComponentsInType(type) * tinygltf::GetComponentSizeInBytes(TINYGLTF_COMPONENT_TYPE_FLOAT);
+    template <typename T>
+    auto getMaxIndex(const void* data, std::size_t count) -> uint32_t {
+        const auto* indices = static_cast<const T*>(data);
+        T maximum = 0;
+        for (std::size_t i = 0; i < count; ++i)
+            maximum = std::max(maximum, indices[i]);
+        return maximum;
     }
 
-    void getBufferValueForAccessor(tinygltf::Model& model, int accessorIndex, int type, PrimitiveBufferValue* bv) {
-        const auto& accessor = model.accessors[accessorIndex];
-        const auto& bufferView = model.bufferViews[accessor.bufferView];
-        bv->data = reinterpret_cast<const float*>(&(model.buffers[bufferView.buffer].data[accessor.byteOffset + bufferView.byteOffset]));
-        bv->stride = accessor.ByteStride(bufferView) ? (accessor.ByteStride(bufferView) / sizeof(float)) : getTinyGltfTypeSizeInBytes(type);
-        bv->count = accessor.count;
+    // The largest index of an index accessor, or 0 if its type can't be used for indices.
+    auto getMaxGltfIndex(const util::StridedSource& source) -> uint32_t {
+        if (source.data == nullptr)
+            return 0;
+        switch (source.componentType) {
+            case util::ComponentType::Uint8:
+                return getMaxIndex<uint8_t>(source.data, source.count);
+            case util::ComponentType::Uint16:
+                return getMaxIndex<uint16_t>(source.data, source.count);
+            case util::ComponentType::Uint32:
+                return getMaxIndex<uint32_t>(source.data, source.count);
+            default:
+                return 0;
+        }
     }
 
-    template <typename T, typename S>
-    void writeToVector(const T* src, const size_t count, std::vector<S>& out) {
-        ZoneScoped;
-        out.resize(count);
-        for (size_t i = 0; i < count; ++i)
-            out[i] = static_cast<T>(src[i]);
+    /**
+     * The unorm16 grid that holds every value of an 8 or 16-bit integer attribute exactly, as
+     * value = offset + scale * (unorm16 / 65535). Returns false for other component types.
+     */
+    bool getSourceGrid(const SourceEncoding& encoding, float& offset, float& scale) {
+        const auto bits = static_cast<uint32_t>(util::getComponentSize(encoding.componentType) * 8);
+        const bool isSigned = encoding.componentType == util::ComponentType::Int8 || encoding.componentType == util::ComponentType::Int16;
+        if (encoding.componentType == util::ComponentType::Float || bits > 16)
+            return false;
+
+        const auto range = static_cast<float>(1U << bits);
+        const auto minimum = isSigned ? -range / 2.0f : 0.0f;
+        // glTF maps signed integers to [-1, 1] by dividing by their maximum, clamping the minimum.
+        const auto normalization = isSigned ? range / 2.0f - 1.0f : range - 1.0f;
+
+        // 8-bit values are shifted into the upper byte of the unorm16.
+        offset = minimum;
+        scale = 65535.0f / static_cast<float>(1U << (16 - bits));
+        if (encoding.normalized) {
+            offset /= normalization;
+            scale /= normalization;
+        }
+        return true;
+    }
+
+    // Returns true and the grid if every primitive that still has full vertices was stored on the same integer grid.
+    template <typename GetEncoding>
+    bool getSharedSourceGrid(const Mesh& mesh, GetEncoding getEncoding, float& offset, float& scale) {
+        const Primitive* first = nullptr;
+        for (const auto& primitive : mesh.primitives) {
+            if (primitive.vertexLayout != VertexLayout::Full)
+                continue;
+            if (first != nullptr && getEncoding(primitive) != getEncoding(*first))
+                return false;
+            first = &primitive;
+        }
+        return first != nullptr && getSourceGrid(getEncoding(*first), offset, scale);
+    }
+
+    /**
+     * Converts the indices of glTF line loops, line strips, triangle strips and triangle fans
+     * into lists, with the vertex order the glTF specification defines for each of them.
+     */
+    auto assembleGltfPrimitive(uint32_t mode, IndexBuffer& indices, IndexType indexType) -> PrimitiveTopology {
+        switch (mode) {
+            case 0:
+                return PrimitiveTopology::Points;
+            case 1:
+                return PrimitiveTopology::Lines;
+            case 2:
+            case 3:
+            case 5:
+            case 6:
+                break;
+            default:
+                return PrimitiveTopology::Triangles;
+        }
+
+        const auto strip = indices.toUint32();
+        const auto count = strip.size();
+        std::vector<uint32_t> list;
+        if (mode == 2 || mode == 3) {
+            list.reserve(count * 2);
+            for (std::size_t i = 0; i + 1 < count; ++i)
+                list.insert(list.end(), { strip[i], strip[i + 1] });
+            // Line loops are closed by one more line.
+            if (mode == 2 && count > 1)
+                list.insert(list.end(), { strip[count - 1], strip[0] });
+            indices.assign(list, indexType);
+            return PrimitiveTopology::Lines;
+        }
+
+        list.reserve(count * 3);
+        for (std::size_t i = 0; i + 2 < count; ++i) {
+            if (mode == 6)
+                list.insert(list.end(), { strip[i + 1], strip[i + 2], strip[0] });
+            else if (i % 2 == 0)
+                list.insert(list.end(), { strip[i], strip[i + 1], strip[i + 2] });
+            else // Every other triangle of a strip is flipped to keep the winding order.
+                list.insert(list.end(), { strip[i], strip[i + 2], strip[i + 1] });
+        }
+        indices.assign(list, indexType);
+        return PrimitiveTopology::Triangles;
     }
 } // namespace krypton::assets::loader
 
 namespace ka = krypton::assets;
 
-void ka::loader::FileLoader::loadGltfMesh(tinygltf::Model& model, const tinygltf::Mesh& mesh, const tinygltf::Node& node,
-                                          glm::mat4 parentMatrix) {
+bool ka::loader::decodeImage(std::span<const std::byte> encoded, ka::Texture& texture) {
     ZoneScoped;
-    auto& kMesh = meshes.emplace_back(std::make_shared<ka::Mesh>());
-    kMesh->name = mesh.name;
-    kMesh->transform = parentMatrix;
+    const auto* data = reinterpret_cast<const stbi_uc*>(encoded.data());
+    auto size = static_cast<int>(encoded.size());
 
-    for (const auto& primitive : mesh.primitives) {
-        auto& kPrimitive = kMesh->primitives.emplace_back();
+    // We always expand images to four channels, as three channel formats are
+    // hardly supported by GPUs.
+    constexpr int channels = 4;
+    int width = 0, height = 0, fileChannels = 0;
+    void* pixels = nullptr;
+    std::size_t bytesPerChannel = 1;
+    if (stbi_is_16_bit_from_memory(data, size)) {
+        pixels = stbi_load_16_from_memory(data, size, &width, &height, &fileChannels, channels);
+        bytesPerChannel = 2;
+    } else {
+        pixels = stbi_load_from_memory(data, size, &width, &height, &fileChannels, channels);
+    }
+    if (pixels == nullptr)
+        return false;
 
-        {
-            // We require a position attribute.
-            if (primitive.attributes.find("POSITION") == primitive.attributes.end()) [[unlikely]]
-                continue;
+    // stb_image always allocates its own output, which the texture takes over as it is.
+    texture.width = static_cast<uint32_t>(width);
+    texture.height = static_cast<uint32_t>(height);
+    texture.channels = channels;
+    texture.bitsPerPixel = static_cast<uint8_t>(bytesPerChannel * 8);
+    texture.mipLevels = 1;
+    texture.pixels.adopt(pixels, static_cast<std::size_t>(width) * height * channels * bytesPerChannel);
+    return true;
+}
+
+void ka::loader::loadGltfPrimitive(const GltfAsset& asset, const GltfPrimitive& primitive, ka::Primitive& kPrimitive,
+                                   const LoaderOptions& options) {
+    ZoneScoped;
+    kPrimitive.materialIndex = primitive.material;
 
-            // We will first load all the different buffers (possibly the same buffer at a different
-            // offset) and store them as pointers.
-            PrimitiveBufferValue positions = {}, normals = {}, uvs = {};
-            getBufferValueForAccessor(model, primitive.attributes.find("POSITION")->second, TINYGLTF_TYPE_VEC3, &positions);
+    // We require a position attribute.
+    const auto positionAttribute = primitive.findAttribute("POSITION");
+    if (positionAttribute < 0) [[unlikely]]
+        return;
 
-            if (primitive.attributes.find("NORMAL") != primitive.attributes.end())
-                getBufferValueForAccessor(model, primitive.attributes.find("NORMAL")->second, TINYGLTF_TYPE_VEC3, &normals);
+    auto positions = asset.getStridedSource(positionAttribute);
+    kPrimitive.vertices.resize(positions.count);
+    kPrimitive.positionEncoding = { positions.componentType, positions.normalized };
 
-            if (primitive.attributes.find("TEXCOORD_0") != primitive.attributes.end())
-                getBufferValueForAccessor(model, primitive.attributes.find("TEXCOORD_0")->second, TINYGLTF_TYPE_VEC2, &uvs);
+    // Every attribute is gathered straight into the interleaved vertices in one pass. Attributes
+    // with fewer components are filled with (0, 0, 0, 1), which matches the previous defaults.
+    bool hasColors = false;
+    bool hasNormals = false;
+    if (!kPrimitive.vertices.empty()) {
+        ZoneScopedN("Vertices");
+        auto& firstVertex = kPrimitive.vertices.front();
+        std::vector<util::StridedGather> gathers;
+        gathers.push_back({ positions, &firstVertex.pos.x, 4 });
 
-            for (size_t i = 0; i < positions.count; ++i) {
-                /* Create new vertices */
-                auto& vertex = kPrimitive.vertices.emplace_back();
-                auto pos = glm::make_vec3(&positions.data[i * positions.stride]);
-                vertex.pos = glm::fvec4(pos.x, pos.y, pos.z, 1.0f);
+        auto addAttribute = [&](const char* name, float* dst, uint32_t dstComponents) -> bool {
+            const auto attribute = primitive.findAttribute(name);
+            if (attribute < 0)
+                return false;
+            auto source = asset.getStridedSource(attribute);
+            source.count = std::min(source.count, positions.count);
+            gathers.push_back({ source, dst, dstComponents });
+            return source.count != 0;
+        };
+        hasNormals = addAttribute("NORMAL", &firstVertex.normals.x, 4);
+        if (addAttribute("TEXCOORD_0", &firstVertex.uv.x, 2))
+            kPrimitive.uvEncoding = { gathers.back().source.componentType, gathers.back().source.normalized };
+        hasColors = options.vertexColors && addAttribute("COLOR_0", &firstVertex.color.x, 4);
 
-                if (normals.data != nullptr) {
-                    auto normal = glm::make_vec3(&normals.data[i * normals.stride]);
-                    vertex.normals = glm::fvec4(normal.x, normal.y, normal.z, 1.0f);
-                }
+        util::gatherStrided(gathers, sizeof(ka::Vertex));
+
+        // Tangents only matter for normal mapping, so they are kept in their own stream.
+        if (const auto tangentAttribute = primitive.findAttribute("TANGENT"); tangentAttribute >= 0) {
+            auto source = asset.getStridedSource(tangentAttribute);
+            source.count = std::min(source.count, positions.count);
+            std::vector<glm::fvec4> tangents(kPrimitive.vertices.size(), glm::fvec4(1.0f, 0.0f, 0.0f, 1.0f));
+            util::gatherStrided(source, &tangents.front().x, sizeof(glm::fvec4), 4);
+            kPrimitive.tangents.resize(tangents.size());
+            util::convertFloatToSnorm16({ &tangents.front().x, tangents.size() * 4 },
+                                        { &kPrimitive.tangents.front().tangent[0], tangents.size() * 4 });
+            kPrimitive.hasTangents = source.count != 0;
+            if (!kPrimitive.hasTangents)
+                kPrimitive.tangents.clear();
+        }
+    }
+
+    // glTF requires the min and max of position accessors, so we usually don't have to look at
+    // the vertices again. Quantized positions have them in the quantized units though.
+    const auto& positionAccessor = asset.accessors[positionAttribute];
+    if (positionAccessor.componentType == util::ComponentType::Float && positionAccessor.boundsComponentCount == 3 &&
+        !kPrimitive.vertices.empty()) {
+        for (int i = 0; i < 3; ++i) {
+            kPrimitive.boundingBox.min[i] = positionAccessor.min[i];
+            kPrimitive.boundingBox.max[i] = positionAccessor.max[i];
+        }
+        kPrimitive.boundingSphere = ka::getBoundingSphere(kPrimitive.boundingBox);
+    } else {
+        computeBounds(kPrimitive);
+    }
+
+    // Indices are optional with glTF. We store them in the narrowest type that can address all
+    // vertices, which usually avoids any conversion for 16-bit glTF indices.
+    auto vertexCount = kPrimitive.vertices.size();
+    auto indexType = ka::getNarrowestIndexType(vertexCount, options.allowUint8Indices);
+    auto& indices = kPrimitive.indices;
+    if (primitive.indices >= 0) {
+        const auto source = asset.getStridedSource(primitive.indices);
+        auto indexCount = source.count;
+        const void* dataPtr = source.data;
 
-                if (uvs.data != nullptr) {
-                    vertex.uv = glm::make_vec2(&uvs.data[i * uvs.stride]);
+        // Everything after this indexes the vertices without any checks, and 32-bit indices may
+        // be narrowed, so malformed primitives are dropped here.
+        if (indexCount != 0 && getMaxGltfIndex(source) >= vertexCount) {
+            krypton::log::err("Index accessor {} references vertices that don't exist.", primitive.indices);
+            kPrimitive = ka::Primitive();
+            return;
+        }
+
+        // Index accessors without a buffer view would be all zeros, which is useless.
+        switch (dataPtr != nullptr ? source.componentType : util::ComponentType::Float) {
+            case util::ComponentType::Uint32: {
+                indices.assign({ static_cast<const uint32_t*>(dataPtr), indexCount }, indexType);
+                break;
+            }
+            case util::ComponentType::Uint16: {
+                // We don't bother narrowing 16-bit indices any further.
+                if (indexType == ka::IndexType::Uint32) {
+                    indices.resize(ka::IndexType::Uint32, indexCount);
+                    krypton::util::widenIndices({ static_cast<const uint16_t*>(dataPtr), indexCount }, indices.as<uint32_t>());
+                } else {
+                    indices.resize(ka::IndexType::Uint16, indexCount);
+                    std::memcpy(indices.getBytes().data(), dataPtr, indices.getBytes().size());
                 }
+                break;
             }
+            case util::ComponentType::Uint8: {
+                indices.resize(indexType, indexCount);
+                if (indexType == ka::IndexType::Uint8) {
+                    std::memcpy(indices.getBytes().data(), dataPtr, indexCount);
+                } else if (indexType == ka::IndexType::Uint16) {
+                    krypton::util::widenIndices({ static_cast<const uint8_t*>(dataPtr), indexCount }, indices.as<uint16_t>());
+                } else {
+                    krypton::util::widenIndices({ static_cast<const uint8_t*>(dataPtr), indexCount }, indices.as<uint32_t>());
+                }
+                break;
+            }
+            default: {
+                krypton::log::err("Index accessor {} is unsupported.", primitive.indices);
+            }
+        }
+    } else {
+        /* As there are no indices, we'll generate them */
+        std::vector<uint32_t> generated(vertexCount);
+        std::iota(generated.begin(), generated.end(), 0U);
+        indices.assign(generated, indexType);
+    }
+    kPrimitive.topology = assembleGltfPrimitive(primitive.mode, indices, indexType);
 
-            // Indices are optional with glTF.
-            if (primitive.indices >= 0) {
-                const auto& accessor = model.accessors[primitive.indices];
-                const auto& bufferView = model.bufferViews[accessor.bufferView];
-                const auto& buffer = model.buffers[bufferView.buffer];
+    loadGltfDeformation(asset, primitive, kPrimitive);
 
-                auto indexCount = static_cast<size_t>(accessor.count);
-                const void* dataPtr = &(buffer.data[accessor.byteOffset + bufferView.byteOffset]);
+    // glTF requires flat normals if there are none, which is the default.
+    if (!hasNormals && !kPrimitive.vertices.empty())
+        ka::processing::generateNormals(kPrimitive, options.missingNormals);
 
-                switch (accessor.componentType) {
-                    case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT: {
-                        writeToVector(static_cast<const ka::Index*>(dataPtr), indexCount, kPrimitive.indices);
-                        break;
-                    }
-                    case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT: {
-                        writeToVector(static_cast<const uint16_t*>(dataPtr), indexCount, kPrimitive.indices);
-                        break;
-                    }
-                    default: {
-                        krypton::log::err("Index component type {} is unsupported.", accessor.componentType);
-                    }
-                }
+    bool needsTangents = options.missingTangents == TangentGeneration::Always;
+    if (options.missingTangents == TangentGeneration::NormalMapped && primitive.material >= 0)
+        needsTangents = asset.materials[primitive.material].normalTexture >= 0;
+    if (!kPrimitive.hasTangents && needsTangents && !kPrimitive.vertices.empty())
+        ka::processing::generateTangents(kPrimitive);
+
+    // The compact layouts have no room for colors, so we keep them in their own stream.
+    if (hasColors && options.vertexLayout != ka::VertexLayout::Full) {
+        kPrimitive.colors.resize(kPrimitive.vertices.size());
+        for (size_t i = 0; i < kPrimitive.vertices.size(); ++i) {
+            const auto& color = kPrimitive.vertices[i].color;
+            kPrimitive.colors[i] = static_cast<uint32_t>(util::floatToUnorm8(color.x)) |
+                                   static_cast<uint32_t>(util::floatToUnorm8(color.y)) << 8 |
+                                   static_cast<uint32_t>(util::floatToUnorm8(color.z)) << 16 |
+                                   static_cast<uint32_t>(util::floatToUnorm8(color.w)) << 24;
+        }
+    }
+}
+
+auto ka::loader::splitPrimitive(const ka::Primitive& primitive, std::size_t maxVertexCount, bool allowUint8Indices)
+    -> std::vector<ka::Primitive> {
+    ZoneScoped;
+    std::vector<ka::Primitive> result;
+    if (!primitive.isTriangleList()) {
+        result.push_back(primitive);
+        return result;
+    }
+
+    auto indices = primitive.indices.toUint32();
+    const bool hasColors = !primitive.colors.empty();
+    const bool hasTangents = !primitive.tangents.empty();
+
+    // Maps original vertex indices to indices within the current chunk.
+    std::vector<uint32_t> remap(primitive.vertices.size(), UINT32_MAX);
+    std::vector<uint32_t> chunkVertices;
+    std::vector<uint32_t> chunkIndices;
+
+    auto finishChunk = [&]() {
+        auto& chunk = result.emplace_back();
+        chunk.materialIndex = primitive.materialIndex;
+        chunk.hasTangents = primitive.hasTangents;
+        chunk.positionEncoding = primitive.positionEncoding;
+        chunk.uvEncoding = primitive.uvEncoding;
+        chunk.vertices.resize(chunkVertices.size());
+        if (hasColors)
+            chunk.colors.resize(chunkVertices.size());
+        if (hasTangents)
+            chunk.tangents.resize(chunkVertices.size());
+        for (size_t i = 0; i < chunkVertices.size(); ++i) {
+            chunk.vertices[i] = primitive.vertices[chunkVertices[i]];
+            if (hasColors)
+                chunk.colors[i] = primitive.colors[chunkVertices[i]];
+            if (hasTangents)
+                chunk.tangents[i] = primitive.tangents[chunkVertices[i]];
+            remap[chunkVertices[i]] = UINT32_MAX;
+        }
+        ka::gatherDeformation(primitive, chunkVertices, chunk);
+        chunk.indices.assign(chunkIndices, ka::getNarrowestIndexType(chunkVertices.size(), allowUint8Indices));
+        computeBounds(chunk);
+        chunkVertices.clear();
+        chunkIndices.clear();
+    };
+
+    // Triangles are kept in their original order, so that the vertex cache behaviour does not change.
+    for (size_t i = 0; i + 3 <= indices.size(); i += 3) {
+        const uint32_t* triangle = &indices[i];
+        size_t newVertices = 0;
+        for (size_t j = 0; j < 3; ++j) {
+            bool duplicate = (j > 0 && triangle[j] == triangle[0]) || (j > 1 && triangle[j] == triangle[1]);
+            if (remap[triangle[j]] == UINT32_MAX && !duplicate)
+                ++newVertices;
+        }
+
+        if (chunkVertices.size() + newVertices > maxVertexCount)
+            finishChunk();
+
+        for (size_t j = 0; j < 3; ++j) {
+            auto& mapped = remap[triangle[j]];
+            if (mapped == UINT32_MAX) {
+                mapped = static_cast<uint32_t>(chunkVertices.size());
+                chunkVertices.push_back(triangle[j]);
+            }
+            chunkIndices.push_back(mapped);
+        }
+    }
+
+    if (!chunkIndices.empty())
+        finishChunk();
+    return result;
+}
+
+void ka::loader::computeBounds(ka::Primitive& primitive) {
+    ZoneScoped;
+    primitive.boundingBox = {};
+    if (primitive.vertexLayout == ka::VertexLayout::Full && !primitive.vertices.empty())
+        krypton::util::computeAabb(&primitive.vertices[0].pos.x, sizeof(ka::Vertex), primitive.vertices.size(),
+                                   &primitive.boundingBox.min.x, &primitive.boundingBox.max.x);
+    primitive.boundingSphere = ka::getBoundingSphere(primitive.boundingBox);
+}
+
+void ka::loader::computeBounds(ka::Mesh& mesh) {
+    ZoneScoped;
+    mesh.boundingBox = {};
+    for (auto& primitive : mesh.primitives) {
+        if (primitive.boundingBox.empty())
+            computeBounds(primitive);
+        mesh.boundingBox.merge(primitive.boundingBox);
+    }
+    mesh.boundingSphere = ka::getBoundingSphere(mesh.boundingBox);
+}
+
+void ka::loader::compactVertices(ka::Mesh& mesh, ka::VertexLayout layout) {
+    ZoneScoped;
+    if (layout == ka::VertexLayout::Full)
+        return;
+
+    if (layout == ka::VertexLayout::Quantized) {
+        // All primitives share the same dequantization transform. Integer attributes keep the
+        // grid they were stored on, so that they are copied without any loss. Everything else
+        // is quantized to the bounds of all primitives.
+        float offset, scale;
+        if (getSharedSourceGrid(mesh, [](const ka::Primitive& primitive) { return primitive.positionEncoding; }, offset, scale)) {
+            mesh.positionOffset = glm::fvec3(offset);
+            mesh.positionScale = glm::fvec3(scale);
+        } else {
+            if (mesh.boundingBox.empty())
+                computeBounds(mesh);
+
+            if (mesh.boundingBox.empty()) {
+                mesh.positionOffset = glm::fvec3(0.0f);
+                mesh.positionScale = glm::fvec3(1.0f);
             } else {
-                /* As there are no indices, we'll generate them */
-                kPrimitive.indices.resize(positions.count);
-                for (size_t i = 0; i < positions.count; ++i) {
-                    kPrimitive.indices[i] = static_cast<ka::Index>(i);
+                mesh.positionOffset = mesh.boundingBox.min;
+                mesh.positionScale = mesh.boundingBox.max - mesh.boundingBox.min;
+            }
+        }
+
+        if (getSharedSourceGrid(mesh, [](const ka::Primitive& primitive) { return primitive.uvEncoding; }, offset, scale)) {
+            mesh.uvOffset = glm::fvec2(offset);
+            mesh.uvScale = glm::fvec2(scale);
+        } else {
+            auto uvMin = glm::fvec2(std::numeric_limits<float>::max()), uvMax = glm::fvec2(std::numeric_limits<float>::lowest());
+            for (const auto& primitive : mesh.primitives) {
+                if (primitive.vertexLayout != ka::VertexLayout::Full)
+                    continue;
+                for (const auto& vertex : primitive.vertices) {
+                    uvMin = glm::min(uvMin, vertex.uv);
+                    uvMax = glm::max(uvMax, vertex.uv);
                 }
             }
+            mesh.uvOffset = uvMin.x <= uvMax.x ? uvMin : glm::fvec2(0.0f);
+            mesh.uvScale = uvMin.x <= uvMax.x ? uvMax - uvMin : glm::fvec2(1.0f);
+        }
+    }
 
-            kPrimitive.materialIndex = primitive.material;
+    auto quantize = [](float value, float offset, float scale) -> uint16_t {
+        return scale > 0.0f ? util::floatToUnorm16((value - offset) / scale) : 0;
+    };
+    auto encodeNormal = [](const glm::fvec4& normal, int16_t* encoded) {
+        // Primitives without normals have zero vectors, which the octahedral mapping can't represent.
+        if (normal.x == 0.0f && normal.y == 0.0f && normal.z == 0.0f) {
+            encoded[0] = encoded[1] = 0;
+            return;
+        }
+        util::encodeOctahedral(&normal.x, encoded);
+    };
+
+    for (auto& primitive : mesh.primitives) {
+        if (primitive.vertexLayout != ka::VertexLayout::Full)
+            continue;
+
+        const auto& vertices = primitive.vertices;
+        if (layout == ka::VertexLayout::Compact) {
+            primitive.compactVertices.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                auto& compact = primitive.compactVertices[i];
+                compact.position[0] = vertices[i].pos.x;
+                compact.position[1] = vertices[i].pos.y;
+                compact.position[2] = vertices[i].pos.z;
+                encodeNormal(vertices[i].normals, compact.normal);
+                compact.uv[0] = util::floatToHalf(vertices[i].uv.x);
+                compact.uv[1] = util::floatToHalf(vertices[i].uv.y);
+            }
+        } else {
+            primitive.quantizedVertices.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                auto& quantized = primitive.quantizedVertices[i];
+                quantized.position[0] = quantize(vertices[i].pos.x, mesh.positionOffset.x, mesh.positionScale.x);
+                quantized.position[1] = quantize(vertices[i].pos.y, mesh.positionOffset.y, mesh.positionScale.y);
+                quantized.position[2] = quantize(vertices[i].pos.z, mesh.positionOffset.z, mesh.positionScale.z);
+                quantized.position[3] = 0;
+                encodeNormal(vertices[i].normals, quantized.normal);
+                quantized.uv[0] = quantize(vertices[i].uv.x, mesh.uvOffset.x, mesh.uvScale.x);
+                quantized.uv[1] = quantize(vertices[i].uv.y, mesh.uvOffset.y, mesh.uvScale.y);
+            }
         }
+
+        primitive.vertices = {};
+        primitive.vertexLayout = layout;
     }
 }
 
-void ka::loader::FileLoader::loadGltfNode(tinygltf::Model& model, uint32_t nodeIndex, glm::mat4 matrix) {
+ka::loader::FileLoader::FileLoader(LoaderOptions options) noexcept : options(options) {}
+
+void ka::loader::FileLoader::collectGltfNodes(const GltfAsset& asset, const GltfScene* scene, std::vector<PrimitiveWorkItem>& workItems) {
     ZoneScoped;
-    matrix = getTransformMatrix(model.nodes[nodeIndex], matrix);
+    hierarchy.clear();
+    gltfNodeIndices.assign(asset.nodes.size(), krypton::util::TransformHierarchy::noParent);
+
+    // The hierarchy has to be built breadth-first, so that its nodes are sorted by depth.
+    std::vector<std::pair<uint32_t, uint32_t>> queue; // The glTF node and its parent in the hierarchy.
+    if (scene != nullptr)
+        for (auto node : scene->nodes)
+            queue.emplace_back(node, krypton::util::TransformHierarchy::noParent);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        const auto [nodeIndex, parent] = queue[i];
+        // Invalid files may reference a node more than once, or even contain cycles.
+        if (gltfNodeIndices[nodeIndex] != krypton::util::TransformHierarchy::noParent)
+            continue;
+        const auto& node = asset.nodes[nodeIndex];
+
+        glm::vec3 translation, scale;
+        glm::quat rotation;
+        getNodeTransform(node, translation, rotation, scale);
+        const float rotationXyzw[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+        const auto index = hierarchy.nodes.addNode(parent, &translation.x, rotationXyzw, &scale.x);
+        hierarchy.nodeNames.emplace_back(node.name);
+        gltfNodeIndices[nodeIndex] = index;
+
+        // Nodes can override the default morph target weights of their mesh.
+        hierarchy.morphWeightOffsets.push_back(static_cast<uint32_t>(hierarchy.morphWeights.size()));
+        if (node.mesh >= 0) {
+            const auto& mesh = asset.meshes[node.mesh];
+            std::size_t weightCount = mesh.weights.size();
+            for (const auto& primitive : mesh.primitives)
+                weightCount = std::max(weightCount, primitive.targets.size());
+            const auto& weights = node.weights.size() == weightCount ? node.weights : mesh.weights;
+            for (std::size_t j = 0; j < weightCount; ++j)
+                hierarchy.morphWeights.push_back(j < weights.size() ? weights[j] : 0.0f);
+        }
+
+        if (node.mesh >= 0) {
+            // Every glTF mesh is only decoded once, no matter how many nodes reference it.
+            auto& meshIndex = gltfMeshIndices[node.mesh];
+            if (meshIndex < 0) {
+                const auto& mesh = asset.meshes[node.mesh];
+                meshIndex = static_cast<int32_t>(meshes.size());
+                auto& kMesh = meshes.emplace_back(std::make_shared<ka::Mesh>());
+                kMesh->name = mesh.name;
+
+                // The primitives are sized once here, so that the work items can point into them.
+                kMesh->primitives.resize(mesh.primitives.size());
+                for (size_t j = 0; j < mesh.primitives.size(); ++j)
+                    workItems.push_back({ &mesh.primitives[j], &kMesh->primitives[j] });
+            }
+
+            instances.push_back({ static_cast<uint32_t>(meshIndex) });
+            hierarchy.instanceNodes.push_back(index);
+            hierarchy.instanceSkins.push_back(node.skin >= 0 ? static_cast<uint32_t>(node.skin) : ka::SceneHierarchy::noSkin);
+        }
 
-    auto& node = model.nodes[nodeIndex];
-    if (node.mesh >= 0) {
-        loadGltfMesh(model, model.meshes[node.mesh], node, matrix);
+        for (auto child : node.children)
+            queue.emplace_back(child, index);
     }
+    hierarchy.morphWeightOffsets.push_back(static_cast<uint32_t>(hierarchy.morphWeights.size()));
+    hierarchy.update(instances);
+}
+
+void ka::loader::FileLoader::loadGltfSkins(const GltfAsset& asset) {
+    ZoneScoped;
+    skins.resize(asset.skins.size());
+    for (std::size_t i = 0; i < asset.skins.size(); ++i) {
+        const auto& skin = asset.skins[i];
+        auto& kSkin = skins[i];
+        kSkin.name = skin.name;
+        kSkin.joints.reserve(skin.joints.size());
+        for (auto joint : skin.joints)
+            kSkin.joints.push_back(gltfNodeIndices[joint]);
 
-    for (auto& i : node.children) {
-        loadGltfNode(model, i, matrix);
+        // Without inverse bind matrices, the joints are already in the space of the skin.
+        kSkin.inverseBindMatrices.resize(skin.joints.size());
+        if (skin.inverseBindMatrices >= 0) {
+            // The gather kernels convert at most four components, so every column is gathered separately.
+            auto source = asset.getStridedSource(skin.inverseBindMatrices);
+            source.count = std::min(source.count, kSkin.inverseBindMatrices.size());
+            source.componentCount = 4;
+            for (std::size_t column = 0; column < 4 && source.data != nullptr; ++column) {
+                auto columnSource = source;
+                columnSource.data = static_cast<const std::byte*>(source.data) + column * 4 * sizeof(float);
+                util::gatherStrided(columnSource, &kSkin.inverseBindMatrices.data()->m[column * 4], sizeof(util::Matrix4), 4);
+            }
+        }
     }
 }
 
-bool ka::loader::FileLoader::loadGltfFile(const fs::path& path) {
+void ka::loader::FileLoader::loadGltfAnimations(const GltfAsset& asset) {
     ZoneScoped;
-    tinygltf::Model model;
-    tinygltf::TinyGLTF loader;
-    std::string err, warn;
+    std::vector<float> times, values;
 
-    fs::path ext = path.extension();
-    bool success = false;
-    if (ext.compare(".glb") == 0) {
-        success = loader.LoadBinaryFromFile(&model, &err, &warn, path.string());
-    } else if (ext.compare(".gltf") == 0) {
-        success = loader.LoadASCIIFromFile(&model, &err, &warn, path.string());
+    animations.resize(asset.animations.size());
+    for (std::size_t i = 0; i < asset.animations.size(); ++i) {
+        const auto& animation = asset.animations[i];
+        auto& kAnimation = animations[i];
+        kAnimation.name = animation.name;
+
+        for (const auto& channel : animation.channels) {
+            if (channel.node < 0 || gltfNodeIndices[channel.node] == krypton::util::TransformHierarchy::noParent)
+                continue;
+            const auto node = gltfNodeIndices[channel.node];
+            const auto& sampler = animation.samplers[channel.sampler];
+
+            ka::AnimationPath path;
+            if (channel.path == "translation") {
+                path = ka::AnimationPath::Translation;
+            } else if (channel.path == "rotation") {
+                path = ka::AnimationPath::Rotation;
+            } else if (channel.path == "scale") {
+                path = ka::AnimationPath::Scale;
+            } else if (channel.path == "weights") {
+                path = ka::AnimationPath::Weights;
+            } else {
+                continue;
+            }
+
+            auto interpolation = krypton::util::Interpolation::Linear;
+            if (sampler.interpolation == "STEP")
+                interpolation = krypton::util::Interpolation::Step;
+            else if (sampler.interpolation == "CUBICSPLINE")
+                interpolation = krypton::util::Interpolation::CubicSpline;
+
+            // The keyframe times have to be float scalars, and the values need as many components
+            // as the path has, with one scalar per morph target weight.
+            const auto& input = asset.accessors[sampler.input];
+            if (input.componentType != util::ComponentType::Float || input.componentCount != 1) {
+                krypton::log::warn("Animation {} has a sampler with times that aren't float scalars", animation.name);
+                continue;
+            }
+            uint32_t expectedComponentCount = 1;
+            if (path == ka::AnimationPath::Translation || path == ka::AnimationPath::Scale)
+                expectedComponentCount = 3;
+            else if (path == ka::AnimationPath::Rotation)
+                expectedComponentCount = 4;
+
+            readAccessor(asset, sampler.input, times);
+            const auto componentCount = readAccessor(asset, sampler.output, values);
+            if (componentCount != expectedComponentCount) {
+                krypton::log::warn("Animation {} has a {} sampler with {} components per value instead of {}", animation.name, channel.path,
+                                   componentCount, expectedComponentCount);
+                continue;
+            }
+            const auto valuesPerKey = interpolation == krypton::util::Interpolation::CubicSpline ? 3U : 1U;
+            if (times.empty() || values.empty())
+                continue;
+
+            if (path != ka::AnimationPath::Weights) {
+                if (values.size() < times.size() * valuesPerKey * componentCount) {
+                    krypton::log::warn("Animation {} has a sampler with too few values", animation.name);
+                    continue;
+                }
+                kAnimation.tracks.addTrack(times, values, componentCount, interpolation, path == ka::AnimationPath::Rotation,
+                                           options.quantizeAnimations);
+                kAnimation.targets.push_back({ .node = node, .path = path });
+                continue;
+            }
+
+            // The output has one scalar per weight and value, which we split into one track per weight.
+            const auto weightCount = hierarchy.morphWeightOffsets[node + 1] - hierarchy.morphWeightOffsets[node];
+            const auto valueCount = times.size() * valuesPerKey;
+            if (weightCount == 0 || values.size() < valueCount * weightCount) {
+                krypton::log::warn("Animation {} has a sampler with too few values", animation.name);
+                continue;
+            }
+            std::vector<float> weights(valueCount);
+            for (uint32_t weight = 0; weight < weightCount; ++weight) {
+                for (std::size_t j = 0; j < valueCount; ++j)
+                    weights[j] = values[j * weightCount + weight];
+                kAnimation.tracks.addTrack(times, weights, 1, interpolation, false, options.quantizeAnimations);
+                kAnimation.targets.push_back({ .node = node, .path = path, .weight = weight });
+            }
+        }
     }
+}
 
-    if (!warn.empty())
-        krypton::log::warn("tinygltf warning: {}", warn);
-    if (!err.empty())
-        krypton::log::err("tinygltf error: {}", err);
-    if (!success)
+bool ka::loader::FileLoader::loadGltfFile(const fs::path& path) {
+    ZoneScoped;
+    // The buffers are only mapped, so they have to stay alive until every primitive is decoded.
+    GltfAsset asset;
+    if (!parseGltf(path, asset))
         return false;
 
-    const tinygltf::Scene& scene = model.scenes[model.defaultScene];
-    for (auto& node : scene.nodes) {
-        loadGltfNode(model, static_cast<uint32_t>(node), glm::mat4(1.0f));
+    // Buffers and images that are neither embedded nor data URIs are separate files.
+    dependencies.clear();
+    for (const auto& buffer : asset.buffers)
+        if (!buffer.uri.empty() && !isDataUri(buffer.uri))
+            dependencies.emplace_back(decodeUriPath(buffer.uri));
+    for (const auto& image : asset.images)
+        if (!image.uri.empty() && !isDataUri(image.uri))
+            dependencies.emplace_back(decodeUriPath(image.uri));
+
+    // We first walk the node tree to find every primitive and its output location, and then
+    // decode all primitives in parallel. As every output is allocated up front, the result
+    // does not depend on the order in which the primitives finish.
+    std::vector<PrimitiveWorkItem> workItems;
+    gltfMeshIndices.assign(asset.meshes.size(), -1);
+    // Scenes are optional. Without one, nothing is instanced, but the skins and animations still
+    // need the node mapping of this file.
+    collectGltfNodes(asset, asset.defaultScene >= 0 ? &asset.scenes[asset.defaultScene] : nullptr, workItems);
+    loadGltfSkins(asset);
+    loadGltfAnimations(asset);
+
+    krypton::threading::Scheduler::getInstance().parallelFor(workItems.size(), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i)
+            loadGltfPrimitive(asset, *workItems[i].primitive, *workItems[i].output, options);
+    });
+
+    std::vector<ka::processing::MeshOptimizationStatistics> optimizationStatistics(meshes.size());
+    krypton::threading::Scheduler::getInstance().parallelFor(meshes.size(), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            auto& mesh = *meshes[i];
+            if (options.splitLargePrimitives) {
+                std::vector<ka::Primitive> primitives;
+                for (auto& primitive : mesh.primitives) {
+                    if (primitive.vertices.size() <= maxUint16VertexCount || !primitive.isTriangleList()) {
+                        primitives.emplace_back(std::move(primitive));
+                        continue;
+                    }
+                    for (auto& chunk : splitPrimitive(primitive, maxUint16VertexCount, options.allowUint8Indices))
+                        primitives.emplace_back(std::move(chunk));
+                }
+                mesh.primitives = std::move(primitives);
+            }
+
+            if (options.optimizeMeshes)
+                optimizationStatistics[i] = ka::processing::optimizeMesh(mesh, options.meshOptimization);
+            if (options.generateLods)
+                for (auto& primitive : mesh.primitives)
+                    ka::processing::generateLods(primitive, options.lods);
+            if (options.buildMeshlets)
+                for (auto& primitive : mesh.primitives)
+                    ka::processing::buildMeshlets(primitive, options.meshlets);
+
+            computeBounds(mesh);
+            compactVertices(mesh, options.vertexLayout);
+        }
+    });
+
+    meshBounds.resize(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+        meshBounds.set(i, meshes[i]->boundingBox, meshes[i]->boundingSphere);
+
+    if (options.optimizeMeshes) {
+        ka::processing::MeshOptimizationStatistics total;
+        for (const auto& statistics : optimizationStatistics)
+            total += statistics;
+        krypton::log::log("Optimized meshes: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}", total.before.getAcmr(), total.after.getAcmr(),
+                          total.before.getAtvr(), total.after.getAtvr());
     }
 
     /* Load textures */
-    for (const auto& tex : model.textures) {
+    // Every image is decoded once, in parallel, and then moved into the last texture using it.
+    // Only textures sharing an image with a later texture need a copy.
+    // External images are only read by the worker decoding them, and data URIs are only
+    // decoded there, so that no encoded image is in memory for longer than necessary.
+    std::vector<ka::Texture> images(asset.images.size());
+    krypton::threading::Scheduler::getInstance().parallelFor(images.size(), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            ZoneScopedN("Decode image");
+            const auto& image = asset.images[i];
+            std::span<const std::byte> encoded;
+            std::vector<std::byte> decodedUri;
+            util::MappedFile file;
+            if (image.bufferView >= 0) {
+                encoded = asset.getBufferViewData(image.bufferView);
+            } else if (isDataUri(image.uri)) {
+                if (decodeDataUri(image.uri, decodedUri))
+                    encoded = decodedUri;
+            } else if (!image.uri.empty()) {
+                images[i].filePath = path.parent_path() / decodeUriPath(image.uri);
+                if (file.open(images[i].filePath))
+                    encoded = file.getData();
+            }
+
+            if (!decodeImage(encoded, images[i]))
+                krypton::log::warn("Failed to decode image {} of {}", i, path.string());
+        }
+    });
+
+    std::vector<size_t> lastUses(images.size(), 0);
+    for (size_t i = 0; i < asset.textures.size(); ++i)
+        if (asset.textures[i].source >= 0)
+            lastUses[asset.textures[i].source] = i;
+
+    for (size_t i = 0; i < asset.textures.size(); ++i) {
+        const auto& tex = asset.textures[i];
         auto& textureFile = textures.emplace_back();
-        const auto& image = model.images[tex.source];
+        if (tex.source >= 0)
+            textureFile = lastUses[tex.source] == i ? std::move(images[tex.source]) : images[tex.source];
         textureFile.name = tex.name;
-        textureFile.width = image.width;
-        textureFile.height = image.height;
-        textureFile.channels = image.component;
-        textureFile.bitsPerPixel =
-            // This is not the best solution, but should cover 99% of cases.
-            image.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ? 8 : 16;
-        textureFile.pixels.resize(image.width * image.height * image.component);
-        memcpy(textureFile.pixels.data(), image.image.data(), textureFile.pixels.size());
     }
 
     /* Load materials */
-    for (const auto& mat : model.materials) {
+    for (const auto& mat : asset.materials) {
         auto& kMaterial = materials.emplace_back();
+        kMaterial.baseColor = glm::make_vec4(mat.baseColorFactor);
+        if (mat.baseColorTexture >= 0)
+            kMaterial.baseTextureIndex = mat.baseColorTexture;
+        if (mat.metallicRoughnessTexture >= 0)
+            kMaterial.pbrTextureIndex = mat.metallicRoughnessTexture;
+        kMaterial.metallicFactor = mat.metallicFactor;
+        kMaterial.roughnessFactor = mat.roughnessFactor;
 
-        {
-            auto& pbrmr = mat.pbrMetallicRoughness;
+        // Missing indices are -1 in the asset, which is the same 'invalid' value we also use.
+        kMaterial.normalTextureIndex = mat.normalTexture;
+        kMaterial.occlusionTextureIndex = mat.occlusionTexture;
+        kMaterial.emissiveTextureIndex = mat.emissiveTexture;
+    }
 
-            // baseColorFactor is a vector of doubles, needs to be converted.
-            if (pbrmr.baseColorFactor.size() == 4) {
-                kMaterial.baseColor = glm::make_vec4(pbrmr.baseColorFactor.data());
-            } else {
-                auto baseColor = glm::make_vec3(pbrmr.baseColorFactor.data());
-                kMaterial.baseColor = glm::fvec4(baseColor, 1.0);
-            }
+    // glTF stores colors in sRGB, everything else is linear data. Textures shared between
+    // occlusion and metallic-roughness, which is common, have to keep all channels.
+    auto setRole = [&](Index index, ka::TextureRole role) {
+        if (index < 0 || static_cast<size_t>(index) >= textures.size())
+            return;
+        textures[index].srgb = role == ka::TextureRole::Color;
+        if (textures[index].role != ka::TextureRole::MetallicRoughness)
+            textures[index].role = role;
+    };
+    for (const auto& kMaterial : materials) {
+        setRole(kMaterial.baseTextureIndex, ka::TextureRole::Color);
+        setRole(kMaterial.emissiveTextureIndex, ka::TextureRole::Color);
+        setRole(kMaterial.normalTextureIndex, ka::TextureRole::Normal);
+        setRole(kMaterial.occlusionTextureIndex, ka::TextureRole::Occlusion);
+        setRole(kMaterial.pbrTextureIndex, ka::TextureRole::MetallicRoughness);
+    }
 
-            if (pbrmr.baseColorTexture.index >= 0)
-                kMaterial.baseTextureIndex = pbrmr.baseColorTexture.index;
-            if (pbrmr.metallicRoughnessTexture.index >= 0)
-                kMaterial.pbrTextureIndex = pbrmr.metallicRoughnessTexture.index;
+    if (options.generateMips)
+        ka::processing::generateMips(textures);
+    if (options.compressTextures)
+        compressTextures(path);
 
-            kMaterial.metallicFactor = static_cast<float>(pbrmr.metallicFactor);
-            kMaterial.roughnessFactor = static_cast<float>(pbrmr.roughnessFactor);
-        }
+    return true;
+}
 
-        {
-            /* Default indices with tinygltf are -1, which is the same
-             * 'invalid' value we also use. */
-            kMaterial.normalTextureIndex = mat.normalTexture.index;
-            kMaterial.occlusionTextureIndex = mat.occlusionTexture.index;
-            kMaterial.emissiveTextureIndex = mat.emissiveTexture.index;
-        }
-    }
+void ka::loader::FileLoader::compressTextures(const fs::path& path) {
+    ZoneScoped;
+    const auto cacheDirectory = options.cacheDirectory.empty() ? path.parent_path() : options.cacheDirectory;
+    krypton::threading::Scheduler::getInstance().parallelFor(textures.size(), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            auto& texture = textures[i];
+            const auto compression = ka::processing::selectBlockCompression(texture, options.textureCompression);
+            if (compression == krypton::util::BlockCompression::None)
+                continue;
 
-    return true;
+            // Textures are identified by their pixels and the format they're compressed to.
+            const uint32_t key[] = { textureCacheVersion, texture.width, texture.height, std::max(texture.mipLevels, 1U),
+                                     static_cast<uint32_t>(compression), texture.srgb ? 1U : 0U };
+            auto hash = krypton::util::hashBytes(texture.pixels.data(), texture.pixels.size());
+            hash = krypton::util::hashBytes(key, sizeof(key), hash);
+            auto cachePath = cacheDirectory / fmt::format("{:016x}.ktx2", hash);
+            if (options.useMeshCache && readKtx2(cachePath, texture))
+                continue;
+
+            if (ka::processing::compressTexture(texture, compression) && options.useMeshCache && !writeKtx2(cachePath, texture))
+                krypton::log::warn("Failed to write the texture cache {}", cachePath.string());
+        }
+    });
 }
 
 bool ka::loader::FileLoader::loadFile(const fs::path& path) {
     ZoneScoped;
     meshes.clear();
+    instances.clear();
+    hierarchy.clear();
+    animations.clear();
+    skins.clear();
     materials.clear();
     textures.clear();
+    textureSources.clear();
 
     if (!path.has_filename()) {
         krypton::log::err("Given path does not point to a file: {}", path.string());
@@ -249,14 +1029,38 @@ bool ka::loader::FileLoader::loadFile(const fs::path& path) {
     }
 
     fs::path ext = path.extension();
-    if (ext.compare(".glb") == 0 || ext.compare(".gltf") == 0) {
-        bool ret = loadGltfFile(path);
-        if (ret) {
-            krypton::log::log("Finished loading model file {}", path.string());
+    if (ext.compare(".glb") != 0 && ext.compare(".gltf") != 0) {
+        krypton::log::err("Failed to load file: {}", path.string());
+        return false;
+    }
+
+    auto cachePath = getMeshCachePath(path, options);
+    auto optionsHash = hashLoaderOptions(options);
+    primitiveSources.clear();
+    meshCache.reset();
+    if (options.useMeshCache) {
+        auto cache = std::make_shared<MeshCache>();
+        if (cache->open(cachePath) && cache->isUpToDate(path, optionsHash)) {
+            readMeshCache(*cache, *this, options.streamTextures, options.mapPrimitives);
+            // The primitive sources point into the cache.
+            meshCache = std::move(cache);
+            krypton::log::log("Finished loading model file {} from {}", path.string(), cachePath.string());
             return true;
         }
     }
 
+    if (loadGltfFile(path)) {
+        krypton::log::log("Finished loading model file {}", path.string());
+        textureSources.resize(textures.size());
+        std::vector<CachedFileStamp> stamps;
+        uint64_t sourceHash = 0;
+        if (options.useMeshCache &&
+            (!getSourceFileStamps(path, dependencies, stamps) || !hashSourceFiles(path, dependencies, sourceHash) ||
+             !writeMeshCache(cachePath, *this, dependencies, stamps, sourceHash, optionsHash)))
+            krypton::log::warn("Failed to write the mesh cache {}", cachePath.string());
+        return true;
+    }
+
     krypton::log::err("Failed to load file: {}", path.string());
     return false;
 }
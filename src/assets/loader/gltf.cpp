@@ -0,0 +1,597 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+
+#include <fmt/format.h>
+
+#include <Tracy.hpp>
+
+#include <assets/loader/gltf.hpp>
+#include <util/logging.hpp>
+#include <util/meshopt_codec.hpp>
+
+namespace ka = krypton::assets;
+namespace ku = krypton::util;
+
+namespace krypton::assets::loader {
+    constexpr uint32_t glbMagic = 0x46546C67;       // "glTF"
+    constexpr uint32_t glbJsonChunk = 0x4E4F534A;   // "JSON"
+    constexpr uint32_t glbBinaryChunk = 0x004E4942; // "BIN\0"
+
+    // Extensions whose data we can't read. Files only using them still load through their fallbacks.
+    constexpr std::array<std::string_view, 1> unsupportedGltfExtensions = { "KHR_draco_mesh_compression" };
+    // Extensions that are safe to require, as the loader handles everything they allow.
+    constexpr std::array<std::string_view, 2> supportedGltfExtensions = { "EXT_meshopt_compression", "KHR_mesh_quantization" };
+
+    auto readUint32(std::span<const std::byte> data, std::size_t offset) noexcept -> uint32_t {
+        uint32_t value;
+        std::memcpy(&value, data.data() + offset, sizeof(value));
+        return value;
+    }
+
+    // Whether count elements of elementSize bytes, stride bytes apart, fit into size bytes after offset.
+    bool fitsIntoRange(std::size_t size, std::size_t offset, std::size_t count, std::size_t stride, std::size_t elementSize) noexcept {
+        if (count == 0)
+            return offset <= size;
+        if (offset > size || elementSize > size - offset)
+            return false;
+        return stride == 0 || (count - 1) <= (size - offset - elementSize) / stride;
+    }
+
+    auto getGltfComponentType(uint64_t componentType, ku::ComponentType& type) noexcept -> bool {
+        switch (componentType) {
+            case 5120:
+                type = ku::ComponentType::Int8;
+                return true;
+            case 5121:
+                type = ku::ComponentType::Uint8;
+                return true;
+            case 5122:
+                type = ku::ComponentType::Int16;
+                return true;
+            case 5123:
+                type = ku::ComponentType::Uint16;
+                return true;
+            case 5125:
+                type = ku::ComponentType::Uint32;
+                return true;
+            case 5126:
+                type = ku::ComponentType::Float;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    auto getGltfComponentCount(std::string_view type) noexcept -> uint32_t {
+        constexpr std::pair<std::string_view, uint32_t> types[] = {
+            { "SCALAR", 1 }, { "VEC2", 2 }, { "VEC3", 3 }, { "VEC4", 4 }, { "MAT2", 4 }, { "MAT3", 9 }, { "MAT4", 16 },
+        };
+        for (const auto& [name, count] : types)
+            if (name == type)
+                return count;
+        return 0;
+    }
+
+    auto getMeshoptMode(std::string_view mode, ku::MeshoptMode& out) noexcept -> bool {
+        constexpr std::pair<std::string_view, ku::MeshoptMode> modes[] = {
+            { "ATTRIBUTES", ku::MeshoptMode::Attributes },
+            { "TRIANGLES", ku::MeshoptMode::Triangles },
+            { "INDICES", ku::MeshoptMode::Indices },
+        };
+        for (const auto& [name, value] : modes) {
+            if (name == mode) {
+                out = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto getMeshoptFilter(std::string_view filter, ku::MeshoptFilter& out) noexcept -> bool {
+        constexpr std::pair<std::string_view, ku::MeshoptFilter> filters[] = {
+            { "NONE", ku::MeshoptFilter::None },
+            { "OCTAHEDRAL", ku::MeshoptFilter::Octahedral },
+            { "QUATERNION", ku::MeshoptFilter::Quaternion },
+            { "EXPONENTIAL", ku::MeshoptFilter::Exponential },
+        };
+        for (const auto& [name, value] : filters) {
+            if (name == filter) {
+                out = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto getBase64Value(char c) noexcept -> int {
+        if (c >= 'A' && c <= 'Z')
+            return c - 'A';
+        if (c >= 'a' && c <= 'z')
+            return c - 'a' + 26;
+        if (c >= '0' && c <= '9')
+            return c - '0' + 52;
+        if (c == '+' || c == '-')
+            return 62;
+        if (c == '/' || c == '_')
+            return 63;
+        return -1;
+    }
+
+    /**
+     * Reads the sections of the JSON into a GltfAsset. Indices are checked against the sizes of
+     * the arrays they point into, which is why the sections are read in dependency order. Only
+     * the first error is reported.
+     */
+    class GltfReader final {
+        const std::filesystem::path& path;
+        GltfAsset& asset;
+        bool valid = true;
+
+    public:
+        explicit GltfReader(const std::filesystem::path& path, GltfAsset& asset) noexcept : path(path), asset(asset) {}
+
+        [[nodiscard]] bool isValid() const noexcept {
+            return valid;
+        }
+
+        void fail(std::string_view message) {
+            if (valid)
+                krypton::log::err("Invalid glTF {}: {}", path.string(), message);
+            valid = false;
+        }
+
+        // Returns -1 for missing values.
+        auto readIndex(ku::JsonValue value, std::size_t count, std::string_view what) -> int32_t {
+            if (!value.exists())
+                return -1;
+            const auto index = value.getUint(~uint64_t(0));
+            if (index >= count) {
+                fail(fmt::format("The {} index {} is out of range", what, value.getNumber(-1.0)));
+                return -1;
+            }
+            return static_cast<int32_t>(index);
+        }
+
+        void readIndices(ku::JsonValue array, std::size_t count, std::string_view what, std::vector<uint32_t>& out) {
+            out.reserve(array.size());
+            for (auto element : array) {
+                const auto index = readIndex(element, count, what);
+                if (index >= 0)
+                    out.push_back(static_cast<uint32_t>(index));
+            }
+        }
+
+        // Reads at most count numbers and keeps the defaults of the rest.
+        static void readFloats(ku::JsonValue array, float* out, std::size_t count) {
+            std::size_t i = 0;
+            for (auto element : array) {
+                if (i == count)
+                    break;
+                out[i] = element.getFloat(out[i]);
+                ++i;
+            }
+        }
+
+        static void readFloats(ku::JsonValue array, std::vector<float>& out) {
+            out.reserve(array.size());
+            for (auto element : array)
+                out.push_back(element.getFloat());
+        }
+
+        // The index of a textureInfo object like baseColorTexture.
+        auto readTextureInfo(ku::JsonValue info) -> int32_t {
+            return readIndex(info["index"], asset.textures.size(), "texture");
+        }
+
+        void readExtensions(ku::JsonValue root) {
+            for (auto extension : root["extensionsRequired"]) {
+                const auto name = extension.getString();
+                if (std::find(unsupportedGltfExtensions.begin(), unsupportedGltfExtensions.end(), name) != unsupportedGltfExtensions.end())
+                    fail(fmt::format("The required extension {} is not supported", name));
+                else if (std::find(supportedGltfExtensions.begin(), supportedGltfExtensions.end(), name) == supportedGltfExtensions.end())
+                    krypton::log::warn("{} requires the unknown extension {}", path.string(), name);
+            }
+        }
+
+        void readBuffers(ku::JsonValue root, std::span<const std::byte> glbBinary) {
+            ZoneScoped;
+            const auto directory = path.parent_path();
+            for (auto buffer : root["buffers"]) {
+                auto& kBuffer = asset.buffers.emplace_back();
+                kBuffer.uri = buffer["uri"].getString();
+                const auto byteLength = buffer["byteLength"].getUint();
+
+                std::span<const std::byte> data;
+                if (kBuffer.uri.empty()) {
+                    // Only the first buffer of a GLB may refer to its binary chunk.
+                    if (asset.buffers.size() == 1)
+                        data = glbBinary;
+                } else if (isDataUri(kBuffer.uri)) {
+                    auto& decoded = asset.decodedUris.emplace_back();
+                    if (!decodeDataUri(kBuffer.uri, decoded))
+                        fail("A buffer has an invalid data URI");
+                    data = decoded;
+                } else {
+                    auto& file = asset.bufferFiles.emplace_back(std::make_unique<ku::MappedFile>());
+                    const auto bufferPath = directory / decodeUriPath(kBuffer.uri);
+                    if (!file->open(bufferPath))
+                        fail(fmt::format("Failed to open the buffer {}", bufferPath.string()));
+                    data = file->getData();
+                }
+
+                // Buffers that only exist as the fallback of compressed buffer views have no data.
+                const bool fallback = buffer["extensions"]["EXT_meshopt_compression"]["fallback"].getBool();
+                if (data.size() < byteLength && !fallback)
+                    fail(fmt::format("The buffer {} is smaller than its byteLength", asset.buffers.size() - 1));
+                kBuffer.data = data.first(std::min<std::size_t>(data.size(), byteLength));
+            }
+        }
+
+        void readBufferViews(ku::JsonValue root) {
+            ZoneScoped;
+            asset.bufferViews.reserve(root["bufferViews"].size());
+            for (auto view : root["bufferViews"]) {
+                auto& kView = asset.bufferViews.emplace_back();
+                kView.buffer = readIndex(view["buffer"], asset.buffers.size(), "buffer");
+                kView.byteOffset = view["byteOffset"].getUint();
+                kView.byteLength = view["byteLength"].getUint();
+                kView.byteStride = view["byteStride"].getUint();
+                if (kView.buffer < 0) {
+                    fail("A buffer view has no buffer");
+                    continue;
+                }
+
+                const auto compressed = view["extensions"]["EXT_meshopt_compression"];
+                if (compressed.exists()) {
+                    readCompressedBufferView(compressed, kView);
+                } else if (!fitsIntoRange(asset.buffers[kView.buffer].data.size(), kView.byteOffset, 1, 0, kView.byteLength)) {
+                    fail(fmt::format("The buffer view {} does not fit into its buffer", asset.bufferViews.size() - 1));
+                } else {
+                    kView.data = asset.buffers[kView.buffer].data.subspan(kView.byteOffset, kView.byteLength);
+                }
+            }
+        }
+
+        // The buffer the view points to is only the fallback, so we decode the compressed data instead.
+        void readCompressedBufferView(ku::JsonValue compressed, GltfBufferView& kView) {
+            const auto index = asset.bufferViews.size() - 1;
+            const auto buffer = readIndex(compressed["buffer"], asset.buffers.size(), "buffer");
+            const auto byteOffset = compressed["byteOffset"].getUint();
+            const auto byteLength = compressed["byteLength"].getUint();
+            const auto byteStride = compressed["byteStride"].getUint();
+            const auto count = compressed["count"].getUint();
+            ku::MeshoptMode mode;
+            ku::MeshoptFilter filter;
+            if (buffer < 0 || !getMeshoptMode(compressed["mode"].getString(), mode) ||
+                !getMeshoptFilter(compressed["filter"].getString("NONE"), filter) || !ku::isValidMeshoptStride(mode, filter, byteStride) ||
+                count > kView.byteLength / byteStride) {
+                fail(fmt::format("The EXT_meshopt_compression data of buffer view {} is invalid", index));
+                return;
+            }
+            if (!fitsIntoRange(asset.buffers[buffer].data.size(), byteOffset, 1, 0, byteLength)) {
+                fail(fmt::format("The compressed buffer view {} does not fit into its buffer", index));
+                return;
+            }
+
+            auto& decoded = asset.decodedBufferViews.emplace_back(kView.byteLength);
+            if (!ku::decodeMeshoptBuffer(asset.buffers[buffer].data.subspan(byteOffset, byteLength), count, byteStride, mode, filter, decoded)) {
+                fail(fmt::format("Failed to decode the compressed buffer view {}", index));
+                return;
+            }
+            kView.data = decoded;
+        }
+
+        void readAccessors(ku::JsonValue root) {
+            ZoneScoped;
+            asset.accessors.reserve(root["accessors"].size());
+            for (auto accessor : root["accessors"]) {
+                auto& kAccessor = asset.accessors.emplace_back();
+                kAccessor.bufferView = readIndex(accessor["bufferView"], asset.bufferViews.size(), "buffer view");
+                kAccessor.byteOffset = accessor["byteOffset"].getUint();
+                kAccessor.count = accessor["count"].getUint();
+                kAccessor.normalized = accessor["normalized"].getBool();
+                kAccessor.componentCount = getGltfComponentCount(accessor["type"].getString());
+                if (!getGltfComponentType(accessor["componentType"].getUint(), kAccessor.componentType) || kAccessor.componentCount == 0) {
+                    fail("An accessor has an invalid type");
+                    continue;
+                }
+
+                const auto min = accessor["min"], max = accessor["max"];
+                kAccessor.boundsComponentCount = static_cast<uint32_t>(std::min<std::size_t>({ min.size(), max.size(), 4 }));
+                readFloats(min, kAccessor.min, kAccessor.boundsComponentCount);
+                readFloats(max, kAccessor.max, kAccessor.boundsComponentCount);
+
+                const auto elementSize = ku::getComponentSize(kAccessor.componentType) * kAccessor.componentCount;
+                if (kAccessor.bufferView >= 0) {
+                    const auto& view = asset.bufferViews[kAccessor.bufferView];
+                    const auto stride = view.byteStride != 0 ? view.byteStride : elementSize;
+                    if (!fitsIntoRange(view.byteLength, kAccessor.byteOffset, kAccessor.count, stride, elementSize))
+                        fail(fmt::format("The accessor {} does not fit into its buffer view", asset.accessors.size() - 1));
+                }
+
+                const auto sparse = accessor["sparse"];
+                if (!sparse.exists())
+                    continue;
+                auto& kSparse = kAccessor.sparse;
+                kSparse.count = sparse["count"].getUint();
+                kSparse.indicesBufferView = readIndex(sparse["indices"]["bufferView"], asset.bufferViews.size(), "buffer view");
+                kSparse.indicesByteOffset = sparse["indices"]["byteOffset"].getUint();
+                kSparse.valuesBufferView = readIndex(sparse["values"]["bufferView"], asset.bufferViews.size(), "buffer view");
+                kSparse.valuesByteOffset = sparse["values"]["byteOffset"].getUint();
+                if (!getGltfComponentType(sparse["indices"]["componentType"].getUint(), kSparse.indicesComponentType) ||
+                    kSparse.indicesBufferView < 0 || kSparse.valuesBufferView < 0) {
+                    fail("A sparse accessor is invalid");
+                    continue;
+                }
+                const auto indexSize = ku::getComponentSize(kSparse.indicesComponentType);
+                if (!fitsIntoRange(asset.bufferViews[kSparse.indicesBufferView].byteLength, kSparse.indicesByteOffset, kSparse.count,
+                                   indexSize, indexSize) ||
+                    !fitsIntoRange(asset.bufferViews[kSparse.valuesBufferView].byteLength, kSparse.valuesByteOffset, kSparse.count,
+                                   elementSize, elementSize))
+                    fail(fmt::format("The sparse data of accessor {} does not fit into its buffer views", asset.accessors.size() - 1));
+            }
+        }
+
+        void readAttributes(ku::JsonValue attributes, std::vector<GltfAttribute>& out) {
+            out.reserve(attributes.size());
+            for (auto attribute : attributes)
+                out.push_back({ attribute.getKey(), readIndex(attribute, asset.accessors.size(), "accessor") });
+        }
+
+        void readMeshes(ku::JsonValue root) {
+            ZoneScoped;
+            asset.meshes.reserve(root["meshes"].size());
+            for (auto mesh : root["meshes"]) {
+                auto& kMesh = asset.meshes.emplace_back();
+                kMesh.name = mesh["name"].getString();
+                readFloats(mesh["weights"], kMesh.weights);
+                for (auto primitive : mesh["primitives"]) {
+                    auto& kPrimitive = kMesh.primitives.emplace_back();
+                    readAttributes(primitive["attributes"], kPrimitive.attributes);
+                    for (auto target : primitive["targets"])
+                        readAttributes(target, kPrimitive.targets.emplace_back());
+                    kPrimitive.indices = readIndex(primitive["indices"], asset.accessors.size(), "accessor");
+                    kPrimitive.material = readIndex(primitive["material"], asset.materials.size(), "material");
+                    kPrimitive.mode = static_cast<uint32_t>(primitive["mode"].getUint(4));
+                    if (kPrimitive.mode > 6)
+                        fail(fmt::format("A primitive has the invalid mode {}", kPrimitive.mode));
+                }
+            }
+        }
+
+        void readNodes(ku::JsonValue root) {
+            ZoneScoped;
+            const auto nodes = root["nodes"];
+            asset.nodes.reserve(nodes.size());
+            for (auto node : nodes) {
+                auto& kNode = asset.nodes.emplace_back();
+                kNode.name = node["name"].getString();
+                kNode.mesh = readIndex(node["mesh"], asset.meshes.size(), "mesh");
+                kNode.skin = readIndex(node["skin"], root["skins"].size(), "skin");
+                readIndices(node["children"], nodes.size(), "node", kNode.children);
+                readFloats(node["weights"], kNode.weights);
+                kNode.hasMatrix = node["matrix"].size() == 16;
+                readFloats(node["matrix"], kNode.matrix, 16);
+                readFloats(node["translation"], kNode.translation, 3);
+                readFloats(node["rotation"], kNode.rotation, 4);
+                readFloats(node["scale"], kNode.scale, 3);
+            }
+
+            for (auto scene : root["scenes"]) {
+                auto& kScene = asset.scenes.emplace_back();
+                kScene.name = scene["name"].getString();
+                readIndices(scene["nodes"], asset.nodes.size(), "node", kScene.nodes);
+            }
+            asset.defaultScene = readIndex(root["scene"], asset.scenes.size(), "scene");
+            if (asset.defaultScene < 0 && !asset.scenes.empty())
+                asset.defaultScene = 0;
+        }
+
+        void readSkins(ku::JsonValue root) {
+            for (auto skin : root["skins"]) {
+                auto& kSkin = asset.skins.emplace_back();
+                kSkin.name = skin["name"].getString();
+                readIndices(skin["joints"], asset.nodes.size(), "node", kSkin.joints);
+                kSkin.inverseBindMatrices = readIndex(skin["inverseBindMatrices"], asset.accessors.size(), "accessor");
+                // The loader reads the matrices column by column, which only works for float matrices.
+                if (kSkin.inverseBindMatrices >= 0) {
+                    const auto& accessor = asset.accessors[kSkin.inverseBindMatrices];
+                    if (accessor.componentType != ku::ComponentType::Float || accessor.componentCount != 16) {
+                        krypton::log::warn("{}: The inverse bind matrices of skin {} are not float matrices and are ignored", path.string(),
+                                           asset.skins.size() - 1);
+                        kSkin.inverseBindMatrices = -1;
+                    }
+                }
+            }
+        }
+
+        void readAnimations(ku::JsonValue root) {
+            ZoneScoped;
+            for (auto animation : root["animations"]) {
+                auto& kAnimation = asset.animations.emplace_back();
+                kAnimation.name = animation["name"].getString();
+                for (auto sampler : animation["samplers"]) {
+                    kAnimation.samplers.push_back({
+                        .input = readIndex(sampler["input"], asset.accessors.size(), "accessor"),
+                        .output = readIndex(sampler["output"], asset.accessors.size(), "accessor"),
+                        .interpolation = sampler["interpolation"].getString("LINEAR"),
+                    });
+                    if (kAnimation.samplers.back().input < 0 || kAnimation.samplers.back().output < 0)
+                        fail("An animation sampler has no input or output");
+                }
+                for (auto channel : animation["channels"]) {
+                    kAnimation.channels.push_back({
+                        .sampler = readIndex(channel["sampler"], kAnimation.samplers.size(), "sampler"),
+                        .node = readIndex(channel["target"]["node"], asset.nodes.size(), "node"),
+                        .path = channel["target"]["path"].getString(),
+                    });
+                    if (kAnimation.channels.back().sampler < 0)
+                        fail("An animation channel has no sampler");
+                }
+            }
+        }
+
+        void readMaterials(ku::JsonValue root) {
+            ZoneScoped;
+            for (auto image : root["images"]) {
+                asset.images.push_back({
+                    .name = image["name"].getString(),
+                    .uri = image["uri"].getString(),
+                    .bufferView = readIndex(image["bufferView"], asset.bufferViews.size(), "buffer view"),
+                });
+            }
+            for (auto texture : root["textures"]) {
+                asset.textures.push_back({
+                    .name = texture["name"].getString(),
+                    .source = readIndex(texture["source"], asset.images.size(), "image"),
+                });
+            }
+
+            for (auto material : root["materials"]) {
+                auto& kMaterial = asset.materials.emplace_back();
+                kMaterial.name = material["name"].getString();
+                const auto pbr = material["pbrMetallicRoughness"];
+                readFloats(pbr["baseColorFactor"], kMaterial.baseColorFactor, 4);
+                kMaterial.metallicFactor = pbr["metallicFactor"].getFloat(1.0f);
+                kMaterial.roughnessFactor = pbr["roughnessFactor"].getFloat(1.0f);
+                kMaterial.baseColorTexture = readTextureInfo(pbr["baseColorTexture"]);
+                kMaterial.metallicRoughnessTexture = readTextureInfo(pbr["metallicRoughnessTexture"]);
+                kMaterial.normalTexture = readTextureInfo(material["normalTexture"]);
+                kMaterial.occlusionTexture = readTextureInfo(material["occlusionTexture"]);
+                kMaterial.emissiveTexture = readTextureInfo(material["emissiveTexture"]);
+            }
+        }
+    };
+} // namespace krypton::assets::loader
+
+auto ka::loader::GltfPrimitive::findAttribute(std::span<const GltfAttribute> attributes, std::string_view name) noexcept -> int32_t {
+    for (const auto& attribute : attributes)
+        if (attribute.name == name)
+            return attribute.accessor;
+    return -1;
+}
+
+auto ka::loader::GltfPrimitive::findAttribute(std::string_view name) const noexcept -> int32_t {
+    return findAttribute(attributes, name);
+}
+
+auto ka::loader::GltfAsset::getBufferViewData(int32_t bufferView) const noexcept -> std::span<const std::byte> {
+    return bufferViews[bufferView].data;
+}
+
+auto ka::loader::GltfAsset::getStridedSource(int32_t accessorIndex) const noexcept -> ku::StridedSource {
+    const auto& accessor = accessors[accessorIndex];
+    if (accessor.bufferView < 0)
+        return {};
+
+    const auto& view = bufferViews[accessor.bufferView];
+    return ku::StridedSource {
+        .data = getBufferViewData(accessor.bufferView).data() + accessor.byteOffset,
+        .stride = view.byteStride != 0 ? view.byteStride : ku::getComponentSize(accessor.componentType) * accessor.componentCount,
+        .count = accessor.count,
+        .componentType = accessor.componentType,
+        .componentCount = accessor.componentCount,
+        .normalized = accessor.normalized,
+    };
+}
+
+bool ka::loader::isDataUri(std::string_view uri) noexcept {
+    return uri.starts_with("data:");
+}
+
+bool ka::loader::decodeDataUri(std::string_view uri, std::vector<std::byte>& data) {
+    ZoneScoped;
+    const auto comma = uri.find(',');
+    if (!isDataUri(uri) || comma == std::string_view::npos || !uri.substr(0, comma).ends_with(";base64"))
+        return false;
+
+    const auto encoded = uri.substr(comma + 1);
+    data.clear();
+    data.reserve(encoded.size() / 4 * 3);
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (const auto c : encoded) {
+        if (c == '=')
+            break;
+        const auto value = getBase64Value(c);
+        if (value < 0)
+            return false;
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            data.push_back(static_cast<std::byte>((bits >> bitCount) & 0xFF));
+        }
+    }
+    return true;
+}
+
+auto ka::loader::decodeUriPath(std::string_view uri) -> std::filesystem::path {
+    std::u8string decoded;
+    decoded.reserve(uri.size());
+    for (std::size_t i = 0; i < uri.size(); ++i) {
+        if (uri[i] == '%' && i + 2 < uri.size()) {
+            const auto hex = std::string(uri.substr(i + 1, 2));
+            char* end = nullptr;
+            const auto value = std::strtoul(hex.c_str(), &end, 16);
+            if (end == hex.c_str() + 2) {
+                decoded.push_back(static_cast<char8_t>(value));
+                i += 2;
+                continue;
+            }
+        }
+        decoded.push_back(static_cast<char8_t>(uri[i]));
+    }
+    return std::filesystem::path(decoded);
+}
+
+bool ka::loader::parseGltf(const std::filesystem::path& path, GltfAsset& asset) {
+    ZoneScoped;
+    if (!asset.file.open(path)) {
+        krypton::log::err("Failed to open {}", path.string());
+        return false;
+    }
+
+    // GLB files are recognized by their header rather than their extension.
+    auto data = asset.file.getData();
+    std::span<const std::byte> json = data, binary;
+    if (data.size() >= 12 && readUint32(data, 0) == glbMagic) {
+        const auto length = std::min<std::size_t>(readUint32(data, 8), data.size());
+        if (readUint32(data, 4) != 2 || length < 20 || readUint32(data, 16) != glbJsonChunk ||
+            readUint32(data, 12) > length - 20) {
+            krypton::log::err("Invalid GLB header in {}", path.string());
+            return false;
+        }
+        json = data.subspan(20, readUint32(data, 12));
+        // Chunks are padded to four bytes.
+        const auto binaryOffset = 20 + ((json.size() + 3) & ~std::size_t(3));
+        if (binaryOffset + 8 <= length && readUint32(data, binaryOffset + 4) == glbBinaryChunk)
+            binary = data.subspan(binaryOffset + 8, std::min<std::size_t>(readUint32(data, binaryOffset), length - binaryOffset - 8));
+    }
+
+    std::string_view text(reinterpret_cast<const char*>(json.data()), json.size());
+    if (text.starts_with("\xEF\xBB\xBF"))
+        text.remove_prefix(3);
+    if (!asset.json.parse(text)) {
+        krypton::log::err("Failed to parse the JSON of {}: {}", path.string(), asset.json.getError());
+        return false;
+    }
+
+    const auto root = asset.json.getRoot();
+    GltfReader reader(path, asset);
+    if (!root["asset"]["version"].getString().starts_with("2."))
+        reader.fail("Only glTF 2.0 is supported");
+    reader.readExtensions(root);
+    reader.readBuffers(root, binary);
+    reader.readBufferViews(root);
+    reader.readAccessors(root);
+    // Materials reference textures and images, meshes reference materials, and so on.
+    reader.readMaterials(root);
+    reader.readMeshes(root);
+    reader.readNodes(root);
+    reader.readSkins(root);
+    reader.readAnimations(root);
+    return reader.isValid();
+}
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include <Tracy.hpp>
+
+#include <assets/loader/ktx2.hpp>
+#include <util/logging.hpp>
+#include <util/mapped_file.hpp>
+
+namespace ka = krypton::assets;
+namespace ku = krypton::util;
+
+namespace krypton::assets::loader {
+    // «KTX 20»\r\n\x1A\n
+    static constexpr std::array<uint8_t, 12> ktx2Identifier = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+    // The sample of a basic data format descriptor, see the Khronos Data Format Specification.
+    struct Ktx2DfdSample final {
+        uint16_t bitOffset;
+        // The length minus one.
+        uint8_t bitLength;
+        uint8_t channelType;
+        uint8_t samplePosition[4];
+        uint32_t sampleLower;
+        uint32_t sampleUpper;
+    };
+
+    struct Ktx2Dfd final {
+        uint32_t totalSize;
+        uint32_t vendorAndType;
+        uint32_t versionAndSize;
+        uint8_t colorModel;
+        uint8_t colorPrimaries;
+        uint8_t transferFunction;
+        uint8_t flags;
+        uint8_t texelBlockDimensions[4];
+        uint8_t bytesPlane[8];
+        Ktx2DfdSample samples[2];
+    };
+
+    static_assert(sizeof(Ktx2DfdSample) == 16);
+    static_assert(sizeof(Ktx2Dfd) == 4 + 24 + 2 * 16);
+
+    [[nodiscard]] auto getBlockCompression(Ktx2Format format) noexcept -> ku::BlockCompression {
+        switch (format) {
+            case Ktx2Format::BC1_RGBA_UNORM:
+            case Ktx2Format::BC1_RGBA_SRGB:
+                return ku::BlockCompression::BC1;
+            case Ktx2Format::BC3_UNORM:
+            case Ktx2Format::BC3_SRGB:
+                return ku::BlockCompression::BC3;
+            case Ktx2Format::BC4_UNORM:
+                return ku::BlockCompression::BC4;
+            case Ktx2Format::BC5_UNORM:
+                return ku::BlockCompression::BC5;
+            case Ktx2Format::BC7_UNORM:
+            case Ktx2Format::BC7_SRGB:
+                return ku::BlockCompression::BC7;
+            case Ktx2Format::Undefined:
+                break;
+        }
+        return ku::BlockCompression::None;
+    }
+
+    [[nodiscard]] auto createKtx2Dfd(ku::BlockCompression compression, bool srgb) noexcept -> Ktx2Dfd {
+        // The color models and channel ids of the BCn formats.
+        constexpr uint8_t modelBc1a = 128, modelBc3 = 130, modelBc4 = 131, modelBc5 = 132, modelBc7 = 134;
+        constexpr uint8_t channelBc1aAlphaPresent = 1, channelBc3Alpha = 15;
+
+        Ktx2Dfd dfd = {};
+        dfd.colorPrimaries = 1; // BT.709
+        dfd.transferFunction = srgb ? 2 : 1;
+        dfd.texelBlockDimensions[0] = dfd.texelBlockDimensions[1] = 3;
+        dfd.bytesPlane[0] = static_cast<uint8_t>(ku::getCompressedBlockSize(compression));
+
+        // Single sample formats cover the whole block, the others 64 bits per sample.
+        const auto blockBits = static_cast<uint8_t>(ku::getCompressedBlockSize(compression) * 8);
+        auto setSample = [&](std::size_t index, uint16_t bitOffset, uint8_t bitLength, uint8_t channel) {
+            dfd.samples[index] = {
+                .bitOffset = bitOffset,
+                .bitLength = static_cast<uint8_t>(bitLength - 1),
+                .channelType = channel,
+                .samplePosition = {},
+                .sampleLower = 0,
+                .sampleUpper = 0xFFFFFFFF,
+            };
+        };
+        std::size_t sampleCount = 1;
+        switch (compression) {
+            case ku::BlockCompression::None:
+                break;
+            case ku::BlockCompression::BC1:
+                dfd.colorModel = modelBc1a;
+                setSample(0, 0, blockBits, channelBc1aAlphaPresent);
+                break;
+            case ku::BlockCompression::BC3:
+                dfd.colorModel = modelBc3;
+                sampleCount = 2;
+                setSample(0, 0, 64, channelBc3Alpha);
+                setSample(1, 64, 64, 0);
+                break;
+            case ku::BlockCompression::BC4:
+                dfd.colorModel = modelBc4;
+                setSample(0, 0, blockBits, 0);
+                break;
+            case ku::BlockCompression::BC5:
+                dfd.colorModel = modelBc5;
+                sampleCount = 2;
+                setSample(0, 0, 64, 0);
+                setSample(1, 64, 64, 1);
+                break;
+            case ku::BlockCompression::BC7:
+                dfd.colorModel = modelBc7;
+                setSample(0, 0, blockBits, 0);
+                break;
+        }
+
+        const auto blockSize = static_cast<uint32_t>(24 + sampleCount * sizeof(Ktx2DfdSample));
+        dfd.totalSize = 4 + blockSize;
+        dfd.versionAndSize = 2 | (blockSize << 16);
+        return dfd;
+    }
+} // namespace krypton::assets::loader
+
+auto ka::loader::getKtx2Format(ku::BlockCompression compression, bool srgb) noexcept -> Ktx2Format {
+    switch (compression) {
+        case ku::BlockCompression::BC1:
+            return srgb ? Ktx2Format::BC1_RGBA_SRGB : Ktx2Format::BC1_RGBA_UNORM;
+        case ku::BlockCompression::BC3:
+            return srgb ? Ktx2Format::BC3_SRGB : Ktx2Format::BC3_UNORM;
+        case ku::BlockCompression::BC4:
+            return Ktx2Format::BC4_UNORM;
+        case ku::BlockCompression::BC5:
+            return Ktx2Format::BC5_UNORM;
+        case ku::BlockCompression::BC7:
+            return srgb ? Ktx2Format::BC7_SRGB : Ktx2Format::BC7_UNORM;
+        case ku::BlockCompression::None:
+            break;
+    }
+    return Ktx2Format::Undefined;
+}
+
+bool ka::loader::writeKtx2(const std::filesystem::path& path, const ka::Texture& texture) {
+    ZoneScoped;
+    const auto format = getKtx2Format(texture.compression, texture.srgb);
+    if (format == Ktx2Format::Undefined)
+        return false;
+
+    const auto levelCount = std::max(texture.mipLevels, 1U);
+    if (texture.pixels.size() != ku::getCompressedMipChainSize(texture.width, texture.height, levelCount, texture.compression))
+        return false;
+
+    const auto dfd = createKtx2Dfd(texture.compression, texture.srgb);
+    Ktx2Header header = {
+        .identifier = {},
+        .format = format,
+        .typeSize = 1,
+        .pixelWidth = texture.width,
+        .pixelHeight = texture.height,
+        .pixelDepth = 0,
+        .layerCount = 0,
+        .faceCount = 1,
+        .levelCount = levelCount,
+        .supercompressionScheme = 0,
+        .dfdByteOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + levelCount * sizeof(Ktx2Level)),
+        .dfdByteLength = dfd.totalSize,
+        .kvdByteOffset = 0,
+        .kvdByteLength = 0,
+        .sgdByteOffset = 0,
+        .sgdByteLength = 0,
+    };
+    std::memcpy(header.identifier, ktx2Identifier.data(), ktx2Identifier.size());
+
+    // KTX2 stores the smallest level first, and every level starts at a multiple of the block size.
+    const auto blockSize = ku::getCompressedBlockSize(texture.compression);
+    std::vector<Ktx2Level> levels(levelCount);
+    std::vector<std::size_t> pixelOffsets(levelCount);
+    std::size_t pixelOffset = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        pixelOffsets[level] = pixelOffset;
+        levels[level].byteLength = ku::getCompressedImageSize(ku::getMipExtent(texture.width, level),
+                                                              ku::getMipExtent(texture.height, level), texture.compression);
+        levels[level].uncompressedByteLength = levels[level].byteLength;
+        pixelOffset += levels[level].byteLength;
+    }
+    uint64_t fileOffset = header.dfdByteOffset + header.dfdByteLength;
+    for (auto level = levelCount; level-- > 0;) {
+        fileOffset = (fileOffset + blockSize - 1) / blockSize * blockSize;
+        levels[level].byteOffset = fileOffset;
+        fileOffset += levels[level].byteLength;
+    }
+
+    std::error_code error;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), error);
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            return false;
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(levels.size() * sizeof(Ktx2Level)));
+        stream.write(reinterpret_cast<const char*>(&dfd), dfd.totalSize);
+        for (auto level = levelCount; level-- > 0;) {
+            const char padding[16] = {};
+            const auto position = static_cast<uint64_t>(stream.tellp());
+            stream.write(padding, static_cast<std::streamsize>(levels[level].byteOffset - position));
+            stream.write(reinterpret_cast<const char*>(texture.pixels.data() + pixelOffsets[level]),
+                         static_cast<std::streamsize>(levels[level].byteLength));
+        }
+        stream.close();
+        if (stream.fail()) {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool ka::loader::openKtx2(const std::filesystem::path& path, ka::Texture& texture, ka::loader::TextureLevelSource& source) {
+    ZoneScoped;
+    auto file = std::make_shared<ku::MappedFile>();
+    if (!file->open(path) || file->size() < sizeof(Ktx2Header))
+        return false;
+
+    const auto data = file->getData();
+    Ktx2Header header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    const auto compression = getBlockCompression(header.format);
+    if (std::memcmp(header.identifier, ktx2Identifier.data(), ktx2Identifier.size()) != 0 || compression == ku::BlockCompression::None ||
+        header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount != 0 || header.faceCount != 1 ||
+        header.levelCount == 0 || header.levelCount > ku::getMipLevelCount(header.pixelWidth, header.pixelHeight) ||
+        header.supercompressionScheme != 0) {
+        krypton::log::warn("Unsupported KTX2 file {}", path.string());
+        return false;
+    }
+    if (data.size() < sizeof(Ktx2Header) + header.levelCount * sizeof(Ktx2Level))
+        return false;
+
+    std::vector<Ktx2Level> levels(header.levelCount);
+    std::memcpy(levels.data(), data.data() + sizeof(Ktx2Header), levels.size() * sizeof(Ktx2Level));
+    for (uint32_t level = 0; level < header.levelCount; ++level) {
+        const auto expectedSize = ku::getCompressedImageSize(ku::getMipExtent(header.pixelWidth, level),
+                                                             ku::getMipExtent(header.pixelHeight, level), compression);
+        if (levels[level].byteLength != expectedSize || levels[level].byteOffset > data.size() ||
+            data.size() - levels[level].byteOffset < levels[level].byteLength)
+            return false;
+    }
+
+    texture.width = header.pixelWidth;
+    texture.height = header.pixelHeight;
+    texture.channels = 4;
+    texture.bitsPerPixel = 8;
+    texture.mipLevels = header.levelCount;
+    texture.compression = compression;
+    texture.srgb = header.format == Ktx2Format::BC1_RGBA_SRGB || header.format == Ktx2Format::BC3_SRGB ||
+                   header.format == Ktx2Format::BC7_SRGB;
+    texture.pixels.clear();
+
+    source.levels.clear();
+    for (const auto& level : levels)
+        source.levels.push_back({ .offset = level.byteOffset, .size = level.byteLength });
+    source.file = std::move(file);
+    return true;
+}
+
+bool ka::loader::readKtx2(const std::filesystem::path& path, ka::Texture& texture) {
+    ZoneScoped;
+    TextureLevelSource source;
+    if (!openKtx2(path, texture, source))
+        return false;
+
+    const auto data = source.file->getData();
+    texture.pixels.resize(ku::getCompressedMipChainSize(texture.width, texture.height, texture.mipLevels, texture.compression));
+    auto* output = texture.pixels.data();
+    for (const auto& level : source.levels) {
+        std::memcpy(output, data.data() + level.offset, level.size);
+        output += level.size;
+    }
+    return true;
+}
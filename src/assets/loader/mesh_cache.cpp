@@ -0,0 +1,915 @@
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <Tracy.hpp>
+
+#include <assets/loader/mesh_cache.hpp>
+#include <util/hash.hpp>
+#include <util/logging.hpp>
+
+namespace krypton::assets::loader {
+    // Everything stored in the cache is copied as raw bytes.
+    static_assert(std::is_trivially_copyable_v<krypton::assets::Vertex>);
+    static_assert(std::is_trivially_copyable_v<krypton::assets::Material>);
+    static_assert(std::is_trivially_copyable_v<krypton::assets::MeshInstance>);
+    static_assert(std::is_trivially_copyable_v<krypton::assets::MeshletBounds>);
+    static_assert(std::is_trivially_copyable_v<krypton::assets::AnimationTarget>);
+    static_assert(std::is_trivially_copyable_v<krypton::util::KeyframeTrack>);
+    static_assert(std::is_trivially_copyable_v<krypton::util::Matrix4>);
+
+    // Writes the cache front to back. Every blob starts at the given alignment.
+    class MeshCacheWriter final {
+        std::ofstream stream;
+        uint64_t offset = 0;
+
+    public:
+        explicit MeshCacheWriter(const fs::path& path) : stream(path, std::ios::binary | std::ios::trunc) {}
+
+        [[nodiscard]] bool good() const noexcept {
+            return stream.good();
+        }
+
+        [[nodiscard]] auto getOffset() const noexcept -> uint64_t {
+            return offset;
+        }
+
+        void pad(std::size_t alignment) {
+            static constexpr char zeros[meshCacheAlignment] = {};
+            auto padding = (alignment - offset % alignment) % alignment;
+            stream.write(zeros, static_cast<std::streamsize>(padding));
+            offset += padding;
+        }
+
+        auto write(const void* data, std::size_t size, std::size_t alignment = meshCacheAlignment) -> CachedRange {
+            if (size == 0)
+                return {};
+            pad(alignment);
+            CachedRange range = { offset, size };
+            stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            offset += size;
+            return range;
+        }
+
+        template <typename T>
+        auto write(std::span<const T> data) -> CachedRange {
+            return write(data.data(), data.size_bytes());
+        }
+
+        // Strings don't need any alignment.
+        auto write(std::string_view string) -> CachedRange {
+            return write(string.data(), string.size(), 1);
+        }
+
+        void writeHeader(const MeshCacheHeader& header) {
+            stream.seekp(0);
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        // Closes the file and returns whether everything has been written.
+        [[nodiscard]] bool finish() {
+            stream.close();
+            return !stream.fail();
+        }
+    };
+
+    auto toCachedBounds(const BoundingBox& box, const BoundingSphere& sphere) noexcept -> CachedBounds {
+        return {
+            .min = { box.min.x, box.min.y, box.min.z },
+            .max = { box.max.x, box.max.y, box.max.z },
+            .sphereCenter = { sphere.center.x, sphere.center.y, sphere.center.z },
+            .sphereRadius = sphere.radius,
+        };
+    }
+
+    void fromCachedBounds(const CachedBounds& bounds, BoundingBox& box, BoundingSphere& sphere) noexcept {
+        box.min = glm::fvec3(bounds.min[0], bounds.min[1], bounds.min[2]);
+        box.max = glm::fvec3(bounds.max[0], bounds.max[1], bounds.max[2]);
+        sphere.center = glm::fvec3(bounds.sphereCenter[0], bounds.sphereCenter[1], bounds.sphereCenter[2]);
+        sphere.radius = bounds.sphereRadius;
+    }
+
+    [[nodiscard]] auto getVertexSize(VertexLayout layout) noexcept -> std::size_t {
+        switch (layout) {
+            case VertexLayout::Full:
+                return sizeof(Vertex);
+            case VertexLayout::Compact:
+                return sizeof(CompactVertex);
+            case VertexLayout::Quantized:
+                return sizeof(QuantizedVertex);
+        }
+        return 0;
+    }
+
+    template <typename T>
+    void assignFromCache(std::vector<T>& vector, std::span<const T> data) {
+        vector.assign(data.begin(), data.end());
+    }
+
+    template <typename T>
+    [[nodiscard]] bool areValidIndices(std::span<const std::byte> bytes, std::size_t vertexCount) noexcept {
+        const auto* indices = reinterpret_cast<const T*>(bytes.data());
+        for (std::size_t i = 0; i < bytes.size() / sizeof(T); ++i)
+            if (indices[i] >= vertexCount)
+                return false;
+        return true;
+    }
+
+    // Whether every index of the range references one of the vertexCount vertices.
+    [[nodiscard]] bool areValidIndices(std::span<const std::byte> bytes, IndexType type, std::size_t vertexCount) noexcept {
+        switch (type) {
+            case IndexType::Uint8:
+                return areValidIndices<uint8_t>(bytes, vertexCount);
+            case IndexType::Uint16:
+                return areValidIndices<uint16_t>(bytes, vertexCount);
+            case IndexType::Uint32:
+                return areValidIndices<uint32_t>(bytes, vertexCount);
+        }
+        return false;
+    }
+
+    // Whether the index is -1, i.e. unused, or below count.
+    [[nodiscard]] bool isValidIndex(Index index, std::size_t count) noexcept {
+        return index == -1 || (index >= 0 && static_cast<std::size_t>(index) < count);
+    }
+
+    /**
+     * Whether the pixels of the texture have exactly the size of all its levels, which uploads
+     * and streaming rely on. Descriptions that no real texture has are rejected before their
+     * sizes could overflow.
+     */
+    [[nodiscard]] bool hasValidPixelSize(const CachedTexture& cached) noexcept {
+        constexpr uint32_t maxExtent = 1U << 16;
+        if (cached.width > maxExtent || cached.height > maxExtent || cached.channels > 4 || cached.mipLevels > 32)
+            return false;
+        if (cached.compression != krypton::util::BlockCompression::None &&
+            krypton::util::getCompressedBlockSize(cached.compression) == 0)
+            return false;
+
+        const Texture texture = {
+            .width = cached.width,
+            .height = cached.height,
+            .channels = cached.channels,
+            .bitsPerPixel = cached.bitsPerPixel,
+            .compression = cached.compression,
+        };
+        std::size_t size = 0;
+        for (uint32_t level = 0; level < std::max(cached.mipLevels, 1U); ++level)
+            size += getTextureLevelSize(texture, level);
+        return size == cached.pixels.size;
+    }
+
+    // Whether all values of the track are within the pools of the given sizes.
+    [[nodiscard]] bool isValidTrack(const krypton::util::KeyframeTrack& track, std::size_t timeCount,
+                                    const std::size_t* poolSizes) noexcept {
+        if (track.keyCount == 0 || track.firstKey > timeCount || track.keyCount > timeCount - track.firstKey)
+            return false;
+        if (track.componentCount < 1 || track.componentCount > 4 || track.interpolation > krypton::util::Interpolation::CubicSpline)
+            return false;
+        const auto valuesPerKey = track.interpolation == krypton::util::Interpolation::CubicSpline ? 3U : 1U;
+        const auto valueCount = static_cast<std::size_t>(track.keyCount) * valuesPerKey;
+        for (std::size_t c = 0; c < track.componentCount; ++c)
+            if (track.firstValues[c] > poolSizes[c] || valueCount > poolSizes[c] - track.firstValues[c])
+                return false;
+        return true;
+    }
+} // namespace krypton::assets::loader
+
+namespace ka = krypton::assets;
+
+bool ka::loader::MeshCache::isValidRange(const CachedRange& range, std::size_t alignment) const noexcept {
+    if (range.size == 0)
+        return true;
+    return range.offset % alignment == 0 && range.offset <= file->size() && range.size <= file->size() - range.offset;
+}
+
+bool ka::loader::MeshCache::validate() const {
+    ZoneScoped;
+    if (file->size() < sizeof(MeshCacheHeader))
+        return false;
+
+    const auto& header = getHeader();
+    if (header.magic != meshCacheMagic || header.version != meshCacheVersion || header.fileSize != file->size())
+        return false;
+
+    // Indexed by MeshCacheSection.
+    constexpr std::size_t elementSizes[] = {
+        sizeof(CachedRange),     sizeof(CachedMesh), sizeof(CachedPrimitive), sizeof(CachedLod),      sizeof(MeshInstance),
+        sizeof(Material),        sizeof(CachedTexture), 1,                    sizeof(CachedNode),     sizeof(uint32_t),
+        sizeof(uint32_t),        sizeof(uint32_t),   sizeof(float),           sizeof(CachedAnimation), sizeof(CachedSkin),
+        sizeof(CachedMorphTarget), sizeof(CachedFileStamp),
+    };
+    static_assert(std::size(elementSizes) == static_cast<std::size_t>(MeshCacheSection::Count));
+    for (std::size_t i = 0; i < static_cast<std::size_t>(MeshCacheSection::Count); ++i)
+        if (!isValidRange(header.sections[i], meshCacheAlignment) || header.sections[i].size % elementSizes[i] != 0)
+            return false;
+
+    const auto dependencies = getSection<CachedRange>(MeshCacheSection::Dependencies);
+    for (const auto& dependency : dependencies)
+        if (!isValidRange(dependency, 1))
+            return false;
+    if (getSection<CachedFileStamp>(MeshCacheSection::FileStamps).size() != dependencies.size() + 1)
+        return false;
+
+    auto primitives = getSection<CachedPrimitive>(MeshCacheSection::Primitives);
+    auto meshes = getSection<CachedMesh>(MeshCacheSection::Meshes);
+    for (const auto& mesh : meshes) {
+        if (!isValidRange(mesh.name, 1) || mesh.firstPrimitive > primitives.size() ||
+            mesh.primitiveCount > primitives.size() - mesh.firstPrimitive)
+            return false;
+    }
+
+    // The vertices of a target have to be sorted, which accumulateMorphTargets relies on.
+    auto morphTargets = getSection<CachedMorphTarget>(MeshCacheSection::MorphTargets);
+    for (const auto& target : morphTargets) {
+        if (!isValidRange(target.vertices, meshCacheAlignment) || !isValidRange(target.positionDeltas, meshCacheAlignment) ||
+            !isValidRange(target.normalDeltas, meshCacheAlignment) || target.vertices.size % sizeof(uint32_t) != 0)
+            return false;
+        const auto deltaSize = target.vertices.size / sizeof(uint32_t) * 3 * sizeof(float);
+        if (target.positionDeltas.size != deltaSize || (target.normalDeltas.size != 0 && target.normalDeltas.size != deltaSize))
+            return false;
+        auto vertices = getArray<uint32_t>(target.vertices);
+        if (std::adjacent_find(vertices.begin(), vertices.end(), std::greater_equal<>()) != vertices.end())
+            return false;
+    }
+
+    auto lods = getSection<CachedLod>(MeshCacheSection::Lods);
+    for (const auto& lod : lods)
+        if (lod.indexType > IndexType::Uint32 || !isValidRange(lod.indices, meshCacheAlignment) ||
+            lod.indices.size % getIndexSize(lod.indexType) != 0)
+            return false;
+
+    auto textures = getSection<CachedTexture>(MeshCacheSection::Textures);
+    for (const auto& texture : textures)
+        if (!isValidRange(texture.name, 1) || !isValidRange(texture.filePath, 1) || !isValidRange(texture.pixels, meshCacheAlignment) ||
+            !hasValidPixelSize(texture))
+            return false;
+
+    auto materials = getSection<Material>(MeshCacheSection::Materials);
+    for (const auto& material : materials) {
+        for (auto texture : { material.baseTextureIndex, material.normalTextureIndex, material.occlusionTextureIndex,
+                              material.emissiveTextureIndex, material.pbrTextureIndex })
+            if (!isValidIndex(texture, textures.size()))
+                return false;
+    }
+
+    for (const auto& primitive : primitives) {
+        if (primitive.vertexLayout > VertexLayout::Quantized || primitive.indexType > IndexType::Uint32 ||
+            primitive.topology > PrimitiveTopology::Points || !isValidIndex(primitive.materialIndex, materials.size()))
+            return false;
+        if (primitive.firstLod > lods.size() || primitive.lodCount > lods.size() - primitive.firstLod)
+            return false;
+        if (primitive.firstMorphTarget > morphTargets.size() ||
+            primitive.morphTargetCount > morphTargets.size() - primitive.firstMorphTarget)
+            return false;
+
+        const std::pair<const CachedRange&, std::size_t> ranges[] = {
+            { primitive.vertices, getVertexSize(primitive.vertexLayout) },
+            { primitive.colors, sizeof(uint32_t) },
+            { primitive.tangents, sizeof(CompactTangent) },
+            { primitive.indices, getIndexSize(primitive.indexType) },
+            { primitive.meshlets, sizeof(Meshlet) },
+            { primitive.meshletBounds, sizeof(MeshletBounds) },
+            { primitive.meshletVertices, sizeof(uint32_t) },
+            { primitive.meshletTriangles, 1 },
+            { primitive.influences, sizeof(krypton::util::VertexInfluences) },
+        };
+        for (const auto& [range, elementSize] : ranges)
+            if (!isValidRange(range, meshCacheAlignment) || range.size % elementSize != 0)
+                return false;
+
+        // Everything that is indexed by vertex has to match the vertex count, and every index
+        // into the vertices has to be in range, as they are used without further checks.
+        const auto vertexCount = primitive.vertices.size / getVertexSize(primitive.vertexLayout);
+        for (const auto& [range, elementSize] : { std::pair { primitive.colors, sizeof(uint32_t) },
+                                                  std::pair { primitive.tangents, sizeof(CompactTangent) },
+                                                  std::pair { primitive.influences, sizeof(krypton::util::VertexInfluences) } })
+            if (range.size != 0 && range.size != vertexCount * elementSize)
+                return false;
+        if (!areValidIndices(getBytes(primitive.indices), primitive.indexType, vertexCount))
+            return false;
+        for (const auto& lod : lods.subspan(primitive.firstLod, primitive.lodCount))
+            if (!areValidIndices(getBytes(lod.indices), lod.indexType, vertexCount))
+                return false;
+        for (const auto& target : morphTargets.subspan(primitive.firstMorphTarget, primitive.morphTargetCount)) {
+            auto vertices = getArray<uint32_t>(target.vertices);
+            if (!vertices.empty() && vertices.back() >= vertexCount)
+                return false;
+        }
+
+        auto meshlets = getArray<Meshlet>(primitive.meshlets);
+        auto meshletVertices = getArray<uint32_t>(primitive.meshletVertices);
+        auto meshletTriangles = getArray<uint8_t>(primitive.meshletTriangles);
+        if (primitive.meshletBounds.size / sizeof(MeshletBounds) != meshlets.size() ||
+            !areValidIndices<uint32_t>(getBytes(primitive.meshletVertices), vertexCount))
+            return false;
+        for (const auto& meshlet : meshlets) {
+            if (meshlet.vertexOffset > meshletVertices.size() || meshlet.vertexCount > meshletVertices.size() - meshlet.vertexOffset)
+                return false;
+            if (meshlet.triangleOffset > meshletTriangles.size() ||
+                meshlet.triangleCount > (meshletTriangles.size() - meshlet.triangleOffset) / 3)
+                return false;
+            for (auto local : meshletTriangles.subspan(meshlet.triangleOffset, meshlet.triangleCount * 3))
+                if (local >= meshlet.vertexCount)
+                    return false;
+        }
+    }
+
+    // The nodes have to be sorted by depth, like the TransformHierarchy requires.
+    auto nodes = getSection<CachedNode>(MeshCacheSection::Nodes);
+    std::vector<uint32_t> depths(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (!isValidRange(nodes[i].name, 1))
+            return false;
+        if (nodes[i].parent != krypton::util::TransformHierarchy::noParent) {
+            if (nodes[i].parent >= i)
+                return false;
+            depths[i] = depths[nodes[i].parent] + 1;
+        }
+        if (i > 0 && depths[i] < depths[i - 1])
+            return false;
+    }
+
+    auto instances = getSection<MeshInstance>(MeshCacheSection::Instances);
+    for (const auto& instance : instances)
+        if (instance.meshIndex >= meshes.size())
+            return false;
+
+    auto instanceNodes = getSection<uint32_t>(MeshCacheSection::InstanceNodes);
+    if (instanceNodes.size() != instances.size())
+        return false;
+    for (const auto node : instanceNodes)
+        if (node >= nodes.size())
+            return false;
+
+    auto skins = getSection<CachedSkin>(MeshCacheSection::Skins);
+    for (const auto& skin : skins) {
+        if (!isValidRange(skin.name, 1) || !isValidRange(skin.joints, meshCacheAlignment) ||
+            !isValidRange(skin.inverseBindMatrices, meshCacheAlignment) || skin.joints.size % sizeof(uint32_t) != 0 ||
+            skin.inverseBindMatrices.size != skin.joints.size / sizeof(uint32_t) * sizeof(krypton::util::Matrix4))
+            return false;
+        for (const auto joint : getArray<uint32_t>(skin.joints))
+            if (joint >= nodes.size() && joint != krypton::util::TransformHierarchy::noParent)
+                return false;
+    }
+
+    auto instanceSkins = getSection<uint32_t>(MeshCacheSection::InstanceSkins);
+    if (instanceSkins.size() != instanceNodes.size())
+        return false;
+    for (const auto skin : instanceSkins)
+        if (skin >= skins.size() && skin != SceneHierarchy::noSkin)
+            return false;
+
+    // Every node has a range of weights, and the ranges cover all weights in order.
+    auto morphWeightOffsets = getSection<uint32_t>(MeshCacheSection::MorphWeightOffsets);
+    const auto morphWeightCount = getSection<float>(MeshCacheSection::MorphWeights).size();
+    if (morphWeightOffsets.size() != nodes.size() + 1)
+        return false;
+    for (std::size_t i = 0; i < morphWeightOffsets.size(); ++i)
+        if ((i == 0 ? morphWeightOffsets[i] != 0 : morphWeightOffsets[i] < morphWeightOffsets[i - 1]) ||
+            morphWeightOffsets[i] > morphWeightCount)
+            return false;
+    if (morphWeightOffsets.back() != morphWeightCount)
+        return false;
+
+    for (const auto& animation : getSection<CachedAnimation>(MeshCacheSection::Animations)) {
+        if (!isValidRange(animation.name, 1))
+            return false;
+        const std::pair<const CachedRange&, std::size_t> ranges[] = {
+            { animation.tracks, sizeof(krypton::util::KeyframeTrack) },
+            { animation.targets, sizeof(AnimationTarget) },
+            { animation.times, sizeof(float) },
+        };
+        for (const auto& [range, elementSize] : ranges)
+            if (!isValidRange(range, meshCacheAlignment) || range.size % elementSize != 0)
+                return false;
+
+        std::size_t valueCounts[4], quantizedValueCounts[4];
+        for (std::size_t c = 0; c < 4; ++c) {
+            if (!isValidRange(animation.values[c], meshCacheAlignment) || animation.values[c].size % sizeof(float) != 0 ||
+                !isValidRange(animation.quantizedValues[c], meshCacheAlignment) ||
+                animation.quantizedValues[c].size % sizeof(uint16_t) != 0)
+                return false;
+            valueCounts[c] = animation.values[c].size / sizeof(float);
+            quantizedValueCounts[c] = animation.quantizedValues[c].size / sizeof(uint16_t);
+        }
+
+        auto tracks = getArray<krypton::util::KeyframeTrack>(animation.tracks);
+        auto targets = getArray<AnimationTarget>(animation.targets);
+        if (tracks.size() != targets.size())
+            return false;
+        const auto timeCount = animation.times.size / sizeof(float);
+        for (std::size_t i = 0; i < tracks.size(); ++i) {
+            if (!isValidTrack(tracks[i], timeCount, tracks[i].quantized ? quantizedValueCounts : valueCounts))
+                return false;
+            const auto& target = targets[i];
+            if (target.node >= nodes.size() || target.path > AnimationPath::Weights)
+                return false;
+            if (target.path == AnimationPath::Weights &&
+                target.weight >= morphWeightOffsets[target.node + 1] - morphWeightOffsets[target.node])
+                return false;
+        }
+    }
+    return true;
+}
+
+bool ka::loader::MeshCache::open(const fs::path& path) {
+    ZoneScoped;
+    // Streamed textures may still reference the previous mapping.
+    file = std::make_shared<krypton::util::MappedFile>();
+    if (!file->open(path))
+        return false;
+    if (!validate()) {
+        krypton::log::warn("Ignoring invalid mesh cache {}", path.string());
+        file->close();
+        return false;
+    }
+    return true;
+}
+
+void ka::loader::MeshCache::close() noexcept {
+    file.reset();
+}
+
+bool ka::loader::MeshCache::isUpToDate(const fs::path& source, uint64_t optionsHash) const {
+    ZoneScoped;
+    if (getHeader().optionsHash != optionsHash)
+        return false;
+
+    std::vector<fs::path> dependencies;
+    for (const auto& dependency : getSection<CachedRange>(MeshCacheSection::Dependencies))
+        dependencies.emplace_back(getString(dependency));
+
+    // Hashing large buffers and images takes much longer than loading the cache, so files that
+    // still have the same size and modification time are assumed to be unchanged.
+    std::vector<CachedFileStamp> stamps;
+    const auto cachedStamps = getSection<CachedFileStamp>(MeshCacheSection::FileStamps);
+    if (getSourceFileStamps(source, dependencies, stamps) &&
+        std::equal(stamps.begin(), stamps.end(), cachedStamps.begin(), cachedStamps.end(), [](const auto& a, const auto& b) {
+            return a.size == b.size && a.modificationTime == b.modificationTime;
+        }))
+        return true;
+
+    uint64_t sourceHash = 0;
+    return hashSourceFiles(source, dependencies, sourceHash) && sourceHash == getHeader().sourceHash;
+}
+
+auto ka::loader::MeshCache::getHeader() const noexcept -> const MeshCacheHeader& {
+    return *reinterpret_cast<const MeshCacheHeader*>(file->getData().data());
+}
+
+auto ka::loader::MeshCache::getBytes(const CachedRange& range) const noexcept -> std::span<const std::byte> {
+    if (range.size == 0)
+        return {};
+    return file->getData().subspan(range.offset, range.size);
+}
+
+auto ka::loader::MeshCache::getFile() const noexcept -> std::shared_ptr<const krypton::util::MappedFile> {
+    return file;
+}
+
+auto ka::loader::MeshCache::getString(const CachedRange& range) const noexcept -> std::string_view {
+    auto bytes = getBytes(range);
+    return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+}
+
+auto ka::loader::getMeshCachePath(const fs::path& source, const LoaderOptions& options) -> fs::path {
+    if (options.cacheDirectory.empty()) {
+        auto path = source;
+        path += ".kcache";
+        return path;
+    }
+
+    // Files with the same name in different directories must not share a cache.
+    std::error_code error;
+    auto absolute = fs::absolute(source, error);
+    auto pathHash = krypton::util::hashString(error ? source.generic_string() : absolute.generic_string());
+    return options.cacheDirectory / fmt::format("{}.{:016x}.kcache", source.filename().string(), pathHash);
+}
+
+auto ka::loader::hashLoaderOptions(const LoaderOptions& options) noexcept -> uint64_t {
+    uint64_t hash = 0;
+    auto add = [&hash](const auto& value) {
+        hash = krypton::util::hashBytes(&value, sizeof(value), hash);
+    };
+    add(options.vertexLayout);
+    add(options.vertexColors);
+    add(options.missingNormals);
+    add(options.missingTangents);
+    add(options.allowUint8Indices);
+    add(options.splitLargePrimitives);
+    add(options.optimizeMeshes);
+    add(options.meshOptimization.weldVertices);
+    add(options.meshOptimization.optimizeOverdraw);
+    add(options.meshOptimization.overdrawThreshold);
+    add(options.generateLods);
+    for (auto ratio : options.lods.triangleRatios)
+        add(ratio);
+    add(options.lods.simplify.attributeWeight);
+    add(options.lods.simplify.maxError);
+    add(options.buildMeshlets);
+    add(options.meshlets.maxVertices);
+    add(options.meshlets.maxTriangles);
+    add(options.generateMips);
+    add(options.compressTextures);
+    add(options.textureCompression.useBc7);
+    add(options.quantizeAnimations);
+    return hash;
+}
+
+bool ka::loader::hashSourceFiles(const fs::path& source, std::span<const fs::path> dependencies, uint64_t& hash) {
+    ZoneScoped;
+    krypton::util::MappedFile file;
+    if (!file.open(source))
+        return false;
+    hash = krypton::util::hashBytes(file.getData().data(), file.size());
+
+    auto directory = source.parent_path();
+    for (const auto& dependency : dependencies) {
+        if (!file.open(directory / dependency))
+            return false;
+        hash = krypton::util::hashBytes(file.getData().data(), file.size(), hash);
+    }
+    return true;
+}
+
+bool ka::loader::getSourceFileStamps(const fs::path& source, std::span<const fs::path> dependencies,
+                                     std::vector<CachedFileStamp>& stamps) {
+    ZoneScoped;
+    stamps.clear();
+    auto addStamp = [&stamps](const fs::path& path) {
+        std::error_code error;
+        auto size = fs::file_size(path, error);
+        if (error)
+            return false;
+        auto time = fs::last_write_time(path, error);
+        if (error)
+            return false;
+        stamps.push_back({ size, static_cast<int64_t>(time.time_since_epoch().count()) });
+        return true;
+    };
+    if (!addStamp(source))
+        return false;
+
+    auto directory = source.parent_path();
+    for (const auto& dependency : dependencies)
+        if (!addStamp(directory / dependency))
+            return false;
+    return true;
+}
+
+bool ka::loader::writeMeshCache(const fs::path& path, const FileLoader& loader, std::span<const fs::path> dependencies,
+                                std::span<const CachedFileStamp> stamps, uint64_t sourceHash, uint64_t optionsHash) {
+    ZoneScoped;
+    std::error_code error;
+    if (path.has_parent_path())
+        fs::create_directories(path.parent_path(), error);
+
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    MeshCacheWriter writer(temporaryPath);
+    if (!writer.good())
+        return false;
+
+    MeshCacheHeader header = {
+        .sourceHash = sourceHash,
+        .optionsHash = optionsHash,
+    };
+    writer.write(&header, sizeof(header));
+
+    std::vector<CachedRange> cachedDependencies;
+    for (const auto& dependency : dependencies)
+        cachedDependencies.push_back(writer.write(dependency.generic_string()));
+
+    std::vector<CachedMesh> cachedMeshes;
+    std::vector<CachedPrimitive> cachedPrimitives;
+    std::vector<CachedLod> cachedLods;
+    std::vector<CachedMorphTarget> cachedMorphTargets;
+    for (const auto& mesh : loader.meshes) {
+        cachedMeshes.push_back({
+            .name = writer.write(mesh->name),
+            .firstPrimitive = static_cast<uint32_t>(cachedPrimitives.size()),
+            .primitiveCount = static_cast<uint32_t>(mesh->primitives.size()),
+            .positionOffset = { mesh->positionOffset.x, mesh->positionOffset.y, mesh->positionOffset.z },
+            .positionScale = { mesh->positionScale.x, mesh->positionScale.y, mesh->positionScale.z },
+            .uvOffset = { mesh->uvOffset.x, mesh->uvOffset.y },
+            .uvScale = { mesh->uvScale.x, mesh->uvScale.y },
+            .bounds = toCachedBounds(mesh->boundingBox, mesh->boundingSphere),
+        });
+
+        for (const auto& primitive : mesh->primitives) {
+            CachedPrimitive cached = {
+                .vertexLayout = primitive.vertexLayout,
+                .indexType = primitive.indices.getType(),
+                .hasTangents = static_cast<uint8_t>(primitive.hasTangents),
+                .topology = primitive.topology,
+                .materialIndex = primitive.materialIndex,
+                .firstLod = static_cast<uint32_t>(cachedLods.size()),
+                .lodCount = static_cast<uint32_t>(primitive.lods.size()),
+                .bounds = toCachedBounds(primitive.boundingBox, primitive.boundingSphere),
+            };
+            switch (primitive.vertexLayout) {
+                case VertexLayout::Full:
+                    cached.vertices = writer.write(std::span(primitive.vertices));
+                    break;
+                case VertexLayout::Compact:
+                    cached.vertices = writer.write(std::span(primitive.compactVertices));
+                    break;
+                case VertexLayout::Quantized:
+                    cached.vertices = writer.write(std::span(primitive.quantizedVertices));
+                    break;
+            }
+            cached.colors = writer.write(std::span(primitive.colors));
+            cached.tangents = writer.write(std::span(primitive.tangents));
+            cached.indices = writer.write(primitive.indices.getBytes());
+            cached.meshlets = writer.write(std::span(primitive.meshlets.meshlets));
+            cached.meshletBounds = writer.write(std::span(primitive.meshlets.bounds));
+            cached.meshletVertices = writer.write(std::span(primitive.meshlets.vertices));
+            cached.meshletTriangles = writer.write(std::span(primitive.meshlets.triangles));
+            cached.influences = writer.write(std::span(primitive.influences));
+            cached.firstMorphTarget = static_cast<uint32_t>(cachedMorphTargets.size());
+            cached.morphTargetCount = static_cast<uint32_t>(primitive.morphTargets.size());
+            cachedPrimitives.push_back(cached);
+
+            for (const auto& target : primitive.morphTargets) {
+                cachedMorphTargets.push_back({
+                    .vertices = writer.write(std::span(target.vertices)),
+                    .positionDeltas = writer.write(std::span(target.positionDeltas)),
+                    .normalDeltas = writer.write(std::span(target.normalDeltas)),
+                });
+            }
+
+            for (const auto& lod : primitive.lods) {
+                cachedLods.push_back({
+                    .indices = writer.write(lod.indices.getBytes()),
+                    .indexType = lod.indices.getType(),
+                    .padding = {},
+                    .error = lod.error,
+                });
+            }
+        }
+    }
+
+    std::vector<CachedTexture> cachedTextures;
+    for (const auto& texture : loader.textures) {
+        cachedTextures.push_back({
+            .name = writer.write(texture.name),
+            .filePath = writer.write(texture.filePath.generic_string()),
+            .pixels = writer.write(std::span(texture.pixels)),
+            .width = texture.width,
+            .height = texture.height,
+            .channels = texture.channels,
+            .mipLevels = texture.mipLevels,
+            .bitsPerPixel = texture.bitsPerPixel,
+            .srgb = texture.srgb,
+            .role = texture.role,
+            .compression = texture.compression,
+            .padding = {},
+        });
+    }
+
+    std::vector<CachedNode> cachedNodes;
+    const auto& localTransforms = loader.hierarchy.nodes.getLocalTransforms();
+    for (std::size_t i = 0; i < loader.hierarchy.nodes.size(); ++i) {
+        cachedNodes.push_back({
+            .name = writer.write(loader.hierarchy.nodeNames[i]),
+            .parent = loader.hierarchy.nodes.getParents()[i],
+            .translation = { localTransforms.translationX[i], localTransforms.translationY[i], localTransforms.translationZ[i] },
+            .rotation = { localTransforms.rotationX[i], localTransforms.rotationY[i], localTransforms.rotationZ[i],
+                          localTransforms.rotationW[i] },
+            .scale = { localTransforms.scaleX[i], localTransforms.scaleY[i], localTransforms.scaleZ[i] },
+            .padding = {},
+        });
+    }
+
+    std::vector<CachedAnimation> cachedAnimations;
+    for (const auto& animation : loader.animations) {
+        const auto& tracks = animation.tracks;
+        CachedAnimation cached = {
+            .name = writer.write(animation.name),
+            .tracks = writer.write(std::span(tracks.tracks)),
+            .targets = writer.write(std::span(animation.targets)),
+            .times = writer.write(std::span(tracks.times)),
+            .values = {},
+            .quantizedValues = {},
+        };
+        for (std::size_t c = 0; c < 4; ++c) {
+            cached.values[c] = writer.write(std::span(tracks.values[c]));
+            cached.quantizedValues[c] = writer.write(std::span(tracks.quantizedValues[c]));
+        }
+        cachedAnimations.push_back(cached);
+    }
+
+    std::vector<CachedSkin> cachedSkins;
+    for (const auto& skin : loader.skins) {
+        cachedSkins.push_back({
+            .name = writer.write(skin.name),
+            .joints = writer.write(std::span(skin.joints)),
+            .inverseBindMatrices = writer.write(std::span(skin.inverseBindMatrices)),
+        });
+    }
+
+    auto setSection = [&](MeshCacheSection section, CachedRange range) {
+        header.sections[static_cast<std::size_t>(section)] = range;
+    };
+    // The data starts at the first aligned offset after the header.
+    constexpr auto dataBegin = (sizeof(MeshCacheHeader) + meshCacheAlignment - 1) / meshCacheAlignment * meshCacheAlignment;
+    if (writer.getOffset() > dataBegin)
+        setSection(MeshCacheSection::Data, { dataBegin, writer.getOffset() - dataBegin });
+    setSection(MeshCacheSection::Dependencies, writer.write(std::span<const CachedRange>(cachedDependencies)));
+    setSection(MeshCacheSection::FileStamps, writer.write(stamps));
+    setSection(MeshCacheSection::Meshes, writer.write(std::span<const CachedMesh>(cachedMeshes)));
+    setSection(MeshCacheSection::Primitives, writer.write(std::span<const CachedPrimitive>(cachedPrimitives)));
+    setSection(MeshCacheSection::Lods, writer.write(std::span<const CachedLod>(cachedLods)));
+    setSection(MeshCacheSection::Instances, writer.write(std::span(loader.instances)));
+    setSection(MeshCacheSection::Materials, writer.write(std::span(loader.materials)));
+    setSection(MeshCacheSection::Textures, writer.write(std::span<const CachedTexture>(cachedTextures)));
+    setSection(MeshCacheSection::Nodes, writer.write(std::span<const CachedNode>(cachedNodes)));
+    setSection(MeshCacheSection::InstanceNodes, writer.write(std::span(loader.hierarchy.instanceNodes)));
+    setSection(MeshCacheSection::InstanceSkins, writer.write(std::span(loader.hierarchy.instanceSkins)));
+    setSection(MeshCacheSection::MorphWeightOffsets, writer.write(std::span(loader.hierarchy.morphWeightOffsets)));
+    setSection(MeshCacheSection::MorphWeights, writer.write(std::span(loader.hierarchy.morphWeights)));
+    setSection(MeshCacheSection::Animations, writer.write(std::span<const CachedAnimation>(cachedAnimations)));
+    setSection(MeshCacheSection::Skins, writer.write(std::span<const CachedSkin>(cachedSkins)));
+    setSection(MeshCacheSection::MorphTargets, writer.write(std::span<const CachedMorphTarget>(cachedMorphTargets)));
+
+    writer.pad(meshCacheAlignment);
+    header.fileSize = writer.getOffset();
+    writer.writeHeader(header);
+    if (!writer.finish()) {
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+    fs::rename(temporaryPath, path, error);
+    if (error) {
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+void ka::loader::readMeshCache(const MeshCache& cache, FileLoader& loader, bool streamTextures, bool mapPrimitives) {
+    ZoneScoped;
+    auto primitives = cache.getSection<CachedPrimitive>(MeshCacheSection::Primitives);
+    auto lods = cache.getSection<CachedLod>(MeshCacheSection::Lods);
+    auto meshes = cache.getSection<CachedMesh>(MeshCacheSection::Meshes);
+    auto morphTargets = cache.getSection<CachedMorphTarget>(MeshCacheSection::MorphTargets);
+
+    loader.meshes.clear();
+    loader.meshes.reserve(meshes.size());
+    loader.primitiveSources.clear();
+    loader.primitiveSources.reserve(meshes.size());
+    for (const auto& cachedMesh : meshes) {
+        auto& mesh = *loader.meshes.emplace_back(std::make_shared<ka::Mesh>());
+        auto& sources = loader.primitiveSources.emplace_back(cachedMesh.primitiveCount);
+        mesh.name = cache.getString(cachedMesh.name);
+        mesh.positionOffset = glm::fvec3(cachedMesh.positionOffset[0], cachedMesh.positionOffset[1], cachedMesh.positionOffset[2]);
+        mesh.positionScale = glm::fvec3(cachedMesh.positionScale[0], cachedMesh.positionScale[1], cachedMesh.positionScale[2]);
+        mesh.uvOffset = glm::fvec2(cachedMesh.uvOffset[0], cachedMesh.uvOffset[1]);
+        mesh.uvScale = glm::fvec2(cachedMesh.uvScale[0], cachedMesh.uvScale[1]);
+        fromCachedBounds(cachedMesh.bounds, mesh.boundingBox, mesh.boundingSphere);
+
+        mesh.primitives.resize(cachedMesh.primitiveCount);
+        for (uint32_t i = 0; i < cachedMesh.primitiveCount; ++i) {
+            const auto& cached = primitives[cachedMesh.firstPrimitive + i];
+            auto& primitive = mesh.primitives[i];
+            auto& source = sources[i];
+            source.vertices = cache.getBytes(cached.vertices);
+            source.colors = cache.getArray<uint32_t>(cached.colors);
+            source.tangents = cache.getArray<ka::CompactTangent>(cached.tangents);
+            source.indices = cache.getBytes(cached.indices);
+            source.meshlets = cache.getArray<ka::Meshlet>(cached.meshlets);
+            source.meshletBounds = cache.getArray<ka::MeshletBounds>(cached.meshletBounds);
+            source.meshletVertices = cache.getArray<uint32_t>(cached.meshletVertices);
+            source.meshletTriangles = cache.getArray<uint8_t>(cached.meshletTriangles);
+
+            primitive.vertexLayout = cached.vertexLayout;
+            primitive.hasTangents = cached.hasTangents != 0;
+            primitive.topology = cached.topology;
+            // Mapped primitives keep the index types, but not the indices.
+            primitive.indices.resize(cached.indexType, mapPrimitives ? 0 : source.indices.size() / ka::getIndexSize(cached.indexType));
+            for (const auto& cachedLod : lods.subspan(cached.firstLod, cached.lodCount)) {
+                auto& lod = primitive.lods.emplace_back();
+                auto lodIndices = source.lodIndices.emplace_back(cache.getBytes(cachedLod.indices));
+                lod.indices.resize(cachedLod.indexType, mapPrimitives ? 0 : lodIndices.size() / ka::getIndexSize(cachedLod.indexType));
+                if (!mapPrimitives)
+                    std::copy(lodIndices.begin(), lodIndices.end(), lod.indices.getBytes().begin());
+                lod.error = cachedLod.error;
+            }
+
+            if (!mapPrimitives) {
+                switch (cached.vertexLayout) {
+                    case VertexLayout::Full:
+                        assignFromCache(primitive.vertices, cache.getArray<ka::Vertex>(cached.vertices));
+                        break;
+                    case VertexLayout::Compact:
+                        assignFromCache(primitive.compactVertices, cache.getArray<ka::CompactVertex>(cached.vertices));
+                        break;
+                    case VertexLayout::Quantized:
+                        assignFromCache(primitive.quantizedVertices, cache.getArray<ka::QuantizedVertex>(cached.vertices));
+                        break;
+                }
+                assignFromCache(primitive.colors, source.colors);
+                assignFromCache(primitive.tangents, source.tangents);
+                std::copy(source.indices.begin(), source.indices.end(), primitive.indices.getBytes().begin());
+                assignFromCache(primitive.meshlets.meshlets, source.meshlets);
+                assignFromCache(primitive.meshlets.bounds, source.meshletBounds);
+                assignFromCache(primitive.meshlets.vertices, source.meshletVertices);
+                assignFromCache(primitive.meshlets.triangles, source.meshletTriangles);
+            }
+
+            // The deformation data is used on the CPU, so it is always copied.
+            assignFromCache(primitive.influences, cache.getArray<krypton::util::VertexInfluences>(cached.influences));
+            for (const auto& cachedTarget : morphTargets.subspan(cached.firstMorphTarget, cached.morphTargetCount)) {
+                auto& target = primitive.morphTargets.emplace_back();
+                assignFromCache(target.vertices, cache.getArray<uint32_t>(cachedTarget.vertices));
+                assignFromCache(target.positionDeltas, cache.getArray<float>(cachedTarget.positionDeltas));
+                assignFromCache(target.normalDeltas, cache.getArray<float>(cachedTarget.normalDeltas));
+            }
+            fromCachedBounds(cached.bounds, primitive.boundingBox, primitive.boundingSphere);
+            primitive.materialIndex = cached.materialIndex;
+        }
+    }
+
+    loader.meshBounds.resize(loader.meshes.size());
+    for (std::size_t i = 0; i < loader.meshes.size(); ++i)
+        loader.meshBounds.set(i, loader.meshes[i]->boundingBox, loader.meshes[i]->boundingSphere);
+
+    auto instances = cache.getSection<ka::MeshInstance>(MeshCacheSection::Instances);
+    loader.instances.assign(instances.begin(), instances.end());
+    loader.hierarchy.clear();
+    for (const auto& cachedNode : cache.getSection<CachedNode>(MeshCacheSection::Nodes)) {
+        loader.hierarchy.nodes.addNode(cachedNode.parent, cachedNode.translation, cachedNode.rotation, cachedNode.scale);
+        loader.hierarchy.nodeNames.emplace_back(cache.getString(cachedNode.name));
+    }
+    auto instanceNodes = cache.getSection<uint32_t>(MeshCacheSection::InstanceNodes);
+    loader.hierarchy.instanceNodes.assign(instanceNodes.begin(), instanceNodes.end());
+    assignFromCache(loader.hierarchy.instanceSkins, cache.getSection<uint32_t>(MeshCacheSection::InstanceSkins));
+    assignFromCache(loader.hierarchy.morphWeightOffsets, cache.getSection<uint32_t>(MeshCacheSection::MorphWeightOffsets));
+    assignFromCache(loader.hierarchy.morphWeights, cache.getSection<float>(MeshCacheSection::MorphWeights));
+    loader.hierarchy.update(loader.instances);
+
+    loader.animations.clear();
+    for (const auto& cachedAnimation : cache.getSection<CachedAnimation>(MeshCacheSection::Animations)) {
+        auto& animation = loader.animations.emplace_back();
+        animation.name = cache.getString(cachedAnimation.name);
+        auto& tracks = animation.tracks;
+        assignFromCache(tracks.tracks, cache.getArray<krypton::util::KeyframeTrack>(cachedAnimation.tracks));
+        assignFromCache(animation.targets, cache.getArray<ka::AnimationTarget>(cachedAnimation.targets));
+        assignFromCache(tracks.times, cache.getArray<float>(cachedAnimation.times));
+        for (std::size_t c = 0; c < 4; ++c) {
+            assignFromCache(tracks.values[c], cache.getArray<float>(cachedAnimation.values[c]));
+            assignFromCache(tracks.quantizedValues[c], cache.getArray<uint16_t>(cachedAnimation.quantizedValues[c]));
+        }
+    }
+
+    loader.skins.clear();
+    for (const auto& cachedSkin : cache.getSection<CachedSkin>(MeshCacheSection::Skins)) {
+        auto& skin = loader.skins.emplace_back();
+        skin.name = cache.getString(cachedSkin.name);
+        assignFromCache(skin.joints, cache.getArray<uint32_t>(cachedSkin.joints));
+        assignFromCache(skin.inverseBindMatrices, cache.getArray<krypton::util::Matrix4>(cachedSkin.inverseBindMatrices));
+    }
+
+    auto materials = cache.getSection<ka::Material>(MeshCacheSection::Materials);
+    loader.materials.assign(materials.begin(), materials.end());
+
+    loader.textures.clear();
+    loader.textureSources.clear();
+    for (const auto& cachedTexture : cache.getSection<CachedTexture>(MeshCacheSection::Textures)) {
+        auto& texture = loader.textures.emplace_back();
+        texture.name = cache.getString(cachedTexture.name);
+        texture.filePath = fs::path(cache.getString(cachedTexture.filePath));
+        texture.width = cachedTexture.width;
+        texture.height = cachedTexture.height;
+        texture.channels = cachedTexture.channels;
+        texture.mipLevels = cachedTexture.mipLevels;
+        texture.bitsPerPixel = cachedTexture.bitsPerPixel;
+        texture.srgb = cachedTexture.srgb != 0;
+        texture.role = cachedTexture.role;
+        texture.compression = cachedTexture.compression;
+
+        auto& source = loader.textureSources.emplace_back();
+        if (streamTextures) {
+            // The levels are stored one after another, so their ranges follow from their sizes.
+            auto offset = cachedTexture.pixels.offset;
+            for (uint32_t level = 0; level < std::max(texture.mipLevels, 1U); ++level) {
+                const auto size = getTextureLevelSize(texture, level);
+                source.levels.push_back({ .offset = offset, .size = size });
+                offset += size;
+            }
+            if (offset == cachedTexture.pixels.offset + cachedTexture.pixels.size) {
+                source.file = cache.getFile();
+                continue;
+            }
+            source.levels.clear();
+        }
+        texture.pixels.assign(cache.getBytes(cachedTexture.pixels));
+    }
+}
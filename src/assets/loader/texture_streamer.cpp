@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <Tracy.hpp>
+
+#include <assets/loader/texture_streamer.hpp>
+#include <util/scheduler.hpp>
+
+namespace ka = krypton::assets;
+namespace ku = krypton::util;
+
+namespace krypton::assets::loader {
+    // A level that is read in the background and put in front of the currently resident levels.
+    struct TextureLevelLoad final {
+        uint32_t index;
+        uint32_t level;
+        std::shared_ptr<const ku::MappedFile> file;
+        TextureLevelRange range;
+        std::shared_ptr<const std::vector<std::byte>> residentPixels;
+    };
+
+    // Copies the given levels out of the file, followed by the already resident levels.
+    [[nodiscard]] auto readTextureLevels(const ku::MappedFile& file, std::span<const TextureLevelRange> levels,
+                                         std::span<const std::byte> residentPixels) -> std::vector<std::byte> {
+        ZoneScoped;
+        std::size_t size = residentPixels.size();
+        for (const auto& level : levels)
+            size += level.size;
+
+        std::vector<std::byte> pixels(size);
+        auto* output = pixels.data();
+        for (const auto& level : levels) {
+            std::memcpy(output, file.getData().data() + level.offset, level.size);
+            output += level.size;
+        }
+        if (!residentPixels.empty())
+            std::memcpy(output, residentPixels.data(), residentPixels.size());
+        return pixels;
+    }
+} // namespace krypton::assets::loader
+
+ka::loader::TextureStreamer::TextureStreamer(TextureStreamerOptions options) noexcept : options(options) {}
+
+ka::loader::TextureStreamer::~TextureStreamer() {
+    waitForPendingLoads();
+}
+
+void ka::loader::TextureStreamer::evictLevel(StreamedTexture& streamed) {
+    const auto size = streamed.source.levels[streamed.residentLevel].size;
+    const auto& pixels = *streamed.pixels;
+    streamed.pixels = std::make_shared<const std::vector<std::byte>>(pixels.begin() + static_cast<std::ptrdiff_t>(size), pixels.end());
+    residentSize -= size;
+    ++streamed.residentLevel;
+    ++streamed.version;
+}
+
+void ka::loader::TextureStreamer::finishLoad(uint32_t index, uint32_t level, std::shared_ptr<const std::vector<std::byte>> pixels) {
+    {
+        auto guard = std::scoped_lock(mutex);
+        auto& streamed = textures[index];
+        const auto size = streamed.source.levels[level].size;
+        residentSize += size;
+        pendingSize -= size;
+        --pendingLoads;
+        streamed.pixels = std::move(pixels);
+        streamed.residentLevel = level;
+        streamed.loading = false;
+        ++streamed.version;
+    }
+    loadFinished.notify_all();
+}
+
+bool ka::loader::TextureStreamer::addTexture(const ka::Texture& texture, TextureLevelSource source, uint32_t& index) {
+    ZoneScoped;
+    const auto levelCount = std::max(texture.mipLevels, 1U);
+    if (!source.file || source.levels.size() != levelCount)
+        return false;
+    const auto fileSize = source.file->size();
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const auto& range = source.levels[level];
+        if (range.size != getTextureLevelSize(texture, level) || range.offset > fileSize || fileSize - range.offset < range.size)
+            return false;
+    }
+
+    StreamedTexture streamed;
+    streamed.texture = {
+        .filePath = texture.filePath,
+        .name = texture.name,
+        .width = texture.width,
+        .height = texture.height,
+        .channels = texture.channels,
+        .mipLevels = levelCount,
+        .bitsPerPixel = texture.bitsPerPixel,
+        .srgb = texture.srgb,
+        .role = texture.role,
+        .compression = texture.compression,
+    };
+
+    // The tail starts with the largest level that isn't larger than tailExtent.
+    const auto extent = std::max(texture.width, texture.height);
+    auto tailLevel = levelCount - 1;
+    while (tailLevel > 0 && ku::getMipExtent(extent, tailLevel - 1) <= options.tailExtent)
+        --tailLevel;
+    streamed.tailLevel = streamed.residentLevel = streamed.requestedLevel = tailLevel;
+
+    auto pixels = readTextureLevels(*source.file, std::span(source.levels).subspan(tailLevel), {});
+    const auto size = pixels.size();
+    streamed.pixels = std::make_shared<const std::vector<std::byte>>(std::move(pixels));
+    streamed.source = std::move(source);
+
+    auto guard = std::scoped_lock(mutex);
+    streamed.lastRequestFrame = frame;
+    residentSize += size;
+    index = static_cast<uint32_t>(textures.size());
+    textures.emplace_back(std::move(streamed));
+    return true;
+}
+
+void ka::loader::TextureStreamer::requestExtent(uint32_t index, uint32_t extent) {
+    auto guard = std::scoped_lock(mutex);
+    auto& streamed = textures[index];
+    const auto maxExtent = std::max(streamed.texture.width, streamed.texture.height);
+    uint32_t level = 0;
+    while (level < streamed.tailLevel && ku::getMipExtent(maxExtent, level + 1) >= extent)
+        ++level;
+
+    if (streamed.lastRequestFrame == frame)
+        level = std::min(level, streamed.requestedLevel);
+    streamed.requestedLevel = level;
+    streamed.lastRequestFrame = frame;
+}
+
+void ka::loader::TextureStreamer::update() {
+    ZoneScoped;
+    std::vector<TextureLevelLoad> loads;
+    {
+        auto guard = std::scoped_lock(mutex);
+        std::vector<uint32_t> candidates;
+        for (uint32_t i = 0; i < textures.size(); ++i) {
+            auto& streamed = textures[i];
+            if (frame - streamed.lastRequestFrame > options.unusedFrameCount)
+                streamed.requestedLevel = streamed.tailLevel;
+            if (streamed.residentLevel > streamed.requestedLevel && !streamed.loading)
+                candidates.push_back(i);
+        }
+
+        // The textures that are furthest from their requested resolution come first.
+        std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+            const auto& first = textures[a];
+            const auto& second = textures[b];
+            const auto firstDeficit = first.residentLevel - first.requestedLevel;
+            const auto secondDeficit = second.residentLevel - second.requestedLevel;
+            if (firstDeficit != secondDeficit)
+                return firstDeficit > secondDeficit;
+            return first.lastRequestFrame > second.lastRequestFrame;
+        });
+
+        for (const auto index : candidates) {
+            if (pendingLoads + loads.size() >= options.maxPendingLoads)
+                break;
+
+            auto& streamed = textures[index];
+            const auto level = streamed.residentLevel - 1;
+            const auto size = streamed.source.levels[level].size;
+            while (residentSize + pendingSize + size > options.memoryBudget) {
+                // Evict the levels nobody asked for first, then those of textures that were requested less recently.
+                StreamedTexture* victim = nullptr;
+                for (auto& other : textures) {
+                    if (&other == &streamed || other.loading || other.residentLevel >= other.tailLevel)
+                        continue;
+                    const bool excess = other.residentLevel < other.requestedLevel;
+                    if (!excess && other.lastRequestFrame >= streamed.lastRequestFrame)
+                        continue;
+                    if (victim == nullptr) {
+                        victim = &other;
+                        continue;
+                    }
+                    const bool victimExcess = victim->residentLevel < victim->requestedLevel;
+                    if (excess != victimExcess) {
+                        if (excess)
+                            victim = &other;
+                    } else if (other.lastRequestFrame != victim->lastRequestFrame) {
+                        if (other.lastRequestFrame < victim->lastRequestFrame)
+                            victim = &other;
+                    } else if (other.residentLevel < victim->residentLevel) {
+                        victim = &other;
+                    }
+                }
+                if (victim == nullptr)
+                    break;
+                evictLevel(*victim);
+            }
+            if (residentSize + pendingSize + size > options.memoryBudget)
+                continue;
+
+            streamed.loading = true;
+            pendingSize += size;
+            loads.push_back({
+                .index = index,
+                .level = level,
+                .file = streamed.source.file,
+                .range = streamed.source.levels[level],
+                .residentPixels = streamed.pixels,
+            });
+        }
+        pendingLoads += static_cast<uint32_t>(loads.size());
+        ++frame;
+    }
+
+    auto& scheduler = krypton::threading::Scheduler::getInstance();
+    for (auto& load : loads) {
+        auto task = [this, load = std::move(load)]() {
+            auto pixels = readTextureLevels(*load.file, std::span(&load.range, 1), *load.residentPixels);
+            finishLoad(load.index, load.level, std::make_shared<const std::vector<std::byte>>(std::move(pixels)));
+        };
+        if (scheduler.isRunning())
+            scheduler.run(task);
+        else
+            task();
+    }
+}
+
+void ka::loader::TextureStreamer::waitForPendingLoads() {
+    auto lock = std::unique_lock(mutex);
+    loadFinished.wait(lock, [&]() { return pendingLoads == 0; });
+}
+
+auto ka::loader::TextureStreamer::getResidentTexture(uint32_t index) const -> ResidentTexture {
+    auto guard = std::scoped_lock(mutex);
+    const auto& streamed = textures[index];
+    return {
+        .firstLevel = streamed.residentLevel,
+        .width = ku::getMipExtent(streamed.texture.width, streamed.residentLevel),
+        .height = ku::getMipExtent(streamed.texture.height, streamed.residentLevel),
+        .levelCount = streamed.texture.mipLevels - streamed.residentLevel,
+        .pixels = streamed.pixels,
+        .version = streamed.version,
+    };
+}
+
+auto ka::loader::TextureStreamer::getResidentSize() const -> std::size_t {
+    auto guard = std::scoped_lock(mutex);
+    return residentSize;
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <array>
+
+#include <Tracy.hpp>
+
+#include <assets/processing/mesh_deformer.hpp>
+#include <util/numeric_conversion.hpp>
+#include <util/scheduler.hpp>
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+
+namespace krypton::assets::processing {
+    // Vertices per task.
+    constexpr std::size_t deformChunkSize = 4096;
+    // Vertices deformed at once within a task, sized so that the scratch buffers stay in L1.
+    constexpr std::size_t deformBatchSize = 256;
+} // namespace krypton::assets::processing
+
+void kap::computeJointMatrices(const ka::Skin& skin, std::span<const krypton::util::Matrix4> worldMatrices,
+                               std::vector<krypton::util::Matrix4>& out) {
+    ZoneScoped;
+    const auto jointCount = std::min(skin.joints.size(), skin.inverseBindMatrices.size());
+    out.resize(jointCount);
+
+    // Joints outside of the scene read some valid matrix first and are reset afterwards.
+    std::vector<uint32_t> joints(skin.joints.begin(), skin.joints.begin() + static_cast<std::ptrdiff_t>(jointCount));
+    for (auto& joint : joints)
+        if (joint >= worldMatrices.size())
+            joint = 0;
+    if (!worldMatrices.empty())
+        krypton::util::multiplyMatrices(worldMatrices, joints, std::span(skin.inverseBindMatrices).first(jointCount), out);
+    for (std::size_t i = 0; i < jointCount; ++i)
+        if (skin.joints[i] >= worldMatrices.size())
+            out[i] = {};
+}
+
+bool kap::deformPrimitive(const ka::Primitive& primitive, std::span<const krypton::util::Matrix4> jointMatrices,
+                          std::span<const float> morphWeights, std::vector<ka::CompactVertex>& out) {
+    ZoneScoped;
+    if (primitive.vertexLayout == ka::VertexLayout::Quantized)
+        return false;
+
+    const auto vertexCount = primitive.getVertexCount();
+    out.resize(vertexCount);
+    const bool skinned = !jointMatrices.empty() && primitive.influences.size() == vertexCount;
+    const auto targetCount = std::min(primitive.morphTargets.size(), morphWeights.size());
+    const auto targets = std::span(primitive.morphTargets).first(targetCount);
+    const auto weights = morphWeights.first(targetCount);
+
+    krypton::threading::Scheduler::getInstance().parallelFor(vertexCount, deformChunkSize, [&](std::size_t begin, std::size_t end) {
+        std::array<float, deformBatchSize * 3> positions, normals;
+        std::array<int16_t, deformBatchSize * 2> encodedNormals;
+        for (auto first = begin; first < end; first += deformBatchSize) {
+            const auto count = std::min(deformBatchSize, end - first);
+            if (primitive.vertexLayout == ka::VertexLayout::Full) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto& vertex = primitive.vertices[first + i];
+                    std::copy_n(&vertex.pos.x, 3, &positions[i * 3]);
+                    std::copy_n(&vertex.normals.x, 3, &normals[i * 3]);
+                    out[first + i].uv[0] = krypton::util::floatToHalf(vertex.uv.x);
+                    out[first + i].uv[1] = krypton::util::floatToHalf(vertex.uv.y);
+                }
+            } else {
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto& vertex = primitive.compactVertices[first + i];
+                    std::copy_n(vertex.position, 3, &positions[i * 3]);
+                    std::copy_n(vertex.normal, 2, &encodedNormals[i * 2]);
+                    std::copy_n(vertex.uv, 2, out[first + i].uv);
+                }
+                krypton::util::decodeOctahedralNormals(std::span(encodedNormals).first(count * 2), std::span(normals).first(count * 3));
+            }
+
+            if (!targets.empty())
+                krypton::util::accumulateMorphTargets(targets, weights, first, count, positions.data(), normals.data());
+
+            auto* dst = &out[first];
+            if (skinned) {
+                krypton::util::skinVertices(jointMatrices, positions.data(), normals.data(), &primitive.influences[first], count,
+                                            dst->position, dst->normal, sizeof(ka::CompactVertex));
+                continue;
+            }
+            krypton::util::encodeOctahedralNormals(std::span(normals).first(count * 3), std::span(encodedNormals).first(count * 2));
+            for (std::size_t i = 0; i < count; ++i) {
+                std::copy_n(&positions[i * 3], 3, dst[i].position);
+                std::copy_n(&encodedNormals[i * 2], 2, dst[i].normal);
+            }
+        }
+    });
+    return true;
+}
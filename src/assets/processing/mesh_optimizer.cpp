@@ -0,0 +1,472 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <Tracy.hpp>
+
+#include <assets/processing/mesh_optimizer.hpp>
+#include <util/flat_map.hpp>
+#include <util/hash.hpp>
+#include <util/scheduler.hpp>
+
+namespace krypton::assets::processing {
+    // ↓ -------------------  FORSYTH  ------------------- ↓
+    // The constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+    constexpr uint32_t forsythCacheSize = 32;
+    constexpr float cacheDecayPower = 1.5f;
+    constexpr float lastTriangleScore = 0.75f;
+    constexpr float valenceBoostScale = 2.0f;
+    constexpr float valenceBoostPower = 0.5f;
+    constexpr uint32_t maxPrecomputedValence = 32;
+
+    struct ForsythScoreTable final {
+        float cache[forsythCacheSize] = {};
+        float valence[maxPrecomputedValence + 1] = {};
+
+        ForsythScoreTable() {
+            for (uint32_t i = 0; i < forsythCacheSize; ++i) {
+                if (i < 3) {
+                    // The vertices of the last triangle get a fixed score, so that we don't
+                    // just draw the same strip direction over and over again.
+                    cache[i] = lastTriangleScore;
+                } else {
+                    auto scale = 1.0f - static_cast<float>(i - 3) / static_cast<float>(forsythCacheSize - 3);
+                    cache[i] = std::pow(scale, cacheDecayPower);
+                }
+            }
+            for (uint32_t i = 1; i <= maxPrecomputedValence; ++i)
+                valence[i] = valenceBoostScale * std::pow(static_cast<float>(i), -valenceBoostPower);
+        }
+
+        [[nodiscard]] auto getVertexScore(int32_t cachePosition, uint32_t remainingTriangles) const noexcept -> float {
+            if (remainingTriangles == 0)
+                return -1.0f;
+            auto score = cachePosition < 0 ? 0.0f : cache[cachePosition];
+            // Vertices with only few triangles left get a boost, so that we get rid of them early.
+            return score + valence[std::min(remainingTriangles, maxPrecomputedValence)];
+        }
+    };
+    // ↑ -------------------  FORSYTH  ------------------- ↑
+
+    [[nodiscard]] auto getPosition(const Vertex& vertex) noexcept -> glm::fvec3 {
+        return glm::fvec3(vertex.pos.x, vertex.pos.y, vertex.pos.z);
+    }
+
+    [[nodiscard]] auto hashVertex(const Vertex& vertex, const uint32_t* color) noexcept -> uint64_t {
+        // We hash each attribute on its own, as the padding of Vertex might not be initialized.
+        auto hash = util::hashBytes(&vertex.pos, sizeof(vertex.pos));
+        hash = util::hashBytes(&vertex.color, sizeof(vertex.color), hash);
+        hash = util::hashBytes(&vertex.normals, sizeof(vertex.normals), hash);
+        hash = util::hashBytes(&vertex.uv, sizeof(vertex.uv), hash);
+        if (color != nullptr)
+            hash = util::hashBytes(color, sizeof(uint32_t), hash);
+        return hash;
+    }
+
+    [[nodiscard]] bool isVertexEqual(const Vertex& lhs, const Vertex& rhs) noexcept {
+        return std::memcmp(&lhs.pos, &rhs.pos, sizeof(lhs.pos)) == 0 && std::memcmp(&lhs.color, &rhs.color, sizeof(lhs.color)) == 0 &&
+               std::memcmp(&lhs.normals, &rhs.normals, sizeof(lhs.normals)) == 0 && std::memcmp(&lhs.uv, &rhs.uv, sizeof(lhs.uv)) == 0;
+    }
+} // namespace krypton::assets::processing
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+
+auto kap::VertexCacheStatistics::getAcmr() const noexcept -> float {
+    return triangleCount == 0 ? 0.0f : static_cast<float>(transformedVertexCount) / static_cast<float>(triangleCount);
+}
+
+auto kap::VertexCacheStatistics::getAtvr() const noexcept -> float {
+    return vertexCount == 0 ? 0.0f : static_cast<float>(transformedVertexCount) / static_cast<float>(vertexCount);
+}
+
+auto kap::VertexCacheStatistics::operator+=(const VertexCacheStatistics& other) noexcept -> VertexCacheStatistics& {
+    vertexCount += other.vertexCount;
+    triangleCount += other.triangleCount;
+    transformedVertexCount += other.transformedVertexCount;
+    return *this;
+}
+
+auto kap::MeshOptimizationStatistics::operator+=(const MeshOptimizationStatistics& other) noexcept -> MeshOptimizationStatistics& {
+    before += other.before;
+    after += other.after;
+    return *this;
+}
+
+auto kap::analyzeVertexCache(std::span<const uint32_t> indices, std::size_t vertexCount, uint32_t cacheSize) -> VertexCacheStatistics {
+    ZoneScoped;
+    VertexCacheStatistics statistics = {
+        .vertexCount = vertexCount,
+        .triangleCount = indices.size() / 3,
+    };
+
+    // Instead of simulating the FIFO itself, we remember when each vertex was last put into the
+    // cache. A vertex is still cached if fewer than cacheSize vertices were added since.
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    uint32_t timestamp = cacheSize + 1;
+    for (auto index : indices) {
+        if (timestamp - timestamps[index] > cacheSize) {
+            timestamps[index] = timestamp++;
+            ++statistics.transformedVertexCount;
+        }
+    }
+    return statistics;
+}
+
+auto kap::weldVertices(std::span<uint32_t> indices, std::span<const Vertex> vertices, std::span<const uint32_t> colors,
+                       std::span<const CompactTangent> tangents, std::span<const util::VertexInfluences> influences) -> std::size_t {
+    ZoneScoped;
+    const bool hasColors = colors.size() == vertices.size();
+    const bool hasTangents = tangents.size() == vertices.size();
+    const bool hasInfluences = influences.size() == vertices.size();
+
+    util::FlatMap<uint64_t, uint32_t> firstOccurrences;
+    firstOccurrences.reserve(vertices.size());
+
+    std::vector<uint32_t> remap(vertices.size());
+    std::size_t uniqueCount = 0;
+    for (uint32_t i = 0; i < vertices.size(); ++i) {
+        auto hash = hashVertex(vertices[i], hasColors ? &colors[i] : nullptr);
+        if (hasTangents)
+            hash = util::hashBytes(&tangents[i], sizeof(CompactTangent), hash);
+        if (hasInfluences)
+            hash = util::hashBytes(&influences[i], sizeof(util::VertexInfluences), hash);
+        auto [first, inserted] = firstOccurrences.insert(hash, i);
+
+        // On the off chance that two different vertices have the same hash, we simply keep both.
+        bool duplicate = !inserted && isVertexEqual(vertices[*first], vertices[i]) && (!hasColors || colors[*first] == colors[i]) &&
+                         (!hasTangents || std::memcmp(&tangents[*first], &tangents[i], sizeof(CompactTangent)) == 0) &&
+                         (!hasInfluences || std::memcmp(&influences[*first], &influences[i], sizeof(util::VertexInfluences)) == 0);
+        remap[i] = duplicate ? *first : i;
+        if (!duplicate)
+            ++uniqueCount;
+    }
+
+    for (auto& index : indices)
+        index = remap[index];
+    return uniqueCount;
+}
+
+void kap::optimizeVertexCache(std::span<const uint32_t> indices, std::size_t vertexCount, std::span<uint32_t> dst) {
+    ZoneScoped;
+    static const ForsythScoreTable scoreTable;
+    constexpr auto npos = std::numeric_limits<std::size_t>::max();
+
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // Build the vertex to triangle adjacency. The triangles of each vertex that have not been
+    // drawn yet are kept at the front of its list.
+    std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+    for (auto index : indices)
+        ++remainingTriangles[index];
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (std::size_t i = 0; i < vertexCount; ++i)
+        adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remainingTriangles[i];
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<int32_t> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (std::size_t i = 0; i < vertexCount; ++i)
+        vertexScores[i] = scoreTable.getVertexScore(-1, remainingTriangles[i]);
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    auto bestTriangle = npos;
+    auto bestScore = -1.0f;
+    for (std::size_t i = 0; i < triangleCount; ++i) {
+        const auto* triangle = &indices[i * 3];
+        const auto score = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+        if (score > bestScore) {
+            bestScore = score;
+            bestTriangle = i;
+        }
+    }
+
+    // The cache temporarily holds three more entries, so that we can update the scores of the
+    // vertices that were just evicted.
+    std::array<uint32_t, forsythCacheSize + 3> cache = {};
+    std::array<uint32_t, forsythCacheSize + 3> newCache = {};
+    std::size_t cacheSize = 0;
+    std::size_t inputCursor = 0;
+
+    for (std::size_t output = 0; output < triangleCount; ++output) {
+        if (bestTriangle == npos) {
+            // Nothing in the cache is connected to any remaining triangle, so we continue with
+            // the next triangle in input order. This keeps the algorithm linear.
+            while (emitted[inputCursor])
+                ++inputCursor;
+            bestTriangle = inputCursor;
+        }
+
+        const auto* triangle = &indices[bestTriangle * 3];
+        std::copy(triangle, triangle + 3, &dst[output * 3]);
+        emitted[bestTriangle] = 1;
+
+        std::size_t newCacheSize = 0;
+        for (std::size_t i = 0; i < 3; ++i) {
+            auto vertex = triangle[i];
+            if (std::find(newCache.begin(), newCache.begin() + newCacheSize, vertex) == newCache.begin() + newCacheSize)
+                newCache[newCacheSize++] = vertex;
+
+            // Remove the triangle from the list of remaining triangles of the vertex.
+            auto* list = &adjacency[adjacencyOffsets[vertex]];
+            auto* end = list + remainingTriangles[vertex];
+            auto* position = std::find(list, end, static_cast<uint32_t>(bestTriangle));
+            std::swap(*position, *(end - 1));
+            --remainingTriangles[vertex];
+        }
+        for (std::size_t i = 0; i < cacheSize; ++i) {
+            auto vertex = cache[i];
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                newCache[newCacheSize++] = vertex;
+        }
+
+        for (std::size_t i = 0; i < newCacheSize; ++i) {
+            auto vertex = newCache[i];
+            cachePositions[vertex] = i < forsythCacheSize ? static_cast<int32_t>(i) : -1;
+            vertexScores[vertex] = scoreTable.getVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+        }
+
+        // Only the triangles of vertices whose score changed need to be rescored. The best
+        // triangle is also only searched among those.
+        bestTriangle = npos;
+        bestScore = -1.0f;
+        for (std::size_t i = 0; i < newCacheSize; ++i) {
+            auto vertex = newCache[i];
+            const auto* list = &adjacency[adjacencyOffsets[vertex]];
+            for (std::size_t j = 0; j < remainingTriangles[vertex]; ++j) {
+                auto candidate = list[j];
+                const auto* candidateIndices = &indices[candidate * 3];
+                auto score = vertexScores[candidateIndices[0]] + vertexScores[candidateIndices[1]] + vertexScores[candidateIndices[2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = candidate;
+                }
+            }
+        }
+
+        cacheSize = std::min<std::size_t>(newCacheSize, forsythCacheSize);
+        std::copy(newCache.begin(), newCache.begin() + cacheSize, cache.begin());
+    }
+}
+
+void kap::optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold) {
+    ZoneScoped;
+    // Clusters that are too small are only split off where the cache is cold anyway, as every
+    // split potentially costs us a full cache refill.
+    constexpr std::size_t minSoftClusterSize = 32;
+
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    auto acmr = analyzeVertexCache(indices, vertices.size()).getAcmr();
+
+    // Split the triangles into clusters. A new cluster starts where all vertices of a triangle
+    // miss the cache, and optionally where a cluster is large and already cache efficient.
+    std::vector<std::size_t> clusterStarts;
+    {
+        std::vector<uint32_t> timestamps(vertices.size(), 0);
+        uint32_t timestamp = defaultAnalysisCacheSize + 1;
+        std::size_t clusterMisses = 0;
+        for (std::size_t i = 0; i < triangleCount; ++i) {
+            std::size_t misses = 0;
+            for (std::size_t j = 0; j < 3; ++j) {
+                auto index = indices[i * 3 + j];
+                if (timestamp - timestamps[index] > defaultAnalysisCacheSize) {
+                    timestamps[index] = timestamp++;
+                    ++misses;
+                }
+            }
+
+            auto clusterSize = clusterStarts.empty() ? 0 : i - clusterStarts.back();
+            bool hardBoundary = misses == 3;
+            bool softBoundary = threshold > 1.0f && misses >= 2 && clusterSize >= minSoftClusterSize &&
+                                static_cast<float>(clusterMisses) <= acmr * threshold * static_cast<float>(clusterSize);
+            if (clusterStarts.empty() || hardBoundary || softBoundary) {
+                clusterStarts.push_back(i);
+                clusterMisses = 0;
+            }
+            clusterMisses += misses;
+        }
+    }
+    if (clusterStarts.size() < 2)
+        return;
+
+    // Sort the clusters by how much they face away from the center of the mesh. Those facing
+    // outwards are more likely to occlude the others.
+    struct Cluster final {
+        std::size_t first = 0;
+        std::size_t count = 0;
+        glm::fvec3 centroid = glm::fvec3(0.0f);
+        glm::fvec3 normal = glm::fvec3(0.0f);
+        float area = 0.0f;
+        float sortKey = 0.0f;
+    };
+
+    std::vector<Cluster> clusters(clusterStarts.size());
+    auto meshCentroid = glm::fvec3(0.0f);
+    auto meshArea = 0.0f;
+    for (std::size_t i = 0; i < clusters.size(); ++i) {
+        auto& cluster = clusters[i];
+        cluster.first = clusterStarts[i];
+        cluster.count = (i + 1 < clusterStarts.size() ? clusterStarts[i + 1] : triangleCount) - cluster.first;
+
+        for (std::size_t j = cluster.first; j < cluster.first + cluster.count; ++j) {
+            auto p0 = getPosition(vertices[indices[j * 3 + 0]]);
+            auto p1 = getPosition(vertices[indices[j * 3 + 1]]);
+            auto p2 = getPosition(vertices[indices[j * 3 + 2]]);
+            auto normal = glm::cross(p1 - p0, p2 - p0);
+            auto area = glm::length(normal);
+
+            cluster.centroid = cluster.centroid + (p0 + p1 + p2) * (area / 3.0f);
+            cluster.normal = cluster.normal + normal;
+            cluster.area += area;
+        }
+
+        meshCentroid = meshCentroid + cluster.centroid;
+        meshArea += cluster.area;
+        if (cluster.area > 0.0f)
+            cluster.centroid = cluster.centroid / cluster.area;
+    }
+    if (meshArea > 0.0f)
+        meshCentroid = meshCentroid / meshArea;
+
+    for (auto& cluster : clusters) {
+        auto normalLength = glm::length(cluster.normal);
+        if (normalLength > 0.0f)
+            cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, cluster.normal / normalLength);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& lhs, const Cluster& rhs) { return lhs.sortKey > rhs.sortKey; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (const auto& cluster : clusters)
+        sorted.insert(sorted.end(), indices.begin() + cluster.first * 3, indices.begin() + (cluster.first + cluster.count) * 3);
+
+    // The split points above are only a heuristic, so we verify the cache efficiency did not
+    // get worse than allowed.
+    auto sortedAcmr = analyzeVertexCache(sorted, vertices.size()).getAcmr();
+    if (sortedAcmr <= acmr * std::max(threshold, 1.0f))
+        std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+void kap::optimizeVertexFetch(ka::Primitive& primitive, std::span<uint32_t> indices) {
+    ZoneScoped;
+    constexpr auto unused = std::numeric_limits<uint32_t>::max();
+    const bool hasColors = primitive.colors.size() == primitive.vertices.size();
+    const bool hasTangents = primitive.tangents.size() == primitive.vertices.size();
+
+    std::vector<uint32_t> remap(primitive.vertices.size(), unused);
+    uint32_t vertexCount = 0;
+    for (auto& index : indices) {
+        if (remap[index] == unused)
+            remap[index] = vertexCount++;
+        index = remap[index];
+    }
+
+    // LODs only reference vertices of the full primitive, but we still keep anything they use.
+    for (auto& lod : primitive.lods) {
+        auto lodIndices = lod.indices.toUint32();
+        for (auto& index : lodIndices) {
+            if (remap[index] == unused)
+                remap[index] = vertexCount++;
+            index = remap[index];
+        }
+        lod.indices.assign(lodIndices, lod.indices.getType());
+    }
+
+    std::vector<ka::Vertex> vertices(vertexCount);
+    std::vector<uint32_t> colors(hasColors ? vertexCount : 0);
+    std::vector<ka::CompactTangent> tangents(hasTangents ? vertexCount : 0);
+    std::vector<uint32_t> sourceVertices(vertexCount);
+    for (std::size_t i = 0; i < remap.size(); ++i) {
+        if (remap[i] == unused)
+            continue;
+        vertices[remap[i]] = primitive.vertices[i];
+        if (hasColors)
+            colors[remap[i]] = primitive.colors[i];
+        if (hasTangents)
+            tangents[remap[i]] = primitive.tangents[i];
+        sourceVertices[remap[i]] = static_cast<uint32_t>(i);
+    }
+
+    primitive.vertices = std::move(vertices);
+    if (hasColors)
+        primitive.colors = std::move(colors);
+    if (hasTangents)
+        primitive.tangents = std::move(tangents);
+    ka::gatherDeformation(primitive, sourceVertices, primitive);
+}
+
+auto kap::optimizePrimitive(ka::Primitive& primitive, const MeshOptimizationOptions& options) -> MeshOptimizationStatistics {
+    ZoneScoped;
+    MeshOptimizationStatistics statistics;
+    if (!primitive.isTriangleList())
+        return statistics;
+
+    auto indices = primitive.indices.toUint32();
+    statistics.before = analyzeVertexCache(indices, primitive.getVertexCount());
+    if (primitive.vertexLayout != ka::VertexLayout::Full || indices.empty()) {
+        statistics.after = statistics.before;
+        return statistics;
+    }
+
+    // Comparing the sparse deltas of every vertex isn't worth it, so morphed primitives are not welded.
+    if (options.weldVertices && primitive.morphTargets.empty())
+        weldVertices(indices, primitive.vertices, primitive.colors, primitive.tangents, primitive.influences);
+
+    std::vector<uint32_t> optimized(indices.size());
+    optimizeVertexCache(indices, primitive.vertices.size(), optimized);
+    if (options.optimizeOverdraw)
+        optimizeOverdraw(optimized, primitive.vertices, options.overdrawThreshold);
+    optimizeVertexFetch(primitive, optimized);
+
+    statistics.after = analyzeVertexCache(optimized, primitive.vertices.size());
+
+    // Welding only ever removes vertices, so the index type can only get narrower. 8-bit
+    // indices are only used if the primitive already had them, as they are opt-in.
+    auto allowUint8 = primitive.indices.getType() == ka::IndexType::Uint8;
+    primitive.indices.assign(optimized, ka::getNarrowestIndexType(primitive.vertices.size(), allowUint8));
+    return statistics;
+}
+
+auto kap::optimizeMesh(ka::Mesh& mesh, const MeshOptimizationOptions& options) -> MeshOptimizationStatistics {
+    MeshOptimizationStatistics statistics;
+    for (auto& primitive : mesh.primitives)
+        statistics += optimizePrimitive(primitive, options);
+    return statistics;
+}
+
+auto kap::optimizeMeshes(std::span<const std::shared_ptr<ka::Mesh>> meshes, const MeshOptimizationOptions& options)
+    -> MeshOptimizationStatistics {
+    ZoneScoped;
+    // We schedule each primitive on its own, as a single mesh often contains most of the geometry.
+    std::vector<ka::Primitive*> primitives;
+    for (const auto& mesh : meshes)
+        for (auto& primitive : mesh->primitives)
+            primitives.push_back(&primitive);
+
+    std::vector<MeshOptimizationStatistics> results(primitives.size());
+    krypton::threading::Scheduler::getInstance().parallelFor(primitives.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            results[i] = optimizePrimitive(*primitives[i], options);
+    });
+
+    MeshOptimizationStatistics statistics;
+    for (const auto& result : results)
+        statistics += result;
+    return statistics;
+}
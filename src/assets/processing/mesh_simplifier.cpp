@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include <Tracy.hpp>
+
+#include <assets/processing/mesh_optimizer.hpp>
+#include <assets/processing/mesh_simplifier.hpp>
+#include <assets/processing/triangle_adjacency.hpp>
+#include <util/flat_map.hpp>
+#include <util/hash.hpp>
+#include <util/scheduler.hpp>
+
+namespace krypton::assets::processing {
+    /**
+     * The sum of the squared distances to a set of planes, weighted by the area of the triangles
+     * they came from. Evaluating the quadric and dividing by the total weight gives the mean
+     * squared distance of a point to the original surface.
+     */
+    struct Quadric final {
+        double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+        double weight = 0;
+
+        void addPlane(double a, double b, double c, double d, double planeWeight) noexcept {
+            a2 += a * a * planeWeight;
+            ab += a * b * planeWeight;
+            ac += a * c * planeWeight;
+            ad += a * d * planeWeight;
+            b2 += b * b * planeWeight;
+            bc += b * c * planeWeight;
+            bd += b * d * planeWeight;
+            c2 += c * c * planeWeight;
+            cd += c * d * planeWeight;
+            d2 += d * d * planeWeight;
+            weight += planeWeight;
+        }
+
+        auto operator+=(const Quadric& other) noexcept -> Quadric& {
+            a2 += other.a2;
+            ab += other.ab;
+            ac += other.ac;
+            ad += other.ad;
+            b2 += other.b2;
+            bc += other.bc;
+            bd += other.bd;
+            c2 += other.c2;
+            cd += other.cd;
+            d2 += other.d2;
+            weight += other.weight;
+            return *this;
+        }
+
+        [[nodiscard]] auto evaluate(double x, double y, double z) const noexcept -> double {
+            if (weight <= 0)
+                return 0;
+            auto error = a2 * x * x + b2 * y * y + c2 * z * z + d2 + 2 * (ab * x * y + ac * x * z + ad * x + bc * y * z + bd * y + cd * z);
+            // Rounding can make the result slightly negative.
+            return std::max(error, 0.0) / weight;
+        }
+    };
+
+    struct Collapse final {
+        uint32_t from = 0;
+        uint32_t to = 0;
+        float cost = 0.0f;
+    };
+
+    [[nodiscard]] auto getEdgeKey(uint32_t a, uint32_t b) noexcept -> uint64_t {
+        return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+    }
+
+    [[nodiscard]] auto getSquaredDistance(const glm::fvec4& lhs, const glm::fvec4& rhs) noexcept -> float {
+        auto x = lhs.x - rhs.x, y = lhs.y - rhs.y, z = lhs.z - rhs.z;
+        return x * x + y * y + z * z;
+    }
+
+    /**
+     * Locks every vertex that shares its position with another vertex, as moving it would tear
+     * open the seam, and every vertex on a border or non-manifold edge, as moving it would
+     * change the outline of the mesh.
+     */
+    [[nodiscard]] auto getLockedVertices(std::span<const uint32_t> indices, std::span<const uint32_t> positionIds) -> std::vector<uint8_t> {
+        std::vector<uint8_t> locked(positionIds.size(), 0);
+        std::vector<uint32_t> wedgeCounts(positionIds.size(), 0);
+        for (auto id : positionIds)
+            ++wedgeCounts[id];
+        for (std::size_t i = 0; i < positionIds.size(); ++i)
+            locked[i] = wedgeCounts[positionIds[i]] > 1;
+
+        util::FlatMap<uint64_t, uint32_t> edgeCounts;
+        edgeCounts.reserve(indices.size());
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+            for (std::size_t j = 0; j < 3; ++j)
+                ++edgeCounts[getEdgeKey(positionIds[indices[i + j]], positionIds[indices[i + (j + 1) % 3]])];
+
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                auto a = indices[i + j], b = indices[i + (j + 1) % 3];
+                if (*edgeCounts.find(getEdgeKey(positionIds[a], positionIds[b])) != 2)
+                    locked[a] = locked[b] = 1;
+            }
+        }
+        return locked;
+    }
+
+    /**
+     * Checks whether collapsing from onto to keeps the surface a manifold and does not flip any
+     * of the remaining triangles around from.
+     */
+    [[nodiscard]] bool isCollapseValid(const Collapse& collapse, std::span<const uint32_t> indices, std::span<const Vertex> vertices,
+                                       std::span<const uint32_t> positionIds, const TriangleAdjacency& adjacency) {
+        const auto& target = vertices[collapse.to].pos;
+        std::size_t sharedNeighbours = 0;
+        for (auto triangle : adjacency.get(collapse.from)) {
+            const auto* corners = &indices[triangle * 3];
+            if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to)
+                continue;
+
+            // A triangle that touches another wedge of the target would become degenerate
+            // without being removed.
+            for (std::size_t j = 0; j < 3; ++j)
+                if (positionIds[corners[j]] == positionIds[collapse.to])
+                    return false;
+
+            glm::fvec3 before[3], after[3];
+            for (std::size_t j = 0; j < 3; ++j) {
+                const auto& position = corners[j] == collapse.from ? target : vertices[corners[j]].pos;
+                before[j] = glm::fvec3(vertices[corners[j]].pos.x, vertices[corners[j]].pos.y, vertices[corners[j]].pos.z);
+                after[j] = glm::fvec3(position.x, position.y, position.z);
+            }
+            auto normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+            auto normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+            if (glm::dot(normalBefore, normalAfter) <= 0.25f * glm::length(normalBefore) * glm::length(normalAfter))
+                return false;
+
+            // Count the neighbours of from that are also neighbours of to.
+            for (std::size_t j = 0; j < 3; ++j) {
+                auto neighbour = corners[j];
+                if (neighbour == collapse.from)
+                    continue;
+                for (auto otherTriangle : adjacency.get(collapse.to)) {
+                    const auto* other = &indices[otherTriangle * 3];
+                    if (other[0] == neighbour || other[1] == neighbour || other[2] == neighbour) {
+                        ++sharedNeighbours;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // On a manifold, only the two vertices opposite of the collapsed edge are neighbours of
+        // both, and each of them is part of exactly one of the triangles we looked at.
+        return sharedNeighbours <= 2;
+    }
+} // namespace krypton::assets::processing
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+
+auto kap::simplify(std::span<const uint32_t> indices, std::span<const ka::Vertex> vertices, std::size_t targetTriangleCount,
+                   const SimplifyOptions& options, float& error) -> std::vector<uint32_t> {
+    ZoneScoped;
+    std::vector<uint32_t> result(indices.begin(), indices.end());
+    error = 0.0f;
+    if (result.size() / 3 <= targetTriangleCount)
+        return result;
+
+    auto positionIds = getPositionIds(vertices);
+    auto locked = getLockedVertices(indices, positionIds);
+
+    std::vector<Quadric> quadrics(vertices.size());
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        const auto& p0 = vertices[indices[i + 0]].pos;
+        const auto& p1 = vertices[indices[i + 1]].pos;
+        const auto& p2 = vertices[indices[i + 2]].pos;
+        auto normal = glm::cross(glm::fvec3(p1.x - p0.x, p1.y - p0.y, p1.z - p0.z), glm::fvec3(p2.x - p0.x, p2.y - p0.y, p2.z - p0.z));
+        auto length = glm::length(normal);
+        if (length <= 0.0f)
+            continue;
+        normal = normal / length;
+        auto distance = -(normal.x * p0.x + normal.y * p0.y + normal.z * p0.z);
+        for (std::size_t j = 0; j < 3; ++j)
+            quadrics[indices[i + j]].addPlane(normal.x, normal.y, normal.z, distance, length * 0.5);
+    }
+
+    auto getCost = [&](uint32_t from, uint32_t to) -> float {
+        auto combined = quadrics[from];
+        combined += quadrics[to];
+        const auto& target = vertices[to].pos;
+        auto cost = static_cast<float>(combined.evaluate(target.x, target.y, target.z));
+
+        // Half-edge collapses replace the attributes of from with those of to, which we weigh
+        // with the size of the area they affect.
+        const auto& a = vertices[from];
+        const auto& b = vertices[to];
+        auto attributeDistance = getSquaredDistance(a.normals, b.normals) + (a.uv.x - b.uv.x) * (a.uv.x - b.uv.x) +
+                                 (a.uv.y - b.uv.y) * (a.uv.y - b.uv.y);
+        return cost + options.attributeWeight * attributeDistance * getSquaredDistance(a.pos, b.pos);
+    };
+
+    const auto maxCost = options.maxError * options.maxError;
+    auto resultCost = 0.0f;
+    TriangleAdjacency adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<uint8_t> touched(vertices.size());
+    std::vector<uint32_t> remap(vertices.size());
+
+    // We collapse in passes. Each pass sorts all edges by their cost and performs the cheapest
+    // collapses that don't touch the same triangles, which is far cheaper than updating a
+    // priority queue after every collapse and gives nearly the same result.
+    while (result.size() / 3 > targetTriangleCount) {
+        adjacency.build(result, vertices.size());
+
+        collapses.clear();
+        for (std::size_t i = 0; i < result.size(); i += 3) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                auto a = result[i + j], b = result[i + (j + 1) % 3];
+                // Interior edges appear once in each direction, so we only take one of them.
+                if (a > b || (locked[a] && locked[b]))
+                    continue;
+                Collapse collapse = { .from = a, .to = b, .cost = locked[a] ? std::numeric_limits<float>::max() : getCost(a, b) };
+                if (!locked[b]) {
+                    auto reverseCost = getCost(b, a);
+                    if (reverseCost < collapse.cost)
+                        collapse = { .from = b, .to = a, .cost = reverseCost };
+                }
+                collapses.push_back(collapse);
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+            if (lhs.cost != rhs.cost)
+                return lhs.cost < rhs.cost;
+            return lhs.from != rhs.from ? lhs.from < rhs.from : lhs.to < rhs.to;
+        });
+
+        std::fill(touched.begin(), touched.end(), 0);
+        std::iota(remap.begin(), remap.end(), 0U);
+        auto removableTriangles = result.size() / 3 - targetTriangleCount;
+        std::size_t removedTriangles = 0;
+        std::size_t collapseCount = 0;
+        for (const auto& collapse : collapses) {
+            if (collapse.cost > maxCost || removedTriangles >= removableTriangles)
+                break;
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+            if (!isCollapseValid(collapse, result, vertices, positionIds, adjacency))
+                continue;
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            resultCost = std::max(resultCost, collapse.cost);
+            ++collapseCount;
+
+            for (auto triangle : adjacency.get(collapse.from)) {
+                const auto* corners = &result[triangle * 3];
+                for (std::size_t j = 0; j < 3; ++j)
+                    touched[corners[j]] = 1;
+                if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to)
+                    ++removedTriangles;
+            }
+        }
+
+        if (collapseCount == 0)
+            break;
+
+        std::size_t write = 0;
+        for (std::size_t i = 0; i < result.size(); i += 3) {
+            auto a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    error = std::sqrt(resultCost);
+    return result;
+}
+
+void kap::generateLods(ka::Primitive& primitive, const LodOptions& options) {
+    ZoneScoped;
+    primitive.lods.clear();
+    if (primitive.vertexLayout != ka::VertexLayout::Full || primitive.indices.empty() || !primitive.isTriangleList())
+        return;
+
+    auto current = primitive.indices.toUint32();
+    const auto triangleCount = current.size() / 3;
+    auto error = 0.0f;
+    for (auto ratio : options.triangleRatios) {
+        auto targetTriangleCount = static_cast<std::size_t>(static_cast<float>(triangleCount) * ratio);
+
+        // As every level is simplified from the previous one, the errors add up.
+        auto levelOptions = options.simplify;
+        levelOptions.maxError = std::max(options.simplify.maxError - error, 0.0f);
+        auto levelError = 0.0f;
+        auto simplified = simplify(current, primitive.vertices, targetTriangleCount, levelOptions, levelError);
+        if (simplified.empty() || simplified.size() >= current.size())
+            break;
+
+        error += levelError;
+        current = std::move(simplified);
+
+        std::vector<uint32_t> optimized(current.size());
+        optimizeVertexCache(current, primitive.vertices.size(), optimized);
+        auto& lod = primitive.lods.emplace_back();
+        lod.indices.assign(optimized, primitive.indices.getType());
+        lod.error = error;
+    }
+}
+
+void kap::generateLods(std::span<const std::shared_ptr<ka::Mesh>> meshes, const LodOptions& options) {
+    ZoneScoped;
+    std::vector<ka::Primitive*> primitives;
+    for (const auto& mesh : meshes)
+        for (auto& primitive : mesh->primitives)
+            primitives.push_back(&primitive);
+
+    krypton::threading::Scheduler::getInstance().parallelFor(primitives.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            generateLods(*primitives[i], options);
+    });
+}
+
+auto kap::selectLod(const ka::Primitive& primitive, float errorScale, float maxError) noexcept -> std::size_t {
+    std::size_t level = 0;
+    for (std::size_t i = 0; i < primitive.lods.size(); ++i) {
+        if (primitive.lods[i].error * errorScale > maxError)
+            break;
+        level = i + 1;
+    }
+    return level;
+}
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <Tracy.hpp>
+
+#include <assets/processing/meshlet_builder.hpp>
+#include <assets/processing/triangle_adjacency.hpp>
+#include <util/assert.hpp>
+#include <util/scheduler.hpp>
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+
+auto kap::buildMeshlets(std::span<const uint32_t> indices, std::size_t vertexCount, const MeshletOptions& options) -> ka::MeshletBuffer {
+    ZoneScoped;
+    VERIFY(options.maxVertices >= 3 && options.maxVertices < 0xFF && options.maxTriangles >= 1);
+    constexpr auto npos = std::numeric_limits<std::size_t>::max();
+    constexpr uint8_t notInMeshlet = 0xFF;
+
+    ka::MeshletBuffer buffer;
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return buffer;
+
+    TriangleAdjacency adjacency;
+    adjacency.build(indices, vertexCount);
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint8_t> localIndices(vertexCount, notInMeshlet);
+    ka::Meshlet meshlet = {};
+
+    auto countNewVertices = [&](std::size_t triangle) -> uint32_t {
+        const auto* corners = &indices[triangle * 3];
+        uint32_t count = 0;
+        for (std::size_t i = 0; i < 3; ++i) {
+            bool duplicate = (i > 0 && corners[i] == corners[0]) || (i > 1 && corners[i] == corners[1]);
+            if (localIndices[corners[i]] == notInMeshlet && !duplicate)
+                ++count;
+        }
+        return count;
+    };
+
+    auto finishMeshlet = [&]() {
+        for (auto i = meshlet.vertexOffset; i < meshlet.vertexOffset + meshlet.vertexCount; ++i)
+            localIndices[buffer.vertices[i]] = notInMeshlet;
+
+        // Keep the triangles of the next meshlet aligned, so that they can be read as uint32s.
+        buffer.triangles.resize((buffer.triangles.size() + 3) & ~std::size_t(3), 0);
+        buffer.meshlets.push_back(meshlet);
+        meshlet = {
+            .vertexOffset = static_cast<uint32_t>(buffer.vertices.size()),
+            .triangleOffset = static_cast<uint32_t>(buffer.triangles.size()),
+        };
+    };
+
+    std::size_t seedCursor = 0;
+    for (std::size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        // Find the triangle next to the meshlet that adds the fewest vertices. If there is none,
+        // we continue with the next triangle in index order, which is usually close by as well.
+        auto best = npos;
+        uint32_t bestNewVertices = 4;
+        for (auto i = meshlet.vertexOffset; i < meshlet.vertexOffset + meshlet.vertexCount; ++i) {
+            for (auto triangle : adjacency.get(buffer.vertices[i])) {
+                if (emitted[triangle])
+                    continue;
+                auto newVertices = countNewVertices(triangle);
+                if (newVertices < bestNewVertices || (newVertices == bestNewVertices && triangle < best)) {
+                    best = triangle;
+                    bestNewVertices = newVertices;
+                }
+            }
+        }
+        if (best == npos) {
+            while (emitted[seedCursor])
+                ++seedCursor;
+            best = seedCursor;
+            bestNewVertices = countNewVertices(best);
+        }
+
+        if (meshlet.vertexCount + bestNewVertices > options.maxVertices || meshlet.triangleCount + 1 > options.maxTriangles) {
+            finishMeshlet();
+            bestNewVertices = countNewVertices(best);
+        }
+
+        const auto* corners = &indices[best * 3];
+        for (std::size_t i = 0; i < 3; ++i) {
+            auto& local = localIndices[corners[i]];
+            if (local == notInMeshlet) {
+                local = static_cast<uint8_t>(meshlet.vertexCount++);
+                buffer.vertices.push_back(corners[i]);
+            }
+            buffer.triangles.push_back(local);
+        }
+        ++meshlet.triangleCount;
+        emitted[best] = 1;
+    }
+
+    finishMeshlet();
+    return buffer;
+}
+
+void kap::computeMeshletBounds(ka::MeshletBuffer& buffer, std::span<const ka::Vertex> vertices) {
+    ZoneScoped;
+    buffer.bounds.resize(buffer.meshlets.size());
+    std::vector<glm::fvec3> positions;
+    std::vector<glm::fvec3> normals;
+
+    for (std::size_t m = 0; m < buffer.meshlets.size(); ++m) {
+        const auto& meshlet = buffer.meshlets[m];
+        auto& bounds = buffer.bounds[m];
+        bounds = {};
+
+        positions.resize(meshlet.vertexCount);
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            const auto& position = vertices[buffer.vertices[meshlet.vertexOffset + i]].pos;
+            positions[i] = glm::fvec3(position.x, position.y, position.z);
+        }
+        if (positions.empty())
+            continue;
+
+        // Ritter's bounding sphere: start with the sphere around two distant points and grow it
+        // to include every point that is still outside.
+        auto findFarthest = [&](const glm::fvec3& from) -> glm::fvec3 {
+            return *std::max_element(positions.begin(), positions.end(), [&](const glm::fvec3& lhs, const glm::fvec3& rhs) {
+                return glm::dot(lhs - from, lhs - from) < glm::dot(rhs - from, rhs - from);
+            });
+        };
+        auto first = findFarthest(positions[0]);
+        auto second = findFarthest(first);
+        auto center = (first + second) * 0.5f;
+        auto radius = glm::length(second - first) * 0.5f;
+        for (const auto& position : positions) {
+            auto distance = glm::length(position - center);
+            if (distance > radius) {
+                auto newRadius = (radius + distance) * 0.5f;
+                center = center + (position - center) * ((newRadius - radius) / distance);
+                radius = newRadius;
+            }
+        }
+
+        bounds.center[0] = center.x;
+        bounds.center[1] = center.y;
+        bounds.center[2] = center.z;
+        bounds.radius = radius;
+        bounds.coneApex[0] = center.x;
+        bounds.coneApex[1] = center.y;
+        bounds.coneApex[2] = center.z;
+
+        // The cone axis is the average triangle normal, and its angle covers every normal.
+        normals.clear();
+        auto axis = glm::fvec3(0.0f);
+        const auto* triangles = &buffer.triangles[meshlet.triangleOffset];
+        for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+            const auto& p0 = positions[triangles[i * 3 + 0]];
+            const auto& p1 = positions[triangles[i * 3 + 1]];
+            const auto& p2 = positions[triangles[i * 3 + 2]];
+            auto normal = glm::cross(p1 - p0, p2 - p0);
+            auto length = glm::length(normal);
+            normals.push_back(length > 0.0f ? normal / length : glm::fvec3(0.0f));
+            if (length > 0.0f)
+                axis = axis + normals.back();
+        }
+
+        auto axisLength = glm::length(axis);
+        if (axisLength <= 0.0f)
+            continue;
+        axis = axis / axisLength;
+        bounds.coneAxis[0] = axis.x;
+        bounds.coneAxis[1] = axis.y;
+        bounds.coneAxis[2] = axis.z;
+
+        auto minDot = 1.0f;
+        for (const auto& normal : normals)
+            if (glm::dot(normal, normal) > 0.0f)
+                minDot = std::min(minDot, glm::dot(normal, axis));
+
+        // Cones wider than about 84 degrees are hardly ever culled, so we don't bother.
+        if (minDot <= 0.1f)
+            continue;
+
+        // Move the apex back along the axis until it is behind the plane of every triangle.
+        auto maxOffset = 0.0f;
+        for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+            const auto& normal = normals[i];
+            if (glm::dot(normal, normal) <= 0.0f)
+                continue;
+            auto offset = glm::dot(center - positions[triangles[i * 3]], normal) / glm::dot(axis, normal);
+            maxOffset = std::max(maxOffset, offset);
+        }
+
+        auto apex = center - axis * maxOffset;
+        bounds.coneApex[0] = apex.x;
+        bounds.coneApex[1] = apex.y;
+        bounds.coneApex[2] = apex.z;
+        bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+void kap::buildMeshlets(ka::Primitive& primitive, const MeshletOptions& options) {
+    ZoneScoped;
+    primitive.meshlets = {};
+    if (primitive.vertexLayout != ka::VertexLayout::Full || primitive.indices.empty() || !primitive.isTriangleList())
+        return;
+
+    auto indices = primitive.indices.toUint32();
+    primitive.meshlets = buildMeshlets(indices, primitive.vertices.size(), options);
+    computeMeshletBounds(primitive.meshlets, primitive.vertices);
+}
+
+void kap::buildMeshlets(std::span<const std::shared_ptr<ka::Mesh>> meshes, const MeshletOptions& options) {
+    ZoneScoped;
+    std::vector<ka::Primitive*> primitives;
+    for (const auto& mesh : meshes)
+        for (auto& primitive : mesh->primitives)
+            primitives.push_back(&primitive);
+
+    krypton::threading::Scheduler::getInstance().parallelFor(primitives.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            buildMeshlets(*primitives[i], options);
+    });
+}
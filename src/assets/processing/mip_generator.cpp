@@ -0,0 +1,59 @@
+#include <Tracy.hpp>
+
+#include <assets/processing/mip_generator.hpp>
+#include <util/mip_filter.hpp>
+#include <util/scheduler.hpp>
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+
+namespace krypton::assets::processing {
+    // Rows of the destination level per task. Small levels are computed by a single task.
+    constexpr uint32_t mipRowChunkSize = 32;
+} // namespace krypton::assets::processing
+
+bool kap::generateMips(ka::Texture& texture) {
+    ZoneScoped;
+    if (texture.mipLevels > 1 || texture.width == 0 || texture.height == 0 || texture.channels == 0)
+        return false;
+    if (texture.bitsPerPixel != 8 && texture.bitsPerPixel != 16)
+        return false;
+
+    const krypton::util::PixelFormat format = {
+        .channels = texture.channels,
+        .bytesPerChannel = texture.bitsPerPixel / 8U,
+        .srgb = texture.srgb,
+    };
+    const auto pixelSize = format.getPixelSize();
+    if (texture.pixels.size() != static_cast<std::size_t>(texture.width) * texture.height * pixelSize)
+        return false;
+
+    const auto levelCount = krypton::util::getMipLevelCount(texture.width, texture.height);
+    texture.pixels.resize(krypton::util::getMipChainSize(texture.width, texture.height, levelCount, pixelSize));
+
+    std::size_t offset = 0;
+    for (uint32_t level = 1; level < levelCount; ++level) {
+        const auto width = krypton::util::getMipExtent(texture.width, level - 1);
+        const auto height = krypton::util::getMipExtent(texture.height, level - 1);
+        const auto srcSize = static_cast<std::size_t>(width) * height * pixelSize;
+        auto src = std::span<const std::byte>(texture.pixels).subspan(offset, srcSize);
+        auto dst = std::span(texture.pixels).subspan(offset + srcSize);
+
+        const auto rowCount = krypton::util::getMipExtent(height, 1);
+        krypton::threading::Scheduler::getInstance().parallelFor(rowCount, mipRowChunkSize, [&](std::size_t begin, std::size_t end) {
+            krypton::util::downsampleImage(src, width, height, format, dst, static_cast<uint32_t>(begin),
+                                           static_cast<uint32_t>(end - begin));
+        });
+        offset += srcSize;
+    }
+    texture.mipLevels = levelCount;
+    return true;
+}
+
+void kap::generateMips(std::span<ka::Texture> textures) {
+    ZoneScoped;
+    krypton::threading::Scheduler::getInstance().parallelFor(textures.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            generateMips(textures[i]);
+    });
+}
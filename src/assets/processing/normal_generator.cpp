@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include <Tracy.hpp>
+
+#include <assets/processing/normal_generator.hpp>
+#include <assets/processing/triangle_adjacency.hpp>
+#include <util/numeric_conversion.hpp>
+#include <util/scheduler.hpp>
+
+namespace krypton::assets::processing {
+    // Big enough that the scheduling overhead is negligible, small enough to split large meshes.
+    constexpr std::size_t generatorChunkSize = 16384;
+
+    /**
+     * Per-triangle data, with every component in its own array so that the loops writing and
+     * reading them can be vectorized.
+     */
+    struct TriangleFrames final {
+        std::vector<float> normalX, normalY, normalZ;
+        std::vector<float> tangentX, tangentY, tangentZ;
+        std::vector<float> bitangentX, bitangentY, bitangentZ;
+        // The angle of every corner, in the same order as the indices.
+        std::vector<float> cornerAngles;
+    };
+
+    [[nodiscard]] auto toVec3(const glm::fvec4& vector) noexcept -> glm::fvec3 {
+        return glm::fvec3(vector.x, vector.y, vector.z);
+    }
+
+    [[nodiscard]] auto getCornerAngle(const glm::fvec3& corner, const glm::fvec3& a, const glm::fvec3& b) noexcept -> float {
+        auto edgeA = a - corner;
+        auto edgeB = b - corner;
+        auto lengths = glm::length(edgeA) * glm::length(edgeB);
+        if (lengths <= 0.0f)
+            return 0.0f;
+        return std::acos(std::clamp(glm::dot(edgeA, edgeB) / lengths, -1.0f, 1.0f));
+    }
+
+    [[nodiscard]] auto normalizeOr(const glm::fvec3& vector, const glm::fvec3& fallback) noexcept -> glm::fvec3 {
+        auto length = glm::length(vector);
+        return length > 0.0f ? vector / length : fallback;
+    }
+
+    void computeTriangleFrames(std::span<const uint32_t> indices, std::span<const Vertex> vertices, bool withTangents,
+                               TriangleFrames& frames) {
+        ZoneScoped;
+        const auto triangleCount = indices.size() / 3;
+        frames.normalX.resize(triangleCount);
+        frames.normalY.resize(triangleCount);
+        frames.normalZ.resize(triangleCount);
+        frames.cornerAngles.resize(triangleCount * 3);
+        if (withTangents) {
+            frames.tangentX.resize(triangleCount);
+            frames.tangentY.resize(triangleCount);
+            frames.tangentZ.resize(triangleCount);
+            frames.bitangentX.resize(triangleCount);
+            frames.bitangentY.resize(triangleCount);
+            frames.bitangentZ.resize(triangleCount);
+        }
+
+        krypton::threading::Scheduler::getInstance().parallelFor(triangleCount, generatorChunkSize, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const auto& v0 = vertices[indices[i * 3 + 0]];
+                const auto& v1 = vertices[indices[i * 3 + 1]];
+                const auto& v2 = vertices[indices[i * 3 + 2]];
+                auto p0 = toVec3(v0.pos), p1 = toVec3(v1.pos), p2 = toVec3(v2.pos);
+
+                auto edge1 = p1 - p0;
+                auto edge2 = p2 - p0;
+                auto normal = normalizeOr(glm::cross(edge1, edge2), glm::fvec3(0.0f));
+                frames.normalX[i] = normal.x;
+                frames.normalY[i] = normal.y;
+                frames.normalZ[i] = normal.z;
+
+                frames.cornerAngles[i * 3 + 0] = getCornerAngle(p0, p1, p2);
+                frames.cornerAngles[i * 3 + 1] = getCornerAngle(p1, p2, p0);
+                frames.cornerAngles[i * 3 + 2] = getCornerAngle(p2, p0, p1);
+
+                if (!withTangents)
+                    continue;
+
+                // Solve edge = duv.x * tangent + duv.y * bitangent for both edges. Triangles with
+                // degenerate UVs don't contribute.
+                auto duv1 = v1.uv - v0.uv;
+                auto duv2 = v2.uv - v0.uv;
+                auto determinant = duv1.x * duv2.y - duv2.x * duv1.y;
+                auto tangent = glm::fvec3(0.0f), bitangent = glm::fvec3(0.0f);
+                if (std::abs(determinant) > 0.0f) {
+                    tangent = normalizeOr((edge1 * duv2.y - edge2 * duv1.y) / determinant, glm::fvec3(0.0f));
+                    bitangent = normalizeOr((edge2 * duv1.x - edge1 * duv2.x) / determinant, glm::fvec3(0.0f));
+                }
+                frames.tangentX[i] = tangent.x;
+                frames.tangentY[i] = tangent.y;
+                frames.tangentZ[i] = tangent.z;
+                frames.bitangentX[i] = bitangent.x;
+                frames.bitangentY[i] = bitangent.y;
+                frames.bitangentZ[i] = bitangent.z;
+            }
+        });
+    }
+
+    /**
+     * Duplicates every vertex that is shared by triangles with a positive and a negative UV
+     * determinant, and points the corners of the negative triangles at the copies. Triangles with
+     * degenerate UVs have no handedness and keep their vertices. Returns the vertex each vertex
+     * of the new buffer is a copy of, or nothing if no vertex had to be split.
+     */
+    [[nodiscard]] auto splitMirroredVertices(std::span<uint32_t> indices, std::span<const Vertex> vertices) -> std::vector<uint32_t> {
+        ZoneScoped;
+        constexpr uint8_t rightHanded = 1, leftHanded = 2;
+        const auto triangleCount = indices.size() / 3;
+        std::vector<uint8_t> triangleHandedness(triangleCount, 0);
+        std::vector<uint8_t> vertexHandedness(vertices.size(), 0);
+        for (std::size_t i = 0; i < triangleCount; ++i) {
+            const auto* triangle = &indices[i * 3];
+            auto duv1 = vertices[triangle[1]].uv - vertices[triangle[0]].uv;
+            auto duv2 = vertices[triangle[2]].uv - vertices[triangle[0]].uv;
+            auto determinant = duv1.x * duv2.y - duv2.x * duv1.y;
+            if (determinant == 0.0f)
+                continue;
+            triangleHandedness[i] = determinant > 0.0f ? rightHanded : leftHanded;
+            for (std::size_t j = 0; j < 3; ++j)
+                vertexHandedness[triangle[j]] |= triangleHandedness[i];
+        }
+
+        // The right-handed triangles keep the original vertex.
+        std::vector<uint32_t> sourceVertices;
+        std::vector<uint32_t> mirroredVertices(vertices.size(), UINT32_MAX);
+        for (uint32_t vertex = 0; vertex < vertices.size(); ++vertex) {
+            if (vertexHandedness[vertex] != (rightHanded | leftHanded))
+                continue;
+            mirroredVertices[vertex] = static_cast<uint32_t>(vertices.size() + sourceVertices.size());
+            sourceVertices.push_back(vertex);
+        }
+        if (sourceVertices.empty())
+            return {};
+
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            if (triangleHandedness[i / 3] == leftHanded && mirroredVertices[indices[i]] != UINT32_MAX)
+                indices[i] = mirroredVertices[indices[i]];
+
+        std::vector<uint32_t> result(vertices.size());
+        std::iota(result.begin(), result.end(), 0U);
+        result.insert(result.end(), sourceVertices.begin(), sourceVertices.end());
+        return result;
+    }
+} // namespace krypton::assets::processing
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+
+void kap::generateSmoothNormals(std::span<const uint32_t> indices, std::span<ka::Vertex> vertices) {
+    ZoneScoped;
+    TriangleFrames frames;
+    computeTriangleFrames(indices, vertices, false, frames);
+
+    // The normals are accumulated per position, so the adjacency is built over position ids.
+    auto positionIds = getPositionIds(vertices);
+    std::vector<uint32_t> positionIndices(indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i)
+        positionIndices[i] = positionIds[indices[i]];
+
+    TriangleAdjacency adjacency;
+    adjacency.build(positionIndices, vertices.size());
+
+    auto& scheduler = krypton::threading::Scheduler::getInstance();
+    scheduler.parallelFor(vertices.size(), generatorChunkSize, [&](std::size_t begin, std::size_t end) {
+        for (auto vertex = static_cast<uint32_t>(begin); vertex < end; ++vertex) {
+            if (positionIds[vertex] != vertex)
+                continue;
+
+            auto normal = glm::fvec3(0.0f);
+            for (auto triangle : adjacency.get(vertex)) {
+                auto weight = 0.0f;
+                for (std::size_t j = 0; j < 3; ++j)
+                    if (positionIndices[triangle * 3 + j] == vertex)
+                        weight += frames.cornerAngles[triangle * 3 + j];
+                normal = normal + glm::fvec3(frames.normalX[triangle], frames.normalY[triangle], frames.normalZ[triangle]) * weight;
+            }
+            normal = normalizeOr(normal, glm::fvec3(0.0f, 0.0f, 1.0f));
+            vertices[vertex].normals = glm::fvec4(normal, 0.0f);
+        }
+    });
+
+    // Every position id is the index of the first vertex at that position, which now holds the
+    // normal for all of them.
+    scheduler.parallelFor(vertices.size(), generatorChunkSize, [&](std::size_t begin, std::size_t end) {
+        for (auto vertex = begin; vertex < end; ++vertex)
+            if (positionIds[vertex] != vertex)
+                vertices[vertex].normals = vertices[positionIds[vertex]].normals;
+    });
+}
+
+void kap::generateTangents(std::span<const uint32_t> indices, std::span<const ka::Vertex> vertices, std::span<ka::CompactTangent> tangents) {
+    ZoneScoped;
+    TriangleFrames frames;
+    computeTriangleFrames(indices, vertices, true, frames);
+
+    TriangleAdjacency adjacency;
+    adjacency.build(indices, vertices.size());
+
+    krypton::threading::Scheduler::getInstance().parallelFor(vertices.size(), generatorChunkSize, [&](std::size_t begin, std::size_t end) {
+        for (auto vertex = static_cast<uint32_t>(begin); vertex < end; ++vertex) {
+            auto normal = normalizeOr(toVec3(vertices[vertex].normals), glm::fvec3(0.0f, 0.0f, 1.0f));
+            auto tangent = glm::fvec3(0.0f), bitangent = glm::fvec3(0.0f);
+
+            // Project every triangle's frame into the tangent plane of the vertex before
+            // weighing it, so that only the direction within that plane matters.
+            for (auto triangle : adjacency.get(vertex)) {
+                auto weight = 0.0f;
+                for (std::size_t j = 0; j < 3; ++j)
+                    if (indices[triangle * 3 + j] == vertex)
+                        weight += frames.cornerAngles[triangle * 3 + j];
+
+                auto triangleTangent = glm::fvec3(frames.tangentX[triangle], frames.tangentY[triangle], frames.tangentZ[triangle]);
+                auto triangleBitangent = glm::fvec3(frames.bitangentX[triangle], frames.bitangentY[triangle], frames.bitangentZ[triangle]);
+                triangleTangent = normalizeOr(triangleTangent - normal * glm::dot(normal, triangleTangent), glm::fvec3(0.0f));
+                triangleBitangent = normalizeOr(triangleBitangent - normal * glm::dot(normal, triangleBitangent), glm::fvec3(0.0f));
+                tangent = tangent + triangleTangent * weight;
+                bitangent = bitangent + triangleBitangent * weight;
+            }
+
+            // Without usable UVs, any direction perpendicular to the normal will do.
+            auto fallback = std::abs(normal.x) < 0.9f ? glm::fvec3(1.0f, 0.0f, 0.0f) : glm::fvec3(0.0f, 1.0f, 0.0f);
+            fallback = glm::normalize(fallback - normal * glm::dot(normal, fallback));
+            tangent = normalizeOr(tangent - normal * glm::dot(normal, tangent), fallback);
+
+            auto& encoded = tangents[vertex].tangent;
+            encoded[0] = krypton::util::floatToSnorm16(tangent.x);
+            encoded[1] = krypton::util::floatToSnorm16(tangent.y);
+            encoded[2] = krypton::util::floatToSnorm16(tangent.z);
+            encoded[3] = glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -32767 : 32767;
+        }
+    });
+}
+
+void kap::generateNormals(ka::Primitive& primitive, NormalGeneration mode) {
+    ZoneScoped;
+    if (primitive.vertexLayout != ka::VertexLayout::Full || !primitive.isTriangleList())
+        return;
+
+    auto indices = primitive.indices.toUint32();
+    if (mode == NormalGeneration::Smooth) {
+        generateSmoothNormals(indices, primitive.vertices);
+        return;
+    }
+
+    // Flat normals need every corner to have its own vertex.
+    TriangleFrames frames;
+    computeTriangleFrames(indices, primitive.vertices, false, frames);
+
+    const bool hasColors = primitive.colors.size() == primitive.vertices.size();
+    const bool hasTangents = primitive.tangents.size() == primitive.vertices.size();
+    std::vector<ka::Vertex> vertices(indices.size());
+    std::vector<uint32_t> colors(hasColors ? indices.size() : 0);
+    std::vector<ka::CompactTangent> tangents(hasTangents ? indices.size() : 0);
+    krypton::threading::Scheduler::getInstance().parallelFor(indices.size(), generatorChunkSize, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            auto triangle = i / 3;
+            vertices[i] = primitive.vertices[indices[i]];
+            vertices[i].normals = glm::fvec4(frames.normalX[triangle], frames.normalY[triangle], frames.normalZ[triangle], 0.0f);
+            if (hasColors)
+                colors[i] = primitive.colors[indices[i]];
+            if (hasTangents)
+                tangents[i] = primitive.tangents[indices[i]];
+        }
+    });
+
+    auto allowUint8 = primitive.indices.getType() == ka::IndexType::Uint8;
+    std::vector<uint32_t> newIndices(indices.size());
+    std::iota(newIndices.begin(), newIndices.end(), 0U);
+    primitive.vertices = std::move(vertices);
+    if (hasColors)
+        primitive.colors = std::move(colors);
+    if (hasTangents)
+        primitive.tangents = std::move(tangents);
+    ka::gatherDeformation(primitive, indices, primitive);
+    primitive.indices.assign(newIndices, ka::getNarrowestIndexType(primitive.vertices.size(), allowUint8));
+}
+
+void kap::generateTangents(ka::Primitive& primitive) {
+    ZoneScoped;
+    if (primitive.vertexLayout != ka::VertexLayout::Full || !primitive.isTriangleList())
+        return;
+
+    auto indices = primitive.indices.toUint32();
+    auto sourceVertices = splitMirroredVertices(indices, primitive.vertices);
+    if (!sourceVertices.empty()) {
+        const bool hasColors = primitive.colors.size() == primitive.vertices.size();
+        std::vector<ka::Vertex> vertices(sourceVertices.size());
+        std::vector<uint32_t> colors(hasColors ? sourceVertices.size() : 0);
+        for (std::size_t i = 0; i < sourceVertices.size(); ++i) {
+            vertices[i] = primitive.vertices[sourceVertices[i]];
+            if (hasColors)
+                colors[i] = primitive.colors[sourceVertices[i]];
+        }
+
+        auto allowUint8 = primitive.indices.getType() == ka::IndexType::Uint8;
+        primitive.vertices = std::move(vertices);
+        if (hasColors)
+            primitive.colors = std::move(colors);
+        ka::gatherDeformation(primitive, sourceVertices, primitive);
+        primitive.indices.assign(indices, ka::getNarrowestIndexType(primitive.vertices.size(), allowUint8));
+    }
+
+    primitive.tangents.resize(primitive.vertices.size());
+    generateTangents(indices, primitive.vertices, primitive.tangents);
+    primitive.hasTangents = true;
+}
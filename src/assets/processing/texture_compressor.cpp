@@ -0,0 +1,93 @@
+#include <algorithm>
+
+#include <Tracy.hpp>
+
+#include <assets/processing/texture_compressor.hpp>
+#include <util/mip_filter.hpp>
+#include <util/scheduler.hpp>
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+namespace ku = krypton::util;
+
+namespace krypton::assets::processing {
+    // Block rows per task. A row of a 4K texture has 1024 blocks.
+    constexpr uint32_t compressionRowChunkSize = 4;
+
+    [[nodiscard]] auto getTextureLevelCount(const ka::Texture& texture) noexcept -> uint32_t {
+        return std::max(texture.mipLevels, 1U);
+    }
+
+    [[nodiscard]] bool hasTransparentPixels(const ka::Texture& texture) noexcept {
+        const auto pixelCount = static_cast<std::size_t>(texture.width) * texture.height;
+        for (std::size_t i = 0; i < pixelCount; ++i)
+            if (texture.pixels[i * 4 + 3] != std::byte(0xFF))
+                return true;
+        return false;
+    }
+} // namespace krypton::assets::processing
+
+auto kap::selectBlockCompression(const ka::Texture& texture, const TextureCompressionOptions& options) -> ku::BlockCompression {
+    ZoneScoped;
+    if (texture.compression != ku::BlockCompression::None || texture.channels != 4 || texture.bitsPerPixel != 8)
+        return ku::BlockCompression::None;
+    if (texture.width == 0 || texture.height == 0)
+        return ku::BlockCompression::None;
+
+    switch (texture.role) {
+        case TextureRole::Normal:
+            return ku::BlockCompression::BC5;
+        case TextureRole::Occlusion:
+            return ku::BlockCompression::BC4;
+        case TextureRole::MetallicRoughness:
+            return options.useBc7 ? ku::BlockCompression::BC7 : ku::BlockCompression::BC1;
+        case TextureRole::Color:
+            if (options.useBc7)
+                return ku::BlockCompression::BC7;
+            return hasTransparentPixels(texture) ? ku::BlockCompression::BC3 : ku::BlockCompression::BC1;
+    }
+    return ku::BlockCompression::None;
+}
+
+bool kap::compressTexture(ka::Texture& texture, ku::BlockCompression compression) {
+    ZoneScoped;
+    if (compression == ku::BlockCompression::None || texture.compression != ku::BlockCompression::None)
+        return false;
+    if (texture.channels != 4 || texture.bitsPerPixel != 8)
+        return false;
+
+    const auto levelCount = getTextureLevelCount(texture);
+    if (texture.pixels.size() != ku::getMipChainSize(texture.width, texture.height, levelCount, 4))
+        return false;
+
+    ka::PixelBuffer compressed;
+    compressed.resize(ku::getCompressedMipChainSize(texture.width, texture.height, levelCount, compression));
+    std::size_t srcOffset = 0, dstOffset = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const auto width = ku::getMipExtent(texture.width, level);
+        const auto height = ku::getMipExtent(texture.height, level);
+        const auto srcSize = static_cast<std::size_t>(width) * height * 4;
+        const auto dstSize = ku::getCompressedImageSize(width, height, compression);
+        auto src = std::span<const std::byte>(texture.pixels).subspan(srcOffset, srcSize);
+        auto dst = std::span(compressed).subspan(dstOffset, dstSize);
+
+        krypton::threading::Scheduler::getInstance().parallelFor(
+            ku::getCompressedBlockCount(height), compressionRowChunkSize, [&](std::size_t begin, std::size_t end) {
+                ku::compressImage(src, width, height, compression, dst, static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin));
+            });
+        srcOffset += srcSize;
+        dstOffset += dstSize;
+    }
+
+    texture.pixels = std::move(compressed);
+    texture.compression = compression;
+    return true;
+}
+
+void kap::compressTextures(std::span<ka::Texture> textures, const TextureCompressionOptions& options) {
+    ZoneScoped;
+    krypton::threading::Scheduler::getInstance().parallelFor(textures.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            compressTexture(textures[i], selectBlockCompression(textures[i], options));
+    });
+}
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <filesystem>
 #include <vector>
 
@@ -21,6 +22,8 @@
 #include <rapi/vertex_descriptor.hpp>
 #include <rapi/window.hpp>
 #include <shaders/shaders.hpp>
+#include <util/cpu_features.hpp>
+#include <util/latency_histogram.hpp>
 #include <util/logging.hpp>
 #include <util/scheduler.hpp>
 
@@ -31,9 +34,18 @@
 namespace fs = std::filesystem;
 namespace kt = krypton::threading;
 namespace kr = krypton::rapi;
+namespace ku = krypton::util;
 
 std::string modelPathString;
 
+// GPU frame times would require timestamp queries, which the RAPI does not expose yet.
+struct FrameStatistics {
+    ku::LatencyHistogram frameTime;
+    ku::LatencyHistogram cpuTime;
+    ku::LatencyHistogram fenceWait;
+    ku::LatencyHistogram present;
+} frameStatistics;
+
 struct FrameData {
     std::shared_ptr<kr::ISemaphore> imageAcquireSemaphore;
     std::shared_ptr<kr::ISemaphore> renderSemaphore;
@@ -72,7 +84,56 @@ void drawUi(krypton::rapi::RenderAPI* rapi) {
     ImGui::End();
 }
 
+void drawFrameStatistics() {
+    ZoneScoped;
+    ImGui::Begin("Frame statistics");
+
+    if (ImGui::BeginTable("Timings", 5)) {
+        ImGui::TableSetupColumn("ms");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p95");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableHeadersRow();
+
+        auto row = [](const char* name, const ku::LatencyHistogram& histogram) {
+            auto summary = histogram.getSummary();
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(name);
+            for (auto value : { summary.p50, summary.p95, summary.p99, summary.max }) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", std::chrono::duration<double, std::milli>(value).count());
+            }
+        };
+        row("Frame", frameStatistics.frameTime);
+        row("CPU", frameStatistics.cpuTime);
+        row("Fence wait", frameStatistics.fenceWait);
+        row("Present", frameStatistics.present);
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Reset")) {
+        frameStatistics.frameTime.reset();
+        frameStatistics.cpuTime.reset();
+        frameStatistics.fenceWait.reset();
+        frameStatistics.present.reset();
+    }
+
+    ImGui::End();
+}
+
+void logFrameStatistics(std::string_view name, const ku::LatencyHistogram& histogram) {
+    auto summary = histogram.getSummary();
+    auto ms = [](std::chrono::nanoseconds value) {
+        return std::chrono::duration<double, std::milli>(value).count();
+    };
+    kl::log("{} ({} frames): p50 {:.3f}ms, p95 {:.3f}ms, p99 {:.3f}ms, max {:.3f}ms", name, summary.count, ms(summary.p50),
+            ms(summary.p95), ms(summary.p99), ms(summary.max));
+}
+
 auto main(int argc, char* argv[]) -> int {
+    kl::log("CPU features: {}", krypton::util::getCpuFeatureString(krypton::util::getCpuFeatures()));
     kt::Scheduler::getInstance().start();
     if (!kr::initRenderApi())
         return -1;
@@ -215,6 +276,8 @@ auto main(int argc, char* argv[]) -> int {
                 std::this_thread::sleep_for(1000ms);
             }
 
+            // Frames that are skipped above are not recorded, as they would skew the statistics.
+            ku::ScopedLatencyTimer frameTimer(frameStatistics.frameTime);
             currentFrame = ++currentFrame % swapchain->getImageCount();
 
             if (!needsResize) {
@@ -235,21 +298,30 @@ auto main(int argc, char* argv[]) -> int {
 
             (*defaultRenderPass)[0].attachment = swapchain->getDrawable();
 
-            frameData[currentFrame].fence->wait();
+            {
+                ku::ScopedLatencyTimer fenceTimer(frameStatistics.fenceWait);
+                frameData[currentFrame].fence->wait();
+            }
             frameData[currentFrame].fence->reset();
 
+            auto cpuStart = std::chrono::steady_clock::now();
             cmd->begin();
             // cmd->beginRenderPass(defaultRenderPass.get());
 
             // cmd->endRenderPass();
 
             drawUi(rapi.get());
+            drawFrameStatistics();
             imgui->draw(cmd.get());
             cmd->end();
 
             presentationQueue->submit(cmd.get(), frameData[currentFrame].imageAcquireSemaphore.get(),
                                       frameData[currentFrame].renderSemaphore.get(), frameData[currentFrame].fence.get());
-            swapchain->present(presentationQueue.get(), frameData[currentFrame].renderSemaphore.get(), &needsResize);
+            frameStatistics.cpuTime.record(std::chrono::steady_clock::now() - cpuStart);
+            {
+                ku::ScopedLatencyTimer presentTimer(frameStatistics.present);
+                swapchain->present(presentationQueue.get(), frameData[currentFrame].renderSemaphore.get(), &needsResize);
+            }
 
             imgui->endFrame();
             FrameMarkEnd(frameName);
@@ -259,6 +331,11 @@ auto main(int argc, char* argv[]) -> int {
         for (auto& frame : frameData)
             frame.fence->wait();
 
+        logFrameStatistics("Frame time", frameStatistics.frameTime);
+        logFrameStatistics("CPU time", frameStatistics.cpuTime);
+        logFrameStatistics("Fence wait", frameStatistics.fenceWait);
+        logFrameStatistics("Present", frameStatistics.present);
+
         swapchain->destroy();
         window->destroy();
 
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <assets/index_buffer.hpp>
+#include <assets/texture.hpp>
+#include <assets/vertex.hpp>
+#include <rapi/icommandbuffer.hpp>
+#include <rapi/idevice.hpp>
+#include <rapi/itexture.hpp>
+#include <rapi/vertex_descriptor.hpp>
+#include <util/index_conversion.hpp>
+
+namespace krypton::rapi {
+    inline auto getIndexType(assets::IndexType type) -> IndexType {
+        switch (type) {
+            case assets::IndexType::Uint8:
+                return IndexType::UINT8;
+            case assets::IndexType::Uint16:
+                return IndexType::UINT16;
+            case assets::IndexType::Uint32:
+                return IndexType::UINT32;
+        }
+        return IndexType::UINT32;
+    }
+
+    /**
+     * The index type to bind indices of the given type with on a device with the given features.
+     * 8-bit indices need DeviceFeatures::indexType8Bit, which Metal doesn't have at all, so
+     * they are bound as 16-bit indices otherwise.
+     */
+    inline auto getIndexType(assets::IndexType type, const DeviceFeatures& features) -> IndexType {
+        if (type == assets::IndexType::Uint8 && !features.indexType8Bit)
+            return IndexType::UINT16;
+        return getIndexType(type);
+    }
+
+    /**
+     * Returns the index data to upload, in the index type returned by getIndexType. 8-bit
+     * indices the device can't use are widened into storage, everything else is returned as is.
+     */
+    inline auto getIndexUploadData(std::span<const std::byte> indices, assets::IndexType type, const DeviceFeatures& features,
+                                   std::vector<std::byte>& storage) -> std::span<const std::byte> {
+        if (type != assets::IndexType::Uint8 || features.indexType8Bit)
+            return indices;
+        storage.resize(indices.size() * sizeof(uint16_t));
+        util::widenIndices({ reinterpret_cast<const uint8_t*>(indices.data()), indices.size() },
+                           { reinterpret_cast<uint16_t*>(storage.data()), indices.size() });
+        return storage;
+    }
+
+    // Returns the format to create a texture with, or TextureFormat::Invalid if there is none.
+    inline auto getTextureFormat(const assets::Texture& texture) -> TextureFormat {
+        switch (texture.compression) {
+            case util::BlockCompression::BC1:
+                return texture.srgb ? TextureFormat::BC1_SRGB : TextureFormat::BC1_UNORM;
+            case util::BlockCompression::BC3:
+                return texture.srgb ? TextureFormat::BC3_SRGB : TextureFormat::BC3_UNORM;
+            case util::BlockCompression::BC4:
+                return TextureFormat::BC4_UNORM;
+            case util::BlockCompression::BC5:
+                return TextureFormat::BC5_UNORM;
+            case util::BlockCompression::BC7:
+                return texture.srgb ? TextureFormat::BC7_SRGB : TextureFormat::BC7_UNORM;
+            case util::BlockCompression::None:
+                break;
+        }
+
+        if (texture.channels == 4 && texture.bitsPerPixel == 16)
+            return TextureFormat::RGBA16_UNORM;
+        if (texture.channels == 4 && texture.bitsPerPixel == 8)
+            return texture.srgb ? TextureFormat::RGBA8_SRGB : TextureFormat::RGBA8_UNORM;
+        if (texture.channels == 1 && texture.bitsPerPixel == 8)
+            return texture.srgb ? TextureFormat::R8_SRGB : TextureFormat::R8_UNORM;
+        return TextureFormat::Invalid;
+    }
+
+    /**
+     * Returns the descriptor for vertices of the given asset layout. The vertices are bound to
+     * buffer 0 and the attributes are always ordered position, normal, UV, color and tangent.
+     * The full layout contains its own color, which the compact layouts keep in a stream of
+     * their own. Tangents are always kept in their own stream. These streams are bound to the
+     * following buffers, in that order, if they are enabled.
+     */
+    inline auto getVertexDescriptor(assets::VertexLayout layout, bool withColors = false, bool withTangents = false) -> VertexDescriptor {
+        VertexDescriptor descriptor;
+        switch (layout) {
+            case assets::VertexLayout::Full: {
+                descriptor.buffers = { { .stride = sizeof(assets::Vertex) } };
+                descriptor.attributes = {
+                    { offsetof(assets::Vertex, pos), 0, VertexFormat::RGBA32_FLOAT },
+                    { offsetof(assets::Vertex, normals), 0, VertexFormat::RGBA32_FLOAT },
+                    { offsetof(assets::Vertex, uv), 0, VertexFormat::RG32_FLOAT },
+                    { offsetof(assets::Vertex, color), 0, VertexFormat::RGBA32_FLOAT },
+                };
+                break;
+            }
+            case assets::VertexLayout::Compact: {
+                descriptor.buffers = { { .stride = sizeof(assets::CompactVertex) } };
+                descriptor.attributes = {
+                    { offsetof(assets::CompactVertex, position), 0, VertexFormat::RGB32_FLOAT },
+                    { offsetof(assets::CompactVertex, normal), 0, VertexFormat::RG16_SNORM },
+                    { offsetof(assets::CompactVertex, uv), 0, VertexFormat::RG16_FLOAT },
+                };
+                break;
+            }
+            case assets::VertexLayout::Quantized: {
+                descriptor.buffers = { { .stride = sizeof(assets::QuantizedVertex) } };
+                descriptor.attributes = {
+                    { offsetof(assets::QuantizedVertex, position), 0, VertexFormat::RGBA16_UNORM },
+                    { offsetof(assets::QuantizedVertex, normal), 0, VertexFormat::RG16_SNORM },
+                    { offsetof(assets::QuantizedVertex, uv), 0, VertexFormat::RG16_UNORM },
+                };
+                break;
+            }
+        }
+
+        if (withColors && layout != assets::VertexLayout::Full) {
+            descriptor.attributes.push_back({ 0, static_cast<uint32_t>(descriptor.buffers.size()), VertexFormat::RGBA8_UNORM });
+            descriptor.buffers.push_back({ .stride = sizeof(uint32_t) });
+        }
+        if (withTangents) {
+            descriptor.attributes.push_back({ 0, static_cast<uint32_t>(descriptor.buffers.size()), VertexFormat::RGBA16_SNORM });
+            descriptor.buffers.push_back({ .stride = sizeof(assets::CompactTangent) });
+        }
+        return descriptor;
+    }
+} // namespace krypton::rapi
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <span>
 #include <string_view>
@@ -30,8 +31,37 @@ namespace krypton::rapi {
 
         // The default depth texture format.
         D32_FLOAT,
+
+        // Block compressed formats, which store 4x4 pixels per block. BC4 and BC5 have one and
+        // two channels respectively.
+        BC1_UNORM,
+        BC1_SRGB,
+        BC3_UNORM,
+        BC3_SRGB,
+        BC4_UNORM,
+        BC5_UNORM,
+        BC7_UNORM,
+        BC7_SRGB,
     };
 
+    // The size of a 4x4 block of a block compressed format, or 0 for all other formats.
+    [[nodiscard]] constexpr auto getTextureBlockSize(TextureFormat format) noexcept -> std::size_t {
+        switch (format) {
+            case TextureFormat::BC1_UNORM:
+            case TextureFormat::BC1_SRGB:
+            case TextureFormat::BC4_UNORM:
+                return 8;
+            case TextureFormat::BC3_UNORM:
+            case TextureFormat::BC3_SRGB:
+            case TextureFormat::BC5_UNORM:
+            case TextureFormat::BC7_UNORM:
+            case TextureFormat::BC7_SRGB:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
     enum class TextureUsage : uint8_t {
         None = 0,
         SampledImage = 1,
@@ -70,7 +100,8 @@ namespace krypton::rapi {
     public:
         ~ITexture() override = default;
 
-        virtual void create(TextureFormat textureFormat, uint32_t width, uint32_t height) = 0;
+        // The texture can have mip levels down to 1x1, which all have to be uploaded.
+        virtual void create(TextureFormat textureFormat, uint32_t width, uint32_t height, uint32_t mipLevels = 1) = 0;
 
         virtual void destroy() = 0;
 
@@ -79,7 +110,9 @@ namespace krypton::rapi {
         /**
          * This finalizes the texture creation process by uploading the texture to the GPU. To be
          * consistent, this function returns *after* the texture has been fully uploaded, so it's
-         * best to call this from a separate thread.
+         * best to call this from a separate thread. With multiple mip levels, the data contains
+         * all levels tightly packed one after another, starting with the largest one. Block
+         * compressed levels are padded to whole blocks.
          */
         virtual void uploadTexture(std::span<std::byte> data) = 0;
     };
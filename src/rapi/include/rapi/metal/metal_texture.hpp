@@ -33,7 +33,7 @@ namespace krypton::rapi::mtl {
         MTL::Texture* texture = nullptr;
 
         NS::String* name = nullptr;
-        uint32_t width = 0, height = 0;
+        uint32_t width = 0, height = 0, mipLevels = 1;
         TextureFormat format = TextureFormat::RGBA8_SRGB;
         TextureUsage usage = TextureUsage::SampledImage;
         MTL::TextureSwizzleChannels swizzleChannels = {};
@@ -45,7 +45,7 @@ namespace krypton::rapi::mtl {
         explicit Texture(MTL::Device* device, rapi::TextureUsage usage);
         ~Texture() override = default;
 
-        void create(TextureFormat format, uint32_t width, uint32_t height) override;
+        void create(TextureFormat format, uint32_t width, uint32_t height, uint32_t mipLevels = 1) override;
         void destroy() override;
         void setName(std::string_view name) override;
         void setSwizzling(SwizzleChannels swizzle) override;
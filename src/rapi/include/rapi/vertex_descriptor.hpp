@@ -14,6 +14,16 @@ namespace krypton::rapi {
         RG32_FLOAT,
         // Four 8-bit unsigned normalized integers.
         RGBA8_UNORM,
+        // Four 16-bit unsigned normalized integers.
+        RGBA16_UNORM,
+        // Four 16-bit signed normalized integers.
+        RGBA16_SNORM,
+        // Two 16-bit unsigned normalized integers.
+        RG16_UNORM,
+        // Two 16-bit signed normalized integers.
+        RG16_SNORM,
+        // Two 16-bit signed floats.
+        RG16_FLOAT,
     };
 
     enum class VertexInputRate : uint8_t {
@@ -2,11 +2,11 @@
 
 #include <vector>
 
-#include <robin_hood.h>
-
 #include <rapi/idevice.hpp>
 #include <rapi/vulkan/vk_struct_chain.hpp>
 #include <util/attributes.hpp>
+#include <util/flat_map.hpp>
+#include <util/string_interner.hpp>
 
 // fwd.
 typedef struct VmaAllocator_T* VmaAllocator;
@@ -23,7 +23,8 @@ namespace krypton::rapi::vk {
         std::vector<VkQueueFamilyProperties2> queueFamilies = {};
         std::vector<uint32_t> presentQueueIndices;
 
-        robin_hood::unordered_set<std::string> availableExtensions;
+        // Maps the interned extension name to its spec version.
+        util::FlatMap<util::InternedString, uint32_t> availableExtensions;
 
         VkPhysicalDevice physicalDevice = nullptr;
 
@@ -48,7 +49,7 @@ namespace krypton::rapi::vk {
         class PhysicalDevice* physicalDevice;
 
         VkDevice device = nullptr;
-        robin_hood::unordered_set<std::string> enabledExtensions;
+        util::FlatSet<util::InternedString> enabledExtensions;
 
         VmaAllocator allocator = nullptr;
 
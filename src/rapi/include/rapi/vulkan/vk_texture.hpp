@@ -29,7 +29,7 @@ namespace krypton::rapi::vk {
         explicit Texture(Device* device, rapi::TextureUsage usage);
         ~Texture() override = default;
 
-        void create(TextureFormat format, uint32_t width, uint32_t height) override;
+        void create(TextureFormat format, uint32_t width, uint32_t height, uint32_t mipLevels = 1) override;
         void destroy() override;
         [[nodiscard]] auto getHandle() const noexcept -> VkImage;
         [[nodiscard]] auto getView() const noexcept -> VkImageView;
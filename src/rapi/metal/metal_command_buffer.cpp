@@ -47,6 +47,8 @@ void kr::mtl::CommandBuffer::bindIndexBuffer(IBuffer* indexBuffer, IndexType typ
     ZoneScoped;
     boundIndexBuffer = dynamic_cast<mtl::Buffer*>(indexBuffer);
     boundIndexBufferOffset = offset;
+    // Metal has no 8-bit indices, which have to be widened with getIndexUploadData.
+    VERIFY(type != IndexType::UINT8);
     boundIndexType = type == IndexType::UINT16 ? MTL::IndexTypeUInt16 : MTL::IndexTypeUInt32;
 }
 
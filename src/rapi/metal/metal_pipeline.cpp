@@ -51,6 +51,21 @@ namespace krypton::rapi::mtl {
             case VertexFormat::RGBA8_UNORM: {
                 return MTL::VertexFormatUChar4;
             }
+            case VertexFormat::RGBA16_UNORM: {
+                return MTL::VertexFormatUShort4Normalized;
+            }
+            case VertexFormat::RGBA16_SNORM: {
+                return MTL::VertexFormatShort4Normalized;
+            }
+            case VertexFormat::RG16_UNORM: {
+                return MTL::VertexFormatUShort2Normalized;
+            }
+            case VertexFormat::RG16_SNORM: {
+                return MTL::VertexFormatShort2Normalized;
+            }
+            case VertexFormat::RG16_FLOAT: {
+                return MTL::VertexFormatHalf2;
+            }
         }
 
         return MTL::VertexFormatInvalid;
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <Tracy.hpp>
 
 #include <rapi/metal/metal_cpp_util.hpp>
@@ -32,6 +34,22 @@ namespace krypton::rapi::mtl {
                 return MTL::PixelFormatR8Unorm_sRGB;
             case TextureFormat::D32_FLOAT:
                 return MTL::PixelFormatDepth32Float;
+            case TextureFormat::BC1_UNORM:
+                return MTL::PixelFormatBC1_RGBA;
+            case TextureFormat::BC1_SRGB:
+                return MTL::PixelFormatBC1_RGBA_sRGB;
+            case TextureFormat::BC3_UNORM:
+                return MTL::PixelFormatBC3_RGBA;
+            case TextureFormat::BC3_SRGB:
+                return MTL::PixelFormatBC3_RGBA_sRGB;
+            case TextureFormat::BC4_UNORM:
+                return MTL::PixelFormatBC4_RUnorm;
+            case TextureFormat::BC5_UNORM:
+                return MTL::PixelFormatBC5_RGUnorm;
+            case TextureFormat::BC7_UNORM:
+                return MTL::PixelFormatBC7_RGBAUnorm;
+            case TextureFormat::BC7_SRGB:
+                return MTL::PixelFormatBC7_RGBAUnorm_sRGB;
             case TextureFormat::Invalid:
                 return MTL::PixelFormatInvalid;
         }
@@ -45,13 +63,15 @@ kr::mtl::Texture::Texture(MTL::Device* device, rapi::TextureUsage usage) : devic
 
 kr::mtl::Texture::Texture(MTL::Device* device, MTL::Texture* texture) : device(device), texture(texture) {}
 
-void kr::mtl::Texture::create(TextureFormat newFormat, uint32_t newWidth, uint32_t newHeight) {
+void kr::mtl::Texture::create(TextureFormat newFormat, uint32_t newWidth, uint32_t newHeight, uint32_t newMipLevels) {
     ZoneScoped;
     format = newFormat;
     width = newWidth;
     height = newHeight;
+    mipLevels = newMipLevels;
 
-    auto* texDesc = MTL::TextureDescriptor::texture2DDescriptor(getPixelFormat(format), width, height, false);
+    auto* texDesc = MTL::TextureDescriptor::texture2DDescriptor(getPixelFormat(format), width, height, mipLevels > 1);
+    texDesc->setMipmapLevelCount(mipLevels);
     texDesc->setUsage(MTL::TextureUsageShaderRead);
     texDesc->setStorageMode(MTL::StorageModeShared);
     texDesc->setSwizzle(swizzleChannels);
@@ -87,8 +107,26 @@ void kr::mtl::Texture::uploadTexture(std::span<std::byte> data) {
     ZoneScoped;
     VERIFY(texture);
 
-    MTL::Region imageRegion = MTL::Region::Make2D(0, 0, width, height);
-    texture->replaceRegion(imageRegion, 0, data.data(), data.size_bytes() / height);
+    // Block compressed levels are made of 4x4 blocks instead of pixels, and rows are block rows.
+    const auto blockSize = getTextureBlockSize(format);
+    const auto blockExtent = blockSize != 0 ? 4U : 1U;
+    auto getLevelBlocks = [&](uint32_t extent, uint32_t level) {
+        return static_cast<std::size_t>((std::max(extent >> level, 1U) + blockExtent - 1) / blockExtent);
+    };
+
+    std::size_t blockCount = 0;
+    for (uint32_t level = 0; level < mipLevels; ++level)
+        blockCount += getLevelBlocks(width, level) * getLevelBlocks(height, level);
+    const auto elementSize = blockSize != 0 ? blockSize : data.size_bytes() / blockCount;
+    VERIFY(data.size_bytes() >= blockCount * elementSize);
+
+    std::size_t offset = 0;
+    for (uint32_t level = 0; level < mipLevels; ++level) {
+        const auto bytesPerRow = getLevelBlocks(width, level) * elementSize;
+        MTL::Region imageRegion = MTL::Region::Make2D(0, 0, std::max(width >> level, 1U), std::max(height >> level, 1U));
+        texture->replaceRegion(imageRegion, level, data.data() + offset, bytesPerRow);
+        offset += bytesPerRow * getLevelBlocks(height, level);
+    }
 }
 #pragma endregion
 
@@ -54,6 +54,8 @@ void kr::vk::CommandBuffer::beginRenderPass(const IRenderPass* renderPass) {
 
 void kr::vk::CommandBuffer::bindIndexBuffer(IBuffer* indexBuffer, IndexType type, uint32_t offset) {
     ZoneScoped;
+    // 8-bit indices need VK_EXT_index_type_uint8, otherwise they have to be widened with getIndexUploadData.
+    VERIFY(type != IndexType::UINT8 || device->getEnabledFeatures().indexType8Bit);
     auto* vkBuffer = dynamic_cast<Buffer*>(indexBuffer);
     vkCmdBindIndexBuffer(cmdBuffer, vkBuffer->getHandle(), offset, vulkanIndexTypes[static_cast<uint8_t>(type)]);
 }
@@ -19,8 +19,10 @@
 #include <util/assert.hpp>
 #include <util/bits.hpp>
 #include <util/logging.hpp>
+#include <util/string_interner.hpp>
 
 namespace kr = krypton::rapi;
+namespace ku = krypton::util;
 
 namespace krypton::rapi::vk {
     std::vector<VkExtensionProperties> getAvailablePhysicalDeviceExtensions(VkPhysicalDevice physicalDevice);
@@ -85,8 +87,10 @@ void kr::vk::PhysicalDevice::init() {
     {
         ZoneScoped;
         auto availableExtensionsVector = getAvailablePhysicalDeviceExtensions(physicalDevice);
+        auto& interner = ku::StringInterner::getInstance();
+        availableExtensions.reserve(availableExtensionsVector.size());
         for (auto& availableExt : availableExtensionsVector)
-            availableExtensions.insert(availableExt.extensionName);
+            availableExtensions.insert(interner.intern(availableExt.extensionName), availableExt.specVersion);
     }
 
     queueFamilies = getQueueFamilyProperties(physicalDevice);
@@ -135,7 +139,7 @@ kr::DeviceFeatures kr::vk::PhysicalDevice::supportedDeviceFeatures() {
 
 bool kr::vk::PhysicalDevice::supportsExtension(const char* extensionName) const {
     ZoneScoped;
-    return availableExtensions.contains(extensionName);
+    return availableExtensions.contains(ku::StringInterner::getInstance().find(extensionName));
 }
 #pragma endregion
 
@@ -329,8 +333,9 @@ VkResult kr::vk::Device::create() {
             kl::throwError("Failed to create device", result);
 
         // Copy all enabled extensions into enabledExtensions
+        auto& interner = ku::StringInterner::getInstance();
         for (auto& ext : deviceExtensions)
-            enabledExtensions.insert(ext);
+            enabledExtensions.insert(interner.intern(ext));
 
         // Load all device function pointers
         volkLoadDevice(device);
@@ -521,7 +526,7 @@ std::shared_ptr<kr::IQueue> kr::vk::Device::getPresentationQueue() {
 
 bool kr::vk::Device::isExtensionEnabled(const char* extensionName) const {
     ZoneScoped;
-    return enabledExtensions.contains(extensionName);
+    return enabledExtensions.contains(ku::StringInterner::getInstance().find(extensionName));
 }
 
 bool kr::vk::Device::isHeadless() const noexcept {
@@ -53,6 +53,21 @@ namespace krypton::rapi::vk {
             case VertexFormat::RGBA8_UNORM: {
                 return VK_FORMAT_R8G8B8A8_UNORM;
             }
+            case VertexFormat::RGBA16_UNORM: {
+                return VK_FORMAT_R16G16B16A16_UNORM;
+            }
+            case VertexFormat::RGBA16_SNORM: {
+                return VK_FORMAT_R16G16B16A16_SNORM;
+            }
+            case VertexFormat::RG16_UNORM: {
+                return VK_FORMAT_R16G16_UNORM;
+            }
+            case VertexFormat::RG16_SNORM: {
+                return VK_FORMAT_R16G16_SNORM;
+            }
+            case VertexFormat::RG16_FLOAT: {
+                return VK_FORMAT_R16G16_SFLOAT;
+            }
         }
 
         return VK_FORMAT_UNDEFINED;
@@ -25,6 +25,22 @@ namespace krypton::rapi::vk {
                 return VK_FORMAT_R8_UNORM;
             case TextureFormat::R8_SRGB:
                 return VK_FORMAT_R8_SRGB;
+            case TextureFormat::BC1_UNORM:
+                return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case TextureFormat::BC1_SRGB:
+                return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            case TextureFormat::BC3_UNORM:
+                return VK_FORMAT_BC3_UNORM_BLOCK;
+            case TextureFormat::BC3_SRGB:
+                return VK_FORMAT_BC3_SRGB_BLOCK;
+            case TextureFormat::BC4_UNORM:
+                return VK_FORMAT_BC4_UNORM_BLOCK;
+            case TextureFormat::BC5_UNORM:
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+            case TextureFormat::BC7_UNORM:
+                return VK_FORMAT_BC7_UNORM_BLOCK;
+            case TextureFormat::BC7_SRGB:
+                return VK_FORMAT_BC7_SRGB_BLOCK;
             default:
                 return VK_FORMAT_UNDEFINED;
         }
@@ -52,7 +68,7 @@ kr::vk::Texture::Texture(Device* device, rapi::TextureUsage usage) : device(devi
 kr::vk::Texture::Texture(krypton::rapi::vk::Device* device, rapi::TextureUsage usage, VkImage image, VkImageView imageView)
     : device(device), image(image), imageView(imageView), usage(usage) {}
 
-void kr::vk::Texture::create(TextureFormat newFormat, uint32_t width, uint32_t height) {
+void kr::vk::Texture::create(TextureFormat newFormat, uint32_t width, uint32_t height, uint32_t mipLevels) {
     ZoneScoped;
     VERIFY(newFormat != TextureFormat::Invalid);
     format = newFormat;
@@ -66,6 +82,8 @@ void kr::vk::Texture::create(TextureFormat newFormat, uint32_t width, uint32_t h
             .width = width,
             .height = height,
         },
+        .mipLevels = mipLevels,
+        .arrayLayers = 1,
         .usage = usageFlags,
     };
 
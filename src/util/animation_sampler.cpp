@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <Tracy.hpp>
+
+#include <util/animation_sampler.hpp>
+#include <util/assert.hpp>
+#include <util/attributes.hpp>
+#include <util/kernel_dispatch.hpp>
+#include <util/scheduler.hpp>
+
+#if defined(KRYPTON_ARCH_X86)
+    #include <immintrin.h>
+#elif defined(KRYPTON_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    // Tracks are sampled in batches. The keys of every track in a batch are located and their
+    // values gathered into lanes first, which the kernels then blend all at once.
+    constexpr std::size_t sampleBatchSize = 64;
+    // Tracks per task when sampling across the Scheduler.
+    constexpr std::size_t sampleChunkSize = 1024;
+
+    /**
+     * Every lane computes the weighted sum of four values, which covers all interpolation modes:
+     * step only uses the first value, linear the first two, and cubic splines additionally use
+     * the two tangents with the Hermite basis functions as weights.
+     */
+    struct alignas(32) SampleBatch final {
+        float weights[4][sampleBatchSize];
+        // Indexed by value, component and lane.
+        float values[4][4][sampleBatchSize];
+        // 1 for lanes whose result is normalized, 0 for all others.
+        float normalize[sampleBatchSize];
+        float results[4][sampleBatchSize];
+    };
+
+    using BlendKernel = void(SampleBatch& batch, std::size_t count);
+
+    // Finds the key and the weights of a track and gathers its values into the given lane.
+    void prepareSampleLane(const KeyframeTracks& tracks, const KeyframeTrack& track, float time, uint32_t* cursor, SampleBatch& batch,
+                           std::size_t lane) {
+        const float* keys = tracks.times.data() + track.firstKey;
+        const auto keyCount = track.keyCount;
+        uint32_t key = 0;
+        float t = 0.0f;
+        float duration = 0.0f;
+        if (keyCount > 1) {
+            if (time >= keys[keyCount - 1]) {
+                key = keyCount - 2;
+                t = 1.0f;
+            } else if (time > keys[0]) {
+                key = cursor != nullptr ? std::min(*cursor, keyCount - 2) : 0;
+                if (time < keys[key] || time >= keys[key + 1]) {
+                    // Playback usually moves forward by less than a key between two samples.
+                    if (key + 2 < keyCount && time >= keys[key + 1] && time < keys[key + 2])
+                        ++key;
+                    else
+                        key = static_cast<uint32_t>(std::upper_bound(keys, keys + keyCount, time) - keys) - 1;
+                }
+                t = (time - keys[key]) / (keys[key + 1] - keys[key]);
+            }
+            duration = keys[key + 1] - keys[key];
+        }
+        if (cursor != nullptr)
+            *cursor = key;
+
+        // The value indices relative to the first value of the track.
+        uint32_t indices[4] = {};
+        float weights[4] = {};
+        std::size_t valueCount = 2;
+        if (keyCount == 1) {
+            indices[0] = indices[1] = track.interpolation == Interpolation::CubicSpline ? 1 : 0;
+            weights[0] = 1.0f;
+        } else if (track.interpolation == Interpolation::Step) {
+            indices[0] = key;
+            indices[1] = key + 1;
+            weights[0] = t < 1.0f ? 1.0f : 0.0f;
+            weights[1] = 1.0f - weights[0];
+        } else if (track.interpolation == Interpolation::Linear) {
+            indices[0] = key;
+            indices[1] = key + 1;
+            weights[0] = 1.0f - t;
+            weights[1] = t;
+        } else {
+            const float t2 = t * t, t3 = t2 * t;
+            indices[0] = key * 3 + 1;
+            indices[1] = key * 3 + 4;
+            indices[2] = key * 3 + 2;
+            indices[3] = key * 3 + 3;
+            weights[0] = 2.0f * t3 - 3.0f * t2 + 1.0f;
+            weights[1] = -2.0f * t3 + 3.0f * t2;
+            weights[2] = (t3 - 2.0f * t2 + t) * duration;
+            weights[3] = (t3 - t2) * duration;
+            valueCount = 4;
+        }
+
+        for (std::size_t v = 0; v < 4; ++v)
+            batch.weights[v][lane] = weights[v];
+        for (std::size_t c = 0; c < 4; ++c) {
+            for (std::size_t v = 0; v < 4; ++v) {
+                float value = 0.0f;
+                if (c < track.componentCount && v < valueCount) {
+                    const auto index = track.firstValues[c] + indices[v];
+                    value = track.quantized ? track.offset[c] + static_cast<float>(tracks.quantizedValues[c][index]) * track.scale[c]
+                                            : tracks.values[c][index];
+                }
+                batch.values[v][c][lane] = value;
+            }
+        }
+
+        // q and -q are the same rotation, so we interpolate towards whichever is closer. Clamped
+        // samples return the last key as it is.
+        if (track.rotation && track.interpolation == Interpolation::Linear && t < 1.0f) {
+            float dot = 0.0f;
+            for (std::size_t c = 0; c < 4; ++c)
+                dot += batch.values[0][c][lane] * batch.values[1][c][lane];
+            if (dot < 0.0f)
+                for (std::size_t c = 0; c < 4; ++c)
+                    batch.values[1][c][lane] = -batch.values[1][c][lane];
+        }
+        batch.normalize[lane] = track.rotation ? 1.0f : 0.0f;
+    }
+
+    // ↓ -------------------  SCALAR  ------------------- ↓
+    void blendSamplesScalar(SampleBatch& batch, std::size_t count) {
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            float result[4];
+            float lengthSquared = 0.0f;
+            for (std::size_t c = 0; c < 4; ++c) {
+                result[c] = batch.weights[0][lane] * batch.values[0][c][lane] + batch.weights[1][lane] * batch.values[1][c][lane] +
+                            batch.weights[2][lane] * batch.values[2][c][lane] + batch.weights[3][lane] * batch.values[3][c][lane];
+                lengthSquared += result[c] * result[c];
+            }
+            const float factor = batch.normalize[lane] != 0.0f && lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 1.0f;
+            for (std::size_t c = 0; c < 4; ++c)
+                batch.results[c][lane] = result[c] * factor;
+        }
+    }
+    // ↑ -------------------  SCALAR  ------------------- ↑
+
+#if defined(KRYPTON_ARCH_X86)
+    // ↓ -------------------   AVX2   ------------------- ↓
+    TARGET_AVX2 void blendSamplesAvx2(SampleBatch& batch, std::size_t count) {
+        const auto zero = _mm256_setzero_ps();
+        const auto one = _mm256_set1_ps(1.0f);
+        // The batch is padded, so the last lanes can be computed even if they are unused.
+        for (std::size_t lane = 0; lane < count; lane += 8) {
+            __m256 weights[4];
+            for (std::size_t v = 0; v < 4; ++v)
+                weights[v] = _mm256_load_ps(&batch.weights[v][lane]);
+
+            __m256 result[4];
+            auto lengthSquared = zero;
+            for (std::size_t c = 0; c < 4; ++c) {
+                result[c] = _mm256_mul_ps(weights[0], _mm256_load_ps(&batch.values[0][c][lane]));
+                result[c] = _mm256_fmadd_ps(weights[1], _mm256_load_ps(&batch.values[1][c][lane]), result[c]);
+                result[c] = _mm256_fmadd_ps(weights[2], _mm256_load_ps(&batch.values[2][c][lane]), result[c]);
+                result[c] = _mm256_fmadd_ps(weights[3], _mm256_load_ps(&batch.values[3][c][lane]), result[c]);
+                lengthSquared = _mm256_fmadd_ps(result[c], result[c], lengthSquared);
+            }
+
+            const auto mask = _mm256_and_ps(_mm256_cmp_ps(_mm256_load_ps(&batch.normalize[lane]), zero, _CMP_NEQ_OQ),
+                                            _mm256_cmp_ps(lengthSquared, zero, _CMP_GT_OQ));
+            const auto factor = _mm256_blendv_ps(one, _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared)), mask);
+            for (std::size_t c = 0; c < 4; ++c)
+                _mm256_store_ps(&batch.results[c][lane], _mm256_mul_ps(result[c], factor));
+        }
+    }
+    // ↑ -------------------   AVX2   ------------------- ↑
+#elif defined(KRYPTON_HAS_NEON)
+    // ↓ -------------------   NEON   ------------------- ↓
+    void blendSamplesNeon(SampleBatch& batch, std::size_t count) {
+        const auto zero = vdupq_n_f32(0.0f);
+        const auto one = vdupq_n_f32(1.0f);
+        for (std::size_t lane = 0; lane < count; lane += 4) {
+            float32x4_t weights[4];
+            for (std::size_t v = 0; v < 4; ++v)
+                weights[v] = vld1q_f32(&batch.weights[v][lane]);
+
+            float32x4_t result[4];
+            auto lengthSquared = zero;
+            for (std::size_t c = 0; c < 4; ++c) {
+                result[c] = vmulq_f32(weights[0], vld1q_f32(&batch.values[0][c][lane]));
+                result[c] = vfmaq_f32(result[c], weights[1], vld1q_f32(&batch.values[1][c][lane]));
+                result[c] = vfmaq_f32(result[c], weights[2], vld1q_f32(&batch.values[2][c][lane]));
+                result[c] = vfmaq_f32(result[c], weights[3], vld1q_f32(&batch.values[3][c][lane]));
+                lengthSquared = vfmaq_f32(lengthSquared, result[c], result[c]);
+            }
+
+            const auto mask = vandq_u32(vmvnq_u32(vceqq_f32(vld1q_f32(&batch.normalize[lane]), zero)), vcgtq_f32(lengthSquared, zero));
+            const auto factor = vbslq_f32(mask, vdivq_f32(one, vsqrtq_f32(lengthSquared)), one);
+            for (std::size_t c = 0; c < 4; ++c)
+                vst1q_f32(&batch.results[c][lane], vmulq_f32(result[c], factor));
+        }
+    }
+    // ↑ -------------------   NEON   ------------------- ↑
+#endif
+} // namespace krypton::util
+
+auto ku::KeyframeTracks::addTrack(std::span<const float> keyTimes, std::span<const float> keyValues, uint32_t componentCount,
+                                  Interpolation interpolation, bool rotation, bool quantize) -> uint32_t {
+    const auto valuesPerKey = interpolation == Interpolation::CubicSpline ? 3U : 1U;
+    const auto valueCount = keyTimes.size() * valuesPerKey;
+    VERIFY(!keyTimes.empty() && componentCount >= 1 && componentCount <= 4 && keyValues.size() >= valueCount * componentCount);
+
+    KeyframeTrack track = {
+        .firstKey = static_cast<uint32_t>(times.size()),
+        .keyCount = static_cast<uint32_t>(keyTimes.size()),
+        .componentCount = static_cast<uint8_t>(componentCount),
+        .interpolation = interpolation,
+        .rotation = rotation,
+        .quantized = quantize,
+    };
+    times.insert(times.end(), keyTimes.begin(), keyTimes.end());
+
+    for (uint32_t c = 0; c < componentCount; ++c) {
+        if (!quantize) {
+            auto& pool = values[c];
+            track.firstValues[c] = static_cast<uint32_t>(pool.size());
+            for (std::size_t i = 0; i < valueCount; ++i)
+                pool.push_back(keyValues[i * componentCount + c]);
+            continue;
+        }
+
+        float min = keyValues[c], max = keyValues[c];
+        for (std::size_t i = 0; i < valueCount; ++i) {
+            min = std::min(min, keyValues[i * componentCount + c]);
+            max = std::max(max, keyValues[i * componentCount + c]);
+        }
+        track.offset[c] = min;
+        track.scale[c] = (max - min) / 65535.0f;
+
+        auto& pool = quantizedValues[c];
+        track.firstValues[c] = static_cast<uint32_t>(pool.size());
+        const float toQuantized = max > min ? 65535.0f / (max - min) : 0.0f;
+        for (std::size_t i = 0; i < valueCount; ++i)
+            pool.push_back(static_cast<uint16_t>(std::lround((keyValues[i * componentCount + c] - min) * toQuantized)));
+    }
+
+    tracks.push_back(track);
+    return static_cast<uint32_t>(tracks.size() - 1);
+}
+
+void ku::KeyframeTracks::clear() noexcept {
+    tracks.clear();
+    times.clear();
+    for (auto& pool : values)
+        pool.clear();
+    for (auto& pool : quantizedValues)
+        pool.clear();
+}
+
+auto ku::KeyframeTracks::size() const noexcept -> std::size_t {
+    return tracks.size();
+}
+
+auto ku::KeyframeTracks::getDuration() const noexcept -> float {
+    float duration = 0.0f;
+    for (const auto& track : tracks)
+        duration = std::max(duration, times[track.firstKey + track.keyCount - 1]);
+    return duration;
+}
+
+void ku::TrackSamples::resize(std::size_t size) {
+    for (auto& component : values)
+        component.resize(size);
+}
+
+auto ku::TrackSamples::size() const noexcept -> std::size_t {
+    return values[0].size();
+}
+
+void ku::sampleTracks(const KeyframeTracks& tracks, std::size_t first, std::size_t count, float time, std::span<uint32_t> cursors,
+                      TrackSamples& out) {
+    ZoneScoped;
+    VERIFY(first + count <= tracks.size() && out.size() >= tracks.size() && (cursors.empty() || cursors.size() >= tracks.size()));
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<BlendKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures, blendSamplesAvx2 },
+#elif defined(KRYPTON_HAS_NEON)
+        { CpuFeature::NEON, blendSamplesNeon },
+#endif
+        { CpuFeature::None, blendSamplesScalar },
+    }));
+    auto* blend = dispatcher.get();
+
+    // Zeroed once, so that the padding lanes the kernels compute are always initialized.
+    SampleBatch batch = {};
+    for (auto begin = first; begin < first + count; begin += sampleBatchSize) {
+        const auto batchCount = std::min(sampleBatchSize, first + count - begin);
+        for (std::size_t lane = 0; lane < batchCount; ++lane) {
+            const auto index = begin + lane;
+            prepareSampleLane(tracks, tracks.tracks[index], time, cursors.empty() ? nullptr : &cursors[index], batch, lane);
+        }
+        blend(batch, batchCount);
+        for (std::size_t c = 0; c < 4; ++c)
+            std::memcpy(&out.values[c][begin], batch.results[c], batchCount * sizeof(float));
+    }
+}
+
+void ku::sampleTracks(const KeyframeTracks& tracks, float time, std::span<uint32_t> cursors, TrackSamples& out) {
+    ZoneScoped;
+    krypton::threading::Scheduler::getInstance().parallelFor(tracks.size(), sampleChunkSize, [&](std::size_t begin, std::size_t end) {
+        sampleTracks(tracks, begin, end - begin, time, cursors, out);
+    });
+}
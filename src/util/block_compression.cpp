@@ -0,0 +1,646 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <span>
+
+#include <Tracy.hpp>
+
+#include <util/assert.hpp>
+#include <util/block_compression.hpp>
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    static constexpr std::size_t blockPixelCount = 16;
+
+    template <std::size_t N>
+    using BlockPoints = std::array<std::array<float, N>, blockPixelCount>;
+
+    template <std::size_t N>
+    using Endpoint = std::array<float, N>;
+
+    // Packs bit fields into a 128-bit block, starting at the least significant bit.
+    struct BlockBitWriter final {
+        uint64_t words[2] = {};
+        uint32_t position = 0;
+
+        void write(uint64_t value, uint32_t count) noexcept {
+            const auto word = position / 64;
+            const auto offset = position % 64;
+            words[word] |= value << offset;
+            if (offset + count > 64)
+                words[word + 1] |= value >> (64 - offset);
+            position += count;
+        }
+    };
+
+    struct BlockBitReader final {
+        uint64_t words[2] = {};
+        uint32_t position = 0;
+
+        [[nodiscard]] auto read(uint32_t count) noexcept -> uint32_t {
+            const auto word = position / 64;
+            const auto offset = position % 64;
+            auto value = words[word] >> offset;
+            if (offset + count > 64)
+                value |= words[word + 1] << (64 - offset);
+            position += count;
+            return static_cast<uint32_t>(value & ((1ULL << count) - 1));
+        }
+    };
+
+    [[nodiscard]] auto clampChannel(float value) noexcept -> float {
+        return std::clamp(value, 0.0f, 255.0f);
+    }
+
+    /**
+     * Finds the line through the block's colors with the least squared distance, by running a
+     * power iteration on their covariance matrix, and returns the extreme points of the colors
+     * projected onto it.
+     */
+    template <std::size_t N>
+    void findBlockEndpoints(const BlockPoints<N>& points, Endpoint<N>& start, Endpoint<N>& end) noexcept {
+        Endpoint<N> mean = {};
+        for (const auto& point : points)
+            for (std::size_t c = 0; c < N; ++c)
+                mean[c] += point[c];
+        for (auto& value : mean)
+            value /= static_cast<float>(blockPixelCount);
+
+        std::array<std::array<float, N>, N> covariance = {};
+        for (const auto& point : points)
+            for (std::size_t i = 0; i < N; ++i)
+                for (std::size_t j = 0; j < N; ++j)
+                    covariance[i][j] += (point[i] - mean[i]) * (point[j] - mean[j]);
+
+        Endpoint<N> axis;
+        axis.fill(1.0f);
+        for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+            Endpoint<N> next = {};
+            for (std::size_t i = 0; i < N; ++i)
+                for (std::size_t j = 0; j < N; ++j)
+                    next[i] += covariance[i][j] * axis[j];
+
+            float largest = 0.0f;
+            for (auto value : next)
+                largest = std::max(largest, std::abs(value));
+            if (largest <= 0.0f) {
+                // All colors are the same.
+                start = end = mean;
+                return;
+            }
+            for (std::size_t i = 0; i < N; ++i)
+                axis[i] = next[i] / largest;
+        }
+
+        float lengthSquared = 0.0f;
+        for (auto value : axis)
+            lengthSquared += value * value;
+
+        auto minimum = std::numeric_limits<float>::max();
+        auto maximum = std::numeric_limits<float>::lowest();
+        for (const auto& point : points) {
+            float projection = 0.0f;
+            for (std::size_t c = 0; c < N; ++c)
+                projection += (point[c] - mean[c]) * axis[c];
+            minimum = std::min(minimum, projection);
+            maximum = std::max(maximum, projection);
+        }
+        for (std::size_t c = 0; c < N; ++c) {
+            start[c] = clampChannel(mean[c] + axis[c] * minimum / lengthSquared);
+            end[c] = clampChannel(mean[c] + axis[c] * maximum / lengthSquared);
+        }
+    }
+
+    /**
+     * Solves for the endpoints that best reproduce the colors with the given interpolation
+     * weights, where 0 selects the start and 1 the end. Returns false if the weights don't
+     * determine both endpoints, e.g. because they're all the same.
+     */
+    template <std::size_t N>
+    bool refitBlockEndpoints(const BlockPoints<N>& points, const std::array<float, blockPixelCount>& weights, Endpoint<N>& start,
+                             Endpoint<N>& end) noexcept {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        Endpoint<N> ap = {}, bp = {};
+        for (std::size_t i = 0; i < blockPixelCount; ++i) {
+            const auto a = 1.0f - weights[i];
+            const auto b = weights[i];
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (std::size_t c = 0; c < N; ++c) {
+                ap[c] += a * points[i][c];
+                bp[c] += b * points[i][c];
+            }
+        }
+
+        const auto determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1e-6f)
+            return false;
+        for (std::size_t c = 0; c < N; ++c) {
+            start[c] = clampChannel((ap[c] * bb - bp[c] * ab) / determinant);
+            end[c] = clampChannel((bp[c] * aa - ap[c] * ab) / determinant);
+        }
+        return true;
+    }
+
+    // ↓ -------------------   BC1    ------------------- ↓
+    [[nodiscard]] auto packColor565(const Endpoint<3>& color) noexcept -> uint16_t {
+        const auto r = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+        const auto g = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+        const auto b = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    [[nodiscard]] auto unpackColor565(uint16_t color) noexcept -> std::array<int32_t, 3> {
+        const auto r = (color >> 11) & 0x1F;
+        const auto g = (color >> 5) & 0x3F;
+        const auto b = color & 0x1F;
+        return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+    }
+
+    // The RGBA palette of a color block. BC3 color blocks always use the four color mode.
+    [[nodiscard]] auto getBc1Palette(uint16_t color0, uint16_t color1, bool alwaysFourColors) noexcept
+        -> std::array<std::array<int32_t, 4>, 4> {
+        const auto a = unpackColor565(color0);
+        const auto b = unpackColor565(color1);
+        std::array<std::array<int32_t, 4>, 4> palette;
+        for (std::size_t c = 0; c < 3; ++c) {
+            palette[0][c] = a[c];
+            palette[1][c] = b[c];
+            if (color0 > color1 || alwaysFourColors) {
+                palette[2][c] = (2 * a[c] + b[c]) / 3;
+                palette[3][c] = (a[c] + 2 * b[c]) / 3;
+            } else {
+                palette[2][c] = (a[c] + b[c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        palette[0][3] = palette[1][3] = palette[2][3] = 255;
+        palette[3][3] = color0 > color1 || alwaysFourColors ? 255 : 0;
+        return palette;
+    }
+
+    void encodeBc1Block(const uint8_t* pixels, std::byte* block) noexcept {
+        BlockPoints<3> points;
+        for (std::size_t i = 0; i < blockPixelCount; ++i)
+            for (std::size_t c = 0; c < 3; ++c)
+                points[i][c] = static_cast<float>(pixels[i * 4 + c]);
+
+        Endpoint<3> start, end;
+        findBlockEndpoints(points, start, end);
+
+        // The weights of the palette entries along the line from color0 to color1.
+        static constexpr std::array<float, 4> paletteWeights = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        auto bestError = std::numeric_limits<int32_t>::max();
+        uint16_t bestColors[2] = {};
+        uint32_t bestIndices = 0;
+        for (uint32_t iteration = 0; iteration < 3; ++iteration) {
+            auto color0 = packColor565(start);
+            auto color1 = packColor565(end);
+            // The four color mode requires color0 > color1.
+            if (color0 < color1)
+                std::swap(color0, color1);
+
+            const auto palette = getBc1Palette(color0, color1, false);
+            const auto entries = color0 == color1 ? 1U : 4U;
+            int32_t error = 0;
+            uint32_t indices = 0;
+            std::array<float, blockPixelCount> weights;
+            for (std::size_t i = 0; i < blockPixelCount; ++i) {
+                auto bestEntryError = std::numeric_limits<int32_t>::max();
+                uint32_t bestEntry = 0;
+                for (uint32_t entry = 0; entry < entries; ++entry) {
+                    int32_t entryError = 0;
+                    for (std::size_t c = 0; c < 3; ++c) {
+                        const auto difference = static_cast<int32_t>(pixels[i * 4 + c]) - palette[entry][c];
+                        entryError += difference * difference;
+                    }
+                    if (entryError < bestEntryError) {
+                        bestEntryError = entryError;
+                        bestEntry = entry;
+                    }
+                }
+                error += bestEntryError;
+                indices |= bestEntry << (i * 2);
+                weights[i] = paletteWeights[bestEntry];
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                bestColors[0] = color0;
+                bestColors[1] = color1;
+                bestIndices = indices;
+            }
+            if (error == 0 || !refitBlockEndpoints(points, weights, start, end))
+                break;
+        }
+
+        std::memcpy(block, &bestColors[0], 2);
+        std::memcpy(block + 2, &bestColors[1], 2);
+        std::memcpy(block + 4, &bestIndices, 4);
+    }
+
+    void decodeBc1Block(const std::byte* block, uint8_t* pixels, bool alwaysFourColors) noexcept {
+        uint16_t colors[2];
+        uint32_t indices;
+        std::memcpy(&colors[0], block, 2);
+        std::memcpy(&colors[1], block + 2, 2);
+        std::memcpy(&indices, block + 4, 4);
+
+        const auto palette = getBc1Palette(colors[0], colors[1], alwaysFourColors);
+        for (std::size_t i = 0; i < blockPixelCount; ++i) {
+            const auto& entry = palette[(indices >> (i * 2)) & 0x3];
+            for (std::size_t c = 0; c < 4; ++c)
+                pixels[i * 4 + c] = static_cast<uint8_t>(entry[c]);
+        }
+    }
+    // ↑ -------------------   BC1    ------------------- ↑
+
+    // ↓ -------------------   BC4    ------------------- ↓
+    [[nodiscard]] auto getBc4Palette(uint8_t value0, uint8_t value1) noexcept -> std::array<int32_t, 8> {
+        std::array<int32_t, 8> palette = { value0, value1 };
+        if (value0 > value1) {
+            for (int32_t i = 1; i < 7; ++i)
+                palette[i + 1] = ((7 - i) * value0 + i * value1 + 3) / 7;
+        } else {
+            for (int32_t i = 1; i < 5; ++i)
+                palette[i + 1] = ((5 - i) * value0 + i * value1 + 2) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+        return palette;
+    }
+
+    // Encodes a single channel of the pixels, which is used for BC3 alpha, BC4 and BC5.
+    void encodeBc4Block(const uint8_t* pixels, std::size_t channel, std::byte* block) noexcept {
+        uint8_t minimum = 255, maximum = 0;
+        for (std::size_t i = 0; i < blockPixelCount; ++i) {
+            minimum = std::min(minimum, pixels[i * 4 + channel]);
+            maximum = std::max(maximum, pixels[i * 4 + channel]);
+        }
+
+        // With maximum > minimum, the eight value mode is used. Otherwise every index is 0.
+        const auto palette = getBc4Palette(maximum, minimum);
+        uint64_t indices = 0;
+        if (maximum > minimum) {
+            for (std::size_t i = 0; i < blockPixelCount; ++i) {
+                const auto value = static_cast<int32_t>(pixels[i * 4 + channel]);
+                uint64_t bestEntry = 0;
+                for (uint64_t entry = 1; entry < palette.size(); ++entry)
+                    if (std::abs(palette[entry] - value) < std::abs(palette[bestEntry] - value))
+                        bestEntry = entry;
+                indices |= bestEntry << (i * 3);
+            }
+        }
+
+        block[0] = static_cast<std::byte>(maximum);
+        block[1] = static_cast<std::byte>(minimum);
+        std::memcpy(block + 2, &indices, 6);
+    }
+
+    void decodeBc4Block(const std::byte* block, uint8_t* pixels, std::size_t channel) noexcept {
+        uint64_t indices = 0;
+        std::memcpy(&indices, block + 2, 6);
+        const auto palette = getBc4Palette(static_cast<uint8_t>(block[0]), static_cast<uint8_t>(block[1]));
+        for (std::size_t i = 0; i < blockPixelCount; ++i)
+            pixels[i * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 0x7]);
+    }
+    // ↑ -------------------   BC4    ------------------- ↑
+
+    // ↓ -------------------   BC7    ------------------- ↓
+    // The interpolation weights of BC7 endpoints with 2-bit and 4-bit indices, out of 64.
+    static constexpr std::array<uint32_t, 4> bc7Weights2 = { 0, 21, 43, 64 };
+    static constexpr std::array<uint32_t, 16> bc7Weights4 = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    struct Bc7Endpoint final {
+        // The bits stored for every channel, without the p-bit.
+        std::array<uint32_t, 4> bits = {};
+        uint32_t pBit = 0;
+        // The 8-bit values the decoder expands the bits to.
+        std::array<int32_t, 4> values = {};
+    };
+
+    /**
+     * Quantizes the channels to the given number of bits. With a p-bit, which is shared by all
+     * channels and appended as the lowest bit, both values are tried and the closer result kept.
+     */
+    [[nodiscard]] auto quantizeBc7Endpoint(const float* endpoint, std::size_t channelCount, uint32_t bitCount, bool withPBit) noexcept
+        -> Bc7Endpoint {
+        Bc7Endpoint best = {};
+        auto bestError = std::numeric_limits<float>::max();
+        const auto maxValue = static_cast<long>((1U << bitCount) - 1);
+        for (uint32_t pBit = 0; pBit < (withPBit ? 2U : 1U); ++pBit) {
+            Bc7Endpoint candidate = { .pBit = pBit };
+            float error = 0.0f;
+            for (std::size_t c = 0; c < channelCount; ++c) {
+                long quantized;
+                if (withPBit) {
+                    quantized = std::clamp(std::lround((endpoint[c] - static_cast<float>(pBit)) / 2.0f), 0L, maxValue);
+                    candidate.values[c] = static_cast<int32_t>((quantized << 1) | pBit);
+                } else {
+                    quantized = std::clamp(std::lround(endpoint[c] * static_cast<float>(maxValue) / 255.0f), 0L, maxValue);
+                    const auto shift = 8 - bitCount;
+                    candidate.values[c] = static_cast<int32_t>((quantized << shift) | (quantized >> (bitCount - shift)));
+                }
+                candidate.bits[c] = static_cast<uint32_t>(quantized);
+                const auto difference = endpoint[c] - static_cast<float>(candidate.values[c]);
+                error += difference * difference;
+            }
+            if (error < bestError) {
+                bestError = error;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    [[nodiscard]] auto interpolateBc7(int32_t value0, int32_t value1, uint32_t weight) noexcept -> int32_t {
+        return ((64 - static_cast<int32_t>(weight)) * value0 + static_cast<int32_t>(weight) * value1 + 32) >> 6;
+    }
+
+    struct Bc7SubsetFit final {
+        Bc7Endpoint endpoints[2];
+        std::array<uint32_t, blockPixelCount> indices;
+        int32_t error;
+    };
+
+    /**
+     * Fits the endpoints and indices of one set of channels. The highest bit of the first index
+     * is implicitly 0, so the endpoints get swapped and the indices mirrored if necessary, which
+     * gives the same colors as the weights are symmetric.
+     */
+    template <std::size_t N>
+    auto fitBc7Subset(const BlockPoints<N>& points, std::span<const uint32_t> weightTable, uint32_t bitCount, bool withPBit) noexcept
+        -> Bc7SubsetFit {
+        Endpoint<N> start, end;
+        findBlockEndpoints(points, start, end);
+
+        Bc7SubsetFit best = {};
+        best.error = std::numeric_limits<int32_t>::max();
+        for (uint32_t iteration = 0; iteration < 3; ++iteration) {
+            Bc7SubsetFit fit = {};
+            fit.endpoints[0] = quantizeBc7Endpoint(start.data(), N, bitCount, withPBit);
+            fit.endpoints[1] = quantizeBc7Endpoint(end.data(), N, bitCount, withPBit);
+            std::array<std::array<int32_t, N>, 16> palette;
+            for (std::size_t entry = 0; entry < weightTable.size(); ++entry)
+                for (std::size_t c = 0; c < N; ++c)
+                    palette[entry][c] = interpolateBc7(fit.endpoints[0].values[c], fit.endpoints[1].values[c], weightTable[entry]);
+
+            std::array<float, blockPixelCount> weights;
+            for (std::size_t i = 0; i < blockPixelCount; ++i) {
+                auto bestEntryError = std::numeric_limits<int32_t>::max();
+                uint32_t bestEntry = 0;
+                for (uint32_t entry = 0; entry < weightTable.size(); ++entry) {
+                    int32_t entryError = 0;
+                    for (std::size_t c = 0; c < N; ++c) {
+                        const auto difference = static_cast<int32_t>(points[i][c]) - palette[entry][c];
+                        entryError += difference * difference;
+                    }
+                    if (entryError < bestEntryError) {
+                        bestEntryError = entryError;
+                        bestEntry = entry;
+                    }
+                }
+                fit.error += bestEntryError;
+                fit.indices[i] = bestEntry;
+                weights[i] = static_cast<float>(weightTable[bestEntry]) / 64.0f;
+            }
+
+            if (fit.error < best.error)
+                best = fit;
+            if (fit.error == 0 || !refitBlockEndpoints(points, weights, start, end))
+                break;
+        }
+
+        const auto indexCount = static_cast<uint32_t>(weightTable.size());
+        if (best.indices[0] >= indexCount / 2) {
+            std::swap(best.endpoints[0], best.endpoints[1]);
+            for (auto& index : best.indices)
+                index = indexCount - 1 - index;
+        }
+        return best;
+    }
+
+    void writeBc7Indices(BlockBitWriter& writer, const std::array<uint32_t, blockPixelCount>& indices, uint32_t bitCount) noexcept {
+        writer.write(indices[0], bitCount - 1);
+        for (std::size_t i = 1; i < blockPixelCount; ++i)
+            writer.write(indices[i], bitCount);
+    }
+
+    /**
+     * Tries mode 6, which interpolates RGBA along a single line with 4-bit indices, and mode 5,
+     * which has separate 2-bit indices for the colors and alpha. The latter is better when alpha
+     * doesn't correlate with the colors.
+     */
+    void encodeBc7Block(const uint8_t* pixels, std::byte* block) noexcept {
+        BlockPoints<4> points;
+        BlockPoints<3> colors;
+        BlockPoints<1> alphas;
+        for (std::size_t i = 0; i < blockPixelCount; ++i) {
+            for (std::size_t c = 0; c < 4; ++c)
+                points[i][c] = static_cast<float>(pixels[i * 4 + c]);
+            for (std::size_t c = 0; c < 3; ++c)
+                colors[i][c] = points[i][c];
+            alphas[i][0] = points[i][3];
+        }
+
+        BlockBitWriter writer;
+        const auto mode6 = fitBc7Subset(points, bc7Weights4, 7, true);
+        auto mode5Color = mode6;
+        auto mode5Alpha = mode6;
+        if (mode6.error > 0) {
+            mode5Color = fitBc7Subset(colors, bc7Weights2, 7, false);
+            mode5Alpha = fitBc7Subset(alphas, bc7Weights2, 8, false);
+        }
+
+        if (mode6.error == 0 || mode6.error <= mode5Color.error + mode5Alpha.error) {
+            writer.write(1U << 6, 7);
+            for (std::size_t c = 0; c < 4; ++c) {
+                writer.write(mode6.endpoints[0].bits[c], 7);
+                writer.write(mode6.endpoints[1].bits[c], 7);
+            }
+            writer.write(mode6.endpoints[0].pBit, 1);
+            writer.write(mode6.endpoints[1].pBit, 1);
+            writeBc7Indices(writer, mode6.indices, 4);
+        } else {
+            // Mode 5 without a channel rotation.
+            writer.write(1U << 5, 6);
+            writer.write(0, 2);
+            for (std::size_t c = 0; c < 3; ++c) {
+                writer.write(mode5Color.endpoints[0].bits[c], 7);
+                writer.write(mode5Color.endpoints[1].bits[c], 7);
+            }
+            writer.write(mode5Alpha.endpoints[0].bits[0], 8);
+            writer.write(mode5Alpha.endpoints[1].bits[0], 8);
+            writeBc7Indices(writer, mode5Color.indices, 2);
+            writeBc7Indices(writer, mode5Alpha.indices, 2);
+        }
+        std::memcpy(block, writer.words, 16);
+    }
+
+    void decodeBc7Block(const std::byte* block, uint8_t* pixels) noexcept {
+        BlockBitReader reader;
+        std::memcpy(reader.words, block, 16);
+        uint32_t mode = 0;
+        while (mode < 8 && reader.read(1) == 0)
+            ++mode;
+
+        if (mode == 6) {
+            std::array<int32_t, 4> endpoints[2];
+            for (std::size_t c = 0; c < 4; ++c) {
+                endpoints[0][c] = static_cast<int32_t>(reader.read(7) << 1);
+                endpoints[1][c] = static_cast<int32_t>(reader.read(7) << 1);
+            }
+            for (auto& endpoint : endpoints) {
+                const auto pBit = static_cast<int32_t>(reader.read(1));
+                for (auto& value : endpoint)
+                    value |= pBit;
+            }
+            for (std::size_t i = 0; i < blockPixelCount; ++i) {
+                const auto weight = bc7Weights4[reader.read(i == 0 ? 3 : 4)];
+                for (std::size_t c = 0; c < 4; ++c)
+                    pixels[i * 4 + c] = static_cast<uint8_t>(interpolateBc7(endpoints[0][c], endpoints[1][c], weight));
+            }
+        } else if (mode == 5) {
+            const auto rotation = reader.read(2);
+            std::array<int32_t, 4> endpoints[2];
+            for (std::size_t c = 0; c < 3; ++c) {
+                for (auto& endpoint : endpoints) {
+                    const auto value = reader.read(7);
+                    endpoint[c] = static_cast<int32_t>((value << 1) | (value >> 6));
+                }
+            }
+            endpoints[0][3] = static_cast<int32_t>(reader.read(8));
+            endpoints[1][3] = static_cast<int32_t>(reader.read(8));
+
+            std::array<uint32_t, blockPixelCount> colorIndices, alphaIndices;
+            for (std::size_t i = 0; i < blockPixelCount; ++i)
+                colorIndices[i] = reader.read(i == 0 ? 1 : 2);
+            for (std::size_t i = 0; i < blockPixelCount; ++i)
+                alphaIndices[i] = reader.read(i == 0 ? 1 : 2);
+            for (std::size_t i = 0; i < blockPixelCount; ++i) {
+                auto* pixel = pixels + i * 4;
+                for (std::size_t c = 0; c < 3; ++c)
+                    pixel[c] = static_cast<uint8_t>(interpolateBc7(endpoints[0][c], endpoints[1][c], bc7Weights2[colorIndices[i]]));
+                pixel[3] = static_cast<uint8_t>(interpolateBc7(endpoints[0][3], endpoints[1][3], bc7Weights2[alphaIndices[i]]));
+                // The rotation swaps alpha with one of the color channels.
+                if (rotation != 0)
+                    std::swap(pixel[3], pixel[rotation - 1]);
+            }
+        } else {
+            std::memset(pixels, 0, blockPixelCount * 4);
+        }
+    }
+    // ↑ -------------------   BC7    ------------------- ↑
+} // namespace krypton::util
+
+void ku::encodeBlock(BlockCompression compression, const uint8_t* pixels, std::byte* block) {
+    switch (compression) {
+        case BlockCompression::None:
+            break;
+        case BlockCompression::BC1:
+            encodeBc1Block(pixels, block);
+            break;
+        case BlockCompression::BC3:
+            encodeBc4Block(pixels, 3, block);
+            encodeBc1Block(pixels, block + 8);
+            break;
+        case BlockCompression::BC4:
+            encodeBc4Block(pixels, 0, block);
+            break;
+        case BlockCompression::BC5:
+            encodeBc4Block(pixels, 0, block);
+            encodeBc4Block(pixels, 1, block + 8);
+            break;
+        case BlockCompression::BC7:
+            encodeBc7Block(pixels, block);
+            break;
+    }
+}
+
+void ku::decodeBlock(BlockCompression compression, const std::byte* block, uint8_t* pixels) {
+    if (compression != BlockCompression::BC1 && compression != BlockCompression::BC3 && compression != BlockCompression::BC7) {
+        for (std::size_t i = 0; i < blockPixelCount; ++i) {
+            pixels[i * 4 + 0] = pixels[i * 4 + 1] = pixels[i * 4 + 2] = 0;
+            pixels[i * 4 + 3] = 255;
+        }
+    }
+
+    switch (compression) {
+        case BlockCompression::None:
+            break;
+        case BlockCompression::BC1:
+            decodeBc1Block(block, pixels, false);
+            break;
+        case BlockCompression::BC3:
+            decodeBc1Block(block + 8, pixels, true);
+            decodeBc4Block(block, pixels, 3);
+            break;
+        case BlockCompression::BC4:
+            decodeBc4Block(block, pixels, 0);
+            break;
+        case BlockCompression::BC5:
+            decodeBc4Block(block, pixels, 0);
+            decodeBc4Block(block + 8, pixels, 1);
+            break;
+        case BlockCompression::BC7:
+            decodeBc7Block(block, pixels);
+            break;
+    }
+}
+
+void ku::compressImage(std::span<const std::byte> src, uint32_t width, uint32_t height, BlockCompression compression,
+                       std::span<std::byte> dst, uint32_t firstBlockRow, uint32_t blockRowCount) {
+    ZoneScoped;
+    const auto blockSize = getCompressedBlockSize(compression);
+    const auto blocksWide = getCompressedBlockCount(width);
+    VERIFY(compression != BlockCompression::None);
+    VERIFY(src.size() >= static_cast<std::size_t>(width) * height * 4);
+    VERIFY(dst.size() >= getCompressedImageSize(width, height, compression));
+    VERIFY(firstBlockRow + blockRowCount <= getCompressedBlockCount(height));
+
+    std::array<uint8_t, blockPixelCount * 4> pixels;
+    for (auto blockY = firstBlockRow; blockY < firstBlockRow + blockRowCount; ++blockY) {
+        for (uint32_t blockX = 0; blockX < blocksWide; ++blockX) {
+            for (uint32_t y = 0; y < compressedBlockExtent; ++y) {
+                const auto sourceY = std::min(blockY * compressedBlockExtent + y, height - 1);
+                for (uint32_t x = 0; x < compressedBlockExtent; ++x) {
+                    const auto sourceX = std::min(blockX * compressedBlockExtent + x, width - 1);
+                    const auto sourceIndex = static_cast<std::size_t>(sourceY) * width + sourceX;
+                    std::memcpy(&pixels[(y * compressedBlockExtent + x) * 4], &src[sourceIndex * 4], 4);
+                }
+            }
+            encodeBlock(compression, pixels.data(), &dst[(static_cast<std::size_t>(blockY) * blocksWide + blockX) * blockSize]);
+        }
+    }
+}
+
+void ku::decompressImage(std::span<const std::byte> src, uint32_t width, uint32_t height, BlockCompression compression,
+                         std::span<std::byte> dst) {
+    ZoneScoped;
+    const auto blockSize = getCompressedBlockSize(compression);
+    const auto blocksWide = getCompressedBlockCount(width);
+    VERIFY(compression != BlockCompression::None);
+    VERIFY(src.size() >= getCompressedImageSize(width, height, compression));
+    VERIFY(dst.size() >= static_cast<std::size_t>(width) * height * 4);
+
+    std::array<uint8_t, blockPixelCount * 4> pixels;
+    for (uint32_t blockY = 0; blockY < getCompressedBlockCount(height); ++blockY) {
+        for (uint32_t blockX = 0; blockX < blocksWide; ++blockX) {
+            decodeBlock(compression, &src[(static_cast<std::size_t>(blockY) * blocksWide + blockX) * blockSize], pixels.data());
+            for (uint32_t y = 0; y < compressedBlockExtent; ++y) {
+                const auto targetY = blockY * compressedBlockExtent + y;
+                for (uint32_t x = 0; x < compressedBlockExtent; ++x) {
+                    const auto targetX = blockX * compressedBlockExtent + x;
+                    if (targetX >= width || targetY >= height)
+                        continue;
+                    const auto targetIndex = static_cast<std::size_t>(targetY) * width + targetX;
+                    std::memcpy(&dst[targetIndex * 4], &pixels[(y * compressedBlockExtent + x) * 4], 4);
+                }
+            }
+        }
+    }
+}
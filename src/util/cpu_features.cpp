@@ -0,0 +1,147 @@
+#include <array>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
+
+#include <util/bits.hpp>
+#include <util/cpu_features.hpp>
+
+#ifdef KRYPTON_ARCH_X86
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    constexpr std::array<std::pair<CpuFeature, std::string_view>, 6> cpuFeatureNames = { {
+        { CpuFeature::SSE42, "sse4.2" },
+        { CpuFeature::AVX2, "avx2" },
+        { CpuFeature::FMA, "fma" },
+        { CpuFeature::F16C, "f16c" },
+        { CpuFeature::AVX512, "avx512" },
+        { CpuFeature::NEON, "neon" },
+    } };
+
+#ifdef KRYPTON_ARCH_X86
+    struct CpuidResult {
+        uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+    };
+
+    CpuidResult cpuid(uint32_t leaf, uint32_t subleaf) {
+        CpuidResult result = {};
+    #if defined(_MSC_VER)
+        std::array<int, 4> registers = {};
+        __cpuidex(registers.data(), static_cast<int>(leaf), static_cast<int>(subleaf));
+        result = { static_cast<uint32_t>(registers[0]), static_cast<uint32_t>(registers[1]), static_cast<uint32_t>(registers[2]),
+                   static_cast<uint32_t>(registers[3]) };
+    #else
+        __cpuid_count(leaf, subleaf, result.eax, result.ebx, result.ecx, result.edx);
+    #endif
+        return result;
+    }
+
+    // Reads the XCR0 register, which tells us which register states the OS saves on context
+    // switches. A CPU might support AVX, but if the OS does not save the YMM registers we can't
+    // use it.
+    uint64_t xgetbv() {
+    #if defined(_MSC_VER)
+        return _xgetbv(0);
+    #else
+        uint32_t eax = 0, edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+    #endif
+    }
+
+    CpuFeature detectCpuFeatures() {
+        auto features = CpuFeature::None;
+
+        const auto maxLeaf = cpuid(0, 0).eax;
+        if (maxLeaf < 1)
+            return features;
+
+        const auto leaf1 = cpuid(1, 0);
+        if (leaf1.ecx & (1U << 20))
+            features = features | CpuFeature::SSE42;
+
+        // Without OSXSAVE we can't query XCR0 and must assume that no AVX state is saved.
+        const bool osxsave = (leaf1.ecx & (1U << 27)) != 0;
+        const uint64_t xcr0 = osxsave ? xgetbv() : 0;
+        const bool avxStateEnabled = (xcr0 & 0x6) == 0x6;
+        const bool avx512StateEnabled = avxStateEnabled && (xcr0 & 0xE0) == 0xE0;
+
+        if (!avxStateEnabled || !(leaf1.ecx & (1U << 28)))
+            return features;
+
+        if (leaf1.ecx & (1U << 12))
+            features = features | CpuFeature::FMA;
+        if (leaf1.ecx & (1U << 29))
+            features = features | CpuFeature::F16C;
+
+        if (maxLeaf >= 7) {
+            const auto leaf7 = cpuid(7, 0);
+            if (leaf7.ebx & (1U << 5))
+                features = features | CpuFeature::AVX2;
+
+            constexpr uint32_t avx512Bits = (1U << 16) | (1U << 30) | (1U << 31); // F, BW, VL
+            if (avx512StateEnabled && (leaf7.ebx & avx512Bits) == avx512Bits)
+                features = features | CpuFeature::AVX512;
+        }
+
+        return features;
+    }
+#else
+    CpuFeature detectCpuFeatures() {
+    #ifdef KRYPTON_HAS_NEON
+        return CpuFeature::NEON;
+    #else
+        return CpuFeature::None;
+    #endif
+    }
+#endif
+
+    CpuFeature getDisabledCpuFeatures() {
+        const char* env = std::getenv("KRYPTON_DISABLE_CPU_FEATURES"); // NOLINT
+        if (env == nullptr)
+            return CpuFeature::None;
+
+        auto disabled = CpuFeature::None;
+        std::string_view list = env;
+        while (!list.empty()) {
+            auto separator = list.find(',');
+            auto name = list.substr(0, separator);
+            for (const auto& [feature, featureName] : cpuFeatureNames) {
+                if (name == featureName)
+                    disabled = disabled | feature;
+            }
+            list = separator == std::string_view::npos ? std::string_view {} : list.substr(separator + 1);
+        }
+        return disabled;
+    }
+} // namespace krypton::util
+
+ku::CpuFeature ku::getCpuFeatures() noexcept {
+    // Static initialization is thread-safe, so this is only ever detected once.
+    static const CpuFeature features = detectCpuFeatures() & ~getDisabledCpuFeatures();
+    return features;
+}
+
+bool ku::hasCpuFeatures(CpuFeature features) noexcept {
+    return (getCpuFeatures() & features) == features;
+}
+
+std::string ku::getCpuFeatureString(CpuFeature features) {
+    std::string result;
+    for (const auto& [feature, name] : cpuFeatureNames) {
+        if (!hasBit(features, feature))
+            continue;
+        if (!result.empty())
+            result += ", ";
+        result += name;
+    }
+    return result.empty() ? "none" : result;
+}
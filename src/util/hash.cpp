@@ -0,0 +1,92 @@
+#include <bit>
+#include <cstring>
+
+#include <util/hash.hpp>
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    static constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t prime3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+    // memcpy is the only well-defined way to do unaligned reads; compilers turn this into a
+    // single mov. We always read little endian so that hashes are the same on every platform.
+    template <typename T>
+    inline T readLittleEndian(const uint8_t* data) noexcept {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        if constexpr (std::endian::native == std::endian::big) {
+            T swapped = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+                swapped |= ((value >> (i * 8)) & 0xFF) << ((sizeof(T) - 1 - i) * 8);
+            return swapped;
+        }
+        return value;
+    }
+
+    inline uint64_t hashRound(uint64_t accumulator, uint64_t input) noexcept {
+        accumulator += input * prime2;
+        accumulator = std::rotl(accumulator, 31);
+        return accumulator * prime1;
+    }
+
+    inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) noexcept {
+        accumulator ^= hashRound(0, value);
+        return accumulator * prime1 + prime4;
+    }
+} // namespace krypton::util
+
+auto ku::hashBytes(const void* data, std::size_t size, uint64_t seed) noexcept -> uint64_t {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const auto* end = bytes + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + prime1 + prime2;
+        uint64_t v2 = seed + prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - prime1;
+        const auto* limit = end - 32;
+        do {
+            v1 = hashRound(v1, readLittleEndian<uint64_t>(bytes));
+            v2 = hashRound(v2, readLittleEndian<uint64_t>(bytes + 8));
+            v3 = hashRound(v3, readLittleEndian<uint64_t>(bytes + 16));
+            v4 = hashRound(v4, readLittleEndian<uint64_t>(bytes + 24));
+            bytes += 32;
+        } while (bytes <= limit);
+
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    } else {
+        hash = seed + prime5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    for (; bytes + 8 <= end; bytes += 8) {
+        hash ^= hashRound(0, readLittleEndian<uint64_t>(bytes));
+        hash = std::rotl(hash, 27) * prime1 + prime4;
+    }
+    if (bytes + 4 <= end) {
+        hash ^= static_cast<uint64_t>(readLittleEndian<uint32_t>(bytes)) * prime1;
+        hash = std::rotl(hash, 23) * prime2 + prime3;
+        bytes += 4;
+    }
+    for (; bytes < end; ++bytes) {
+        hash ^= static_cast<uint64_t>(*bytes) * prime5;
+        hash = std::rotl(hash, 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
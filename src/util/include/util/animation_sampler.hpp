@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace krypton::util {
+    // The interpolation modes of glTF animation samplers.
+    enum class Interpolation : uint8_t {
+        Step = 0,
+        Linear = 1,
+        // Every key has an in-tangent, a value and an out-tangent.
+        CubicSpline = 2,
+    };
+
+    struct KeyframeTrack final {
+        // The times of the keys are times[firstKey, firstKey + keyCount), in increasing order.
+        uint32_t firstKey = 0;
+        uint32_t keyCount = 0;
+        // The index of the first value of every component in its pool. Cubic splines store three
+        // values per key.
+        uint32_t firstValues[4] = {};
+        uint8_t componentCount = 0;
+        Interpolation interpolation = Interpolation::Linear;
+        // Rotations are quaternions, which are interpolated along the shorter arc and normalized.
+        bool rotation = false;
+        // Whether the values are stored in quantizedValues instead of values.
+        bool quantized = false;
+        // Quantized values are decoded as offset + value * scale.
+        float offset[4] = {};
+        float scale[4] = {};
+    };
+
+    /**
+     * The keyframes of many tracks, e.g. all channels of an animation. The times and values of
+     * all tracks are stored in shared pools, with every value component in its own array, so
+     * that the keys of a track are contiguous and tracks with fewer components take less space.
+     */
+    struct KeyframeTracks final {
+        std::vector<KeyframeTrack> tracks;
+        std::vector<float> times;
+        std::array<std::vector<float>, 4> values;
+        // The values of quantized tracks, as 16-bit fractions of the range of their track.
+        std::array<std::vector<uint16_t>, 4> quantizedValues;
+
+        /**
+         * Appends a track and returns its index. keyValues holds componentCount interleaved floats
+         * per value, with three values per key for cubic splines (in-tangent, value,
+         * out-tangent), just like glTF. Quantized tracks store their values with 16 bits within
+         * the range of each component, which halves their size.
+         */
+        auto addTrack(std::span<const float> keyTimes, std::span<const float> keyValues, uint32_t componentCount,
+                      Interpolation interpolation, bool rotation, bool quantize) -> uint32_t;
+        void clear() noexcept;
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+        // The time of the last key of any track.
+        [[nodiscard]] auto getDuration() const noexcept -> float;
+    };
+
+    // The sampled value of every track, with every component in its own array.
+    struct TrackSamples final {
+        std::array<std::vector<float>, 4> values;
+
+        void resize(std::size_t size);
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+    };
+
+    /**
+     * Samples the tracks [first, first + count) at the given time and writes the results to the
+     * same indices of out, which has to be at least as big as tracks. Components a track doesn't
+     * have are 0. Times outside of the keys of a track are clamped to its first or last key.
+     *
+     * cursors is either empty or holds a key index for every track, which is where the search for
+     * the current key starts and which is updated with the key that was found. With cursors,
+     * playing an animation forward only has to look at one or two keys per track and sample.
+     */
+    void sampleTracks(const KeyframeTracks& tracks, std::size_t first, std::size_t count, float time, std::span<uint32_t> cursors,
+                      TrackSamples& out);
+
+    // Samples all tracks, split into chunks across the Scheduler.
+    void sampleTracks(const KeyframeTracks& tracks, float time, std::span<uint32_t> cursors, TrackSamples& out);
+} // namespace krypton::util
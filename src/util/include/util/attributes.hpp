@@ -6,3 +6,18 @@
 #else
     #define ALWAYS_INLINE
 #endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    // GCC and Clang only allow the use of intrinsics for instruction sets that are enabled for the
+    // current function. These attributes enable them for a single function, so that we can ship
+    // multiple kernel variants in one binary without compiling everything with e.g. -mavx2.
+    // The features enabled by TARGET_AVX2 have to match krypton::util::avx2TargetFeatures.
+    #define TARGET_SSE42 [[gnu::target("sse4.2")]]
+    #define TARGET_AVX2 [[gnu::target("avx2,fma,f16c")]]
+    #define TARGET_AVX512 [[gnu::target("avx512f,avx512bw,avx512vl,avx2,fma,f16c")]]
+#else
+    // MSVC allows any intrinsic to be used anywhere.
+    #define TARGET_SSE42
+    #define TARGET_AVX2
+    #define TARGET_AVX512
+#endif
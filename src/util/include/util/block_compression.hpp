@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <util/mip_filter.hpp>
+
+namespace krypton::util {
+    // The block compressed formats we can encode. The values match the format numbers.
+    enum class BlockCompression : uint8_t {
+        None = 0,
+        // Opaque RGB with 4 bits per pixel.
+        BC1 = 1,
+        // RGB like BC1, with a separate alpha block like BC4.
+        BC3 = 3,
+        // A single channel with 4 bits per pixel.
+        BC4 = 4,
+        // Two independent BC4 channels, mostly used for normal maps.
+        BC5 = 5,
+        // RGBA with 8 bits per pixel and the best quality.
+        BC7 = 7,
+    };
+
+    // Every block covers 4x4 pixels.
+    static constexpr uint32_t compressedBlockExtent = 4;
+
+    [[nodiscard]] constexpr auto getCompressedBlockSize(BlockCompression compression) noexcept -> std::size_t {
+        switch (compression) {
+            case BlockCompression::None:
+                return 0;
+            case BlockCompression::BC1:
+            case BlockCompression::BC4:
+                return 8;
+            case BlockCompression::BC3:
+            case BlockCompression::BC5:
+            case BlockCompression::BC7:
+                return 16;
+        }
+        return 0;
+    }
+
+    [[nodiscard]] constexpr auto getCompressedBlockCount(uint32_t extent) noexcept -> uint32_t {
+        return (extent + compressedBlockExtent - 1) / compressedBlockExtent;
+    }
+
+    // The size of a compressed image. Partial blocks at the right and bottom edges count fully.
+    [[nodiscard]] constexpr auto getCompressedImageSize(uint32_t width, uint32_t height, BlockCompression compression) noexcept
+        -> std::size_t {
+        return static_cast<std::size_t>(getCompressedBlockCount(width)) * getCompressedBlockCount(height) *
+               getCompressedBlockSize(compression);
+    }
+
+    // The size of the first levelCount levels of a compressed mip chain, with every level tightly packed.
+    [[nodiscard]] constexpr auto getCompressedMipChainSize(uint32_t width, uint32_t height, uint32_t levelCount,
+                                                           BlockCompression compression) noexcept -> std::size_t {
+        std::size_t size = 0;
+        for (uint32_t level = 0; level < levelCount; ++level)
+            size += getCompressedImageSize(getMipExtent(width, level), getMipExtent(height, level), compression);
+        return size;
+    }
+
+    /**
+     * Encodes 4x4 RGBA8 pixels, given row by row, into a single block. BC4 only encodes the red
+     * channel, BC5 the red and green channels. BC1 always uses the opaque four color mode, so
+     * BC3 or BC7 have to be used for images with alpha.
+     *
+     * The encoders fit the endpoints along the principal axis of the block's colors and then
+     * refine them with least squares. BC7 only uses modes 5 and 6, which have a single subset
+     * and are fast to encode and good at smooth gradients and alpha, but are noticeably worse
+     * than exhaustive encoders at sharp edges between multiple colors.
+     */
+    void encodeBlock(BlockCompression compression, const uint8_t* pixels, std::byte* block);
+
+    /**
+     * Decodes a single block into 4x4 RGBA8 pixels. Missing channels are 0, and alpha is 255.
+     * The BC7 decoder only supports the mode 5 and 6 blocks written by encodeBlock, and decodes
+     * all other modes to zero.
+     */
+    void decodeBlock(BlockCompression compression, const std::byte* block, uint8_t* pixels);
+
+    /**
+     * Encodes the block rows [firstBlockRow, firstBlockRow + blockRowCount) of an RGBA8 image.
+     * Pixels outside of the image are clamped to the edge. The rows can be encoded
+     * independently, e.g. on multiple threads.
+     */
+    void compressImage(std::span<const std::byte> src, uint32_t width, uint32_t height, BlockCompression compression,
+                       std::span<std::byte> dst, uint32_t firstBlockRow, uint32_t blockRowCount);
+
+    // Decodes a whole image into RGBA8 pixels, e.g. to measure the quality of the encoders.
+    void decompressImage(std::span<const std::byte> src, uint32_t width, uint32_t height, BlockCompression compression,
+                         std::span<std::byte> dst);
+} // namespace krypton::util
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define KRYPTON_ARCH_X86
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+    #define KRYPTON_ARCH_ARM
+    #if defined(__aarch64__) || defined(_M_ARM64)
+        #define KRYPTON_ARCH_ARM64
+    #endif
+    // NEON is mandatory on AArch64, but has to be explicitly enabled on 32-bit ARM.
+    #if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+        #define KRYPTON_HAS_NEON
+    #endif
+#endif
+
+namespace krypton::util {
+    enum class CpuFeature : uint32_t {
+        None = 0,
+        // x86 features
+        SSE42 = 1 << 0,
+        AVX2 = 1 << 1,
+        FMA = 1 << 2,
+        F16C = 1 << 3,
+        AVX512 = 1 << 4, // This implies AVX512F, AVX512BW and AVX512VL.
+        // ARM features
+        NEON = 1 << 8,
+    };
+
+    static constexpr inline CpuFeature operator|(CpuFeature a, CpuFeature b) {
+        return static_cast<CpuFeature>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+    }
+
+    static constexpr inline CpuFeature operator&(CpuFeature a, CpuFeature b) {
+        return static_cast<CpuFeature>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+    }
+
+    static constexpr inline CpuFeature operator~(CpuFeature a) {
+        return static_cast<CpuFeature>(~static_cast<uint32_t>(a));
+    }
+
+    // The features TARGET_AVX2 enables, which every kernel variant compiled with it requires.
+    static constexpr inline CpuFeature avx2TargetFeatures = CpuFeature::AVX2 | CpuFeature::FMA | CpuFeature::F16C;
+
+    /**
+     * Returns the instruction set extensions supported by the CPU and the OS. This is only
+     * detected once and then cached, so it is cheap to call repeatedly.
+     *
+     * Setting the environment variable KRYPTON_DISABLE_CPU_FEATURES to a comma-separated list of
+     * feature names (e.g. "avx512,avx2") masks those features, which is useful to test the
+     * fallback kernels on newer hardware.
+     */
+    [[nodiscard]] auto getCpuFeatures() noexcept -> CpuFeature;
+
+    // Checks whether *all* of the given features are supported.
+    [[nodiscard]] bool hasCpuFeatures(CpuFeature features) noexcept;
+
+    [[nodiscard]] auto getCpuFeatureString(CpuFeature features) -> std::string;
+} // namespace krypton::util
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <util/hash.hpp>
+
+namespace krypton::util {
+    template <typename T>
+    concept FlatMapKey = std::is_integral_v<T> || std::is_enum_v<T>;
+
+    /**
+     * A hash map using open addressing with linear probing. Keys are integers, enums or
+     * InternedStrings, which means no key ever has to allocate or be hashed by a slow function.
+     * All slots live in a single array, so a lookup is usually a single cache miss. Erasing uses
+     * backward shifting instead of tombstones, so the map never degrades over time.
+     *
+     * Pointers to values are invalidated whenever the map grows or an element is erased.
+     */
+    template <FlatMapKey Key, typename Value>
+    requires std::is_default_constructible_v<Value> && std::is_move_assignable_v<Value>
+    class FlatMap final {
+        struct Slot {
+            Key key = {};
+            [[no_unique_address]] Value value = {};
+        };
+
+        std::vector<Slot> slots;
+        std::vector<uint8_t> occupied;
+        std::size_t count = 0;
+        std::size_t mask = 0;
+
+        static constexpr std::size_t npos = ~std::size_t(0);
+        static constexpr std::size_t minCapacity = 8;
+
+        [[nodiscard]] static constexpr auto toInteger(Key key) noexcept -> uint64_t {
+            if constexpr (std::is_enum_v<Key>) {
+                return static_cast<uint64_t>(static_cast<std::underlying_type_t<Key>>(key));
+            } else {
+                return static_cast<uint64_t>(key);
+            }
+        }
+
+        [[nodiscard]] auto bucketOf(Key key) const noexcept -> std::size_t {
+            return static_cast<std::size_t>(mixHash(toInteger(key))) & mask;
+        }
+
+        [[nodiscard]] auto findIndex(Key key) const noexcept -> std::size_t {
+            if (count == 0)
+                return npos;
+            for (auto i = bucketOf(key);; i = (i + 1) & mask) {
+                if (!occupied[i])
+                    return npos;
+                if (slots[i].key == key)
+                    return i;
+            }
+        }
+
+        void rehash(std::size_t newCapacity) {
+            auto oldSlots = std::move(slots);
+            auto oldOccupied = std::move(occupied);
+            slots = std::vector<Slot>(newCapacity);
+            occupied = std::vector<uint8_t>(newCapacity, 0);
+            mask = newCapacity - 1;
+
+            for (std::size_t i = 0; i < oldSlots.size(); ++i) {
+                if (!oldOccupied[i])
+                    continue;
+                auto j = bucketOf(oldSlots[i].key);
+                while (occupied[j])
+                    j = (j + 1) & mask;
+                slots[j] = std::move(oldSlots[i]);
+                occupied[j] = 1;
+            }
+        }
+
+        // We keep the load factor below 3/4, as linear probing gets slow beyond that.
+        void growFor(std::size_t newCount) {
+            if (newCount * 4 <= slots.size() * 3)
+                return;
+            auto capacity = slots.empty() ? minCapacity : slots.size();
+            while (newCount * 4 > capacity * 3)
+                capacity *= 2;
+            rehash(capacity);
+        }
+
+    public:
+        explicit FlatMap() = default;
+
+        [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+            return slots.size();
+        }
+
+        void clear() noexcept {
+            slots.clear();
+            occupied.clear();
+            count = 0;
+            mask = 0;
+        }
+
+        [[nodiscard]] bool contains(Key key) const noexcept {
+            return findIndex(key) != npos;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return count == 0;
+        }
+
+        // Returns true if the key was present.
+        bool erase(Key key) {
+            auto i = findIndex(key);
+            if (i == npos)
+                return false;
+
+            // Shift back every following element of the cluster that would otherwise become
+            // unreachable, i.e. whose ideal bucket is not between the hole and itself.
+            for (auto j = (i + 1) & mask; occupied[j]; j = (j + 1) & mask) {
+                auto ideal = bucketOf(slots[j].key);
+                bool reachable = (i <= j) ? (i < ideal && ideal <= j) : (i < ideal || ideal <= j);
+                if (reachable)
+                    continue;
+                slots[i] = std::move(slots[j]);
+                i = j;
+            }
+
+            slots[i] = Slot {};
+            occupied[i] = 0;
+            --count;
+            return true;
+        }
+
+        [[nodiscard]] auto find(Key key) noexcept -> Value* {
+            auto i = findIndex(key);
+            return i == npos ? nullptr : &slots[i].value;
+        }
+
+        [[nodiscard]] auto find(Key key) const noexcept -> const Value* {
+            auto i = findIndex(key);
+            return i == npos ? nullptr : &slots[i].value;
+        }
+
+        /**
+         * Inserts the value if the key is not yet present. Returns a pointer to the value stored
+         * for the key and whether the insertion took place.
+         */
+        auto insert(Key key, Value value) -> std::pair<Value*, bool> {
+            if (auto i = findIndex(key); i != npos)
+                return { &slots[i].value, false };
+
+            growFor(count + 1);
+            auto i = bucketOf(key);
+            while (occupied[i])
+                i = (i + 1) & mask;
+            slots[i] = Slot { key, std::move(value) };
+            occupied[i] = 1;
+            ++count;
+            return { &slots[i].value, true };
+        }
+
+        // Calls function(key, value) for every element, in no particular order.
+        template <typename Function>
+        void forEach(Function&& function) const {
+            for (std::size_t i = 0; i < slots.size(); ++i)
+                if (occupied[i])
+                    function(slots[i].key, slots[i].value);
+        }
+
+        void reserve(std::size_t size) {
+            growFor(size);
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t {
+            return count;
+        }
+
+        auto operator[](Key key) -> Value& {
+            return *insert(key, Value {}).first;
+        }
+    };
+
+    template <FlatMapKey Key>
+    class FlatSet final {
+        struct Empty {};
+        FlatMap<Key, Empty> map;
+
+    public:
+        explicit FlatSet() = default;
+
+        void clear() noexcept {
+            map.clear();
+        }
+
+        [[nodiscard]] bool contains(Key key) const noexcept {
+            return map.contains(key);
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return map.empty();
+        }
+
+        bool erase(Key key) {
+            return map.erase(key);
+        }
+
+        template <typename Function>
+        void forEach(Function&& function) const {
+            map.forEach([&](Key key, const Empty&) { function(key); });
+        }
+
+        // Returns true if the key was not yet present.
+        bool insert(Key key) {
+            return map.insert(key, Empty {}).second;
+        }
+
+        void reserve(std::size_t size) {
+            map.reserve(size);
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t {
+            return map.size();
+        }
+    };
+} // namespace krypton::util
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace krypton::util {
+    /**
+     * Hashes arbitrary bytes into a 64-bit value. This implements XXH64, which is fast for both
+     * short keys and large buffers and has a good enough distribution to use the result directly
+     * as a key, e.g. for caches. The result is stable across platforms and runs.
+     */
+    [[nodiscard]] auto hashBytes(const void* data, std::size_t size, uint64_t seed = 0) noexcept -> uint64_t;
+
+    [[nodiscard]] inline auto hashString(std::string_view string, uint64_t seed = 0) noexcept -> uint64_t {
+        return hashBytes(string.data(), string.size(), seed);
+    }
+
+    /**
+     * Mixes the bits of an integer so that sequential values are spread across the whole range.
+     * This is used by the flat containers to turn e.g. indices into bucket positions.
+     */
+    [[nodiscard]] constexpr auto mixHash(uint64_t value) noexcept -> uint64_t {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+} // namespace krypton::util
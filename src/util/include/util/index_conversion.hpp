@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace krypton::util {
+    /**
+     * Widens 8-bit or 16-bit indices to 32-bit indices. The destination has to be at least as
+     * large as the source. These use the widest vector instructions available on the CPU.
+     */
+    void widenIndices(std::span<const uint8_t> src, std::span<uint32_t> dst);
+    void widenIndices(std::span<const uint16_t> src, std::span<uint32_t> dst);
+    void widenIndices(std::span<const uint8_t> src, std::span<uint16_t> dst);
+
+    /**
+     * Narrows 32-bit indices to 16-bit indices. Every index has to be smaller than 65536, which
+     * callers usually know from the vertex count.
+     */
+    void narrowIndices(std::span<const uint32_t> src, std::span<uint16_t> dst);
+} // namespace krypton::util
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace krypton::util {
+    enum class JsonType : uint8_t {
+        // Also the type of missing values, e.g. of members that don't exist.
+        Null = 0,
+        Bool = 1,
+        Number = 2,
+        String = 3,
+        Array = 4,
+        Object = 5,
+    };
+
+    class JsonDocument;
+
+    /**
+     * A view of a value within a JsonDocument, which is only valid as long as the document is.
+     * Looking up something that doesn't exist, e.g. a member of a number, returns a value that
+     * doesn't exist instead of failing, so that optional members can be read with a fallback:
+     *
+     *     auto count = accessor["count"].getUint(0);
+     */
+    class JsonValue final {
+        const JsonDocument* document = nullptr;
+        uint32_t index = 0;
+
+        friend class JsonDocument;
+        explicit JsonValue(const JsonDocument* document, uint32_t index) noexcept;
+
+    public:
+        // Iterates over the elements of an array or the members of an object.
+        class Iterator final {
+            const JsonDocument* document = nullptr;
+            uint32_t index = 0;
+
+            friend class JsonValue;
+            explicit Iterator(const JsonDocument* document, uint32_t index) noexcept;
+
+        public:
+            auto operator*() const noexcept -> JsonValue;
+            auto operator++() noexcept -> Iterator&;
+            bool operator==(const Iterator& other) const noexcept = default;
+        };
+
+        explicit JsonValue() = default;
+
+        [[nodiscard]] bool exists() const noexcept;
+        [[nodiscard]] auto getType() const noexcept -> JsonType;
+        [[nodiscard]] bool isArray() const noexcept;
+        [[nodiscard]] bool isObject() const noexcept;
+        [[nodiscard]] bool isNumber() const noexcept;
+        [[nodiscard]] bool isString() const noexcept;
+
+        // The number of elements or members of arrays and objects, and 0 for everything else.
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+        // The key of a value that is a member of an object, or empty.
+        [[nodiscard]] auto getKey() const noexcept -> std::string_view;
+
+        // Finds a member of an object by its key, with a linear search.
+        [[nodiscard]] auto operator[](std::string_view key) const noexcept -> JsonValue;
+        // Finds an element of an array. This has to skip all previous elements, so iterate instead
+        // of indexing when visiting every element.
+        [[nodiscard]] auto operator[](std::size_t index) const noexcept -> JsonValue;
+
+        [[nodiscard]] auto begin() const noexcept -> Iterator;
+        [[nodiscard]] auto end() const noexcept -> Iterator;
+
+        // These return the fallback for values of another type.
+        [[nodiscard]] auto getBool(bool fallback = false) const noexcept -> bool;
+        [[nodiscard]] auto getNumber(double fallback = 0.0) const noexcept -> double;
+        [[nodiscard]] auto getFloat(float fallback = 0.0f) const noexcept -> float;
+        // Also returns the fallback for numbers that aren't integers within the range of the type.
+        [[nodiscard]] auto getInt(int64_t fallback = 0) const noexcept -> int64_t;
+        [[nodiscard]] auto getUint(uint64_t fallback = 0) const noexcept -> uint64_t;
+        // Escape sequences are already resolved.
+        [[nodiscard]] auto getString(std::string_view fallback = {}) const noexcept -> std::string_view;
+    };
+
+    /**
+     * A parsed JSON document. Parsing runs in two passes like simdjson: the first finds the
+     * position of every structural character, string and scalar with SIMD instructions, 64
+     * bytes at a time, and the second walks only those positions to build a flat array of
+     * nodes, in which every node knows where its next sibling is. Strings without escape
+     * sequences are not copied and point into the source, which therefore has to outlive the
+     * document.
+     */
+    class JsonDocument final {
+        struct Node final {
+            JsonType type = JsonType::Null;
+            // Whether the key or the string value are stored in unescapedStrings instead of the source.
+            bool keyUnescaped = false;
+            bool stringUnescaped = false;
+            // The index of the next sibling, which is right after all children of this node.
+            uint32_t next = 0;
+            uint32_t keyOffset = 0;
+            uint32_t keyLength = 0;
+            // The number of children for arrays and objects, the offset and length of strings,
+            // and the value of booleans and numbers.
+            union {
+                struct {
+                    uint32_t count;
+                } container;
+                struct {
+                    uint32_t offset;
+                    uint32_t length;
+                } text;
+                bool boolean;
+                double number = 0.0;
+            };
+        };
+
+        std::string_view source;
+        std::vector<Node> nodes;
+        std::vector<char> unescapedStrings;
+        std::string_view error;
+
+        friend class JsonValue;
+        [[nodiscard]] auto getKey(const Node& node) const noexcept -> std::string_view;
+        [[nodiscard]] auto getString(const Node& node) const noexcept -> std::string_view;
+        bool parseString(std::size_t& position, uint32_t& offset, uint32_t& length, bool& unescaped);
+        bool parseScalar(std::size_t position, std::size_t end, Node& node);
+
+    public:
+        explicit JsonDocument() = default;
+
+        // Replaces the current document. On failure, the document is empty and getError describes the problem.
+        [[nodiscard]] bool parse(std::string_view json);
+        [[nodiscard]] auto getError() const noexcept -> std::string_view;
+        [[nodiscard]] auto getRoot() const noexcept -> JsonValue;
+    };
+
+    /**
+     * Finds the positions of all structural characters outside of strings, of the opening
+     * quotes of strings and of the first character of every other scalar, i.e. of everything
+     * the second pass of the parser has to look at. Returns false if a string is not closed.
+     */
+    [[nodiscard]] bool findJsonStructurals(std::string_view json, std::vector<uint32_t>& positions);
+} // namespace krypton::util
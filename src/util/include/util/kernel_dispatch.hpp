@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include <util/assert.hpp>
+#include <util/cpu_features.hpp>
+
+namespace krypton::util {
+    template <typename Function>
+    struct KernelVariant {
+        // The features this variant requires. CpuFeature::None marks the portable fallback.
+        CpuFeature requirements = CpuFeature::None;
+        Function* function = nullptr;
+    };
+
+    /**
+     * Selects the best variant of a kernel for the CPU we're running on. The variants have to be
+     * ordered from most to least preferred, and the last variant has to be a portable fallback
+     * that requires no features at all.
+     *
+     * The selection happens once when the dispatcher is constructed. The usual pattern is to
+     * define the dispatcher as a function-local static, so that the lookup is thread-safe and
+     * every call afterwards is just an indirect call:
+     *
+     *     static const KernelDispatcher dispatcher(std::to_array<KernelVariant<decltype(scalar)>>({
+     *         { avx2TargetFeatures, avx2 },
+     *         { CpuFeature::None, scalar },
+     *     }));
+     *     dispatcher(args...);
+     */
+    template <typename Function, std::size_t N>
+    class KernelDispatcher final {
+        static_assert(N > 0, "A kernel needs at least a portable fallback");
+
+        std::array<KernelVariant<Function>, N> variants;
+        Function* selected = nullptr;
+
+    public:
+        explicit KernelDispatcher(std::array<KernelVariant<Function>, N> variants) noexcept;
+
+        [[nodiscard]] auto get() const noexcept -> Function*;
+        [[nodiscard]] auto getVariants() const noexcept -> const std::array<KernelVariant<Function>, N>&;
+        [[nodiscard]] auto select(CpuFeature available) const noexcept -> Function*;
+
+        template <typename... Args>
+        decltype(auto) operator()(Args&&... args) const;
+    };
+
+    template <typename Function, std::size_t N>
+    KernelDispatcher<Function, N>::KernelDispatcher(std::array<KernelVariant<Function>, N> variants) noexcept
+        : variants(std::move(variants)) {
+        VERIFY(this->variants.back().requirements == CpuFeature::None && this->variants.back().function != nullptr);
+        selected = select(getCpuFeatures());
+    }
+
+    template <typename Function, std::size_t N>
+    auto KernelDispatcher<Function, N>::get() const noexcept -> Function* {
+        return selected;
+    }
+
+    template <typename Function, std::size_t N>
+    auto KernelDispatcher<Function, N>::getVariants() const noexcept -> const std::array<KernelVariant<Function>, N>& {
+        return variants;
+    }
+
+    template <typename Function, std::size_t N>
+    auto KernelDispatcher<Function, N>::select(CpuFeature available) const noexcept -> Function* {
+        for (std::size_t i = 0; i < N - 1; ++i) {
+            const auto& variant = variants[i];
+            if (variant.function != nullptr && (available & variant.requirements) == variant.requirements)
+                return variant.function;
+        }
+        return variants.back().function;
+    }
+
+    template <typename Function, std::size_t N>
+    template <typename... Args>
+    decltype(auto) KernelDispatcher<Function, N>::operator()(Args&&... args) const {
+        return selected(std::forward<Args>(args)...);
+    }
+} // namespace krypton::util
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace krypton::util {
+    struct LatencySummary final {
+        uint64_t count = 0;
+        std::chrono::nanoseconds min {}, max {}, mean {};
+        std::chrono::nanoseconds p50 {}, p95 {}, p99 {};
+    };
+
+    /**
+     * An HDR-style histogram of durations with a fixed memory footprint. Values are sorted into
+     * log-linear buckets: each power of two is split into 64 linear sub-buckets, which bounds
+     * the relative error of any reported percentile to below 1.6%, from single nanoseconds up
+     * to centuries.
+     *
+     * Recording is lock-free and wait-free apart from the min/max updates, so any number of
+     * threads can record into the same histogram. Queries are not synchronized with concurrent
+     * recording, which means they may observe a partially recorded value.
+     */
+    class LatencyHistogram final {
+        static constexpr uint32_t subBucketBits = 7;
+        static constexpr uint64_t subBucketCount = 1ULL << subBucketBits;
+        static constexpr uint64_t subBucketHalfCount = subBucketCount / 2;
+        static constexpr std::size_t bucketCount = (64 - subBucketBits) * subBucketHalfCount + subBucketCount;
+
+        std::array<std::atomic<uint64_t>, bucketCount> buckets = {};
+        std::atomic<uint64_t> totalCount = 0;
+        std::atomic<uint64_t> totalSum = 0;
+        std::atomic<uint64_t> minValue = UINT64_MAX;
+        std::atomic<uint64_t> maxValue = 0;
+
+        [[nodiscard]] static auto getBucketIndex(uint64_t value) noexcept -> std::size_t;
+        // The largest value that falls into the given bucket.
+        [[nodiscard]] static auto getBucketUpperBound(std::size_t index) noexcept -> uint64_t;
+
+    public:
+        explicit LatencyHistogram() = default;
+
+        [[nodiscard]] auto getCount() const noexcept -> uint64_t;
+        [[nodiscard]] auto getMax() const noexcept -> std::chrono::nanoseconds;
+        [[nodiscard]] auto getMean() const noexcept -> std::chrono::nanoseconds;
+        [[nodiscard]] auto getMin() const noexcept -> std::chrono::nanoseconds;
+        [[nodiscard]] auto getSummary() const noexcept -> LatencySummary;
+
+        /**
+         * Returns the value below which the given percentage (0 to 100) of the recorded values
+         * fall. Like HdrHistogram, this reports the highest value equivalent to the bucket,
+         * clamped to the actual maximum. Returns zero if nothing has been recorded.
+         */
+        [[nodiscard]] auto getPercentile(double percentile) const noexcept -> std::chrono::nanoseconds;
+
+        void record(std::chrono::nanoseconds duration) noexcept;
+        void reset() noexcept;
+    };
+
+    // Records the lifetime of this object into a histogram.
+    class ScopedLatencyTimer final {
+        LatencyHistogram& histogram;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit ScopedLatencyTimer(LatencyHistogram& histogram) noexcept
+            : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+        ~ScopedLatencyTimer() noexcept {
+            histogram.record(std::chrono::steady_clock::now() - start);
+        }
+
+        ScopedLatencyTimer(const ScopedLatencyTimer&) = delete;
+        ScopedLatencyTimer& operator=(const ScopedLatencyTimer&) = delete;
+    };
+} // namespace krypton::util
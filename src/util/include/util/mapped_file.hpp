@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace krypton::util {
+    /**
+     * A read-only memory mapping of a whole file. Pages are only read from disk when they are
+     * first touched, so opening even very large files is cheap, and the OS can share and evict
+     * the pages like any other file cache. The mapping stays valid until the file is closed or
+     * the object is destroyed.
+     */
+    class MappedFile final {
+        const std::byte* mapping = nullptr;
+        std::size_t mappingSize = 0;
+        bool opened = false;
+#if defined(_WIN32)
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+
+    public:
+        explicit MappedFile() = default;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        ~MappedFile();
+
+        auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+        auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+        // Closes the current file, if any. Empty files can be opened, but have no data.
+        [[nodiscard]] bool open(const std::filesystem::path& path);
+        void close() noexcept;
+
+        [[nodiscard]] bool isOpen() const noexcept;
+        [[nodiscard]] auto getData() const noexcept -> std::span<const std::byte>;
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+    };
+} // namespace krypton::util
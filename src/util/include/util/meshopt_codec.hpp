@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace krypton::util {
+    // The meshoptimizer codecs, named like the modes of EXT_meshopt_compression.
+    enum class MeshoptMode : uint8_t {
+        // Vertex attributes, or any other data with a stride that is a multiple of four.
+        Attributes,
+        // Triangle list indices, with the triangles ideally optimized for the vertex cache.
+        Triangles,
+        // Any other indices, e.g. of line lists or of sparse accessors.
+        Indices,
+    };
+
+    // The filters that are reversed after decoding attributes.
+    enum class MeshoptFilter : uint8_t {
+        None,
+        // Unit vectors as 8 or 16 bit octahedral coordinates, with the 4th component kept as is.
+        Octahedral,
+        // Unit quaternions as three 16 bit components, with the largest one reconstructed.
+        Quaternion,
+        // 32 bit floats as a 24 bit mantissa and a shared 8 bit exponent.
+        Exponential,
+    };
+
+    // Whether elements of the given stride can be encoded with the mode and filter.
+    [[nodiscard]] bool isValidMeshoptStride(MeshoptMode mode, MeshoptFilter filter, std::size_t stride) noexcept;
+
+    /**
+     * Decodes count elements of stride bytes, which were encoded with meshoptimizer's vertex,
+     * index or index sequence codec, into dst and reverses the filter. This follows the
+     * bitstreams of the EXT_meshopt_compression glTF extension, which only uses version 0 of
+     * the vertex codec. Returns false if the data is malformed, in which case dst is left in
+     * an unspecified state.
+     */
+    [[nodiscard]] bool decodeMeshoptBuffer(std::span<const std::byte> src, std::size_t count, std::size_t stride, MeshoptMode mode,
+                                           MeshoptFilter filter, std::span<std::byte> dst);
+} // namespace krypton::util
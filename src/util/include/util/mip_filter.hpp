@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace krypton::util {
+    // The layout of the pixels of an image with unsigned normalized channels.
+    struct PixelFormat final {
+        uint32_t channels = 4;
+        // 1 for 8-bit and 2 for 16-bit channels.
+        uint32_t bytesPerChannel = 1;
+        // Whether the color channels are sRGB encoded. With four channels, the last one is alpha,
+        // which is always linear.
+        bool srgb = false;
+
+        [[nodiscard]] constexpr auto getPixelSize() const noexcept -> std::size_t {
+            return static_cast<std::size_t>(channels) * bytesPerChannel;
+        }
+    };
+
+    [[nodiscard]] constexpr auto getMipExtent(uint32_t extent, uint32_t level) noexcept -> uint32_t {
+        return std::max(extent >> level, 1U);
+    }
+
+    // The number of levels of a full mip chain, down to and including 1x1.
+    [[nodiscard]] constexpr auto getMipLevelCount(uint32_t width, uint32_t height) noexcept -> uint32_t {
+        return static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1U })));
+    }
+
+    // The size of the first levelCount levels of a mip chain, with every level tightly packed.
+    [[nodiscard]] constexpr auto getMipChainSize(uint32_t width, uint32_t height, uint32_t levelCount, std::size_t pixelSize) noexcept
+        -> std::size_t {
+        std::size_t size = 0;
+        for (uint32_t level = 0; level < levelCount; ++level)
+            size += static_cast<std::size_t>(getMipExtent(width, level)) * getMipExtent(height, level) * pixelSize;
+        return size;
+    }
+
+    /**
+     * Computes rows [firstRow, firstRow + rowCount) of the next mip level of an image with a 2x2
+     * box filter. sRGB channels are averaged in linear space, so that the levels don't get darker.
+     * With an odd width or height, the last column or row is ignored, just like most GPUs do
+     * when they generate mips. The rows can be computed independently, e.g. on multiple threads.
+     */
+    void downsampleImage(std::span<const std::byte> src, uint32_t width, uint32_t height, const PixelFormat& format,
+                         std::span<std::byte> dst, uint32_t firstRow, uint32_t rowCount);
+} // namespace krypton::util
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace krypton::util {
+    // ↓ -------------------  SINGLE VALUES  ------------------- ↓
+    // These are the scalar reference implementations, which the bulk kernels below are required
+    // to match. Rounding always uses round-to-nearest-even, just like the hardware instructions.
+    [[nodiscard]] auto floatToHalf(float value) noexcept -> uint16_t;
+    [[nodiscard]] auto halfToFloat(uint16_t value) noexcept -> float;
+
+    [[nodiscard]] auto floatToSnorm8(float value) noexcept -> int8_t;
+    [[nodiscard]] auto floatToSnorm16(float value) noexcept -> int16_t;
+    [[nodiscard]] auto floatToUnorm8(float value) noexcept -> uint8_t;
+    [[nodiscard]] auto floatToUnorm16(float value) noexcept -> uint16_t;
+    [[nodiscard]] auto snorm8ToFloat(int8_t value) noexcept -> float;
+    [[nodiscard]] auto snorm16ToFloat(int16_t value) noexcept -> float;
+    [[nodiscard]] auto unorm8ToFloat(uint8_t value) noexcept -> float;
+    [[nodiscard]] auto unorm16ToFloat(uint16_t value) noexcept -> float;
+
+    // Encodes a unit vector into two snorm16 values using an octahedral mapping. The vector does
+    // not need to be normalized.
+    void encodeOctahedral(const float* normal, int16_t* encoded) noexcept;
+    void decodeOctahedral(const int16_t* encoded, float* normal) noexcept;
+    // ↑ -------------------  SINGLE VALUES  ------------------- ↑
+
+    // ↓ -------------------   BULK KERNELS  ------------------- ↓
+    // All of these convert min(src.size(), dst.size()) elements and use the widest vector
+    // instructions available on the current CPU.
+    void convertFloatToHalf(std::span<const float> src, std::span<uint16_t> dst);
+    void convertHalfToFloat(std::span<const uint16_t> src, std::span<float> dst);
+
+    void convertFloatToSnorm8(std::span<const float> src, std::span<int8_t> dst);
+    void convertFloatToSnorm16(std::span<const float> src, std::span<int16_t> dst);
+    void convertFloatToUnorm8(std::span<const float> src, std::span<uint8_t> dst);
+    void convertFloatToUnorm16(std::span<const float> src, std::span<uint16_t> dst);
+    void convertSnorm8ToFloat(std::span<const int8_t> src, std::span<float> dst);
+    void convertSnorm16ToFloat(std::span<const int16_t> src, std::span<float> dst);
+    void convertUnorm8ToFloat(std::span<const uint8_t> src, std::span<float> dst);
+    void convertUnorm16ToFloat(std::span<const uint16_t> src, std::span<float> dst);
+
+    // Encodes tightly packed xyz normals into tightly packed pairs of snorm16 values. src has to
+    // contain three floats per normal and dst two values per normal.
+    void encodeOctahedralNormals(std::span<const float> src, std::span<int16_t> dst);
+    void decodeOctahedralNormals(std::span<const int16_t> src, std::span<float> dst);
+    // ↑ -------------------   BULK KERNELS  ------------------- ↑
+} // namespace krypton::util
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <functional>
 #include <mutex>
@@ -12,6 +13,7 @@ namespace krypton::threading {
     // dispatched from anywhere.
     class Scheduler final {
         using taskFunction = std::function<void()>;
+        using rangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
         using workerThreadFunction = std::function<void(Scheduler*)>;
 
         // We subtract by one as our main thread is not allocated through
@@ -47,6 +49,18 @@ namespace krypton::threading {
 
         static auto getInstance() -> Scheduler&;
         [[maybe_unused]] auto getMaxThreadCount() const -> uint32_t;
+        // Tasks passed to run() are dropped while the scheduler is not running.
+        [[nodiscard]] bool isRunning() const;
+
+        /**
+         * Splits [0, count) into chunks of chunkSize elements and calls function(begin, end) for
+         * each of them, using the worker threads. The calling thread works on chunks too and
+         * this only returns once every chunk has finished, so it's safe to call this from
+         * within a task. If any invocation throws, the remaining chunks are skipped and the
+         * first exception is rethrown on the calling thread. If the scheduler is not running,
+         * everything is executed on the calling thread.
+         */
+        void parallelFor(std::size_t count, std::size_t chunkSize, const rangeFunction& function);
         void run(const Scheduler::taskFunction& function);
         void shutdown();
         void start();
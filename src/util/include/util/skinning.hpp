@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <util/transform_math.hpp>
+
+namespace krypton::util {
+    // The joints and weights of a vertex, like JOINTS_0 and WEIGHTS_0 of glTF. The weights are unorm16. 16 bytes.
+    struct VertexInfluences final {
+        uint16_t joints[4];
+        uint16_t weights[4];
+    };
+
+    /**
+     * A morph target that only stores the vertices it actually moves, sorted by their index.
+     * Most targets, e.g. facial expressions, only move a small part of a mesh.
+     */
+    struct SparseMorphTarget final {
+        std::vector<uint32_t> vertices;
+        // The xyz position delta of every vertex.
+        std::vector<float> positionDeltas;
+        // The xyz normal delta of every vertex, or empty.
+        std::vector<float> normalDeltas;
+
+        /**
+         * The target for a new vertex buffer whose vertex i is a copy of the vertex
+         * sourceVertices[i] of the buffer this target belongs to, e.g. after vertices have been
+         * reordered, removed or duplicated.
+         */
+        [[nodiscard]] auto gatherVertices(std::span<const uint32_t> sourceVertices) const -> SparseMorphTarget;
+    };
+
+    /**
+     * Adds the deltas of all targets, scaled by their weight, to the vertices [first, first + count).
+     * positions and normals hold the xyz floats of these vertices only, starting with the vertex
+     * first. normals may be null.
+     */
+    void accumulateMorphTargets(std::span<const SparseMorphTarget> targets, std::span<const float> weights, std::size_t first,
+                                std::size_t count, float* positions, float* normals);
+
+    /**
+     * Transforms count vertices by the weighted sum of the matrices of their joints, i.e. linear
+     * blend skinning. The weights of every vertex are normalized first, and vertices without any
+     * weight are not transformed. Joints beyond jointMatrices use the last matrix. Normals are
+     * transformed by the same matrix, which is only correct without non-uniform scaling, and
+     * may be null.
+     *
+     * positions and normals are tightly packed xyz floats. The results are written as xyz floats
+     * to dstPositions and as octahedral snorm16 normals to dstNormals, every vertex dstStride
+     * bytes apart, so that e.g. CompactVertex can be written directly.
+     */
+    void skinVertices(std::span<const Matrix4> jointMatrices, const float* positions, const float* normals,
+                      const VertexInfluences* influences, std::size_t count, float* dstPositions, int16_t* dstNormals,
+                      std::size_t dstStride);
+} // namespace krypton::util
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace krypton::util {
+    enum class ComponentType : uint8_t {
+        Int8,
+        Uint8,
+        Int16,
+        Uint16,
+        Uint32,
+        Float,
+    };
+
+    [[nodiscard]] constexpr auto getComponentSize(ComponentType type) noexcept -> std::size_t {
+        switch (type) {
+            case ComponentType::Int8:
+            case ComponentType::Uint8:
+                return 1;
+            case ComponentType::Int16:
+            case ComponentType::Uint16:
+                return 2;
+            case ComponentType::Uint32:
+            case ComponentType::Float:
+                return 4;
+        }
+        return 0;
+    }
+
+    /**
+     * Describes an array of elements with up to four components each, which may be interleaved
+     * with other data. This maps directly to glTF accessors and buffer views.
+     */
+    struct StridedSource final {
+        const void* data = nullptr;
+        // The distance between two elements in bytes.
+        std::size_t stride = 0;
+        std::size_t count = 0;
+        ComponentType componentType = ComponentType::Float;
+        uint32_t componentCount = 0;
+        // Whether integers map to [0, 1] or [-1, 1]. Otherwise, they are converted as is.
+        bool normalized = false;
+    };
+
+    /**
+     * Converts every element of src into floats and writes dstComponents floats per element to
+     * dst, each element being dstStride bytes apart. Components that src does not have are
+     * filled with (0, 0, 0, 1), just like the vertex input stage of the GPU does. This allows
+     * e.g. a vec3 position to be written straight into the vec4 of an interleaved vertex.
+     */
+    void gatherStrided(const StridedSource& src, float* dst, std::size_t dstStride, uint32_t dstComponents);
+
+    struct StridedGather final {
+        StridedSource source;
+        float* dst = nullptr;
+        uint32_t dstComponents = 0;
+    };
+
+    /**
+     * Performs multiple gathers into the same interleaved destination, e.g. all attributes of
+     * a vertex. This works on small blocks of elements at a time, so that each destination cache
+     * line is only fetched from memory once instead of once per attribute.
+     */
+    void gatherStrided(std::span<const StridedGather> gathers, std::size_t dstStride);
+} // namespace krypton::util
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+#include <util/flat_map.hpp>
+
+namespace krypton::util {
+    /**
+     * A compact id of a string stored in a StringInterner. Two ids from the same interner are
+     * equal exactly if their strings are equal, so they can be compared and used as keys of a
+     * FlatMap without ever touching the string itself.
+     */
+    enum class InternedString : uint32_t {
+        Invalid = ~0U,
+    };
+
+    /**
+     * Stores each distinct string once and hands out ids for them. Strings are never freed and
+     * never move, so views returned by getString stay valid for the lifetime of the interner.
+     * This is meant for a bounded set of strings like extension, entry point or parameter names,
+     * not for arbitrary user input. All functions are thread-safe.
+     */
+    class StringInterner final {
+        static constexpr std::size_t blockSize = 16 * 1024;
+
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::size_t blockOffset = blockSize;
+
+        std::vector<std::string_view> strings;
+        // Hash collisions are chained through this, indexed by id.
+        std::vector<InternedString> nextWithSameHash;
+        FlatMap<uint64_t, InternedString> lookup;
+
+        mutable std::shared_mutex mutex;
+
+        [[nodiscard]] auto findLocked(std::string_view string, uint64_t hash) const noexcept -> InternedString;
+        auto store(std::string_view string) -> std::string_view;
+
+    public:
+        explicit StringInterner() = default;
+
+        // The global interner, which should be used unless ids are never compared across systems.
+        static auto getInstance() -> StringInterner&;
+
+        // Returns the id of the given string, or InternedString::Invalid if it has never been
+        // interned. This never allocates.
+        [[nodiscard]] auto find(std::string_view string) const -> InternedString;
+        auto intern(std::string_view string) -> InternedString;
+
+        // The returned view is always null-terminated. The id has to be valid.
+        [[nodiscard]] auto getString(InternedString id) const -> std::string_view;
+        [[nodiscard]] auto getCString(InternedString id) const -> const char*;
+        [[nodiscard]] auto size() const -> std::size_t;
+    };
+} // namespace krypton::util
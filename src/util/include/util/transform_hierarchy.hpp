@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <util/transform_math.hpp>
+
+namespace krypton::util {
+    /**
+     * A tree of transforms, flattened into arrays that are sorted by depth. The nodes of every
+     * level are contiguous and come after all nodes of the previous level, so parents always
+     * come before their children, and all nodes of a level can be updated in parallel once the
+     * previous level is done. World matrices are only recomputed for nodes whose local transform
+     * or the local transform of one of their ancestors changed since the last update.
+     */
+    class TransformHierarchy final {
+        std::vector<uint32_t> parents;
+        // The index of the first node of every level.
+        std::vector<uint32_t> levelStarts;
+        TransformSoA localTransforms;
+        std::vector<Matrix4> worldMatrices;
+        // Set for every node whose local transform changed. During update(), this is also set for
+        // all of their descendants.
+        std::vector<uint8_t> dirty;
+        bool anyDirty = false;
+
+        void updateNodes(uint32_t first, uint32_t last);
+
+    public:
+        static constexpr uint32_t noParent = ~0U;
+
+        /**
+         * Adds a node and returns its index. To keep the nodes sorted by depth, roots can only be
+         * added before any other node, and the parent of every other node has to be in the
+         * deepest or second deepest level. Adding the nodes of a tree breadth-first always
+         * satisfies this.
+         */
+        auto addNode(uint32_t parent, const float* translation, const float* rotation, const float* scale) -> uint32_t;
+        void reserve(std::size_t size);
+        void clear() noexcept;
+
+        // Sets the local transform of a node and marks it as dirty.
+        void setLocalTransform(uint32_t node, const float* translation, const float* rotation, const float* scale) noexcept;
+        // Flags a node whose local transform has been changed through getLocalTransforms().
+        void markDirty(uint32_t node) noexcept;
+
+        /**
+         * Recomputes the world matrices of all dirty nodes and their descendants. The levels are
+         * processed one after another, with the nodes of each level split across the Scheduler.
+         */
+        void update();
+
+        [[nodiscard]] auto getLocalTransforms() noexcept -> TransformSoA&;
+        [[nodiscard]] auto getLocalTransforms() const noexcept -> const TransformSoA&;
+        [[nodiscard]] auto getParents() const noexcept -> std::span<const uint32_t>;
+        // Only valid for nodes that have not been changed since the last update.
+        [[nodiscard]] auto getWorldMatrices() const noexcept -> std::span<const Matrix4>;
+        [[nodiscard]] auto getLevelCount() const noexcept -> std::size_t;
+        // The nodes [first, last) of the given level.
+        [[nodiscard]] auto getLevel(std::size_t level) const noexcept -> std::pair<uint32_t, uint32_t>;
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+    };
+} // namespace krypton::util
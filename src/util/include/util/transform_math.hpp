@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace krypton::util {
+    /**
+     * A column-major 4x4 matrix. This has the same layout as glm::mat4, so the two can be
+     * converted with std::bit_cast. util does not depend on glm, which is why we have our own
+     * type here.
+     */
+    struct alignas(16) Matrix4 final {
+        float m[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+    };
+
+    /**
+     * Translations, rotations (as quaternions) and scales of many transforms, each component
+     * stored in its own array so that the kernels can process multiple transforms per
+     * instruction.
+     */
+    struct TransformSoA final {
+        std::vector<float> translationX, translationY, translationZ;
+        std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+        std::vector<float> scaleX, scaleY, scaleZ;
+
+        // New elements are initialized to the identity transform.
+        void resize(std::size_t size);
+        void reserve(std::size_t size);
+        void set(std::size_t index, const float* translation, const float* rotation, const float* scale) noexcept;
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+    };
+
+    // Axis-aligned bounding boxes, stored as SoA.
+    struct AabbSoA final {
+        std::vector<float> minX, minY, minZ;
+        std::vector<float> maxX, maxY, maxZ;
+
+        void resize(std::size_t size);
+        void set(std::size_t index, const float* min, const float* max) noexcept;
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+    };
+
+    [[nodiscard]] auto multiplyMatrix(const Matrix4& lhs, const Matrix4& rhs) noexcept -> Matrix4;
+
+    /**
+     * Builds translation * rotation * scale matrices for the transforms [first, first + out.size())
+     * of the given SoA.
+     */
+    void composeTransforms(const TransformSoA& transforms, std::size_t first, std::span<Matrix4> out);
+
+    // Computes out[i] = lhs[i] * rhs[i].
+    void multiplyMatrices(std::span<const Matrix4> lhs, std::span<const Matrix4> rhs, std::span<Matrix4> out);
+
+    // Computes out[i] = lhs[lhsIndices[i]] * rhs[i]. This is e.g. used to multiply local matrices
+    // with the world matrix of their parent.
+    void multiplyMatrices(std::span<const Matrix4> lhs, std::span<const uint32_t> lhsIndices, std::span<const Matrix4> rhs,
+                          std::span<Matrix4> out);
+
+    /**
+     * Transforms the boxes [first, first + matrices.size()) of src by their matrix and writes the
+     * axis-aligned box of the result into the same indices of dst, which has to be at least as big
+     * as src. Only the affine part of the matrices is used.
+     */
+    void transformAabbs(const AabbSoA& src, std::size_t first, std::span<const Matrix4> matrices, AabbSoA& dst);
+
+    /**
+     * Computes the axis-aligned box around count points. The x, y and z components of each point
+     * are consecutive floats, and stride is the distance between two points in bytes, so that
+     * e.g. the positions of interleaved vertices can be passed directly. Without any points, min
+     * is +inf and max is -inf.
+     */
+    void computeAabb(const float* points, std::size_t stride, std::size_t count, float* min, float* max);
+} // namespace krypton::util
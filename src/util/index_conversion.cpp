@@ -0,0 +1,193 @@
+#include <cstring>
+
+#include <Tracy.hpp>
+
+#include <util/assert.hpp>
+#include <util/attributes.hpp>
+#include <util/index_conversion.hpp>
+#include <util/kernel_dispatch.hpp>
+
+#if defined(KRYPTON_ARCH_X86)
+    #include <immintrin.h>
+#elif defined(KRYPTON_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    template <typename S, typename D = uint32_t>
+    using WidenKernel = void(const S* src, D* dst, std::size_t count);
+
+    template <typename S, typename D = uint32_t>
+    void widenIndicesScalar(const S* src, D* dst, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            dst[i] = static_cast<D>(src[i]);
+    }
+
+    void narrowIndicesScalar(const uint32_t* src, uint16_t* dst, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            dst[i] = static_cast<uint16_t>(src[i]);
+    }
+
+#if defined(KRYPTON_ARCH_X86)
+    TARGET_SSE42 void widenIndicesSse42(const uint8_t* src, uint32_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            int32_t packed;
+            std::memcpy(&packed, src + i, sizeof(packed));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+        }
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_SSE42 void widenIndicesSse42(const uint16_t* src, uint32_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            auto packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_cvtepu16_epi32(packed));
+        }
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_SSE42 void widenIndicesSse42(const uint8_t* src, uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_cvtepu8_epi16(packed));
+        }
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_SSE42 void narrowIndicesSse42(const uint32_t* src, uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi32(low, high));
+        }
+        narrowIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_AVX2 void widenIndicesAvx2(const uint8_t* src, uint32_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu8_epi32(packed));
+        }
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_AVX2 void widenIndicesAvx2(const uint16_t* src, uint32_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            auto packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu16_epi32(_mm256_castsi256_si128(packed)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 8), _mm256_cvtepu16_epi32(_mm256_extracti128_si256(packed, 1)));
+        }
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_AVX2 void widenIndicesAvx2(const uint8_t* src, uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            auto packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu8_epi16(packed));
+        }
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_AVX2 void narrowIndicesAvx2(const uint32_t* src, uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8));
+            // packus works per 128-bit lane, so the 64-bit blocks have to be put back in order.
+            auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(low, high), 0b11011000);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+        }
+        narrowIndicesScalar(src + i, dst + i, count - i);
+    }
+#elif defined(KRYPTON_HAS_NEON)
+    void widenIndicesNeon(const uint8_t* src, uint32_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto wide = vmovl_u8(vld1_u8(src + i));
+            vst1q_u32(dst + i, vmovl_u16(vget_low_u16(wide)));
+            vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(wide)));
+        }
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    void widenIndicesNeon(const uint16_t* src, uint32_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto packed = vld1q_u16(src + i);
+            vst1q_u32(dst + i, vmovl_u16(vget_low_u16(packed)));
+            vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(packed)));
+        }
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    void widenIndicesNeon(const uint8_t* src, uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            vst1q_u16(dst + i, vmovl_u8(vld1_u8(src + i)));
+        widenIndicesScalar(src + i, dst + i, count - i);
+    }
+
+    void narrowIndicesNeon(const uint32_t* src, uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            vst1q_u16(dst + i, vcombine_u16(vmovn_u32(vld1q_u32(src + i)), vmovn_u32(vld1q_u32(src + i + 4))));
+        narrowIndicesScalar(src + i, dst + i, count - i);
+    }
+#endif
+
+    template <typename S, typename D = uint32_t>
+    auto getWidenIndicesKernel() -> WidenKernel<S, D>* {
+        static const KernelDispatcher dispatcher(std::to_array<KernelVariant<WidenKernel<S, D>>>({
+#if defined(KRYPTON_ARCH_X86)
+            { avx2TargetFeatures, widenIndicesAvx2 },
+            { CpuFeature::SSE42, widenIndicesSse42 },
+#elif defined(KRYPTON_HAS_NEON)
+            { CpuFeature::NEON, widenIndicesNeon },
+#endif
+            { CpuFeature::None, widenIndicesScalar<S, D> },
+        }));
+        return dispatcher.get();
+    }
+} // namespace krypton::util
+
+void ku::widenIndices(std::span<const uint8_t> src, std::span<uint32_t> dst) {
+    ZoneScoped;
+    VERIFY(dst.size() >= src.size());
+    getWidenIndicesKernel<uint8_t>()(src.data(), dst.data(), src.size());
+}
+
+void ku::widenIndices(std::span<const uint16_t> src, std::span<uint32_t> dst) {
+    ZoneScoped;
+    VERIFY(dst.size() >= src.size());
+    getWidenIndicesKernel<uint16_t>()(src.data(), dst.data(), src.size());
+}
+
+void ku::widenIndices(std::span<const uint8_t> src, std::span<uint16_t> dst) {
+    ZoneScoped;
+    VERIFY(dst.size() >= src.size());
+    getWidenIndicesKernel<uint8_t, uint16_t>()(src.data(), dst.data(), src.size());
+}
+
+void ku::narrowIndices(std::span<const uint32_t> src, std::span<uint16_t> dst) {
+    ZoneScoped;
+    VERIFY(dst.size() >= src.size());
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<decltype(narrowIndicesScalar)>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures, narrowIndicesAvx2 },
+        { CpuFeature::SSE42, narrowIndicesSse42 },
+#elif defined(KRYPTON_HAS_NEON)
+        { CpuFeature::NEON, narrowIndicesNeon },
+#endif
+        { CpuFeature::None, narrowIndicesScalar },
+    }));
+    dispatcher(src.data(), dst.data(), src.size());
+}
@@ -0,0 +1,682 @@
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <Tracy.hpp>
+
+#include <util/attributes.hpp>
+#include <util/json.hpp>
+#include <util/kernel_dispatch.hpp>
+
+#if defined(KRYPTON_ARCH_X86)
+    #include <immintrin.h>
+#elif defined(KRYPTON_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    // Deeper documents are rejected, so that malicious input can't exhaust memory with brackets alone.
+    constexpr std::size_t maxJsonDepth = 1024;
+
+    // One bit per byte of a 64 byte block.
+    struct JsonBlockMasks final {
+        uint64_t quotes = 0;
+        uint64_t backslashes = 0;
+        // {}[]:,
+        uint64_t structurals = 0;
+        uint64_t whitespace = 0;
+    };
+
+    // Bit i of the result is the xor of the bits [0, i] of the input.
+    ALWAYS_INLINE inline auto prefixXor(uint64_t bits) noexcept -> uint64_t {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    /**
+     * Turns the character classes of consecutive blocks into structural positions. The state
+     * carried from one block to the next is whether the first byte is escaped, whether it is
+     * inside a string and whether it continues a scalar.
+     */
+    class JsonStructuralScanner final {
+        std::vector<uint32_t>& positions;
+        std::size_t count = 0;
+        uint64_t previousEscaped = 0;
+        uint64_t previousInString = 0;
+        uint64_t previousScalar = 0;
+
+    public:
+        explicit JsonStructuralScanner(std::vector<uint32_t>& positions) noexcept : positions(positions) {}
+
+        ALWAYS_INLINE void addBlock(const JsonBlockMasks& masks, uint32_t offset) {
+            // Backslashes are rare, so they are resolved one after another instead of with the
+            // branchless carry trick of simdjson.
+            uint64_t escaped = previousEscaped;
+            previousEscaped = 0;
+            for (auto backslashes = masks.backslashes & ~escaped; backslashes != 0;) {
+                const auto bit = std::countr_zero(backslashes);
+                if (bit == 63) {
+                    previousEscaped = 1;
+                    break;
+                }
+                escaped |= uint64_t(1) << (bit + 1);
+                // The escaped character can't start another escape sequence.
+                backslashes &= ~((uint64_t(2) << (bit + 1)) - 1);
+            }
+
+            // Opening quotes are part of the string, closing quotes aren't.
+            const auto quotes = masks.quotes & ~escaped;
+            const auto inString = prefixXor(quotes) ^ previousInString;
+            previousInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+            const auto scalars = ~(masks.structurals | masks.whitespace | masks.quotes) & ~inString;
+            const auto scalarStarts = scalars & ~((scalars << 1) | previousScalar);
+            previousScalar = scalars >> 63;
+
+            auto bits = (masks.structurals & ~inString) | (quotes & inString) | scalarStarts;
+            if (count + 64 > positions.size())
+                positions.resize(std::max(positions.size() * 2, count + 64));
+            auto* out = positions.data() + count;
+            count += static_cast<std::size_t>(std::popcount(bits));
+            for (; bits != 0; bits &= bits - 1)
+                *out++ = offset + static_cast<uint32_t>(std::countr_zero(bits));
+        }
+
+        // Returns false if the last string is not closed.
+        bool finish() {
+            positions.resize(count);
+            return previousInString == 0;
+        }
+    };
+
+    auto classifyJsonBlockScalar(const char* block) noexcept -> JsonBlockMasks {
+        JsonBlockMasks masks;
+        for (std::size_t i = 0; i < 64; ++i) {
+            const auto bit = uint64_t(1) << i;
+            switch (block[i]) {
+                case '"':
+                    masks.quotes |= bit;
+                    break;
+                case '\\':
+                    masks.backslashes |= bit;
+                    break;
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',':
+                    masks.structurals |= bit;
+                    break;
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                    masks.whitespace |= bit;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return masks;
+    }
+
+    using JsonStructuralKernel = bool(std::string_view json, std::vector<uint32_t>& positions);
+
+    // The last partial block is classified from a copy padded with whitespace.
+    ALWAYS_INLINE inline auto padJsonBlock(std::string_view json, std::size_t offset, char* block) noexcept -> const char* {
+        std::memset(block, ' ', 64);
+        std::memcpy(block, json.data() + offset, json.size() - offset);
+        return block;
+    }
+
+    bool findJsonStructuralsScalar(std::string_view json, std::vector<uint32_t>& positions) {
+        JsonStructuralScanner scanner(positions);
+        std::size_t offset = 0;
+        for (; offset + 64 <= json.size(); offset += 64)
+            scanner.addBlock(classifyJsonBlockScalar(json.data() + offset), static_cast<uint32_t>(offset));
+        char block[64];
+        if (offset < json.size())
+            scanner.addBlock(classifyJsonBlockScalar(padJsonBlock(json, offset, block)), static_cast<uint32_t>(offset));
+        return scanner.finish();
+    }
+
+#if defined(KRYPTON_ARCH_X86)
+    TARGET_AVX2 ALWAYS_INLINE inline auto toBitsAvx2(__m256i mask) noexcept -> uint64_t {
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(mask)));
+    }
+
+    TARGET_AVX2 ALWAYS_INLINE inline auto classifyJsonBlockAvx2(const char* block) noexcept -> JsonBlockMasks {
+        JsonBlockMasks masks;
+        for (int half = 0; half < 2; ++half) {
+            const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + half * 32));
+            // Setting bit 5 maps [ and ] to { and }, and no other character to either of them.
+            const auto brackets = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+            const auto structurals = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(brackets, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(brackets, _mm256_set1_epi8('}'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(','))));
+            const auto whitespace = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\r'))));
+
+            const auto shift = half * 32;
+            masks.quotes |= toBitsAvx2(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('"'))) << shift;
+            masks.backslashes |= toBitsAvx2(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\\'))) << shift;
+            masks.structurals |= toBitsAvx2(structurals) << shift;
+            masks.whitespace |= toBitsAvx2(whitespace) << shift;
+        }
+        return masks;
+    }
+
+    TARGET_AVX2 bool findJsonStructuralsAvx2(std::string_view json, std::vector<uint32_t>& positions) {
+        JsonStructuralScanner scanner(positions);
+        std::size_t offset = 0;
+        for (; offset + 64 <= json.size(); offset += 64)
+            scanner.addBlock(classifyJsonBlockAvx2(json.data() + offset), static_cast<uint32_t>(offset));
+        char block[64];
+        if (offset < json.size())
+            scanner.addBlock(classifyJsonBlockAvx2(padJsonBlock(json, offset, block)), static_cast<uint32_t>(offset));
+        return scanner.finish();
+    }
+#elif defined(KRYPTON_HAS_NEON)
+    // Packs the top bit of each of the 64 bytes into a mask, like movemask on x86.
+    ALWAYS_INLINE inline auto neonToBits(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d) noexcept -> uint64_t {
+        const uint8x16_t bitValues = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+        auto sum0 = vpaddq_u8(vandq_u8(a, bitValues), vandq_u8(b, bitValues));
+        auto sum1 = vpaddq_u8(vandq_u8(c, bitValues), vandq_u8(d, bitValues));
+        sum0 = vpaddq_u8(sum0, sum1);
+        sum0 = vpaddq_u8(sum0, sum0);
+        return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+    }
+
+    ALWAYS_INLINE inline auto classifyJsonBlockNeon(const char* block) noexcept -> JsonBlockMasks {
+        uint8x16_t quotes[4], backslashes[4], structurals[4], whitespace[4];
+        for (int i = 0; i < 4; ++i) {
+            const auto bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(block) + i * 16);
+            const auto brackets = vorrq_u8(bytes, vdupq_n_u8(0x20));
+            quotes[i] = vceqq_u8(bytes, vdupq_n_u8('"'));
+            backslashes[i] = vceqq_u8(bytes, vdupq_n_u8('\\'));
+            structurals[i] = vorrq_u8(vorrq_u8(vceqq_u8(brackets, vdupq_n_u8('{')), vceqq_u8(brackets, vdupq_n_u8('}'))),
+                                      vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(':')), vceqq_u8(bytes, vdupq_n_u8(','))));
+            whitespace[i] = vorrq_u8(vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(' ')), vceqq_u8(bytes, vdupq_n_u8('\t'))),
+                                     vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('\n')), vceqq_u8(bytes, vdupq_n_u8('\r'))));
+        }
+        return {
+            .quotes = neonToBits(quotes[0], quotes[1], quotes[2], quotes[3]),
+            .backslashes = neonToBits(backslashes[0], backslashes[1], backslashes[2], backslashes[3]),
+            .structurals = neonToBits(structurals[0], structurals[1], structurals[2], structurals[3]),
+            .whitespace = neonToBits(whitespace[0], whitespace[1], whitespace[2], whitespace[3]),
+        };
+    }
+
+    bool findJsonStructuralsNeon(std::string_view json, std::vector<uint32_t>& positions) {
+        JsonStructuralScanner scanner(positions);
+        std::size_t offset = 0;
+        for (; offset + 64 <= json.size(); offset += 64)
+            scanner.addBlock(classifyJsonBlockNeon(json.data() + offset), static_cast<uint32_t>(offset));
+        char block[64];
+        if (offset < json.size())
+            scanner.addBlock(classifyJsonBlockNeon(padJsonBlock(json, offset, block)), static_cast<uint32_t>(offset));
+        return scanner.finish();
+    }
+#endif
+
+    // Appends the code point as UTF-8.
+    void appendUtf8(std::vector<char>& out, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            out.push_back(static_cast<char>(codePoint));
+        } else if (codePoint < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    bool parseHex4(std::string_view text, std::size_t position, uint32_t& value) {
+        if (position + 4 > text.size())
+            return false;
+        const auto result = std::from_chars(text.data() + position, text.data() + position + 4, value, 16);
+        return result.ec == std::errc() && result.ptr == text.data() + position + 4;
+    }
+
+    // Whether the text is a number as JSON defines it, which is stricter than from_chars.
+    bool isJsonNumber(std::string_view text) {
+        std::size_t i = 0;
+        auto digits = [&]() {
+            const auto start = i;
+            while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+                ++i;
+            return i > start;
+        };
+        if (i < text.size() && text[i] == '-')
+            ++i;
+        if (i < text.size() && text[i] == '0')
+            ++i;
+        else if (!digits())
+            return false;
+        if (i < text.size() && text[i] == '.') {
+            ++i;
+            if (!digits())
+                return false;
+        }
+        if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+            ++i;
+            if (i < text.size() && (text[i] == '+' || text[i] == '-'))
+                ++i;
+            if (!digits())
+                return false;
+        }
+        return i == text.size();
+    }
+} // namespace krypton::util
+
+bool ku::findJsonStructurals(std::string_view json, std::vector<uint32_t>& positions) {
+    ZoneScoped;
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<JsonStructuralKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures, findJsonStructuralsAvx2 },
+#elif defined(KRYPTON_HAS_NEON)
+        { CpuFeature::NEON, findJsonStructuralsNeon },
+#endif
+        { CpuFeature::None, findJsonStructuralsScalar },
+    }));
+    positions.clear();
+    return dispatcher(json, positions);
+}
+
+// ↓ -------------------  JSON VALUE  ------------------- ↓
+ku::JsonValue::JsonValue(const JsonDocument* document, uint32_t index) noexcept : document(document), index(index) {}
+
+ku::JsonValue::Iterator::Iterator(const JsonDocument* document, uint32_t index) noexcept : document(document), index(index) {}
+
+auto ku::JsonValue::Iterator::operator*() const noexcept -> JsonValue {
+    return JsonValue(document, index);
+}
+
+auto ku::JsonValue::Iterator::operator++() noexcept -> Iterator& {
+    index = document->nodes[index].next;
+    return *this;
+}
+
+bool ku::JsonValue::exists() const noexcept {
+    return document != nullptr;
+}
+
+auto ku::JsonValue::getType() const noexcept -> JsonType {
+    return document == nullptr ? JsonType::Null : document->nodes[index].type;
+}
+
+bool ku::JsonValue::isArray() const noexcept {
+    return getType() == JsonType::Array;
+}
+
+bool ku::JsonValue::isObject() const noexcept {
+    return getType() == JsonType::Object;
+}
+
+bool ku::JsonValue::isNumber() const noexcept {
+    return getType() == JsonType::Number;
+}
+
+bool ku::JsonValue::isString() const noexcept {
+    return getType() == JsonType::String;
+}
+
+auto ku::JsonValue::size() const noexcept -> std::size_t {
+    return isArray() || isObject() ? document->nodes[index].container.count : 0;
+}
+
+auto ku::JsonValue::getKey() const noexcept -> std::string_view {
+    return document == nullptr ? std::string_view() : document->getKey(document->nodes[index]);
+}
+
+auto ku::JsonValue::operator[](std::string_view key) const noexcept -> JsonValue {
+    if (!isObject())
+        return JsonValue();
+    for (auto member : *this)
+        if (member.getKey() == key)
+            return member;
+    return JsonValue();
+}
+
+auto ku::JsonValue::operator[](std::size_t element) const noexcept -> JsonValue {
+    if (!isArray() || element >= size())
+        return JsonValue();
+    auto it = begin();
+    for (std::size_t i = 0; i < element; ++i)
+        ++it;
+    return *it;
+}
+
+auto ku::JsonValue::begin() const noexcept -> Iterator {
+    if (document == nullptr)
+        return Iterator(nullptr, 0);
+    // Children directly follow their parent, and scalars start at their own end.
+    return Iterator(document, size() != 0 ? index + 1 : document->nodes[index].next);
+}
+
+auto ku::JsonValue::end() const noexcept -> Iterator {
+    return Iterator(document, document == nullptr ? 0 : document->nodes[index].next);
+}
+
+auto ku::JsonValue::getBool(bool fallback) const noexcept -> bool {
+    return getType() == JsonType::Bool ? document->nodes[index].boolean : fallback;
+}
+
+auto ku::JsonValue::getNumber(double fallback) const noexcept -> double {
+    return isNumber() ? document->nodes[index].number : fallback;
+}
+
+auto ku::JsonValue::getFloat(float fallback) const noexcept -> float {
+    return isNumber() ? static_cast<float>(document->nodes[index].number) : fallback;
+}
+
+auto ku::JsonValue::getInt(int64_t fallback) const noexcept -> int64_t {
+    const auto value = getNumber(0.5);
+    if (std::trunc(value) != value || value < -0x1p63 || value >= 0x1p63)
+        return fallback;
+    return static_cast<int64_t>(value);
+}
+
+auto ku::JsonValue::getUint(uint64_t fallback) const noexcept -> uint64_t {
+    const auto value = getNumber(0.5);
+    if (std::trunc(value) != value || value < 0.0 || value >= 0x1p64)
+        return fallback;
+    return static_cast<uint64_t>(value);
+}
+
+auto ku::JsonValue::getString(std::string_view fallback) const noexcept -> std::string_view {
+    return isString() ? document->getString(document->nodes[index]) : fallback;
+}
+// ↑ -------------------  JSON VALUE  ------------------- ↑
+
+// ↓ -------------------  JSON DOCUMENT  ------------------- ↓
+auto ku::JsonDocument::getKey(const Node& node) const noexcept -> std::string_view {
+    if (node.keyUnescaped)
+        return { unescapedStrings.data() + node.keyOffset, node.keyLength };
+    return source.substr(node.keyOffset, node.keyLength);
+}
+
+auto ku::JsonDocument::getString(const Node& node) const noexcept -> std::string_view {
+    if (node.stringUnescaped)
+        return { unescapedStrings.data() + node.text.offset, node.text.length };
+    return source.substr(node.text.offset, node.text.length);
+}
+
+bool ku::JsonDocument::parseString(std::size_t& position, uint32_t& offset, uint32_t& length, bool& unescaped) {
+    // The closing quote is the first one that isn't preceded by an odd number of backslashes.
+    const auto begin = position + 1;
+    auto end = begin;
+    while (true) {
+        const auto* quote = static_cast<const char*>(std::memchr(source.data() + end, '"', source.size() - end));
+        if (quote == nullptr) {
+            error = "A string is not terminated";
+            return false;
+        }
+        end = static_cast<std::size_t>(quote - source.data());
+        std::size_t backslashes = 0;
+        while (end - backslashes > begin && source[end - backslashes - 1] == '\\')
+            ++backslashes;
+        if (backslashes % 2 == 0)
+            break;
+        ++end;
+    }
+    position = end;
+
+    const auto text = source.substr(begin, end - begin);
+    unescaped = text.find('\\') != std::string_view::npos;
+    if (!unescaped) {
+        offset = static_cast<uint32_t>(begin);
+        length = static_cast<uint32_t>(text.size());
+        return true;
+    }
+
+    const auto start = unescapedStrings.size();
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\') {
+            unescapedStrings.push_back(text[i]);
+            continue;
+        }
+        // The closing quote search guarantees that every backslash is followed by something.
+        switch (text[++i]) {
+            case '"':
+            case '\\':
+            case '/':
+                unescapedStrings.push_back(text[i]);
+                break;
+            case 'b':
+                unescapedStrings.push_back('\b');
+                break;
+            case 'f':
+                unescapedStrings.push_back('\f');
+                break;
+            case 'n':
+                unescapedStrings.push_back('\n');
+                break;
+            case 'r':
+                unescapedStrings.push_back('\r');
+                break;
+            case 't':
+                unescapedStrings.push_back('\t');
+                break;
+            case 'u': {
+                uint32_t codePoint = 0;
+                if (!parseHex4(text, i + 1, codePoint)) {
+                    error = "Invalid unicode escape sequence";
+                    return false;
+                }
+                i += 4;
+                // Characters outside of the BMP are escaped as a surrogate pair.
+                uint32_t low = 0;
+                if (codePoint >= 0xD800 && codePoint < 0xDC00 && i + 2 < text.size() && text[i + 1] == '\\' && text[i + 2] == 'u' &&
+                    parseHex4(text, i + 3, low) && low >= 0xDC00 && low < 0xE000) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                appendUtf8(unescapedStrings, codePoint);
+                break;
+            }
+            default:
+                error = "Invalid escape sequence";
+                return false;
+        }
+    }
+    offset = static_cast<uint32_t>(start);
+    length = static_cast<uint32_t>(unescapedStrings.size() - start);
+    return true;
+}
+
+bool ku::JsonDocument::parseScalar(std::size_t position, std::size_t end, Node& node) {
+    auto text = source.substr(position, end - position);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\n' || text.back() == '\r'))
+        text.remove_suffix(1);
+
+    if (text == "true" || text == "false") {
+        node.type = JsonType::Bool;
+        node.boolean = text == "true";
+        return true;
+    }
+    if (text == "null") {
+        node.type = JsonType::Null;
+        return true;
+    }
+    if (!isJsonNumber(text)) {
+        error = "Invalid value";
+        return false;
+    }
+
+    // Most numbers in practice are small integers, which are cheaper to convert by hand.
+    node.type = JsonType::Number;
+    const bool negative = text.front() == '-';
+    const auto digits = text.substr(negative ? 1 : 0);
+    if (digits.size() <= 18 && digits.find_first_of(".eE") == std::string_view::npos) {
+        int64_t value = 0;
+        for (const auto digit : digits)
+            value = value * 10 + (digit - '0');
+        node.number = static_cast<double>(negative ? -value : value);
+        return true;
+    }
+    // Out of range values are rounded to zero or infinity, like most parsers do.
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), node.number);
+    if (result.ec == std::errc::result_out_of_range)
+        node.number = std::strtod(std::string(text).c_str(), nullptr);
+    return true;
+}
+
+bool ku::JsonDocument::parse(std::string_view json) {
+    ZoneScoped;
+    source = {};
+    nodes.clear();
+    unescapedStrings.clear();
+    error = {};
+    auto fail = [this](std::string_view message) {
+        if (!message.empty())
+            error = message;
+        source = {};
+        nodes.clear();
+        unescapedStrings.clear();
+        return false;
+    };
+
+    if (json.size() >= std::numeric_limits<uint32_t>::max())
+        return fail("The document is too large");
+    std::vector<uint32_t> positions;
+    if (!findJsonStructurals(json, positions))
+        return fail("A string is not terminated");
+    if (positions.empty())
+        return fail("The document is empty");
+
+    ZoneScopedN("Build nodes");
+    source = json;
+    // Most values take a key, a colon and a comma besides themselves.
+    nodes.reserve(positions.size() / 3 + 1);
+
+    enum class State : uint8_t {
+        Value,
+        ValueOrEnd,
+        Key,
+        KeyOrEnd,
+        Colon,
+        CommaOrEnd,
+        Done,
+    };
+    struct Scope {
+        uint32_t node;
+        bool object;
+    };
+    std::vector<Scope> scopes;
+    auto state = State::Value;
+    uint32_t keyOffset = 0, keyLength = 0;
+    bool keyUnescaped = false;
+
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        auto position = static_cast<std::size_t>(positions[i]);
+        const char c = json[position];
+        switch (state) {
+            case State::Done:
+                return fail("Unexpected content after the root value");
+            case State::Colon:
+                if (c != ':')
+                    return fail("Expected a colon after a key");
+                state = State::Value;
+                continue;
+            case State::KeyOrEnd:
+                if (c == '}')
+                    break;
+                [[fallthrough]];
+            case State::Key:
+                if (c != '"')
+                    return fail("Expected a key");
+                if (!parseString(position, keyOffset, keyLength, keyUnescaped))
+                    return fail({});
+                state = State::Colon;
+                continue;
+            case State::CommaOrEnd:
+                if (c == ',') {
+                    state = scopes.back().object ? State::Key : State::Value;
+                    continue;
+                }
+                break;
+            case State::ValueOrEnd:
+                if (c == ']')
+                    break;
+                [[fallthrough]];
+            case State::Value: {
+                const auto index = static_cast<uint32_t>(nodes.size());
+                Node node = {};
+                if (!scopes.empty()) {
+                    auto& parent = nodes[scopes.back().node];
+                    ++parent.container.count;
+                    if (scopes.back().object) {
+                        node.keyOffset = keyOffset;
+                        node.keyLength = keyLength;
+                        node.keyUnescaped = keyUnescaped;
+                    }
+                }
+
+                if (c == '{' || c == '[') {
+                    if (scopes.size() >= maxJsonDepth)
+                        return fail("The document is nested too deeply");
+                    node.type = c == '{' ? JsonType::Object : JsonType::Array;
+                    node.container.count = 0;
+                    nodes.push_back(node);
+                    scopes.push_back({ index, c == '{' });
+                    state = c == '{' ? State::KeyOrEnd : State::ValueOrEnd;
+                    continue;
+                }
+
+                if (c == '"') {
+                    node.type = JsonType::String;
+                    if (!parseString(position, node.text.offset, node.text.length, node.stringUnescaped))
+                        return fail({});
+                } else {
+                    const auto end = i + 1 < positions.size() ? static_cast<std::size_t>(positions[i + 1]) : json.size();
+                    if (!parseScalar(position, end, node))
+                        return fail({});
+                }
+                node.next = index + 1;
+                nodes.push_back(node);
+                state = scopes.empty() ? State::Done : State::CommaOrEnd;
+                continue;
+            }
+        }
+
+        // Everything that gets here has to close the innermost array or object.
+        if (scopes.empty() || c != (scopes.back().object ? '}' : ']'))
+            return fail("Expected a comma or a closing bracket");
+        nodes[scopes.back().node].next = static_cast<uint32_t>(nodes.size());
+        scopes.pop_back();
+        state = scopes.empty() ? State::Done : State::CommaOrEnd;
+    }
+
+    if (state != State::Done)
+        return fail("Unexpected end of the document");
+    return true;
+}
+
+auto ku::JsonDocument::getError() const noexcept -> std::string_view {
+    return error;
+}
+
+auto ku::JsonDocument::getRoot() const noexcept -> JsonValue {
+    return nodes.empty() ? JsonValue() : JsonValue(this, 0);
+}
+// ↑ -------------------  JSON DOCUMENT  ------------------- ↑
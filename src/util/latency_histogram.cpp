@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include <util/latency_histogram.hpp>
+
+namespace ku = krypton::util;
+
+auto ku::LatencyHistogram::getBucketIndex(uint64_t value) noexcept -> std::size_t {
+    if (value < subBucketCount)
+        return static_cast<std::size_t>(value);
+
+    // Values in [2^(e + bits - 1), 2^(e + bits)) are shifted down by e, which leaves a sub-bucket
+    // in the upper half of [0, subBucketCount).
+    auto exponent = static_cast<uint32_t>(std::bit_width(value)) - subBucketBits;
+    auto subBucket = value >> exponent;
+    return static_cast<std::size_t>(exponent * subBucketHalfCount + subBucket);
+}
+
+auto ku::LatencyHistogram::getBucketUpperBound(std::size_t index) noexcept -> uint64_t {
+    if (index < subBucketCount)
+        return index;
+
+    auto exponent = (index / subBucketHalfCount) - 1;
+    auto subBucket = index - exponent * subBucketHalfCount;
+    return ((subBucket + 1) << exponent) - 1;
+}
+
+auto ku::LatencyHistogram::getCount() const noexcept -> uint64_t {
+    return totalCount.load(std::memory_order_relaxed);
+}
+
+auto ku::LatencyHistogram::getMax() const noexcept -> std::chrono::nanoseconds {
+    return std::chrono::nanoseconds(maxValue.load(std::memory_order_relaxed));
+}
+
+auto ku::LatencyHistogram::getMean() const noexcept -> std::chrono::nanoseconds {
+    auto count = getCount();
+    if (count == 0)
+        return {};
+    return std::chrono::nanoseconds(totalSum.load(std::memory_order_relaxed) / count);
+}
+
+auto ku::LatencyHistogram::getMin() const noexcept -> std::chrono::nanoseconds {
+    auto value = minValue.load(std::memory_order_relaxed);
+    return std::chrono::nanoseconds(value == UINT64_MAX ? 0 : value);
+}
+
+auto ku::LatencyHistogram::getPercentile(double percentile) const noexcept -> std::chrono::nanoseconds {
+    // We sum the buckets instead of relying on totalCount so that the result is consistent
+    // even if other threads are recording right now.
+    uint64_t count = 0;
+    for (const auto& bucket : buckets)
+        count += bucket.load(std::memory_order_relaxed);
+    if (count == 0)
+        return {};
+
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count))));
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            auto value = std::min(getBucketUpperBound(i), maxValue.load(std::memory_order_relaxed));
+            return std::chrono::nanoseconds(value);
+        }
+    }
+    return getMax();
+}
+
+auto ku::LatencyHistogram::getSummary() const noexcept -> LatencySummary {
+    return LatencySummary {
+        .count = getCount(),
+        .min = getMin(),
+        .max = getMax(),
+        .mean = getMean(),
+        .p50 = getPercentile(50.0),
+        .p95 = getPercentile(95.0),
+        .p99 = getPercentile(99.0),
+    };
+}
+
+void ku::LatencyHistogram::record(std::chrono::nanoseconds duration) noexcept {
+    auto value = static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+
+    buckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalSum.fetch_add(value, std::memory_order_relaxed);
+
+    auto currentMin = minValue.load(std::memory_order_relaxed);
+    while (value < currentMin && !minValue.compare_exchange_weak(currentMin, value, std::memory_order_relaxed)) {}
+    auto currentMax = maxValue.load(std::memory_order_relaxed);
+    while (value > currentMax && !maxValue.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {}
+}
+
+void ku::LatencyHistogram::reset() noexcept {
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    totalCount.store(0, std::memory_order_relaxed);
+    totalSum.store(0, std::memory_order_relaxed);
+    minValue.store(UINT64_MAX, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
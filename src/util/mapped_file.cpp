@@ -0,0 +1,134 @@
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <Tracy.hpp>
+
+#include <util/mapped_file.hpp>
+
+namespace ku = krypton::util;
+
+ku::MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+ku::MappedFile::~MappedFile() {
+    close();
+}
+
+auto ku::MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile& {
+    if (this == &other)
+        return *this;
+    close();
+    mapping = std::exchange(other.mapping, nullptr);
+    mappingSize = std::exchange(other.mappingSize, 0);
+    opened = std::exchange(other.opened, false);
+#if defined(_WIN32)
+    fileHandle = std::exchange(other.fileHandle, nullptr);
+    mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+    return *this;
+}
+
+bool ku::MappedFile::open(const std::filesystem::path& path) {
+    ZoneScoped;
+    close();
+
+#if defined(_WIN32)
+    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    opened = true;
+    if (fileSize.QuadPart == 0)
+        return true;
+
+    // Mapping a file with a size of zero fails, which is why that is handled above.
+    mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        close();
+        return false;
+    }
+    mapping = static_cast<const std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (mapping == nullptr) {
+        close();
+        return false;
+    }
+    mappingSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+        return false;
+
+    struct stat status = {};
+    if (fstat(file, &status) != 0) {
+        ::close(file);
+        return false;
+    }
+
+    auto size = static_cast<std::size_t>(status.st_size);
+    void* address = nullptr;
+    if (size != 0) {
+        address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (address == MAP_FAILED) {
+            ::close(file);
+            return false;
+        }
+    }
+
+    // The mapping keeps its own reference to the file.
+    ::close(file);
+    mapping = static_cast<const std::byte*>(address);
+    mappingSize = size;
+    opened = true;
+#endif
+    return true;
+}
+
+void ku::MappedFile::close() noexcept {
+#if defined(_WIN32)
+    if (mapping != nullptr)
+        UnmapViewOfFile(mapping);
+    if (mappingHandle != nullptr)
+        CloseHandle(mappingHandle);
+    if (fileHandle != nullptr)
+        CloseHandle(fileHandle);
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    if (mapping != nullptr)
+        munmap(const_cast<std::byte*>(mapping), mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    opened = false;
+}
+
+bool ku::MappedFile::isOpen() const noexcept {
+    return opened;
+}
+
+auto ku::MappedFile::getData() const noexcept -> std::span<const std::byte> {
+    return { mapping, mappingSize };
+}
+
+auto ku::MappedFile::size() const noexcept -> std::size_t {
+    return mappingSize;
+}
@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include <Tracy.hpp>
+
+#include <util/meshopt_codec.hpp>
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    constexpr uint8_t vertexHeader = 0xA0;
+    constexpr uint8_t triangleHeader = 0xE0;
+    constexpr uint8_t sequenceHeader = 0xD0;
+
+    // Vertices are encoded in blocks of at most 8 KiB and 256 vertices, every byte of a block
+    // in groups of 16 bytes.
+    constexpr std::size_t vertexBlockSizeBytes = 8192;
+    constexpr std::size_t vertexBlockMaxSize = 256;
+    constexpr std::size_t byteGroupSize = 16;
+    // The most a byte group can read, which the encoder guarantees through the tail.
+    constexpr std::size_t byteGroupDecodeLimit = 24;
+    constexpr std::size_t vertexTailMaxSize = 32;
+
+    auto getVertexBlockSize(std::size_t stride) noexcept -> std::size_t {
+        return std::min((vertexBlockSizeBytes / stride) & ~(byteGroupSize - 1), vertexBlockMaxSize);
+    }
+
+    auto unzigzag8(uint8_t value) noexcept -> uint8_t {
+        return static_cast<uint8_t>(-(value & 1) ^ (value >> 1));
+    }
+
+    /**
+     * Decodes a group of 16 bytes with 0, 2, 4 or 8 bits each. Values that don't fit into 2 or
+     * 4 bits are marked with all bits set and follow the packed bits as whole bytes.
+     */
+    auto decodeBytesGroup(const uint8_t* data, uint8_t* out, uint32_t bitsLog2) noexcept -> const uint8_t* {
+        if (bitsLog2 == 0) {
+            std::memset(out, 0, byteGroupSize);
+            return data;
+        }
+        if (bitsLog2 == 3) {
+            std::memcpy(out, data, byteGroupSize);
+            return data + byteGroupSize;
+        }
+
+        const uint32_t bits = bitsLog2 == 1 ? 2 : 4;
+        const uint32_t mask = (1u << bits) - 1;
+        const auto* packed = data;
+        const auto* variable = data + byteGroupSize * bits / 8;
+        for (std::size_t i = 0; i < byteGroupSize; i += 8 / bits) {
+            auto byte = *packed++;
+            for (uint32_t j = 0; j < 8 / bits; ++j) {
+                const auto value = static_cast<uint32_t>(byte >> (8 - bits));
+                byte = static_cast<uint8_t>(byte << bits);
+                out[i + j] = value == mask ? *variable++ : static_cast<uint8_t>(value);
+            }
+        }
+        return variable;
+    }
+
+    // Decodes size bytes, a multiple of 16, with a two bit header for every group.
+    auto decodeBytes(const uint8_t* data, const uint8_t* end, uint8_t* out, std::size_t size) noexcept -> const uint8_t* {
+        const auto headerSize = (size / byteGroupSize + 3) / 4;
+        if (static_cast<std::size_t>(end - data) < headerSize)
+            return nullptr;
+        const auto* header = data;
+        data += headerSize;
+        for (std::size_t i = 0; i < size; i += byteGroupSize) {
+            if (static_cast<std::size_t>(end - data) < byteGroupDecodeLimit)
+                return nullptr;
+            const auto group = i / byteGroupSize;
+            data = decodeBytesGroup(data, out + i, (header[group / 4] >> ((group % 4) * 2)) & 3);
+        }
+        return data;
+    }
+
+    /**
+     * Every byte of a vertex is stored as the zigzag encoded difference to the same byte of the
+     * previous vertex. The first vertex is stored at the end, as the base of the first deltas.
+     */
+    bool decodeVertexBuffer(std::span<const uint8_t> src, std::size_t count, std::size_t stride, std::byte* dst) noexcept {
+        if (src.size() < 1 + stride || src[0] != vertexHeader)
+            return false;
+
+        std::array<uint8_t, vertexBlockMaxSize> lastVertex;
+        std::memcpy(lastVertex.data(), src.data() + src.size() - stride, stride);
+
+        const auto* data = src.data() + 1;
+        const auto* end = src.data() + src.size();
+        const auto blockSize = getVertexBlockSize(stride);
+        std::array<uint8_t, vertexBlockMaxSize> buffer;
+        for (std::size_t first = 0; first < count; first += blockSize) {
+            const auto blockCount = std::min(blockSize, count - first);
+            const auto alignedCount = (blockCount + byteGroupSize - 1) & ~(byteGroupSize - 1);
+            for (std::size_t k = 0; k < stride; ++k) {
+                data = decodeBytes(data, end, buffer.data(), alignedCount);
+                if (data == nullptr)
+                    return false;
+
+                auto previous = lastVertex[k];
+                for (std::size_t i = 0; i < blockCount; ++i) {
+                    previous = static_cast<uint8_t>(unzigzag8(buffer[i]) + previous);
+                    dst[(first + i) * stride + k] = static_cast<std::byte>(previous);
+                }
+                lastVertex[k] = previous;
+            }
+        }
+        return static_cast<std::size_t>(end - data) == std::max(stride, vertexTailMaxSize);
+    }
+
+    // A LEB128 like varint with at most five bytes.
+    auto decodeVByte(const uint8_t*& data) noexcept -> uint32_t {
+        const auto lead = *data++;
+        if (lead < 128)
+            return lead;
+        uint32_t result = lead & 127;
+        for (uint32_t i = 0, shift = 7; i < 4; ++i, shift += 7) {
+            const auto group = *data++;
+            result |= static_cast<uint32_t>(group & 127) << shift;
+            if (group < 128)
+                break;
+        }
+        return result;
+    }
+
+    // Indices that aren't in the FIFOs are stored as zigzag encoded differences to the last one.
+    auto decodeIndex(const uint8_t*& data, uint32_t last) noexcept -> uint32_t {
+        const auto value = decodeVByte(data);
+        return last + ((value >> 1) ^ (0u - (value & 1)));
+    }
+
+    void writeIndex(std::byte* dst, std::size_t stride, std::size_t index, uint32_t value) noexcept {
+        if (stride == 2) {
+            const auto narrow = static_cast<uint16_t>(value);
+            std::memcpy(dst + index * 2, &narrow, sizeof(narrow));
+        } else {
+            std::memcpy(dst + index * 4, &value, sizeof(value));
+        }
+    }
+
+    /**
+     * Triangles are encoded with a byte per triangle, which refers to an edge and a vertex of the
+     * previous triangles through two 16 entry FIFOs, or says which of its vertices are new. The
+     * FIFO updates have to match the encoder exactly. The last 16 bytes are a table of common
+     * codes for triangles without a shared edge.
+     */
+    bool decodeIndexBuffer(std::span<const uint8_t> src, std::size_t count, std::size_t stride, std::byte* dst) noexcept {
+        if (src.size() < 1 + count / 3 + 16 || (src[0] & 0xF0) != triangleHeader || (src[0] & 0x0F) > 1)
+            return false;
+        const uint32_t maxFifoCode = (src[0] & 0x0F) >= 1 ? 13 : 15;
+
+        uint32_t edgeFifo[16][2], vertexFifo[16];
+        std::memset(edgeFifo, 0xFF, sizeof(edgeFifo));
+        std::memset(vertexFifo, 0xFF, sizeof(vertexFifo));
+        uint32_t edgeOffset = 0, vertexOffset = 0;
+        uint32_t next = 0, last = 0;
+
+        const auto pushEdge = [&](uint32_t a, uint32_t b) {
+            edgeFifo[edgeOffset][0] = a;
+            edgeFifo[edgeOffset][1] = b;
+            edgeOffset = (edgeOffset + 1) & 15;
+        };
+        const auto pushVertex = [&](uint32_t v, bool push = true) {
+            vertexFifo[vertexOffset] = v;
+            vertexOffset = (vertexOffset + (push ? 1 : 0)) & 15;
+        };
+
+        const auto* codes = src.data() + 1;
+        const auto* data = codes + count / 3;
+        // Every triangle reads at most 16 bytes, which the table at the end makes room for.
+        const auto* safeEnd = src.data() + src.size() - 16;
+        const auto* codeAuxTable = safeEnd;
+        for (std::size_t i = 0; i < count; i += 3) {
+            if (data > safeEnd)
+                return false;
+
+            const auto code = *codes++;
+            uint32_t a, b, c;
+            if (code < 0xF0) {
+                // An edge of a previous triangle and a new, cached or explicit third vertex.
+                const auto& edge = edgeFifo[(edgeOffset - 1 - (code >> 4)) & 15];
+                a = edge[0];
+                b = edge[1];
+                const uint32_t fec = code & 15;
+                if (fec < maxFifoCode) {
+                    c = fec == 0 ? next++ : vertexFifo[(vertexOffset - 1 - fec) & 15];
+                    pushVertex(c, fec == 0);
+                } else {
+                    // Version 1 encodes 13 and 14 as the last explicit index -1 and +1.
+                    last = c = fec != 15 ? last + (fec == 13 ? -1 : 1) : decodeIndex(data, last);
+                    pushVertex(c);
+                }
+                pushEdge(c, b);
+                pushEdge(a, c);
+            } else {
+                // A triangle without a shared edge, whose codes are in the table or the next byte.
+                const bool inTable = code < 0xFE;
+                const auto codeAux = inTable ? codeAuxTable[code & 15] : *data++;
+                const uint32_t fea = inTable || code == 0xFE ? 0 : 15;
+                const uint32_t feb = codeAux >> 4, fec = codeAux & 15;
+                if (!inTable && codeAux == 0)
+                    next = 0;
+
+                a = fea == 0 ? next++ : 0;
+                b = feb == 0 ? next++ : vertexFifo[(vertexOffset - feb) & 15];
+                c = fec == 0 ? next++ : vertexFifo[(vertexOffset - fec) & 15];
+                if (fea == 15)
+                    last = a = decodeIndex(data, last);
+                if (feb == 15)
+                    last = b = decodeIndex(data, last);
+                if (fec == 15)
+                    last = c = decodeIndex(data, last);
+
+                pushVertex(a);
+                pushVertex(b, feb == 0 || feb == 15);
+                pushVertex(c, fec == 0 || fec == 15);
+                pushEdge(b, a);
+                pushEdge(c, b);
+                pushEdge(a, c);
+            }
+
+            writeIndex(dst, stride, i + 0, a);
+            writeIndex(dst, stride, i + 1, b);
+            writeIndex(dst, stride, i + 2, c);
+        }
+        return data == safeEnd;
+    }
+
+    // Every index is a zigzag encoded difference to one of two previous indices.
+    bool decodeIndexSequence(std::span<const uint8_t> src, std::size_t count, std::size_t stride, std::byte* dst) noexcept {
+        if (src.size() < 1 + count + 4 || (src[0] & 0xF0) != sequenceHeader || (src[0] & 0x0F) > 1)
+            return false;
+
+        const auto* data = src.data() + 1;
+        // Every index reads at most 5 bytes, which the 4 byte tail makes room for.
+        const auto* safeEnd = src.data() + src.size() - 4;
+        uint32_t last[2] = {};
+        for (std::size_t i = 0; i < count; ++i) {
+            if (data >= safeEnd)
+                return false;
+            const auto value = decodeVByte(data);
+            const auto baseline = value & 1;
+            const auto delta = value >> 1;
+            last[baseline] += (delta >> 1) ^ (0u - (delta & 1));
+            writeIndex(dst, stride, i, last[baseline]);
+        }
+        return data == safeEnd;
+    }
+
+    template <typename T>
+    auto roundToInt(float value) noexcept -> T {
+        return static_cast<T>(static_cast<int32_t>(value + (value >= 0.0f ? 0.5f : -0.5f)));
+    }
+
+    // The z component holds the value that 1.0 was encoded as, which is also the output scale.
+    template <typename T>
+    void decodeOctahedralFilter(std::byte* data, std::size_t count) noexcept {
+        constexpr auto maxValue = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+        for (std::size_t i = 0; i < count; ++i) {
+            T values[4];
+            std::memcpy(values, data + i * sizeof(values), sizeof(values));
+            auto x = static_cast<float>(values[0]);
+            auto y = static_cast<float>(values[1]);
+            const auto z = static_cast<float>(values[2]) - std::fabs(x) - std::fabs(y);
+            // Fold the lower hemisphere back out.
+            const auto t = std::min(z, 0.0f);
+            x += x >= 0.0f ? t : -t;
+            y += y >= 0.0f ? t : -t;
+
+            const auto scale = maxValue / std::sqrt(x * x + y * y + z * z);
+            values[0] = roundToInt<T>(x * scale);
+            values[1] = roundToInt<T>(y * scale);
+            values[2] = roundToInt<T>(z * scale);
+            std::memcpy(data + i * sizeof(values), values, sizeof(values));
+        }
+    }
+
+    // The 4th component holds the index of the dropped largest component and the encoding scale.
+    void decodeQuaternionFilter(std::byte* data, std::size_t count) noexcept {
+        const auto scale = 1.0f / std::sqrt(2.0f);
+        for (std::size_t i = 0; i < count; ++i) {
+            int16_t values[4];
+            std::memcpy(values, data + i * sizeof(values), sizeof(values));
+            const auto componentScale = scale / static_cast<float>(values[3] | 3);
+            const auto x = static_cast<float>(values[0]) * componentScale;
+            const auto y = static_cast<float>(values[1]) * componentScale;
+            const auto z = static_cast<float>(values[2]) * componentScale;
+            const auto w = std::sqrt(std::max(1.0f - x * x - y * y - z * z, 0.0f));
+
+            const auto largest = static_cast<uint32_t>(values[3] & 3);
+            values[(largest + 1) & 3] = roundToInt<int16_t>(x * 32767.0f);
+            values[(largest + 2) & 3] = roundToInt<int16_t>(y * 32767.0f);
+            values[(largest + 3) & 3] = roundToInt<int16_t>(z * 32767.0f);
+            values[largest] = roundToInt<int16_t>(w * 32767.0f);
+            std::memcpy(data + i * sizeof(values), values, sizeof(values));
+        }
+    }
+
+    void decodeExponentialFilter(std::byte* data, std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; ++i) {
+            int32_t value;
+            std::memcpy(&value, data + i * 4, sizeof(value));
+            // The mantissa is the sign extended lower 24 bits, the exponent the upper 8 bits.
+            const auto mantissa = static_cast<int32_t>(static_cast<uint32_t>(value) << 8) >> 8;
+            const auto exponent = value >> 24;
+            const auto decoded = std::ldexp(static_cast<float>(mantissa), exponent);
+            std::memcpy(data + i * 4, &decoded, sizeof(decoded));
+        }
+    }
+} // namespace krypton::util
+
+bool ku::isValidMeshoptStride(MeshoptMode mode, MeshoptFilter filter, std::size_t stride) noexcept {
+    switch (mode) {
+        case MeshoptMode::Attributes:
+            break;
+        case MeshoptMode::Triangles:
+        case MeshoptMode::Indices:
+            return filter == MeshoptFilter::None && (stride == 2 || stride == 4);
+    }
+
+    if (stride == 0 || stride % 4 != 0 || stride > vertexBlockMaxSize)
+        return false;
+    switch (filter) {
+        case MeshoptFilter::None:
+        case MeshoptFilter::Exponential:
+            return true;
+        case MeshoptFilter::Octahedral:
+            return stride == 4 || stride == 8;
+        case MeshoptFilter::Quaternion:
+            return stride == 8;
+    }
+    return false;
+}
+
+bool ku::decodeMeshoptBuffer(std::span<const std::byte> src, std::size_t count, std::size_t stride, MeshoptMode mode, MeshoptFilter filter,
+                             std::span<std::byte> dst) {
+    ZoneScoped;
+    if (!isValidMeshoptStride(mode, filter, stride) || dst.size() / stride < count)
+        return false;
+
+    const std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(src.data()), src.size());
+    switch (mode) {
+        case MeshoptMode::Attributes:
+            if (!decodeVertexBuffer(bytes, count, stride, dst.data()))
+                return false;
+            break;
+        case MeshoptMode::Triangles:
+            return count % 3 == 0 && decodeIndexBuffer(bytes, count, stride, dst.data());
+        case MeshoptMode::Indices:
+            return decodeIndexSequence(bytes, count, stride, dst.data());
+    }
+
+    switch (filter) {
+        case MeshoptFilter::None:
+            break;
+        case MeshoptFilter::Octahedral:
+            if (stride == 4)
+                decodeOctahedralFilter<int8_t>(dst.data(), count);
+            else
+                decodeOctahedralFilter<int16_t>(dst.data(), count);
+            break;
+        case MeshoptFilter::Quaternion:
+            decodeQuaternionFilter(dst.data(), count);
+            break;
+        case MeshoptFilter::Exponential:
+            decodeExponentialFilter(dst.data(), count * stride / 4);
+            break;
+    }
+    return true;
+}
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+#include <Tracy.hpp>
+
+#include <util/assert.hpp>
+#include <util/attributes.hpp>
+#include <util/kernel_dispatch.hpp>
+#include <util/mip_filter.hpp>
+
+#if defined(KRYPTON_ARCH_X86)
+    #include <immintrin.h>
+#elif defined(KRYPTON_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    // Downsamples one row of four channel pixels from the two source rows.
+    using DownsampleKernel = void(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth);
+
+    [[nodiscard]] auto srgbToLinear(float value) noexcept -> float {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    [[nodiscard]] auto linearToSrgb(float value) noexcept -> float {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    struct SrgbTables final {
+        // The first 256 entries decode sRGB to linear, the next 256 decode linear 8-bit values,
+        // so that alpha channels can be looked up with the same instruction.
+        alignas(64) float toLinear[512];
+        // Encodes linear values quantized to 16 bits. Even near zero, one step of this is far
+        // smaller than one 8-bit sRGB step. The table is padded so that it can be read with
+        // 32-bit gathers.
+        alignas(64) uint8_t toSrgb[65536 + 3];
+    };
+
+    auto getSrgbTables() -> const SrgbTables& {
+        static const auto tables = []() {
+            auto result = std::make_unique<SrgbTables>();
+            for (uint32_t i = 0; i < 256; ++i) {
+                result->toLinear[i] = srgbToLinear(static_cast<float>(i) / 255.0f);
+                result->toLinear[256 + i] = static_cast<float>(i) / 255.0f;
+            }
+            for (uint32_t i = 0; i < 65536; ++i)
+                result->toSrgb[i] = static_cast<uint8_t>(std::lround(linearToSrgb(static_cast<float>(i) / 65535.0f) * 255.0f));
+            result->toSrgb[65536] = result->toSrgb[65537] = result->toSrgb[65538] = 0;
+            return result;
+        }();
+        return *tables;
+    }
+
+    // ↓ -------------------  SCALAR  ------------------- ↓
+    void downsampleRgba8Scalar(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth) {
+        const auto* a = reinterpret_cast<const uint8_t*>(row0);
+        const auto* b = reinterpret_cast<const uint8_t*>(row1);
+        auto* out = reinterpret_cast<uint8_t*>(dst);
+        for (std::size_t i = 0; i < dstWidth * 4; ++i) {
+            const auto x = (i / 4) * 8 + i % 4;
+            out[i] = static_cast<uint8_t>((a[x] + a[x + 4] + b[x] + b[x + 4] + 2) >> 2);
+        }
+    }
+
+    void downsampleRgba16Scalar(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth) {
+        const auto* a = reinterpret_cast<const uint16_t*>(row0);
+        const auto* b = reinterpret_cast<const uint16_t*>(row1);
+        auto* out = reinterpret_cast<uint16_t*>(dst);
+        for (std::size_t i = 0; i < dstWidth * 4; ++i) {
+            const auto x = (i / 4) * 8 + i % 4;
+            out[i] = static_cast<uint16_t>((uint32_t(a[x]) + a[x + 4] + b[x] + b[x + 4] + 2) >> 2);
+        }
+    }
+
+    // Uses the same order of operations as the vectorized kernels, so that the results match.
+    void downsampleRgba8SrgbScalar(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth) {
+        const auto& tables = getSrgbTables();
+        const auto* a = reinterpret_cast<const uint8_t*>(row0);
+        const auto* b = reinterpret_cast<const uint8_t*>(row1);
+        auto* out = reinterpret_cast<uint8_t*>(dst);
+        for (std::size_t i = 0; i < dstWidth * 4; ++i) {
+            const auto x = (i / 4) * 8 + i % 4;
+            const bool alpha = i % 4 == 3;
+            const auto* table = alpha ? tables.toLinear + 256 : tables.toLinear;
+            const auto sum = (table[a[x]] + table[b[x]]) + (table[a[x + 4]] + table[b[x + 4]]);
+            const auto value = sum * 0.25f * (alpha ? 255.0f : 65535.0f);
+            const auto index = static_cast<int32_t>(std::nearbyint(value));
+            out[i] = alpha ? static_cast<uint8_t>(index) : tables.toSrgb[index];
+        }
+    }
+    // ↑ -------------------  SCALAR  ------------------- ↑
+
+#if defined(KRYPTON_ARCH_X86)
+    // ↓ -------------------   AVX2   ------------------- ↓
+    // Decodes two pixels into linear floats.
+    TARGET_AVX2 ALWAYS_INLINE inline auto loadLinearAvx2(const float* toLinear, const std::byte* pixels, __m256i alphaOffset) -> __m256 {
+        const auto values = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels)));
+        return _mm256_i32gather_ps(toLinear, _mm256_add_epi32(values, alphaOffset), 4);
+    }
+
+    TARGET_AVX2 void downsampleRgba8SrgbAvx2(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth) {
+        const auto& tables = getSrgbTables();
+        const auto* toLinear = tables.toLinear;
+        const auto alphaOffset = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+        const auto alphaMask = _mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1);
+        const auto scale = _mm256_setr_ps(65535.0f, 65535.0f, 65535.0f, 255.0f, 65535.0f, 65535.0f, 65535.0f, 255.0f);
+        const auto quarter = _mm256_set1_ps(0.25f);
+        const auto byteMask = _mm256_set1_epi32(0xFF);
+
+        std::size_t x = 0;
+        for (; x + 2 <= dstWidth; x += 2) {
+            // a holds the column sums of source pixels 0 and 1, b those of pixels 2 and 3.
+            const auto* a0 = row0 + x * 8;
+            const auto* a1 = row1 + x * 8;
+            const auto a = _mm256_add_ps(loadLinearAvx2(toLinear, a0, alphaOffset), loadLinearAvx2(toLinear, a1, alphaOffset));
+            const auto b = _mm256_add_ps(loadLinearAvx2(toLinear, a0 + 8, alphaOffset), loadLinearAvx2(toLinear, a1 + 8, alphaOffset));
+            const auto sum = _mm256_add_ps(_mm256_permute2f128_ps(a, b, 0x20), _mm256_permute2f128_ps(a, b, 0x31));
+            const auto indices = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_mul_ps(sum, quarter), scale));
+
+            auto encoded = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(tables.toSrgb), indices, 1), byteMask);
+            encoded = _mm256_blendv_epi8(encoded, indices, alphaMask);
+            const auto words = _mm_packus_epi32(_mm256_castsi256_si128(encoded), _mm256_extracti128_si256(encoded, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packus_epi16(words, words));
+        }
+        downsampleRgba8SrgbScalar(row0 + x * 8, row1 + x * 8, dst + x * 4, dstWidth - x);
+    }
+    // ↑ -------------------   AVX2   ------------------- ↑
+
+    // ↓ -------------------  SSE4.2  ------------------- ↓
+    TARGET_SSE42 void downsampleRgba8Sse42(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth) {
+        const auto rounding = _mm_set1_epi16(2);
+        std::size_t x = 0;
+        for (; x + 2 <= dstWidth; x += 2) {
+            const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+            const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+            // Add up the rows with 16 bits per channel, and then the neighbouring pixels.
+            const auto low = _mm_add_epi16(_mm_cvtepu8_epi16(a), _mm_cvtepu8_epi16(b));
+            const auto high = _mm_add_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(a, 8)), _mm_cvtepu8_epi16(_mm_srli_si128(b, 8)));
+            auto sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+            sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packus_epi16(sum, sum));
+        }
+        downsampleRgba8Scalar(row0 + x * 8, row1 + x * 8, dst + x * 4, dstWidth - x);
+    }
+
+    TARGET_SSE42 void downsampleRgba16Sse42(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth) {
+        const auto rounding = _mm_set1_epi32(2);
+        for (std::size_t x = 0; x < dstWidth; ++x) {
+            const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 16));
+            const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 16));
+            const auto left = _mm_add_epi32(_mm_cvtepu16_epi32(a), _mm_cvtepu16_epi32(b));
+            const auto right = _mm_add_epi32(_mm_cvtepu16_epi32(_mm_srli_si128(a, 8)), _mm_cvtepu16_epi32(_mm_srli_si128(b, 8)));
+            const auto sum = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(left, right), rounding), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 8), _mm_packus_epi32(sum, sum));
+        }
+    }
+    // ↑ -------------------  SSE4.2  ------------------- ↑
+#elif defined(KRYPTON_HAS_NEON)
+    // ↓ -------------------   NEON   ------------------- ↓
+    void downsampleRgba8Neon(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth) {
+        std::size_t x = 0;
+        for (; x + 2 <= dstWidth; x += 2) {
+            const auto a = vld1q_u8(reinterpret_cast<const uint8_t*>(row0 + x * 8));
+            const auto b = vld1q_u8(reinterpret_cast<const uint8_t*>(row1 + x * 8));
+            const auto low = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+            const auto high = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+            const auto sum = vaddq_u16(vcombine_u16(vget_low_u16(low), vget_low_u16(high)),
+                                       vcombine_u16(vget_high_u16(low), vget_high_u16(high)));
+            // Computes (sum + 2) >> 2.
+            vst1_u8(reinterpret_cast<uint8_t*>(dst + x * 4), vrshrn_n_u16(sum, 2));
+        }
+        downsampleRgba8Scalar(row0 + x * 8, row1 + x * 8, dst + x * 4, dstWidth - x);
+    }
+
+    void downsampleRgba16Neon(const std::byte* row0, const std::byte* row1, std::byte* dst, std::size_t dstWidth) {
+        for (std::size_t x = 0; x < dstWidth; ++x) {
+            const auto a = vld1q_u16(reinterpret_cast<const uint16_t*>(row0 + x * 16));
+            const auto b = vld1q_u16(reinterpret_cast<const uint16_t*>(row1 + x * 16));
+            const auto left = vaddl_u16(vget_low_u16(a), vget_low_u16(b));
+            const auto right = vaddl_u16(vget_high_u16(a), vget_high_u16(b));
+            vst1_u16(reinterpret_cast<uint16_t*>(dst + x * 8), vrshrn_n_u32(vaddq_u32(left, right), 2));
+        }
+    }
+    // ↑ -------------------   NEON   ------------------- ↑
+#endif
+
+    auto getDownsampleKernel(const PixelFormat& format) -> DownsampleKernel* {
+        if (format.channels != 4)
+            return nullptr;
+
+        if (format.bytesPerChannel == 1 && !format.srgb) {
+            static const KernelDispatcher dispatcher(std::to_array<KernelVariant<DownsampleKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+                { CpuFeature::SSE42, downsampleRgba8Sse42 },
+#elif defined(KRYPTON_HAS_NEON)
+                { CpuFeature::NEON, downsampleRgba8Neon },
+#endif
+                { CpuFeature::None, downsampleRgba8Scalar },
+            }));
+            return dispatcher.get();
+        }
+        if (format.bytesPerChannel == 1) {
+            // Without gathers, the table lookups can't be vectorized.
+            static const KernelDispatcher dispatcher(std::to_array<KernelVariant<DownsampleKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+                { avx2TargetFeatures, downsampleRgba8SrgbAvx2 },
+#endif
+                { CpuFeature::None, downsampleRgba8SrgbScalar },
+            }));
+            return dispatcher.get();
+        }
+        if (format.bytesPerChannel == 2 && !format.srgb) {
+            static const KernelDispatcher dispatcher(std::to_array<KernelVariant<DownsampleKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+                { CpuFeature::SSE42, downsampleRgba16Sse42 },
+#elif defined(KRYPTON_HAS_NEON)
+                { CpuFeature::NEON, downsampleRgba16Neon },
+#endif
+                { CpuFeature::None, downsampleRgba16Scalar },
+            }));
+            return dispatcher.get();
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] auto readChannel(const std::byte* pixel, uint32_t channel, uint32_t bytesPerChannel) noexcept -> uint32_t {
+        if (bytesPerChannel == 1)
+            return static_cast<uint32_t>(pixel[channel]);
+        uint16_t value;
+        std::memcpy(&value, pixel + channel * 2, sizeof(value));
+        return value;
+    }
+
+    /**
+     * Handles every format and every width, including source rows with a single pixel, which
+     * the kernels don't. sRGB values with 16 bits are converted exactly, which is slow but rare.
+     */
+    void downsampleRowGeneric(const std::byte* row0, const std::byte* row1, uint32_t srcWidth, std::byte* dst, std::size_t dstWidth,
+                              const PixelFormat& format) {
+        const auto pixelSize = format.getPixelSize();
+        const auto maxValue = static_cast<float>((1U << (format.bytesPerChannel * 8)) - 1);
+        for (std::size_t x = 0; x < dstWidth; ++x) {
+            const std::byte* pixels[4] = {
+                row0 + std::min<std::size_t>(x * 2, srcWidth - 1) * pixelSize,
+                row0 + std::min<std::size_t>(x * 2 + 1, srcWidth - 1) * pixelSize,
+                row1 + std::min<std::size_t>(x * 2, srcWidth - 1) * pixelSize,
+                row1 + std::min<std::size_t>(x * 2 + 1, srcWidth - 1) * pixelSize,
+            };
+            for (uint32_t channel = 0; channel < format.channels; ++channel) {
+                uint32_t result = 0;
+                if (format.srgb && channel < 3) {
+                    float sum = 0.0f;
+                    for (const auto* pixel : pixels)
+                        sum += srgbToLinear(static_cast<float>(readChannel(pixel, channel, format.bytesPerChannel)) / maxValue);
+                    result = static_cast<uint32_t>(std::lround(linearToSrgb(sum * 0.25f) * maxValue));
+                } else {
+                    for (const auto* pixel : pixels)
+                        result += readChannel(pixel, channel, format.bytesPerChannel);
+                    result = (result + 2) >> 2;
+                }
+
+                auto* out = dst + x * pixelSize;
+                if (format.bytesPerChannel == 1) {
+                    out[channel] = static_cast<std::byte>(result);
+                } else {
+                    const auto value = static_cast<uint16_t>(result);
+                    std::memcpy(out + channel * 2, &value, sizeof(value));
+                }
+            }
+        }
+    }
+} // namespace krypton::util
+
+void ku::downsampleImage(std::span<const std::byte> src, uint32_t width, uint32_t height, const PixelFormat& format,
+                         std::span<std::byte> dst, uint32_t firstRow, uint32_t rowCount) {
+    ZoneScoped;
+    const auto pixelSize = format.getPixelSize();
+    const auto dstWidth = getMipExtent(width, 1);
+    const auto dstHeight = getMipExtent(height, 1);
+    VERIFY(format.bytesPerChannel == 1 || format.bytesPerChannel == 2);
+    VERIFY(src.size() >= static_cast<std::size_t>(width) * height * pixelSize);
+    VERIFY(dst.size() >= static_cast<std::size_t>(dstWidth) * dstHeight * pixelSize);
+    VERIFY(firstRow + rowCount <= dstHeight);
+
+    // The kernels read two full pixels per output pixel.
+    auto* kernel = width >= 2 ? getDownsampleKernel(format) : nullptr;
+    const auto srcRowSize = static_cast<std::size_t>(width) * pixelSize;
+    const auto dstRowSize = static_cast<std::size_t>(dstWidth) * pixelSize;
+    for (auto y = firstRow; y < firstRow + rowCount; ++y) {
+        const auto* row0 = src.data() + std::min(y * 2, height - 1) * srcRowSize;
+        const auto* row1 = src.data() + std::min(y * 2 + 1, height - 1) * srcRowSize;
+        auto* out = dst.data() + y * dstRowSize;
+        if (kernel != nullptr)
+            kernel(row0, row1, out, dstWidth);
+        else
+            downsampleRowGeneric(row0, row1, width, out, dstWidth, format);
+    }
+}
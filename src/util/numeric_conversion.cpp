@@ -0,0 +1,567 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#include <Tracy.hpp>
+
+#include <util/attributes.hpp>
+#include <util/kernel_dispatch.hpp>
+#include <util/numeric_conversion.hpp>
+
+#if defined(KRYPTON_ARCH_X86)
+    #include <immintrin.h>
+#elif defined(KRYPTON_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    template <typename T>
+    struct NormalizedTraits;
+
+    template <>
+    struct NormalizedTraits<int8_t> {
+        static constexpr float min = -1.0f;
+        static constexpr float scale = 127.0f;
+    };
+
+    template <>
+    struct NormalizedTraits<int16_t> {
+        static constexpr float min = -1.0f;
+        static constexpr float scale = 32767.0f;
+    };
+
+    template <>
+    struct NormalizedTraits<uint8_t> {
+        static constexpr float min = 0.0f;
+        static constexpr float scale = 255.0f;
+    };
+
+    template <>
+    struct NormalizedTraits<uint16_t> {
+        static constexpr float min = 0.0f;
+        static constexpr float scale = 65535.0f;
+    };
+
+    template <typename T>
+    ALWAYS_INLINE inline T floatToNormalized(float value) noexcept {
+        // Written this way so that NaN maps to the lower bound, just like (v)maxps does.
+        value = value >= NormalizedTraits<T>::min ? value : NormalizedTraits<T>::min;
+        value = value <= 1.0f ? value : 1.0f;
+        return static_cast<T>(std::nearbyint(value * NormalizedTraits<T>::scale));
+    }
+
+    template <typename T>
+    ALWAYS_INLINE inline float normalizedToFloat(T value) noexcept {
+        // We multiply with the reciprocal instead of dividing, so that the vector kernels
+        // produce bit-exact results.
+        constexpr float reciprocal = 1.0f / NormalizedTraits<T>::scale;
+        return std::max(static_cast<float>(value) * reciprocal, NormalizedTraits<T>::min);
+    }
+
+    template <typename S, typename D>
+    using ConversionKernel = void(const S* src, D* dst, std::size_t count);
+
+    // ↓ -------------------  SCALAR  ------------------- ↓
+    void floatToHalfScalar(const float* src, uint16_t* dst, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            dst[i] = floatToHalf(src[i]);
+    }
+
+    void halfToFloatScalar(const uint16_t* src, float* dst, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            dst[i] = halfToFloat(src[i]);
+    }
+
+    template <typename T>
+    void floatToNormalizedScalar(const float* src, T* dst, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            dst[i] = floatToNormalized<T>(src[i]);
+    }
+
+    template <typename T>
+    void normalizedToFloatScalar(const T* src, float* dst, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            dst[i] = normalizedToFloat<T>(src[i]);
+    }
+
+    void encodeOctahedralScalar(const float* src, int16_t* dst, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            encodeOctahedral(src + i * 3, dst + i * 2);
+    }
+
+    void decodeOctahedralScalar(const int16_t* src, float* dst, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            decodeOctahedral(src + i * 2, dst + i * 3);
+    }
+    // ↑ -------------------  SCALAR  ------------------- ↑
+
+#if defined(KRYPTON_ARCH_X86)
+    // ↓ -------------------   AVX2   ------------------- ↓
+    TARGET_AVX2 void floatToHalfAvx2(const float* src, uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto half = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), half);
+        }
+        floatToHalfScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_AVX2 void halfToFloatAvx2(const uint16_t* src, float* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(half));
+        }
+        halfToFloatScalar(src + i, dst + i, count - i);
+    }
+
+    // Clamps, scales and rounds 8 floats to 8 int32 values.
+    template <typename T>
+    TARGET_AVX2 ALWAYS_INLINE inline __m256i scaleToInt(const float* src) {
+        auto value = _mm256_max_ps(_mm256_loadu_ps(src), _mm256_set1_ps(NormalizedTraits<T>::min));
+        value = _mm256_min_ps(value, _mm256_set1_ps(1.0f));
+        // cvtps uses the current rounding mode, which is round-to-nearest-even by default.
+        return _mm256_cvtps_epi32(_mm256_mul_ps(value, _mm256_set1_ps(NormalizedTraits<T>::scale)));
+    }
+
+    template <typename T>
+    TARGET_AVX2 void floatToNormalizedAvx2(const float* src, T* dst, std::size_t count) {
+        constexpr bool isSigned = std::is_signed_v<T>;
+        std::size_t i = 0;
+        if constexpr (sizeof(T) == 2) {
+            for (; i + 16 <= count; i += 16) {
+                auto a = scaleToInt<T>(src + i);
+                auto b = scaleToInt<T>(src + i + 8);
+                // The pack instructions work within 128-bit lanes, so we have to reorder the
+                // 64-bit blocks afterwards.
+                auto packed = isSigned ? _mm256_packs_epi32(a, b) : _mm256_packus_epi32(a, b);
+                packed = _mm256_permute4x64_epi64(packed, 0b11011000);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+            }
+        } else {
+            const auto order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+            for (; i + 32 <= count; i += 32) {
+                auto a = scaleToInt<T>(src + i);
+                auto b = scaleToInt<T>(src + i + 8);
+                auto c = scaleToInt<T>(src + i + 16);
+                auto d = scaleToInt<T>(src + i + 24);
+                __m256i packed;
+                if constexpr (isSigned) {
+                    packed = _mm256_packs_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+                } else {
+                    packed = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+                }
+                packed = _mm256_permutevar8x32_epi32(packed, order);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+            }
+        }
+        floatToNormalizedScalar(src + i, dst + i, count - i);
+    }
+
+    template <typename T>
+    TARGET_AVX2 void normalizedToFloatAvx2(const T* src, float* dst, std::size_t count) {
+        const auto reciprocal = _mm256_set1_ps(1.0f / NormalizedTraits<T>::scale);
+        const auto min = _mm256_set1_ps(NormalizedTraits<T>::min);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i wide;
+            if constexpr (sizeof(T) == 2) {
+                auto packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                wide = std::is_signed_v<T> ? _mm256_cvtepi16_epi32(packed) : _mm256_cvtepu16_epi32(packed);
+            } else {
+                auto packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+                wide = std::is_signed_v<T> ? _mm256_cvtepi8_epi32(packed) : _mm256_cvtepu8_epi32(packed);
+            }
+            auto value = _mm256_mul_ps(_mm256_cvtepi32_ps(wide), reciprocal);
+            _mm256_storeu_ps(dst + i, _mm256_max_ps(value, min));
+        }
+        normalizedToFloatScalar(src + i, dst + i, count - i);
+    }
+
+    TARGET_AVX2 void encodeOctahedralAvx2(const float* src, int16_t* dst, std::size_t count) {
+        const auto signMask = _mm256_set1_ps(-0.0f);
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto gatherIndices = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const float* base = src + i * 3;
+            auto x = _mm256_i32gather_ps(base, gatherIndices, 4);
+            auto y = _mm256_i32gather_ps(base + 1, gatherIndices, 4);
+            auto z = _mm256_i32gather_ps(base + 2, gatherIndices, 4);
+
+            // Project onto the octahedron.
+            auto length = _mm256_add_ps(_mm256_add_ps(_mm256_andnot_ps(signMask, x), _mm256_andnot_ps(signMask, y)),
+                                        _mm256_andnot_ps(signMask, z));
+            auto invLength = _mm256_div_ps(one, length);
+            x = _mm256_mul_ps(x, invLength);
+            y = _mm256_mul_ps(y, invLength);
+
+            // Fold the lower hemisphere over the diagonals.
+            auto signX = _mm256_or_ps(_mm256_and_ps(x, signMask), one);
+            auto signY = _mm256_or_ps(_mm256_and_ps(y, signMask), one);
+            auto foldedX = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signMask, y)), signX);
+            auto foldedY = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signMask, x)), signY);
+            auto lower = _mm256_cmp_ps(z, _mm256_setzero_ps(), _CMP_LT_OQ);
+            x = _mm256_blendv_ps(x, foldedX, lower);
+            y = _mm256_blendv_ps(y, foldedY, lower);
+
+            // Convert to snorm16 and pack x and y into one 32-bit value per normal.
+            const auto scale = _mm256_set1_ps(NormalizedTraits<int16_t>::scale);
+            const auto minusOne = _mm256_set1_ps(-1.0f);
+            auto ix = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(x, minusOne), one), scale));
+            auto iy = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(y, minusOne), one), scale));
+            auto packed = _mm256_or_si256(_mm256_and_si256(ix, _mm256_set1_epi32(0xFFFF)), _mm256_slli_epi32(iy, 16));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), packed);
+        }
+        encodeOctahedralScalar(src + i * 3, dst + i * 2, count - i);
+    }
+
+    TARGET_AVX2 void decodeOctahedralAvx2(const int16_t* src, float* dst, std::size_t count) {
+        const auto signMask = _mm256_set1_ps(-0.0f);
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto reciprocal = _mm256_set1_ps(1.0f / NormalizedTraits<int16_t>::scale);
+        const auto minusOne = _mm256_set1_ps(-1.0f);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2));
+            auto x = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(packed, 16), 16));
+            auto y = _mm256_cvtepi32_ps(_mm256_srai_epi32(packed, 16));
+            x = _mm256_max_ps(_mm256_mul_ps(x, reciprocal), minusOne);
+            y = _mm256_max_ps(_mm256_mul_ps(y, reciprocal), minusOne);
+
+            auto z = _mm256_sub_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signMask, x)), _mm256_andnot_ps(signMask, y));
+            auto t = _mm256_max_ps(_mm256_sub_ps(_mm256_setzero_ps(), z), _mm256_setzero_ps());
+            // x += x >= 0 ? -t : t
+            x = _mm256_sub_ps(x, _mm256_or_ps(t, _mm256_and_ps(x, signMask)));
+            y = _mm256_sub_ps(y, _mm256_or_ps(t, _mm256_and_ps(y, signMask)));
+
+            auto lengthSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+            auto invLength = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared));
+
+            // Interleaving three vectors is awkward with AVX2, so we just go through the stack.
+            alignas(32) float components[3][8];
+            _mm256_store_ps(components[0], _mm256_mul_ps(x, invLength));
+            _mm256_store_ps(components[1], _mm256_mul_ps(y, invLength));
+            _mm256_store_ps(components[2], _mm256_mul_ps(z, invLength));
+            for (std::size_t j = 0; j < 8; ++j) {
+                dst[(i + j) * 3 + 0] = components[0][j];
+                dst[(i + j) * 3 + 1] = components[1][j];
+                dst[(i + j) * 3 + 2] = components[2][j];
+            }
+        }
+        decodeOctahedralScalar(src + i * 2, dst + i * 3, count - i);
+    }
+    // ↑ -------------------   AVX2   ------------------- ↑
+#elif defined(KRYPTON_ARCH_ARM64)
+    // ↓ -------------------   NEON   ------------------- ↓
+    void floatToHalfNeon(const float* src, uint16_t* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+        floatToHalfScalar(src + i, dst + i, count - i);
+    }
+
+    void halfToFloatNeon(const uint16_t* src, float* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+        halfToFloatScalar(src + i, dst + i, count - i);
+    }
+
+    template <typename T>
+    ALWAYS_INLINE inline float32x4_t clampAndScale(const float* src) {
+        auto value = vmaxq_f32(vld1q_f32(src), vdupq_n_f32(NormalizedTraits<T>::min));
+        return vmulq_f32(vminq_f32(value, vdupq_n_f32(1.0f)), vdupq_n_f32(NormalizedTraits<T>::scale));
+    }
+
+    template <typename T>
+    void floatToNormalizedNeon(const float* src, T* dst, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            // vcvtn rounds to nearest with ties to even.
+            if constexpr (std::is_signed_v<T>) {
+                auto wide = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(clampAndScale<T>(src + i))),
+                                         vqmovn_s32(vcvtnq_s32_f32(clampAndScale<T>(src + i + 4))));
+                if constexpr (sizeof(T) == 2) {
+                    vst1q_s16(dst + i, wide);
+                } else {
+                    vst1_s8(dst + i, vqmovn_s16(wide));
+                }
+            } else {
+                auto wide = vcombine_u16(vqmovn_u32(vcvtnq_u32_f32(clampAndScale<T>(src + i))),
+                                         vqmovn_u32(vcvtnq_u32_f32(clampAndScale<T>(src + i + 4))));
+                if constexpr (sizeof(T) == 2) {
+                    vst1q_u16(dst + i, wide);
+                } else {
+                    vst1_u8(dst + i, vqmovn_u16(wide));
+                }
+            }
+        }
+        floatToNormalizedScalar(src + i, dst + i, count - i);
+    }
+
+    template <typename T>
+    void normalizedToFloatNeon(const T* src, float* dst, std::size_t count) {
+        const auto reciprocal = vdupq_n_f32(1.0f / NormalizedTraits<T>::scale);
+        const auto min = vdupq_n_f32(NormalizedTraits<T>::min);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            float32x4_t low, high;
+            if constexpr (std::is_signed_v<T>) {
+                int16x8_t wide;
+                if constexpr (sizeof(T) == 2) {
+                    wide = vld1q_s16(src + i);
+                } else {
+                    wide = vmovl_s8(vld1_s8(src + i));
+                }
+                low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide)));
+                high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide)));
+            } else {
+                uint16x8_t wide;
+                if constexpr (sizeof(T) == 2) {
+                    wide = vld1q_u16(src + i);
+                } else {
+                    wide = vmovl_u8(vld1_u8(src + i));
+                }
+                low = vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide)));
+                high = vcvtq_f32_u32(vmovl_u16(vget_high_u16(wide)));
+            }
+            vst1q_f32(dst + i, vmaxq_f32(vmulq_f32(low, reciprocal), min));
+            vst1q_f32(dst + i + 4, vmaxq_f32(vmulq_f32(high, reciprocal), min));
+        }
+        normalizedToFloatScalar(src + i, dst + i, count - i);
+    }
+    // ↑ -------------------   NEON   ------------------- ↑
+#endif
+
+    template <typename S, typename D>
+    auto getFloatToNormalizedKernel() -> ConversionKernel<S, D>* {
+        static const KernelDispatcher dispatcher(std::to_array<KernelVariant<ConversionKernel<S, D>>>({
+#if defined(KRYPTON_ARCH_X86)
+            { avx2TargetFeatures, floatToNormalizedAvx2<D> },
+#elif defined(KRYPTON_ARCH_ARM64)
+            { CpuFeature::NEON, floatToNormalizedNeon<D> },
+#endif
+            { CpuFeature::None, floatToNormalizedScalar<D> },
+        }));
+        return dispatcher.get();
+    }
+
+    template <typename S, typename D>
+    auto getNormalizedToFloatKernel() -> ConversionKernel<S, D>* {
+        static const KernelDispatcher dispatcher(std::to_array<KernelVariant<ConversionKernel<S, D>>>({
+#if defined(KRYPTON_ARCH_X86)
+            { avx2TargetFeatures, normalizedToFloatAvx2<S> },
+#elif defined(KRYPTON_ARCH_ARM64)
+            { CpuFeature::NEON, normalizedToFloatNeon<S> },
+#endif
+            { CpuFeature::None, normalizedToFloatScalar<S> },
+        }));
+        return dispatcher.get();
+    }
+} // namespace krypton::util
+
+// ↓ -------------------  SINGLE VALUES  ------------------- ↓
+uint16_t ku::floatToHalf(float value) noexcept {
+    // Based on "float_to_half_fast3_rtne" by Fabian Giesen, which uses the FPU to round subnormals
+    // and an integer rounding bias for the normal range.
+    constexpr uint32_t infinity = 255U << 23;
+    constexpr uint32_t halfMax = (127U + 16U) << 23;
+    constexpr uint32_t denormMagic = ((127U - 15U) + (23U - 10U) + 1U) << 23;
+
+    auto bits = std::bit_cast<uint32_t>(value);
+    const uint32_t sign = bits & 0x80000000U;
+    bits ^= sign;
+
+    uint32_t result;
+    if (bits >= halfMax) {
+        // Infinity or NaN. We keep the upper mantissa bits of NaNs and make them quiet, like F16C.
+        result = bits > infinity ? (0x7E00U | ((bits >> 13) & 0x3FFU)) : 0x7C00U;
+    } else if (bits < (113U << 23)) {
+        // The result is a subnormal or zero. Adding the magic value aligns the mantissa bits at
+        // the bottom of the float and rounds them to nearest even.
+        auto aligned = std::bit_cast<float>(bits) + std::bit_cast<float>(denormMagic);
+        result = std::bit_cast<uint32_t>(aligned) - denormMagic;
+    } else {
+        const uint32_t mantissaOdd = (bits >> 13) & 1U;
+        bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFU;
+        bits += mantissaOdd;
+        result = bits >> 13;
+    }
+    return static_cast<uint16_t>(result | (sign >> 16));
+}
+
+float ku::halfToFloat(uint16_t value) noexcept {
+    constexpr uint32_t shiftedExponent = 0x7C00U << 13;
+    constexpr uint32_t magic = 113U << 23;
+
+    uint32_t bits = (value & 0x7FFFU) << 13;
+    const uint32_t exponent = bits & shiftedExponent;
+    bits += (127U - 15U) << 23;
+
+    if (exponent == shiftedExponent) {
+        // Infinity or NaN
+        bits += (128U - 16U) << 23;
+    } else if (exponent == 0) {
+        // Zero or subnormal, which we renormalize using the FPU.
+        bits += 1U << 23;
+        bits = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) - std::bit_cast<float>(magic));
+    }
+
+    bits |= static_cast<uint32_t>(value & 0x8000U) << 16;
+    return std::bit_cast<float>(bits);
+}
+
+int8_t ku::floatToSnorm8(float value) noexcept {
+    return floatToNormalized<int8_t>(value);
+}
+
+int16_t ku::floatToSnorm16(float value) noexcept {
+    return floatToNormalized<int16_t>(value);
+}
+
+uint8_t ku::floatToUnorm8(float value) noexcept {
+    return floatToNormalized<uint8_t>(value);
+}
+
+uint16_t ku::floatToUnorm16(float value) noexcept {
+    return floatToNormalized<uint16_t>(value);
+}
+
+float ku::snorm8ToFloat(int8_t value) noexcept {
+    return normalizedToFloat(value);
+}
+
+float ku::snorm16ToFloat(int16_t value) noexcept {
+    return normalizedToFloat(value);
+}
+
+float ku::unorm8ToFloat(uint8_t value) noexcept {
+    return normalizedToFloat(value);
+}
+
+float ku::unorm16ToFloat(uint16_t value) noexcept {
+    return normalizedToFloat(value);
+}
+
+void ku::encodeOctahedral(const float* normal, int16_t* encoded) noexcept {
+    const float length = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+    float x = normal[0] * (1.0f / length);
+    float y = normal[1] * (1.0f / length);
+    if (normal[2] < 0.0f) {
+        const float foldedX = (1.0f - std::abs(y)) * std::copysign(1.0f, x);
+        const float foldedY = (1.0f - std::abs(x)) * std::copysign(1.0f, y);
+        x = foldedX;
+        y = foldedY;
+    }
+    encoded[0] = floatToNormalized<int16_t>(x);
+    encoded[1] = floatToNormalized<int16_t>(y);
+}
+
+void ku::decodeOctahedral(const int16_t* encoded, float* normal) noexcept {
+    float x = normalizedToFloat(encoded[0]);
+    float y = normalizedToFloat(encoded[1]);
+    const float z = 1.0f - std::abs(x) - std::abs(y);
+    const float t = std::max(-z, 0.0f);
+    x -= std::copysign(t, x);
+    y -= std::copysign(t, y);
+
+    const float invLength = 1.0f / std::sqrt(x * x + y * y + z * z);
+    normal[0] = x * invLength;
+    normal[1] = y * invLength;
+    normal[2] = z * invLength;
+}
+// ↑ -------------------  SINGLE VALUES  ------------------- ↑
+
+// ↓ -------------------   BULK KERNELS  ------------------- ↓
+void ku::convertFloatToHalf(std::span<const float> src, std::span<uint16_t> dst) {
+    ZoneScoped;
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<ConversionKernel<float, uint16_t>>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures | CpuFeature::F16C, floatToHalfAvx2 },
+#elif defined(KRYPTON_ARCH_ARM64)
+        { CpuFeature::NEON, floatToHalfNeon },
+#endif
+        { CpuFeature::None, floatToHalfScalar },
+    }));
+    dispatcher(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertHalfToFloat(std::span<const uint16_t> src, std::span<float> dst) {
+    ZoneScoped;
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<ConversionKernel<uint16_t, float>>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures | CpuFeature::F16C, halfToFloatAvx2 },
+#elif defined(KRYPTON_ARCH_ARM64)
+        { CpuFeature::NEON, halfToFloatNeon },
+#endif
+        { CpuFeature::None, halfToFloatScalar },
+    }));
+    dispatcher(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertFloatToSnorm8(std::span<const float> src, std::span<int8_t> dst) {
+    ZoneScoped;
+    getFloatToNormalizedKernel<float, int8_t>()(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertFloatToSnorm16(std::span<const float> src, std::span<int16_t> dst) {
+    ZoneScoped;
+    getFloatToNormalizedKernel<float, int16_t>()(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertFloatToUnorm8(std::span<const float> src, std::span<uint8_t> dst) {
+    ZoneScoped;
+    getFloatToNormalizedKernel<float, uint8_t>()(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertFloatToUnorm16(std::span<const float> src, std::span<uint16_t> dst) {
+    ZoneScoped;
+    getFloatToNormalizedKernel<float, uint16_t>()(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertSnorm8ToFloat(std::span<const int8_t> src, std::span<float> dst) {
+    ZoneScoped;
+    getNormalizedToFloatKernel<int8_t, float>()(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertSnorm16ToFloat(std::span<const int16_t> src, std::span<float> dst) {
+    ZoneScoped;
+    getNormalizedToFloatKernel<int16_t, float>()(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertUnorm8ToFloat(std::span<const uint8_t> src, std::span<float> dst) {
+    ZoneScoped;
+    getNormalizedToFloatKernel<uint8_t, float>()(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::convertUnorm16ToFloat(std::span<const uint16_t> src, std::span<float> dst) {
+    ZoneScoped;
+    getNormalizedToFloatKernel<uint16_t, float>()(src.data(), dst.data(), std::min(src.size(), dst.size()));
+}
+
+void ku::encodeOctahedralNormals(std::span<const float> src, std::span<int16_t> dst) {
+    ZoneScoped;
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<ConversionKernel<float, int16_t>>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures, encodeOctahedralAvx2 },
+#endif
+        { CpuFeature::None, encodeOctahedralScalar },
+    }));
+    dispatcher(src.data(), dst.data(), std::min(src.size() / 3, dst.size() / 2));
+}
+
+void ku::decodeOctahedralNormals(std::span<const int16_t> src, std::span<float> dst) {
+    ZoneScoped;
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<ConversionKernel<int16_t, float>>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures, decodeOctahedralAvx2 },
+#endif
+        { CpuFeature::None, decodeOctahedralScalar },
+    }));
+    dispatcher(src.data(), dst.data(), std::min(src.size() / 2, dst.size() / 3));
+}
+// ↑ -------------------   BULK KERNELS  ------------------- ↑
@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
 #include <Tracy.hpp>
 
 #include <util/logging.hpp>
@@ -29,6 +34,71 @@ kt::Scheduler& kt::Scheduler::getInstance() {
     return maxThreadCount;
 }
 
+bool kt::Scheduler::isRunning() const {
+    return running;
+}
+
+void kt::Scheduler::parallelFor(std::size_t count, std::size_t chunkSize, const rangeFunction& function) {
+    ZoneScoped;
+    if (count == 0)
+        return;
+
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    auto chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (!running || chunkCount == 1) {
+        for (std::size_t begin = 0; begin < count; begin += chunkSize)
+            function(begin, std::min(begin + chunkSize, count));
+        return;
+    }
+
+    // The state is shared with the helper tasks, as they might only get to run after this
+    // function has already returned. They then won't find any chunks left and never touch
+    // the function.
+    struct ParallelForState {
+        std::atomic<std::size_t> nextChunk = 0;
+        std::atomic<std::size_t> remainingChunks = 0;
+        std::atomic<bool> failed = false;
+        std::exception_ptr exception;
+    };
+    auto state = std::make_shared<ParallelForState>();
+    state->remainingChunks = chunkCount;
+
+    auto work = [state, &function, count, chunkSize, chunkCount]() {
+        while (true) {
+            auto chunk = state->nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunkCount)
+                break;
+
+            if (!state->failed.load(std::memory_order_relaxed)) {
+                auto begin = chunk * chunkSize;
+                try {
+                    function(begin, std::min(begin + chunkSize, count));
+                } catch (...) {
+                    if (!state->failed.exchange(true))
+                        state->exception = std::current_exception();
+                }
+            }
+
+            if (state->remainingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                state->remainingChunks.notify_all();
+        }
+    };
+
+    auto helperCount = std::min<std::size_t>(chunkCount - 1, maxThreadCount);
+    for (std::size_t i = 0; i < helperCount; ++i)
+        run(work);
+    work();
+
+    for (auto remaining = state->remainingChunks.load(std::memory_order_acquire); remaining != 0;
+         remaining = state->remainingChunks.load(std::memory_order_acquire)) {
+        ZoneScopedN("parallelFor wait");
+        state->remainingChunks.wait(remaining, std::memory_order_acquire);
+    }
+
+    if (state->exception)
+        std::rethrow_exception(state->exception);
+}
+
 void kt::Scheduler::run(const kt::Scheduler::taskFunction& function) {
     ZoneScoped;
     if (!running) {
@@ -71,6 +141,8 @@ void kt::Scheduler::start() {
         threadPool.reserve(maxThreadCount);
     }
 
+    // The scheduler might be restarted after a previous shutdown.
+    terminate = false;
     for (uint32_t i = 0; i < maxThreadCount; ++i) {
         threadPool.emplace_back(&Scheduler::workerThreadLoop, this, i);
     }
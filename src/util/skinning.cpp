@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <Tracy.hpp>
+
+#include <util/assert.hpp>
+#include <util/attributes.hpp>
+#include <util/kernel_dispatch.hpp>
+#include <util/numeric_conversion.hpp>
+#include <util/skinning.hpp>
+
+#if defined(KRYPTON_ARCH_X86)
+    #include <immintrin.h>
+#elif defined(KRYPTON_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    // Vertices are skinned in batches, whose normals are then encoded all at once.
+    constexpr std::size_t skinningBatchSize = 256;
+
+    /**
+     * Writes the skinned positions to dstPositions, every dstStride bytes, and the skinned normals
+     * as tightly packed xyz floats to dstNormals, which is null if there are no normals.
+     */
+    using SkinKernel = void(const Matrix4* joints, uint32_t lastJoint, const float* positions, const float* normals,
+                            const VertexInfluences* influences, std::size_t count, float* dstPositions, std::size_t dstStride,
+                            float* dstNormals);
+
+    ALWAYS_INLINE inline auto offsetPosition(float* positions, std::size_t index, std::size_t stride) noexcept -> float* {
+        return reinterpret_cast<float*>(reinterpret_cast<std::byte*>(positions) + index * stride);
+    }
+
+    // The factor that normalizes the weights of a vertex, or 0 if it has no weights at all.
+    ALWAYS_INLINE inline auto getWeightScale(const VertexInfluences& influences) noexcept -> float {
+        const uint32_t sum = static_cast<uint32_t>(influences.weights[0]) + influences.weights[1] + influences.weights[2] +
+                             influences.weights[3];
+        return sum == 0 ? 0.0f : 1.0f / static_cast<float>(sum);
+    }
+
+    // ↓ -------------------  SCALAR  ------------------- ↓
+    void skinVerticesScalar(const Matrix4* joints, uint32_t lastJoint, const float* positions, const float* normals,
+                            const VertexInfluences* influences, std::size_t count, float* dstPositions, std::size_t dstStride,
+                            float* dstNormals) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& vertex = influences[i];
+            const auto scale = getWeightScale(vertex);
+
+            // Only the upper 3x4 part of the matrices is needed.
+            float m[12] = { 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0 };
+            if (scale != 0.0f) [[likely]] {
+                float weights[4];
+                const float* matrices[4];
+                for (std::size_t k = 0; k < 4; ++k) {
+                    weights[k] = static_cast<float>(vertex.weights[k]) * scale;
+                    matrices[k] = joints[std::min<uint32_t>(vertex.joints[k], lastJoint)].m;
+                }
+                for (std::size_t column = 0; column < 4; ++column)
+                    for (std::size_t row = 0; row < 3; ++row)
+                        m[column * 3 + row] = weights[0] * matrices[0][column * 4 + row] + weights[1] * matrices[1][column * 4 + row] +
+                                              weights[2] * matrices[2][column * 4 + row] + weights[3] * matrices[3][column * 4 + row];
+            }
+
+            const float* p = positions + i * 3;
+            auto* dst = offsetPosition(dstPositions, i, dstStride);
+            for (std::size_t row = 0; row < 3; ++row)
+                dst[row] = m[row] * p[0] + m[3 + row] * p[1] + m[6 + row] * p[2] + m[9 + row];
+            if (normals != nullptr) {
+                const float* n = normals + i * 3;
+                for (std::size_t row = 0; row < 3; ++row)
+                    dstNormals[i * 3 + row] = m[row] * n[0] + m[3 + row] * n[1] + m[6 + row] * n[2];
+            }
+        }
+    }
+    // ↑ -------------------  SCALAR  ------------------- ↑
+
+#if defined(KRYPTON_ARCH_X86)
+    // ↓ -------------------   AVX2   ------------------- ↓
+    TARGET_AVX2 ALWAYS_INLINE inline auto combineHalves(__m128 lower, __m128 upper) noexcept -> __m256 {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lower), upper, 1);
+    }
+
+    /**
+     * Every matrix is kept in two registers, with the first two and the last two columns. A vector
+     * is transformed by multiplying the halves with (x, x, x, x, y, y, y, y) and
+     * (z, z, z, z, w, w, w, w), and adding the resulting four columns.
+     */
+    TARGET_AVX2 void skinVerticesAvx2(const Matrix4* joints, uint32_t lastJoint, const float* positions, const float* normals,
+                                      const VertexInfluences* influences, std::size_t count, float* dstPositions, std::size_t dstStride,
+                                      float* dstNormals) {
+        static const Matrix4 identity = {};
+        const auto one = _mm_set1_ps(1.0f);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& vertex = influences[i];
+            const auto scale = getWeightScale(vertex);
+
+            __m256 lower, upper;
+            if (scale == 0.0f) [[unlikely]] {
+                lower = _mm256_loadu_ps(identity.m);
+                upper = _mm256_loadu_ps(identity.m + 8);
+            } else {
+                // All four weights are converted at once and then broadcast one by one.
+                const auto packedWeights = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(vertex.weights));
+                const auto weights = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu16_epi32(packedWeights)), _mm_set1_ps(scale));
+                const auto allWeights = _mm256_castps128_ps256(weights);
+                const float* m0 = joints[std::min<uint32_t>(vertex.joints[0], lastJoint)].m;
+                const float* m1 = joints[std::min<uint32_t>(vertex.joints[1], lastJoint)].m;
+                const float* m2 = joints[std::min<uint32_t>(vertex.joints[2], lastJoint)].m;
+                const float* m3 = joints[std::min<uint32_t>(vertex.joints[3], lastJoint)].m;
+                const auto w0 = _mm256_permutevar8x32_ps(allWeights, _mm256_set1_epi32(0));
+                const auto w1 = _mm256_permutevar8x32_ps(allWeights, _mm256_set1_epi32(1));
+                const auto w2 = _mm256_permutevar8x32_ps(allWeights, _mm256_set1_epi32(2));
+                const auto w3 = _mm256_permutevar8x32_ps(allWeights, _mm256_set1_epi32(3));
+                // Two independent sums per half keep the FMA chains short.
+                lower = _mm256_add_ps(_mm256_fmadd_ps(w0, _mm256_loadu_ps(m0), _mm256_mul_ps(w1, _mm256_loadu_ps(m1))),
+                                      _mm256_fmadd_ps(w2, _mm256_loadu_ps(m2), _mm256_mul_ps(w3, _mm256_loadu_ps(m3))));
+                upper = _mm256_add_ps(_mm256_fmadd_ps(w0, _mm256_loadu_ps(m0 + 8), _mm256_mul_ps(w1, _mm256_loadu_ps(m1 + 8))),
+                                      _mm256_fmadd_ps(w2, _mm256_loadu_ps(m2 + 8), _mm256_mul_ps(w3, _mm256_loadu_ps(m3 + 8))));
+            }
+
+            const float* p = positions + i * 3;
+            auto position = _mm256_fmadd_ps(combineHalves(_mm_set1_ps(p[0]), _mm_set1_ps(p[1])), lower,
+                                             _mm256_mul_ps(combineHalves(_mm_set1_ps(p[2]), one), upper));
+            alignas(16) float result[4];
+            _mm_store_ps(result, _mm_add_ps(_mm256_castps256_ps128(position), _mm256_extractf128_ps(position, 1)));
+            std::memcpy(offsetPosition(dstPositions, i, dstStride), result, 3 * sizeof(float));
+
+            if (normals != nullptr) {
+                const float* n = normals + i * 3;
+                auto normal = _mm256_fmadd_ps(combineHalves(_mm_set1_ps(n[0]), _mm_set1_ps(n[1])), lower,
+                                               _mm256_mul_ps(combineHalves(_mm_set1_ps(n[2]), _mm_setzero_ps()), upper));
+                _mm_store_ps(result, _mm_add_ps(_mm256_castps256_ps128(normal), _mm256_extractf128_ps(normal, 1)));
+                std::memcpy(dstNormals + i * 3, result, 3 * sizeof(float));
+            }
+        }
+    }
+    // ↑ -------------------   AVX2   ------------------- ↑
+#elif defined(KRYPTON_HAS_NEON)
+    // ↓ -------------------   NEON   ------------------- ↓
+    void skinVerticesNeon(const Matrix4* joints, uint32_t lastJoint, const float* positions, const float* normals,
+                          const VertexInfluences* influences, std::size_t count, float* dstPositions, std::size_t dstStride,
+                          float* dstNormals) {
+        static const Matrix4 identity = {};
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& vertex = influences[i];
+            const auto scale = getWeightScale(vertex);
+
+            float32x4_t columns[4];
+            if (scale == 0.0f) [[unlikely]] {
+                for (std::size_t column = 0; column < 4; ++column)
+                    columns[column] = vld1q_f32(identity.m + column * 4);
+            } else {
+                for (std::size_t column = 0; column < 4; ++column)
+                    columns[column] = vdupq_n_f32(0.0f);
+                for (std::size_t k = 0; k < 4; ++k) {
+                    const auto weight = static_cast<float>(vertex.weights[k]) * scale;
+                    const float* m = joints[std::min<uint32_t>(vertex.joints[k], lastJoint)].m;
+                    for (std::size_t column = 0; column < 4; ++column)
+                        columns[column] = vfmaq_n_f32(columns[column], vld1q_f32(m + column * 4), weight);
+                }
+            }
+
+            const float* p = positions + i * 3;
+            auto position = vfmaq_n_f32(vfmaq_n_f32(vfmaq_n_f32(columns[3], columns[0], p[0]), columns[1], p[1]), columns[2], p[2]);
+            auto* dst = offsetPosition(dstPositions, i, dstStride);
+            vst1_f32(dst, vget_low_f32(position));
+            dst[2] = vgetq_lane_f32(position, 2);
+
+            if (normals != nullptr) {
+                const float* n = normals + i * 3;
+                auto normal = vfmaq_n_f32(vfmaq_n_f32(vmulq_n_f32(columns[0], n[0]), columns[1], n[1]), columns[2], n[2]);
+                vst1_f32(dstNormals + i * 3, vget_low_f32(normal));
+                dstNormals[i * 3 + 2] = vgetq_lane_f32(normal, 2);
+            }
+        }
+    }
+    // ↑ -------------------   NEON   ------------------- ↑
+#endif
+} // namespace krypton::util
+
+auto ku::SparseMorphTarget::gatherVertices(std::span<const uint32_t> sourceVertices) const -> SparseMorphTarget {
+    SparseMorphTarget result;
+    if (vertices.empty())
+        return result;
+
+    // The entry of every vertex this target moves.
+    constexpr auto none = ~0U;
+    std::vector<uint32_t> entries(vertices.back() + 1, none);
+    for (uint32_t entry = 0; entry < vertices.size(); ++entry)
+        entries[vertices[entry]] = entry;
+
+    const bool hasNormals = !normalDeltas.empty();
+    for (uint32_t i = 0; i < sourceVertices.size(); ++i) {
+        const auto source = sourceVertices[i];
+        if (source >= entries.size() || entries[source] == none)
+            continue;
+        const auto entry = entries[source];
+        result.vertices.push_back(i);
+        result.positionDeltas.insert(result.positionDeltas.end(), &positionDeltas[entry * 3], &positionDeltas[entry * 3 + 3]);
+        if (hasNormals)
+            result.normalDeltas.insert(result.normalDeltas.end(), &normalDeltas[entry * 3], &normalDeltas[entry * 3 + 3]);
+    }
+    return result;
+}
+
+void ku::accumulateMorphTargets(std::span<const SparseMorphTarget> targets, std::span<const float> weights, std::size_t first,
+                                std::size_t count, float* positions, float* normals) {
+    ZoneScoped;
+    for (std::size_t t = 0; t < std::min(targets.size(), weights.size()); ++t) {
+        const auto weight = weights[t];
+        if (weight == 0.0f)
+            continue;
+
+        // Only the part of the target within the range is touched.
+        const auto& target = targets[t];
+        const auto begin = std::lower_bound(target.vertices.begin(), target.vertices.end(), first) - target.vertices.begin();
+        const auto end = std::lower_bound(target.vertices.begin() + begin, target.vertices.end(), first + count) - target.vertices.begin();
+        for (auto entry = begin; entry < end; ++entry) {
+            const auto vertex = target.vertices[entry] - first;
+            for (std::size_t c = 0; c < 3; ++c)
+                positions[vertex * 3 + c] += weight * target.positionDeltas[entry * 3 + c];
+        }
+        if (normals == nullptr || target.normalDeltas.empty())
+            continue;
+        for (auto entry = begin; entry < end; ++entry) {
+            const auto vertex = target.vertices[entry] - first;
+            for (std::size_t c = 0; c < 3; ++c)
+                normals[vertex * 3 + c] += weight * target.normalDeltas[entry * 3 + c];
+        }
+    }
+}
+
+void ku::skinVertices(std::span<const Matrix4> jointMatrices, const float* positions, const float* normals,
+                      const VertexInfluences* influences, std::size_t count, float* dstPositions, int16_t* dstNormals,
+                      std::size_t dstStride) {
+    ZoneScoped;
+    VERIFY(!jointMatrices.empty());
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<SkinKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures, skinVerticesAvx2 },
+#elif defined(KRYPTON_HAS_NEON)
+        { CpuFeature::NEON, skinVerticesNeon },
+#endif
+        { CpuFeature::None, skinVerticesScalar },
+    }));
+    auto* kernel = dispatcher.get();
+
+    // Joints beyond the matrices are clamped to the last one instead of reading out of bounds.
+    const auto lastJoint = static_cast<uint32_t>(std::min<std::size_t>(jointMatrices.size() - 1, UINT16_MAX));
+    float skinnedNormals[skinningBatchSize * 3];
+    int16_t encodedNormals[skinningBatchSize * 2];
+    for (std::size_t begin = 0; begin < count; begin += skinningBatchSize) {
+        const auto batchCount = std::min(skinningBatchSize, count - begin);
+        const auto* batchNormals = normals != nullptr ? normals + begin * 3 : nullptr;
+        kernel(jointMatrices.data(), lastJoint, positions + begin * 3, batchNormals, influences + begin, batchCount,
+               offsetPosition(dstPositions, begin, dstStride), dstStride, batchNormals != nullptr ? skinnedNormals : nullptr);
+        if (batchNormals == nullptr)
+            continue;
+
+        encodeOctahedralNormals({ skinnedNormals, batchCount * 3 }, { encodedNormals, batchCount * 2 });
+        for (std::size_t i = 0; i < batchCount; ++i) {
+            auto* dst = reinterpret_cast<int16_t*>(reinterpret_cast<std::byte*>(dstNormals) + (begin + i) * dstStride);
+            // Zero vectors, e.g. of degenerate triangles, can't be represented by the octahedral mapping.
+            const float* normal = &skinnedNormals[i * 3];
+            const bool zero = normal[0] == 0.0f && normal[1] == 0.0f && normal[2] == 0.0f;
+            dst[0] = zero ? int16_t(0) : encodedNormals[i * 2];
+            dst[1] = zero ? int16_t(0) : encodedNormals[i * 2 + 1];
+        }
+    }
+}
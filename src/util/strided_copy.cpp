@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <Tracy.hpp>
+
+#include <util/attributes.hpp>
+#include <util/kernel_dispatch.hpp>
+#include <util/numeric_conversion.hpp>
+#include <util/strided_copy.hpp>
+
+#if defined(KRYPTON_ARCH_X86)
+    #include <immintrin.h>
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    using GatherKernel = void(const StridedSource& src, float* dst, std::size_t dstStride, uint32_t dstComponents);
+
+    static constexpr float defaultComponents[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    // ↓ -------------------  SCALAR  ------------------- ↓
+    template <typename T>
+    ALWAYS_INLINE inline float componentToFloat(T value, bool normalized) noexcept {
+        if constexpr (std::is_same_v<T, float>) {
+            return value;
+        } else if constexpr (std::is_same_v<T, int8_t>) {
+            return normalized ? snorm8ToFloat(value) : static_cast<float>(value);
+        } else if constexpr (std::is_same_v<T, uint8_t>) {
+            return normalized ? unorm8ToFloat(value) : static_cast<float>(value);
+        } else if constexpr (std::is_same_v<T, int16_t>) {
+            return normalized ? snorm16ToFloat(value) : static_cast<float>(value);
+        } else if constexpr (std::is_same_v<T, uint16_t>) {
+            return normalized ? unorm16ToFloat(value) : static_cast<float>(value);
+        } else {
+            // There is no normalized uint32 in glTF or on the GPU.
+            return static_cast<float>(value);
+        }
+    }
+
+    template <typename T>
+    void gatherElementsScalar(const StridedSource& src, std::size_t first, float* dst, std::size_t dstStride,
+                              uint32_t dstComponents) {
+        const auto* srcBytes = static_cast<const std::byte*>(src.data);
+        auto* dstBytes = reinterpret_cast<std::byte*>(dst);
+        const auto srcComponents = std::min(src.componentCount, dstComponents);
+        for (std::size_t i = first; i < src.count; ++i) {
+            auto* out = reinterpret_cast<float*>(dstBytes + i * dstStride);
+            for (uint32_t c = 0; c < srcComponents; ++c) {
+                T value;
+                std::memcpy(&value, srcBytes + i * src.stride + c * sizeof(T), sizeof(T));
+                out[c] = componentToFloat(value, src.normalized);
+            }
+            for (uint32_t c = srcComponents; c < dstComponents; ++c)
+                out[c] = defaultComponents[c];
+        }
+    }
+
+    void gatherFromScalar(const StridedSource& src, std::size_t first, float* dst, std::size_t dstStride, uint32_t dstComponents) {
+        switch (src.componentType) {
+            case ComponentType::Int8:
+                return gatherElementsScalar<int8_t>(src, first, dst, dstStride, dstComponents);
+            case ComponentType::Uint8:
+                return gatherElementsScalar<uint8_t>(src, first, dst, dstStride, dstComponents);
+            case ComponentType::Int16:
+                return gatherElementsScalar<int16_t>(src, first, dst, dstStride, dstComponents);
+            case ComponentType::Uint16:
+                return gatherElementsScalar<uint16_t>(src, first, dst, dstStride, dstComponents);
+            case ComponentType::Uint32:
+                return gatherElementsScalar<uint32_t>(src, first, dst, dstStride, dstComponents);
+            case ComponentType::Float:
+                return gatherElementsScalar<float>(src, first, dst, dstStride, dstComponents);
+        }
+    }
+
+    void gatherStridedScalar(const StridedSource& src, float* dst, std::size_t dstStride, uint32_t dstComponents) {
+        gatherFromScalar(src, 0, dst, dstStride, dstComponents);
+    }
+    // ↑ -------------------  SCALAR  ------------------- ↑
+
+#if defined(KRYPTON_ARCH_X86)
+    // ↓ -------------------  AVX2  ------------------- ↓
+    /**
+     * Every element is loaded into a single SSE register, converted, blended with the default
+     * components and written with a store of exactly the destination width, which leaves the
+     * rest of the destination untouched. Integer elements are loaded with a full 4 or 8 byte
+     * load, which may read past the end of the source, so the elements within that distance of
+     * its end are handled by the scalar path.
+     */
+    template <typename T>
+    TARGET_AVX2 ALWAYS_INLINE inline __m128 loadElementAvx2(const std::byte* src) noexcept {
+        if constexpr (std::is_same_v<T, int8_t>) {
+            return _mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_loadu_si32(src)));
+        } else if constexpr (std::is_same_v<T, uint8_t>) {
+            return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_loadu_si32(src)));
+        } else if constexpr (std::is_same_v<T, int16_t>) {
+            return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+        } else {
+            return _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+        }
+    }
+
+    // Masked stores are very slow on some CPUs, so we use plain stores of the right width.
+    template <uint32_t DstComponents>
+    TARGET_AVX2 ALWAYS_INLINE inline void storeElementAvx2(float* dst, __m128 value) noexcept {
+        if constexpr (DstComponents == 4) {
+            _mm_storeu_ps(dst, value);
+        } else if constexpr (DstComponents == 3) {
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst), value);
+            _mm_store_ss(dst + 2, _mm_movehl_ps(value, value));
+        } else if constexpr (DstComponents == 2) {
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst), value);
+        } else {
+            _mm_store_ss(dst, value);
+        }
+    }
+
+    template <typename T, uint32_t DstComponents>
+    TARGET_AVX2 void gatherElementsAvx2(const StridedSource& src, float* dst, std::size_t dstStride) {
+        const auto* srcBytes = static_cast<const std::byte*>(src.data);
+        auto* dstBytes = reinterpret_cast<std::byte*>(dst);
+        const auto srcComponents = static_cast<int>(std::min(src.componentCount, DstComponents));
+
+        const auto srcMask = _mm_cmplt_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(srcComponents));
+        const auto defaults = _mm_loadu_ps(defaultComponents);
+
+        if constexpr (std::is_same_v<T, float>) {
+            // Masked loads never fault on the masked lanes, so we can process every element.
+            for (std::size_t i = 0; i < src.count; ++i) {
+                auto value = _mm_maskload_ps(reinterpret_cast<const float*>(srcBytes + i * src.stride), srcMask);
+                value = _mm_blendv_ps(defaults, value, _mm_castsi128_ps(srcMask));
+                storeElementAvx2<DstComponents>(reinterpret_cast<float*>(dstBytes + i * dstStride), value);
+            }
+        } else {
+            auto scale = _mm_set1_ps(1.0f);
+            auto min = _mm_set1_ps(std::numeric_limits<float>::lowest());
+            if (src.normalized) {
+                if constexpr (std::is_same_v<T, int8_t>) {
+                    scale = _mm_set1_ps(1.0f / 127.0f);
+                } else if constexpr (std::is_same_v<T, uint8_t>) {
+                    scale = _mm_set1_ps(1.0f / 255.0f);
+                } else if constexpr (std::is_same_v<T, int16_t>) {
+                    scale = _mm_set1_ps(1.0f / 32767.0f);
+                } else {
+                    scale = _mm_set1_ps(1.0f / 65535.0f);
+                }
+                min = _mm_set1_ps(-1.0f);
+            }
+
+            // The loads may only cover bytes up to the end of the last element. With tightly
+            // packed sources, that leaves more than just the last element to the scalar path.
+            if (src.count == 0)
+                return;
+            constexpr std::size_t loadWidth = sizeof(T) == 1 ? 4 : 8;
+            const auto end = (src.count - 1) * src.stride + src.componentCount * sizeof(T);
+            std::size_t i = 0;
+            for (; i < src.count && i * src.stride + loadWidth <= end; ++i) {
+                auto value = _mm_max_ps(_mm_mul_ps(loadElementAvx2<T>(srcBytes + i * src.stride), scale), min);
+                value = _mm_blendv_ps(defaults, value, _mm_castsi128_ps(srcMask));
+                storeElementAvx2<DstComponents>(reinterpret_cast<float*>(dstBytes + i * dstStride), value);
+            }
+            gatherFromScalar(src, i, dst, dstStride, DstComponents);
+        }
+    }
+
+    template <typename T>
+    TARGET_AVX2 void gatherElementsAvx2(const StridedSource& src, float* dst, std::size_t dstStride, uint32_t dstComponents) {
+        switch (dstComponents) {
+            case 1:
+                return gatherElementsAvx2<T, 1>(src, dst, dstStride);
+            case 2:
+                return gatherElementsAvx2<T, 2>(src, dst, dstStride);
+            case 3:
+                return gatherElementsAvx2<T, 3>(src, dst, dstStride);
+            case 4:
+                return gatherElementsAvx2<T, 4>(src, dst, dstStride);
+            default:
+                return;
+        }
+    }
+
+    TARGET_AVX2 void gatherStridedAvx2(const StridedSource& src, float* dst, std::size_t dstStride, uint32_t dstComponents) {
+        switch (src.componentType) {
+            case ComponentType::Int8:
+                return gatherElementsAvx2<int8_t>(src, dst, dstStride, dstComponents);
+            case ComponentType::Uint8:
+                return gatherElementsAvx2<uint8_t>(src, dst, dstStride, dstComponents);
+            case ComponentType::Int16:
+                return gatherElementsAvx2<int16_t>(src, dst, dstStride, dstComponents);
+            case ComponentType::Uint16:
+                return gatherElementsAvx2<uint16_t>(src, dst, dstStride, dstComponents);
+            case ComponentType::Float:
+                return gatherElementsAvx2<float>(src, dst, dstStride, dstComponents);
+            case ComponentType::Uint32:
+                // Values above INT32_MAX can't be converted with cvtdq2ps, and uint32 attributes
+                // are rare enough to not bother.
+                return gatherStridedScalar(src, dst, dstStride, dstComponents);
+        }
+    }
+    // ↑ -------------------  AVX2  ------------------- ↑
+#endif
+} // namespace krypton::util
+
+namespace krypton::util {
+    auto getGatherKernel() -> GatherKernel* {
+        static const KernelDispatcher dispatcher(std::to_array<KernelVariant<GatherKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+            { avx2TargetFeatures, gatherStridedAvx2 },
+#endif
+            { CpuFeature::None, gatherStridedScalar },
+        }));
+        return dispatcher.get();
+    }
+} // namespace krypton::util
+
+void ku::gatherStrided(const StridedSource& src, float* dst, std::size_t dstStride, uint32_t dstComponents) {
+    ZoneScoped;
+    getGatherKernel()(src, dst, dstStride, std::min(dstComponents, 4U));
+}
+
+void ku::gatherStrided(std::span<const StridedGather> gathers, std::size_t dstStride) {
+    ZoneScoped;
+    std::size_t count = 0;
+    for (const auto& gather : gathers)
+        count = std::max(count, gather.source.count);
+
+    // Small enough that the destination block stays in L1/L2 until all attributes are written.
+    constexpr std::size_t blockSize = 512;
+    auto* kernel = getGatherKernel();
+    for (std::size_t begin = 0; begin < count; begin += blockSize) {
+        for (const auto& gather : gathers) {
+            if (begin >= gather.source.count)
+                continue;
+
+            auto block = gather.source;
+            block.data = static_cast<const std::byte*>(block.data) + begin * block.stride;
+            block.count = std::min(blockSize, gather.source.count - begin);
+            auto* dst = reinterpret_cast<float*>(reinterpret_cast<std::byte*>(gather.dst) + begin * dstStride);
+            kernel(block, dst, dstStride, std::min(gather.dstComponents, 4U));
+        }
+    }
+}
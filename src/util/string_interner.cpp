@@ -0,0 +1,100 @@
+#include <cstring>
+#include <mutex>
+
+#include <Tracy.hpp>
+
+#include <util/assert.hpp>
+#include <util/hash.hpp>
+#include <util/string_interner.hpp>
+
+namespace ku = krypton::util;
+
+auto ku::StringInterner::getInstance() -> StringInterner& {
+    static StringInterner instance;
+    return instance;
+}
+
+auto ku::StringInterner::findLocked(std::string_view string, uint64_t hash) const noexcept -> InternedString {
+    const auto* first = lookup.find(hash);
+    if (first == nullptr)
+        return InternedString::Invalid;
+
+    for (auto id = *first; id != InternedString::Invalid; id = nextWithSameHash[static_cast<uint32_t>(id)]) {
+        if (strings[static_cast<uint32_t>(id)] == string)
+            return id;
+    }
+    return InternedString::Invalid;
+}
+
+auto ku::StringInterner::store(std::string_view string) -> std::string_view {
+    auto size = string.size() + 1;
+    char* destination;
+    if (size > blockSize / 4) {
+        // Big strings get their own allocation so that they don't waste the rest of a block.
+        // We insert it before the current block so that we can continue filling that one.
+        auto block = std::make_unique<char[]>(size);
+        destination = block.get();
+        blocks.insert(blocks.empty() ? blocks.end() : blocks.end() - 1, std::move(block));
+    } else {
+        if (blockOffset + size > blockSize) {
+            blocks.emplace_back(std::make_unique<char[]>(blockSize));
+            blockOffset = 0;
+        }
+        destination = blocks.back().get() + blockOffset;
+        blockOffset += size;
+    }
+
+    std::memcpy(destination, string.data(), string.size());
+    destination[string.size()] = '\0';
+    return { destination, string.size() };
+}
+
+auto ku::StringInterner::find(std::string_view string) const -> InternedString {
+    ZoneScoped;
+    auto hash = hashString(string);
+    std::shared_lock lock(mutex);
+    return findLocked(string, hash);
+}
+
+auto ku::StringInterner::intern(std::string_view string) -> InternedString {
+    ZoneScoped;
+    auto hash = hashString(string);
+    {
+        std::shared_lock lock(mutex);
+        if (auto id = findLocked(string, hash); id != InternedString::Invalid)
+            return id;
+    }
+
+    std::unique_lock lock(mutex);
+    // Another thread might have interned the same string while we didn't hold the lock.
+    if (auto id = findLocked(string, hash); id != InternedString::Invalid)
+        return id;
+
+    VERIFY(strings.size() < static_cast<uint32_t>(InternedString::Invalid));
+    auto id = static_cast<InternedString>(strings.size());
+    strings.emplace_back(store(string));
+
+    auto [first, inserted] = lookup.insert(hash, id);
+    if (inserted) {
+        nextWithSameHash.emplace_back(InternedString::Invalid);
+    } else {
+        nextWithSameHash.emplace_back(*first);
+        *first = id;
+    }
+    return id;
+}
+
+auto ku::StringInterner::getString(InternedString id) const -> std::string_view {
+    std::shared_lock lock(mutex);
+    VERIFY(static_cast<uint32_t>(id) < strings.size());
+    return strings[static_cast<uint32_t>(id)];
+}
+
+auto ku::StringInterner::getCString(InternedString id) const -> const char* {
+    return getString(id).data();
+}
+
+auto ku::StringInterner::size() const -> std::size_t {
+    std::shared_lock lock(mutex);
+    return strings.size();
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <array>
+
+#include <Tracy.hpp>
+
+#include <util/assert.hpp>
+#include <util/scheduler.hpp>
+#include <util/transform_hierarchy.hpp>
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    // Nodes per task. Each task composes and multiplies its nodes in batches of hierarchyBatchSize
+    // matrices on the stack.
+    constexpr std::size_t hierarchyChunkSize = 1024;
+    constexpr std::size_t hierarchyBatchSize = 128;
+} // namespace krypton::util
+
+auto ku::TransformHierarchy::addNode(uint32_t parent, const float* translation, const float* rotation, const float* scale) -> uint32_t {
+    const auto index = static_cast<uint32_t>(parents.size());
+    if (parent == noParent) {
+        VERIFY(levelStarts.size() <= 1);
+        if (levelStarts.empty())
+            levelStarts.push_back(0);
+    } else {
+        VERIFY(parent < index);
+        const auto parentLevel = static_cast<std::size_t>(std::upper_bound(levelStarts.begin(), levelStarts.end(), parent) -
+                                                          levelStarts.begin() - 1);
+        VERIFY(parentLevel + 2 >= levelStarts.size());
+        if (parentLevel + 1 == levelStarts.size())
+            levelStarts.push_back(index);
+    }
+
+    parents.push_back(parent);
+    localTransforms.resize(index + 1);
+    localTransforms.set(index, translation, rotation, scale);
+    worldMatrices.emplace_back();
+    dirty.push_back(1);
+    anyDirty = true;
+    return index;
+}
+
+void ku::TransformHierarchy::reserve(std::size_t size) {
+    parents.reserve(size);
+    localTransforms.reserve(size);
+    worldMatrices.reserve(size);
+    dirty.reserve(size);
+}
+
+void ku::TransformHierarchy::clear() noexcept {
+    parents.clear();
+    levelStarts.clear();
+    localTransforms.resize(0);
+    worldMatrices.clear();
+    dirty.clear();
+    anyDirty = false;
+}
+
+void ku::TransformHierarchy::setLocalTransform(uint32_t node, const float* translation, const float* rotation,
+                                               const float* scale) noexcept {
+    localTransforms.set(node, translation, rotation, scale);
+    markDirty(node);
+}
+
+void ku::TransformHierarchy::markDirty(uint32_t node) noexcept {
+    dirty[node] = 1;
+    anyDirty = true;
+}
+
+void ku::TransformHierarchy::updateNodes(uint32_t first, uint32_t last) {
+    // The parents are in the previous level, which has already been updated.
+    for (auto i = first; i < last; ++i)
+        if (!dirty[i] && parents[i] != noParent && dirty[parents[i]])
+            dirty[i] = 1;
+
+    std::array<Matrix4, hierarchyBatchSize> localMatrices;
+    for (auto i = first; i < last;) {
+        if (!dirty[i]) {
+            ++i;
+            continue;
+        }
+
+        // Consecutive dirty nodes are computed together, so that the kernels can vectorize.
+        auto end = i + 1;
+        while (end < last && end - i < hierarchyBatchSize && dirty[end])
+            ++end;
+        const auto count = end - i;
+        auto world = std::span(worldMatrices).subspan(i, count);
+        if (parents[i] == noParent) {
+            // Only the first level has roots, and it has nothing else.
+            composeTransforms(localTransforms, i, world);
+        } else {
+            auto local = std::span(localMatrices).first(count);
+            composeTransforms(localTransforms, i, local);
+            multiplyMatrices(worldMatrices, std::span(parents).subspan(i, count), local, world);
+        }
+        i = end;
+    }
+}
+
+void ku::TransformHierarchy::update() {
+    ZoneScoped;
+    if (!anyDirty)
+        return;
+
+    auto& scheduler = krypton::threading::Scheduler::getInstance();
+    for (std::size_t level = 0; level < levelStarts.size(); ++level) {
+        const auto [first, last] = getLevel(level);
+        scheduler.parallelFor(last - first, hierarchyChunkSize, [&](std::size_t begin, std::size_t end) {
+            updateNodes(first + static_cast<uint32_t>(begin), first + static_cast<uint32_t>(end));
+        });
+    }
+    std::fill(dirty.begin(), dirty.end(), 0);
+    anyDirty = false;
+}
+
+auto ku::TransformHierarchy::getLocalTransforms() noexcept -> TransformSoA& {
+    return localTransforms;
+}
+
+auto ku::TransformHierarchy::getLocalTransforms() const noexcept -> const TransformSoA& {
+    return localTransforms;
+}
+
+auto ku::TransformHierarchy::getParents() const noexcept -> std::span<const uint32_t> {
+    return parents;
+}
+
+auto ku::TransformHierarchy::getWorldMatrices() const noexcept -> std::span<const Matrix4> {
+    return worldMatrices;
+}
+
+auto ku::TransformHierarchy::getLevelCount() const noexcept -> std::size_t {
+    return levelStarts.size();
+}
+
+auto ku::TransformHierarchy::getLevel(std::size_t level) const noexcept -> std::pair<uint32_t, uint32_t> {
+    const auto last = level + 1 < levelStarts.size() ? levelStarts[level + 1] : static_cast<uint32_t>(parents.size());
+    return { levelStarts[level], last };
+}
+
+auto ku::TransformHierarchy::size() const noexcept -> std::size_t {
+    return parents.size();
+}
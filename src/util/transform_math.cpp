@@ -0,0 +1,507 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <Tracy.hpp>
+
+#include <util/assert.hpp>
+#include <util/attributes.hpp>
+#include <util/kernel_dispatch.hpp>
+#include <util/transform_math.hpp>
+
+#if defined(KRYPTON_ARCH_X86)
+    #include <immintrin.h>
+#elif defined(KRYPTON_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace ku = krypton::util;
+
+namespace krypton::util {
+    using ComposeKernel = void(const TransformSoA& transforms, std::size_t first, Matrix4* out, std::size_t count);
+    using MultiplyKernel = void(const Matrix4* lhs, const uint32_t* lhsIndices, const Matrix4* rhs, Matrix4* out, std::size_t count);
+    using AabbKernel = void(const AabbSoA& src, std::size_t first, const Matrix4* matrices, AabbSoA& dst, std::size_t count);
+    using BoundsKernel = void(const std::byte* points, std::size_t stride, std::size_t count, float* min, float* max);
+
+    // ↓ -------------------  SCALAR  ------------------- ↓
+    void composeTransformsScalar(const TransformSoA& t, std::size_t first, Matrix4* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto j = first + i;
+            const float x = t.rotationX[j], y = t.rotationY[j], z = t.rotationZ[j], w = t.rotationW[j];
+            const float sx = t.scaleX[j], sy = t.scaleY[j], sz = t.scaleZ[j];
+            auto& m = out[i].m;
+            m[0] = (1.0f - 2.0f * (y * y + z * z)) * sx;
+            m[1] = 2.0f * (x * y + w * z) * sx;
+            m[2] = 2.0f * (x * z - w * y) * sx;
+            m[3] = 0.0f;
+            m[4] = 2.0f * (x * y - w * z) * sy;
+            m[5] = (1.0f - 2.0f * (x * x + z * z)) * sy;
+            m[6] = 2.0f * (y * z + w * x) * sy;
+            m[7] = 0.0f;
+            m[8] = 2.0f * (x * z + w * y) * sz;
+            m[9] = 2.0f * (y * z - w * x) * sz;
+            m[10] = (1.0f - 2.0f * (x * x + y * y)) * sz;
+            m[11] = 0.0f;
+            m[12] = t.translationX[j];
+            m[13] = t.translationY[j];
+            m[14] = t.translationZ[j];
+            m[15] = 1.0f;
+        }
+    }
+
+    ALWAYS_INLINE inline void multiplyMatrixScalar(const Matrix4& lhs, const Matrix4& rhs, Matrix4& out) noexcept {
+        for (std::size_t column = 0; column < 4; ++column) {
+            for (std::size_t row = 0; row < 4; ++row) {
+                float sum = 0.0f;
+                for (std::size_t k = 0; k < 4; ++k)
+                    sum += lhs.m[k * 4 + row] * rhs.m[column * 4 + k];
+                out.m[column * 4 + row] = sum;
+            }
+        }
+    }
+
+    void multiplyMatricesScalar(const Matrix4* lhs, const uint32_t* lhsIndices, const Matrix4* rhs, Matrix4* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            multiplyMatrixScalar(lhsIndices != nullptr ? lhs[lhsIndices[i]] : lhs[i], rhs[i], out[i]);
+    }
+
+    void transformAabbsScalar(const AabbSoA& src, std::size_t first, const Matrix4* matrices, AabbSoA& dst, std::size_t count) {
+        // Arvo's method: transform the center and add up the absolute extents of each axis.
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto j = first + i;
+            const auto& m = matrices[i].m;
+            const float center[3] = { (src.minX[j] + src.maxX[j]) * 0.5f, (src.minY[j] + src.maxY[j]) * 0.5f,
+                                      (src.minZ[j] + src.maxZ[j]) * 0.5f };
+            const float extent[3] = { (src.maxX[j] - src.minX[j]) * 0.5f, (src.maxY[j] - src.minY[j]) * 0.5f,
+                                      (src.maxZ[j] - src.minZ[j]) * 0.5f };
+            float newCenter[3], newExtent[3];
+            for (std::size_t row = 0; row < 3; ++row) {
+                newCenter[row] = m[12 + row] + m[row] * center[0] + m[4 + row] * center[1] + m[8 + row] * center[2];
+                newExtent[row] = std::abs(m[row]) * extent[0] + std::abs(m[4 + row]) * extent[1] + std::abs(m[8 + row]) * extent[2];
+            }
+            dst.minX[j] = newCenter[0] - newExtent[0];
+            dst.minY[j] = newCenter[1] - newExtent[1];
+            dst.minZ[j] = newCenter[2] - newExtent[2];
+            dst.maxX[j] = newCenter[0] + newExtent[0];
+            dst.maxY[j] = newCenter[1] + newExtent[1];
+            dst.maxZ[j] = newCenter[2] + newExtent[2];
+        }
+    }
+
+    void computeAabbScalar(const std::byte* points, std::size_t stride, std::size_t count, float* min, float* max) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto* point = reinterpret_cast<const float*>(points + i * stride);
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                min[axis] = std::min(min[axis], point[axis]);
+                max[axis] = std::max(max[axis], point[axis]);
+            }
+        }
+    }
+    // ↑ -------------------  SCALAR  ------------------- ↑
+
+#if defined(KRYPTON_ARCH_X86)
+    // ↓ -------------------   AVX2   ------------------- ↓
+    TARGET_AVX2 ALWAYS_INLINE inline void transpose8x8(__m256* rows) {
+        auto t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+        auto t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+        auto t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+        auto t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+        auto t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+        auto t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+        auto t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+        auto t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+        auto s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        auto s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        auto s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        auto s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        auto s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        auto s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        auto s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        auto s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+        rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+        rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+        rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+        rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+        rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+        rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+        rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+        rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+    }
+
+    TARGET_AVX2 void composeTransformsAvx2(const TransformSoA& t, std::size_t first, Matrix4* out, std::size_t count) {
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto two = _mm256_set1_ps(2.0f);
+        const auto zero = _mm256_setzero_ps();
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const auto j = first + i;
+            auto x = _mm256_loadu_ps(&t.rotationX[j]);
+            auto y = _mm256_loadu_ps(&t.rotationY[j]);
+            auto z = _mm256_loadu_ps(&t.rotationZ[j]);
+            auto w = _mm256_loadu_ps(&t.rotationW[j]);
+            auto sx = _mm256_loadu_ps(&t.scaleX[j]);
+            auto sy = _mm256_loadu_ps(&t.scaleY[j]);
+            auto sz = _mm256_loadu_ps(&t.scaleZ[j]);
+
+            auto xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+            auto xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+            auto wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+            // Each entry holds one matrix element for 8 different transforms.
+            __m256 columns[16];
+            columns[0] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx);
+            columns[1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+            columns[2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+            columns[3] = zero;
+            columns[4] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+            columns[5] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy);
+            columns[6] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+            columns[7] = zero;
+            columns[8] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+            columns[9] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+            columns[10] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz);
+            columns[11] = zero;
+            columns[12] = _mm256_loadu_ps(&t.translationX[j]);
+            columns[13] = _mm256_loadu_ps(&t.translationY[j]);
+            columns[14] = _mm256_loadu_ps(&t.translationZ[j]);
+            columns[15] = one;
+
+            // Transposing turns the 8 vectors of each matrix half into 8 consecutive matrices.
+            transpose8x8(columns);
+            transpose8x8(columns + 8);
+            for (std::size_t k = 0; k < 8; ++k) {
+                _mm256_storeu_ps(&out[i + k].m[0], columns[k]);
+                _mm256_storeu_ps(&out[i + k].m[8], columns[k + 8]);
+            }
+        }
+        composeTransformsScalar(t, first + i, out + i, count - i);
+    }
+
+    TARGET_AVX2 void multiplyMatricesAvx2(const Matrix4* lhs, const uint32_t* lhsIndices, const Matrix4* rhs, Matrix4* out,
+                                          std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& a = lhsIndices != nullptr ? lhs[lhsIndices[i]] : lhs[i];
+            // Every column of lhs duplicated into both 128-bit lanes.
+            auto a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.m[0]));
+            auto a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.m[4]));
+            auto a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.m[8]));
+            auto a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.m[12]));
+
+            // We compute two result columns at once, one per 128-bit lane.
+            for (std::size_t column = 0; column < 16; column += 8) {
+                auto b = _mm256_loadu_ps(&rhs[i].m[column]);
+                auto result = _mm256_mul_ps(a0, _mm256_permute_ps(b, _MM_SHUFFLE(0, 0, 0, 0)));
+                result = _mm256_fmadd_ps(a1, _mm256_permute_ps(b, _MM_SHUFFLE(1, 1, 1, 1)), result);
+                result = _mm256_fmadd_ps(a2, _mm256_permute_ps(b, _MM_SHUFFLE(2, 2, 2, 2)), result);
+                result = _mm256_fmadd_ps(a3, _mm256_permute_ps(b, _MM_SHUFFLE(3, 3, 3, 3)), result);
+                _mm256_storeu_ps(&out[i].m[column], result);
+            }
+        }
+    }
+
+    TARGET_AVX2 void transformAabbsAvx2(const AabbSoA& src, std::size_t first, const Matrix4* matrices, AabbSoA& dst,
+                                        std::size_t count) {
+        const auto half = _mm256_set1_ps(0.5f);
+        const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        // Offsets of the same element in 8 consecutive matrices.
+        const auto matrixOffsets = _mm256_setr_epi32(0, 16, 32, 48, 64, 80, 96, 112);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const auto j = first + i;
+            auto minX = _mm256_loadu_ps(&src.minX[j]), maxX = _mm256_loadu_ps(&src.maxX[j]);
+            auto minY = _mm256_loadu_ps(&src.minY[j]), maxY = _mm256_loadu_ps(&src.maxY[j]);
+            auto minZ = _mm256_loadu_ps(&src.minZ[j]), maxZ = _mm256_loadu_ps(&src.maxZ[j]);
+            __m256 center[3] = { _mm256_mul_ps(_mm256_add_ps(minX, maxX), half), _mm256_mul_ps(_mm256_add_ps(minY, maxY), half),
+                                 _mm256_mul_ps(_mm256_add_ps(minZ, maxZ), half) };
+            __m256 extent[3] = { _mm256_mul_ps(_mm256_sub_ps(maxX, minX), half), _mm256_mul_ps(_mm256_sub_ps(maxY, minY), half),
+                                 _mm256_mul_ps(_mm256_sub_ps(maxZ, minZ), half) };
+
+            __m256 newMin[3], newMax[3];
+            const float* base = matrices[i].m;
+            for (int row = 0; row < 3; ++row) {
+                auto newCenter = _mm256_i32gather_ps(base + 12 + row, matrixOffsets, 4);
+                auto newExtent = _mm256_setzero_ps();
+                for (int column = 0; column < 3; ++column) {
+                    auto element = _mm256_i32gather_ps(base + column * 4 + row, matrixOffsets, 4);
+                    newCenter = _mm256_fmadd_ps(element, center[column], newCenter);
+                    newExtent = _mm256_fmadd_ps(_mm256_and_ps(element, absMask), extent[column], newExtent);
+                }
+                newMin[row] = _mm256_sub_ps(newCenter, newExtent);
+                newMax[row] = _mm256_add_ps(newCenter, newExtent);
+            }
+            _mm256_storeu_ps(&dst.minX[j], newMin[0]);
+            _mm256_storeu_ps(&dst.minY[j], newMin[1]);
+            _mm256_storeu_ps(&dst.minZ[j], newMin[2]);
+            _mm256_storeu_ps(&dst.maxX[j], newMax[0]);
+            _mm256_storeu_ps(&dst.maxY[j], newMax[1]);
+            _mm256_storeu_ps(&dst.maxZ[j], newMax[2]);
+        }
+        transformAabbsScalar(src, first + i, matrices + i, dst, count - i);
+    }
+    // ↑ -------------------   AVX2   ------------------- ↑
+
+    // ↓ -------------------  SSE4.2  ------------------- ↓
+    // Every point but the last is read with a single 16-byte load. The fourth lane is part of the
+    // next point or the padding in between, which is always readable and simply ignored.
+    TARGET_SSE42 void computeAabbSse42(const std::byte* points, std::size_t stride, std::size_t count, float* min, float* max) {
+        if (count == 0)
+            return;
+
+        __m128 min0 = _mm_setr_ps(min[0], min[1], min[2], 0.0f), max0 = _mm_setr_ps(max[0], max[1], max[2], 0.0f);
+        __m128 min1 = min0, max1 = max0;
+        std::size_t i = 0;
+        for (; i + 2 < count; i += 2) {
+            const auto a = _mm_loadu_ps(reinterpret_cast<const float*>(points + i * stride));
+            const auto b = _mm_loadu_ps(reinterpret_cast<const float*>(points + (i + 1) * stride));
+            min0 = _mm_min_ps(min0, a);
+            max0 = _mm_max_ps(max0, a);
+            min1 = _mm_min_ps(min1, b);
+            max1 = _mm_max_ps(max1, b);
+        }
+        alignas(16) float resultMin[4], resultMax[4];
+        _mm_store_ps(resultMin, _mm_min_ps(min0, min1));
+        _mm_store_ps(resultMax, _mm_max_ps(max0, max1));
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            min[axis] = resultMin[axis];
+            max[axis] = resultMax[axis];
+        }
+        computeAabbScalar(points + i * stride, stride, count - i, min, max);
+    }
+    // ↑ -------------------  SSE4.2  ------------------- ↑
+#elif defined(KRYPTON_ARCH_ARM64)
+    // ↓ -------------------   NEON   ------------------- ↓
+    ALWAYS_INLINE inline void transpose4x4(float32x4_t* rows) {
+        auto t01 = vtrnq_f32(rows[0], rows[1]);
+        auto t23 = vtrnq_f32(rows[2], rows[3]);
+        rows[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        rows[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        rows[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        rows[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    void composeTransformsNeon(const TransformSoA& t, std::size_t first, Matrix4* out, std::size_t count) {
+        const auto one = vdupq_n_f32(1.0f);
+        const auto two = vdupq_n_f32(2.0f);
+        const auto zero = vdupq_n_f32(0.0f);
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const auto j = first + i;
+            auto x = vld1q_f32(&t.rotationX[j]);
+            auto y = vld1q_f32(&t.rotationY[j]);
+            auto z = vld1q_f32(&t.rotationZ[j]);
+            auto w = vld1q_f32(&t.rotationW[j]);
+            auto sx = vld1q_f32(&t.scaleX[j]);
+            auto sy = vld1q_f32(&t.scaleY[j]);
+            auto sz = vld1q_f32(&t.scaleZ[j]);
+
+            auto xx = vmulq_f32(x, x), yy = vmulq_f32(y, y), zz = vmulq_f32(z, z);
+            auto xy = vmulq_f32(x, y), xz = vmulq_f32(x, z), yz = vmulq_f32(y, z);
+            auto wx = vmulq_f32(w, x), wy = vmulq_f32(w, y), wz = vmulq_f32(w, z);
+
+            float32x4_t columns[16];
+            columns[0] = vmulq_f32(vfmsq_f32(one, two, vaddq_f32(yy, zz)), sx);
+            columns[1] = vmulq_f32(vmulq_f32(two, vaddq_f32(xy, wz)), sx);
+            columns[2] = vmulq_f32(vmulq_f32(two, vsubq_f32(xz, wy)), sx);
+            columns[3] = zero;
+            columns[4] = vmulq_f32(vmulq_f32(two, vsubq_f32(xy, wz)), sy);
+            columns[5] = vmulq_f32(vfmsq_f32(one, two, vaddq_f32(xx, zz)), sy);
+            columns[6] = vmulq_f32(vmulq_f32(two, vaddq_f32(yz, wx)), sy);
+            columns[7] = zero;
+            columns[8] = vmulq_f32(vmulq_f32(two, vaddq_f32(xz, wy)), sz);
+            columns[9] = vmulq_f32(vmulq_f32(two, vsubq_f32(yz, wx)), sz);
+            columns[10] = vmulq_f32(vfmsq_f32(one, two, vaddq_f32(xx, yy)), sz);
+            columns[11] = zero;
+            columns[12] = vld1q_f32(&t.translationX[j]);
+            columns[13] = vld1q_f32(&t.translationY[j]);
+            columns[14] = vld1q_f32(&t.translationZ[j]);
+            columns[15] = one;
+
+            for (std::size_t quarter = 0; quarter < 16; quarter += 4) {
+                transpose4x4(columns + quarter);
+                for (std::size_t k = 0; k < 4; ++k)
+                    vst1q_f32(&out[i + k].m[quarter], columns[quarter + k]);
+            }
+        }
+        composeTransformsScalar(t, first + i, out + i, count - i);
+    }
+
+    void multiplyMatricesNeon(const Matrix4* lhs, const uint32_t* lhsIndices, const Matrix4* rhs, Matrix4* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& a = lhsIndices != nullptr ? lhs[lhsIndices[i]] : lhs[i];
+            auto a0 = vld1q_f32(&a.m[0]), a1 = vld1q_f32(&a.m[4]);
+            auto a2 = vld1q_f32(&a.m[8]), a3 = vld1q_f32(&a.m[12]);
+            for (std::size_t column = 0; column < 16; column += 4) {
+                auto b = vld1q_f32(&rhs[i].m[column]);
+                auto result = vmulq_laneq_f32(a0, b, 0);
+                result = vfmaq_laneq_f32(result, a1, b, 1);
+                result = vfmaq_laneq_f32(result, a2, b, 2);
+                result = vfmaq_laneq_f32(result, a3, b, 3);
+                vst1q_f32(&out[i].m[column], result);
+            }
+        }
+    }
+
+    // Reads each point with a single 16-byte load, see computeAabbSse42.
+    void computeAabbNeon(const std::byte* points, std::size_t stride, std::size_t count, float* min, float* max) {
+        if (count == 0)
+            return;
+
+        const float initialMin[4] = { min[0], min[1], min[2], 0.0f }, initialMax[4] = { max[0], max[1], max[2], 0.0f };
+        float32x4_t min0 = vld1q_f32(initialMin), max0 = vld1q_f32(initialMax);
+        float32x4_t min1 = min0, max1 = max0;
+        std::size_t i = 0;
+        for (; i + 2 < count; i += 2) {
+            const auto a = vld1q_f32(reinterpret_cast<const float*>(points + i * stride));
+            const auto b = vld1q_f32(reinterpret_cast<const float*>(points + (i + 1) * stride));
+            min0 = vminq_f32(min0, a);
+            max0 = vmaxq_f32(max0, a);
+            min1 = vminq_f32(min1, b);
+            max1 = vmaxq_f32(max1, b);
+        }
+        float resultMin[4], resultMax[4];
+        vst1q_f32(resultMin, vminq_f32(min0, min1));
+        vst1q_f32(resultMax, vmaxq_f32(max0, max1));
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            min[axis] = resultMin[axis];
+            max[axis] = resultMax[axis];
+        }
+        computeAabbScalar(points + i * stride, stride, count - i, min, max);
+    }
+    // ↑ -------------------   NEON   ------------------- ↑
+#endif
+} // namespace krypton::util
+
+void ku::TransformSoA::resize(std::size_t size) {
+    translationX.resize(size, 0.0f);
+    translationY.resize(size, 0.0f);
+    translationZ.resize(size, 0.0f);
+    rotationX.resize(size, 0.0f);
+    rotationY.resize(size, 0.0f);
+    rotationZ.resize(size, 0.0f);
+    rotationW.resize(size, 1.0f);
+    scaleX.resize(size, 1.0f);
+    scaleY.resize(size, 1.0f);
+    scaleZ.resize(size, 1.0f);
+}
+
+void ku::TransformSoA::reserve(std::size_t size) {
+    for (auto* component : { &translationX, &translationY, &translationZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX,
+                             &scaleY, &scaleZ })
+        component->reserve(size);
+}
+
+void ku::TransformSoA::set(std::size_t index, const float* translation, const float* rotation, const float* scale) noexcept {
+    translationX[index] = translation[0];
+    translationY[index] = translation[1];
+    translationZ[index] = translation[2];
+    rotationX[index] = rotation[0];
+    rotationY[index] = rotation[1];
+    rotationZ[index] = rotation[2];
+    rotationW[index] = rotation[3];
+    scaleX[index] = scale[0];
+    scaleY[index] = scale[1];
+    scaleZ[index] = scale[2];
+}
+
+std::size_t ku::TransformSoA::size() const noexcept {
+    return translationX.size();
+}
+
+void ku::AabbSoA::resize(std::size_t size) {
+    minX.resize(size);
+    minY.resize(size);
+    minZ.resize(size);
+    maxX.resize(size);
+    maxY.resize(size);
+    maxZ.resize(size);
+}
+
+void ku::AabbSoA::set(std::size_t index, const float* min, const float* max) noexcept {
+    minX[index] = min[0];
+    minY[index] = min[1];
+    minZ[index] = min[2];
+    maxX[index] = max[0];
+    maxY[index] = max[1];
+    maxZ[index] = max[2];
+}
+
+std::size_t ku::AabbSoA::size() const noexcept {
+    return minX.size();
+}
+
+ku::Matrix4 ku::multiplyMatrix(const Matrix4& lhs, const Matrix4& rhs) noexcept {
+    Matrix4 result;
+    multiplyMatrixScalar(lhs, rhs, result);
+    return result;
+}
+
+void ku::composeTransforms(const TransformSoA& transforms, std::size_t first, std::span<Matrix4> out) {
+    ZoneScoped;
+    VERIFY(first + out.size() <= transforms.size());
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<ComposeKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures, composeTransformsAvx2 },
+#elif defined(KRYPTON_ARCH_ARM64)
+        { CpuFeature::NEON, composeTransformsNeon },
+#endif
+        { CpuFeature::None, composeTransformsScalar },
+    }));
+    dispatcher(transforms, first, out.data(), out.size());
+}
+
+namespace krypton::util {
+    auto getMultiplyMatricesKernel() -> MultiplyKernel* {
+        static const KernelDispatcher dispatcher(std::to_array<KernelVariant<MultiplyKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+            { avx2TargetFeatures, multiplyMatricesAvx2 },
+#elif defined(KRYPTON_ARCH_ARM64)
+            { CpuFeature::NEON, multiplyMatricesNeon },
+#endif
+            { CpuFeature::None, multiplyMatricesScalar },
+        }));
+        return dispatcher.get();
+    }
+} // namespace krypton::util
+
+void ku::multiplyMatrices(std::span<const Matrix4> lhs, std::span<const Matrix4> rhs, std::span<Matrix4> out) {
+    ZoneScoped;
+    VERIFY(lhs.size() >= out.size() && rhs.size() >= out.size());
+    getMultiplyMatricesKernel()(lhs.data(), nullptr, rhs.data(), out.data(), out.size());
+}
+
+void ku::multiplyMatrices(std::span<const Matrix4> lhs, std::span<const uint32_t> lhsIndices, std::span<const Matrix4> rhs,
+                          std::span<Matrix4> out) {
+    ZoneScoped;
+    VERIFY(lhsIndices.size() >= out.size() && rhs.size() >= out.size());
+    getMultiplyMatricesKernel()(lhs.data(), lhsIndices.data(), rhs.data(), out.data(), out.size());
+}
+
+void ku::transformAabbs(const AabbSoA& src, std::size_t first, std::span<const Matrix4> matrices, AabbSoA& dst) {
+    ZoneScoped;
+    VERIFY(first + matrices.size() <= src.size() && dst.size() >= src.size());
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<AabbKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+        { avx2TargetFeatures, transformAabbsAvx2 },
+#endif
+        { CpuFeature::None, transformAabbsScalar },
+    }));
+    dispatcher(src, first, matrices.data(), dst, matrices.size());
+}
+
+void ku::computeAabb(const float* points, std::size_t stride, std::size_t count, float* min, float* max) {
+    ZoneScoped;
+    VERIFY(stride >= 3 * sizeof(float));
+    static const KernelDispatcher dispatcher(std::to_array<KernelVariant<BoundsKernel>>({
+#if defined(KRYPTON_ARCH_X86)
+        { CpuFeature::SSE42, computeAabbSse42 },
+#elif defined(KRYPTON_ARCH_ARM64)
+        { CpuFeature::NEON, computeAabbNeon },
+#endif
+        { CpuFeature::None, computeAabbScalar },
+    }));
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        min[axis] = INFINITY;
+        max[axis] = -INFINITY;
+    }
+    dispatcher(reinterpret_cast<const std::byte*>(points), stride, count, min, max);
+}
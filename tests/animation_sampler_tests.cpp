@@ -0,0 +1,241 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <util/animation_sampler.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+namespace {
+    // A straightforward sampler to compare against, which always searches for the key from scratch.
+    std::vector<float> referenceSample(const std::vector<float>& times, const std::vector<float>& values, uint32_t componentCount,
+                                       ku::Interpolation interpolation, bool rotation, float time) {
+        std::vector<float> result(componentCount);
+        const auto stride = interpolation == ku::Interpolation::CubicSpline ? 3U : 1U;
+        const auto offset = interpolation == ku::Interpolation::CubicSpline ? 1U : 0U;
+        auto value = [&](std::size_t key, std::size_t element, uint32_t c) {
+            return values[(key * stride + element) * componentCount + c];
+        };
+        if (times.size() == 1 || time <= times.front() || time >= times.back()) {
+            const auto key = time <= times.front() ? 0 : times.size() - 1;
+            for (uint32_t c = 0; c < componentCount; ++c)
+                result[c] = value(key, offset, c);
+            return result;
+        }
+
+        std::size_t key = 0;
+        while (time >= times[key + 1])
+            ++key;
+        const auto duration = times[key + 1] - times[key];
+        const auto t = (time - times[key]) / duration;
+        float sign = 1.0f;
+        if (rotation && interpolation == ku::Interpolation::Linear) {
+            float dot = 0.0f;
+            for (uint32_t c = 0; c < componentCount; ++c)
+                dot += value(key, 0, c) * value(key + 1, 0, c);
+            sign = dot < 0.0f ? -1.0f : 1.0f;
+        }
+        for (uint32_t c = 0; c < componentCount; ++c) {
+            if (interpolation == ku::Interpolation::Step) {
+                result[c] = value(key, 0, c);
+            } else if (interpolation == ku::Interpolation::Linear) {
+                result[c] = value(key, 0, c) * (1.0f - t) + sign * value(key + 1, 0, c) * t;
+            } else {
+                const float t2 = t * t, t3 = t2 * t;
+                result[c] = (2 * t3 - 3 * t2 + 1) * value(key, 1, c) + (t3 - 2 * t2 + t) * duration * value(key, 2, c) +
+                            (-2 * t3 + 3 * t2) * value(key + 1, 1, c) + (t3 - t2) * duration * value(key + 1, 0, c);
+            }
+        }
+        if (rotation) {
+            float length = 0.0f;
+            for (auto component : result)
+                length += component * component;
+            for (auto& component : result)
+                component /= std::sqrt(length);
+        }
+        return result;
+    }
+
+    struct RandomTrack {
+        std::vector<float> times;
+        std::vector<float> values;
+        uint32_t componentCount;
+        ku::Interpolation interpolation;
+        bool rotation;
+    };
+
+    std::vector<RandomTrack> createRandomTracks(std::size_t count, std::size_t maxKeyCount) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> step(0.01f, 0.2f);
+        std::uniform_int_distribution<std::size_t> keyCount(1, maxKeyCount);
+        std::uniform_int_distribution<int> mode(0, 5);
+
+        std::vector<RandomTrack> tracks(count);
+        for (auto& track : tracks) {
+            const auto type = mode(rng);
+            track.rotation = type == 0;
+            track.componentCount = track.rotation ? 4 : type == 1 ? 1 : 3;
+            track.interpolation = ku::Interpolation::Linear;
+            if (type == 3)
+                track.interpolation = ku::Interpolation::Step;
+            else if (type >= 4)
+                track.interpolation = ku::Interpolation::CubicSpline;
+
+            float time = step(rng);
+            track.times.resize(keyCount(rng));
+            for (auto& key : track.times) {
+                key = time;
+                time += step(rng);
+            }
+            const auto valueCount = track.times.size() * (track.interpolation == ku::Interpolation::CubicSpline ? 3 : 1);
+            track.values.resize(valueCount * track.componentCount);
+            for (auto& component : track.values)
+                component = value(rng);
+            // Rotation keys are unit quaternions.
+            for (std::size_t i = 0; track.rotation && i < track.values.size(); i += 4) {
+                const auto length = std::sqrt(track.values[i] * track.values[i] + track.values[i + 1] * track.values[i + 1] +
+                                              track.values[i + 2] * track.values[i + 2] + track.values[i + 3] * track.values[i + 3]);
+                for (std::size_t c = 0; c < 4; ++c)
+                    track.values[i + c] /= length;
+            }
+        }
+        return tracks;
+    }
+
+    ku::KeyframeTracks addTracks(const std::vector<RandomTrack>& randomTracks, bool quantize) {
+        ku::KeyframeTracks tracks;
+        for (const auto& track : randomTracks)
+            tracks.addTrack(track.times, track.values, track.componentCount, track.interpolation, track.rotation, quantize);
+        return tracks;
+    }
+} // namespace
+
+TEST_CASE("Keyframe interpolation", "[animation_sampler]") {
+    ku::KeyframeTracks tracks;
+    const std::vector<float> times = { 1.0f, 2.0f, 4.0f };
+    const std::vector<float> values = { 0.0f, 10.0f, 20.0f, 30.0f, 40.0f, 50.0f };
+    const auto step = tracks.addTrack(times, values, 2, ku::Interpolation::Step, false, false);
+    const auto linear = tracks.addTrack(times, values, 2, ku::Interpolation::Linear, false, false);
+    // Zero tangents around two values.
+    const std::vector<float> cubicValues = { 0.0f, 1.0f, 0.0f, 0.0f, 3.0f, 0.0f };
+    const auto cubic = tracks.addTrack(std::span(times).first(2), cubicValues, 1, ku::Interpolation::CubicSpline, false, false);
+    REQUIRE(tracks.size() == 3);
+    REQUIRE(tracks.getDuration() == 4.0f);
+
+    ku::TrackSamples samples;
+    samples.resize(tracks.size());
+    ku::sampleTracks(tracks, 0, tracks.size(), 1.5f, {}, samples);
+    REQUIRE(samples.values[0][step] == 0.0f);
+    REQUIRE(samples.values[1][step] == 10.0f);
+    REQUIRE(samples.values[0][linear] == Catch::Approx(10.0f));
+    REQUIRE(samples.values[1][linear] == Catch::Approx(20.0f));
+    REQUIRE(samples.values[2][linear] == 0.0f);
+    REQUIRE(samples.values[0][cubic] == Catch::Approx(2.0f));
+
+    ku::sampleTracks(tracks, 0, tracks.size(), 3.0f, {}, samples);
+    REQUIRE(samples.values[0][step] == 20.0f);
+    REQUIRE(samples.values[0][linear] == Catch::Approx(30.0f));
+    REQUIRE(samples.values[0][cubic] == Catch::Approx(3.0f));
+
+    // Times outside of the keys are clamped.
+    ku::sampleTracks(tracks, 0, tracks.size(), -1.0f, {}, samples);
+    REQUIRE(samples.values[1][linear] == 10.0f);
+    REQUIRE(samples.values[0][cubic] == 1.0f);
+    ku::sampleTracks(tracks, 0, tracks.size(), 10.0f, {}, samples);
+    REQUIRE(samples.values[0][step] == 40.0f);
+    REQUIRE(samples.values[1][linear] == Catch::Approx(50.0f));
+}
+
+TEST_CASE("Rotation interpolation", "[animation_sampler]") {
+    ku::KeyframeTracks tracks;
+    const std::vector<float> times = { 0.0f, 1.0f };
+    // The second key is the same rotation as the identity, negated.
+    const float halfSqrt = std::sqrt(0.5f);
+    const std::vector<float> values = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, -halfSqrt, 0.0f, -halfSqrt };
+    tracks.addTrack(times, values, 4, ku::Interpolation::Linear, true, false);
+
+    ku::TrackSamples samples;
+    samples.resize(tracks.size());
+    ku::sampleTracks(tracks, 0, 1, 0.5f, {}, samples);
+    float length = 0.0f;
+    for (std::size_t c = 0; c < 4; ++c)
+        length += samples.values[c][0] * samples.values[c][0];
+    REQUIRE(length == Catch::Approx(1.0f));
+    // The shorter arc is a rotation by 45° around +Y, with both components positive.
+    REQUIRE(samples.values[1][0] > 0.0f);
+    REQUIRE(samples.values[3][0] > 0.0f);
+    REQUIRE(samples.values[1][0] == Catch::Approx(std::sin(0.3926991f)));
+}
+
+TEST_CASE("Sampling many tracks", "[animation_sampler]") {
+    const auto randomTracks = createRandomTracks(1000, 24);
+    const auto tracks = addTracks(randomTracks, false);
+    const auto duration = tracks.getDuration();
+
+    ku::TrackSamples samples, cursorSamples;
+    samples.resize(tracks.size());
+    cursorSamples.resize(tracks.size());
+    std::vector<uint32_t> cursors(tracks.size());
+    // Plays forward, then jumps back to check that stale cursors are handled.
+    for (const auto time : { 0.0f, 0.13f, 0.5f, 0.51f, 1.2f, 2.9f, 0.3f, duration + 1.0f }) {
+        ku::sampleTracks(tracks, 0, tracks.size(), time, {}, samples);
+        ku::sampleTracks(tracks, time, cursors, cursorSamples);
+        for (std::size_t i = 0; i < tracks.size(); ++i) {
+            const auto& track = randomTracks[i];
+            const auto expected =
+                referenceSample(track.times, track.values, track.componentCount, track.interpolation, track.rotation, time);
+            for (std::size_t c = 0; c < 4; ++c) {
+                REQUIRE(samples.values[c][i] == cursorSamples.values[c][i]);
+                if (c < track.componentCount)
+                    REQUIRE(samples.values[c][i] == Catch::Approx(expected[c]).margin(1e-4));
+                else
+                    REQUIRE(samples.values[c][i] == 0.0f);
+            }
+        }
+    }
+}
+
+TEST_CASE("Quantized tracks", "[animation_sampler]") {
+    const auto randomTracks = createRandomTracks(200, 16);
+    const auto tracks = addTracks(randomTracks, false);
+    const auto quantizedTracks = addTracks(randomTracks, true);
+    REQUIRE(quantizedTracks.values[0].empty());
+    REQUIRE(quantizedTracks.quantizedValues[0].size() == tracks.values[0].size());
+
+    ku::TrackSamples samples, quantizedSamples;
+    samples.resize(tracks.size());
+    quantizedSamples.resize(tracks.size());
+    for (const auto time : { 0.0f, 0.7f, 1.9f }) {
+        ku::sampleTracks(tracks, time, {}, samples);
+        ku::sampleTracks(quantizedTracks, time, {}, quantizedSamples);
+        for (std::size_t i = 0; i < tracks.size(); ++i) {
+            // Values are within [-2, 2], so every step is 4 / 65535. Tangents and normalization
+            // can scale the error up a bit.
+            for (std::size_t c = 0; c < 4; ++c)
+                REQUIRE(std::abs(samples.values[c][i] - quantizedSamples.values[c][i]) < 1e-3f);
+        }
+    }
+}
+
+TEST_CASE("Animation sampler benchmarks", "[.benchmark]") {
+    constexpr std::size_t trackCount = 64 * 1024;
+    const auto randomTracks = createRandomTracks(trackCount, 64);
+    for (const bool quantize : { false, true }) {
+        const auto tracks = addTracks(randomTracks, quantize);
+        ku::TrackSamples samples;
+        samples.resize(tracks.size());
+        std::vector<uint32_t> cursors(tracks.size());
+        float time = 0.0f;
+        krypton::tests::measureThroughput(quantize ? "Quantized track sampling" : "Track sampling", trackCount, [&]() {
+            ku::sampleTracks(tracks, 0, tracks.size(), time, cursors, samples);
+            time += 1.0f / 60.0f;
+        });
+    }
+}
@@ -0,0 +1,329 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <assets/loader/fileloader.hpp>
+#include <util/numeric_conversion.hpp>
+
+#include "test_meshes.hpp"
+
+namespace ka = krypton::assets;
+namespace kal = krypton::assets::loader;
+namespace kt = krypton::tests;
+namespace ku = krypton::util;
+
+namespace {
+    /**
+     * Gives every vertex a color, influences and, for every third vertex, a morph target delta
+     * that encode its index, so that they can be traced back after the vertices have been moved.
+     */
+    void addVertexIds(ka::Primitive& primitive) {
+        const auto vertexCount = static_cast<uint32_t>(primitive.vertices.size());
+        primitive.colors.resize(vertexCount);
+        primitive.influences.resize(vertexCount);
+        auto& target = primitive.morphTargets.emplace_back();
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            primitive.colors[i] = i;
+            primitive.influences[i] = { { static_cast<uint16_t>(i), static_cast<uint16_t>(i >> 16), 0, 0 }, { 0xFFFF, 0, 0, 0 } };
+            if (i % 3 != 0)
+                continue;
+            target.vertices.push_back(i);
+            target.positionDeltas.insert(target.positionDeltas.end(), { static_cast<float>(i), 0.0f, 0.0f });
+        }
+    }
+
+    // Checks that the deformation data of every vertex of the chunk belongs to the vertex its color names.
+    void checkDeformation(const ka::Primitive& chunk) {
+        REQUIRE(chunk.influences.size() == chunk.vertices.size());
+        for (std::size_t i = 0; i < chunk.vertices.size(); ++i) {
+            const auto& influences = chunk.influences[i];
+            REQUIRE((influences.joints[0] | (static_cast<uint32_t>(influences.joints[1]) << 16)) == chunk.colors[i]);
+        }
+
+        REQUIRE(chunk.morphTargets.size() == 1);
+        const auto& target = chunk.morphTargets[0];
+        REQUIRE(target.positionDeltas.size() == target.vertices.size() * 3);
+        std::size_t movedVertices = 0;
+        for (std::size_t i = 0; i < chunk.vertices.size(); ++i)
+            movedVertices += chunk.colors[i] % 3 == 0;
+        REQUIRE(target.vertices.size() == movedVertices);
+        for (std::size_t i = 0; i < target.vertices.size(); ++i) {
+            REQUIRE(target.vertices[i] < chunk.vertices.size());
+            REQUIRE(target.positionDeltas[i * 3] == static_cast<float>(chunk.colors[target.vertices[i]]));
+        }
+    }
+
+    /**
+     * A unit sphere through the 26 neighbours of a 3x3x3 grid, whose normals point in every
+     * direction, and a grid next to it without normals and with tiled UVs. Together they span
+     * (-1, -1, -1) to (4, 1, 1), with UVs from -1 to 3.
+     */
+    auto createLayoutMesh() -> ka::Mesh {
+        ka::Mesh mesh;
+        auto& sphere = mesh.primitives.emplace_back();
+        for (int x = -1; x <= 1; ++x) {
+            for (int y = -1; y <= 1; ++y) {
+                for (int z = -1; z <= 1; ++z) {
+                    if (x == 0 && y == 0 && z == 0)
+                        continue;
+                    const auto direction = glm::normalize(glm::fvec3(x, y, z));
+                    auto& vertex = sphere.vertices.emplace_back();
+                    vertex.pos = glm::fvec4(direction, 1.0f);
+                    vertex.normals = glm::fvec4(direction, 0.0f);
+                    vertex.uv = glm::fvec2(direction.x, direction.y) * 0.5f + 0.5f;
+                }
+            }
+        }
+
+        auto& grid = mesh.primitives.emplace_back();
+        for (int y = 0; y <= 3; ++y) {
+            for (int x = 0; x <= 3; ++x) {
+                auto& vertex = grid.vertices.emplace_back();
+                vertex.pos = glm::fvec4(static_cast<float>(x + 1), static_cast<float>(y) / 3.0f - 0.5f, 0.25f, 1.0f);
+                vertex.normals = glm::fvec4(0.0f);
+                vertex.uv = glm::fvec2(static_cast<float>(x * 4), static_cast<float>(y * 4)) / 3.0f - 1.0f;
+            }
+        }
+        return mesh;
+    }
+
+    auto getVertices(const ka::Mesh& mesh) -> std::vector<std::vector<ka::Vertex>> {
+        std::vector<std::vector<ka::Vertex>> vertices;
+        for (const auto& primitive : mesh.primitives)
+            vertices.push_back(primitive.vertices);
+        return vertices;
+    }
+
+    // Half-floats keep 11 significant bits.
+    void checkHalf(uint16_t encoded, float value) {
+        REQUIRE(std::abs(ku::halfToFloat(encoded) - value) <= std::abs(value) / 2048.0f);
+    }
+
+    // Checks that an octahedral normal restores the direction of the full normal, and that zero normals stay zero.
+    void checkNormal(const int16_t* encoded, const glm::fvec4& normal) {
+        const auto direction = glm::fvec3(normal);
+        if (direction == glm::fvec3(0.0f)) {
+            CHECK(encoded[0] == 0);
+            CHECK(encoded[1] == 0);
+            return;
+        }
+
+        glm::fvec3 decoded;
+        ku::decodeOctahedral(encoded, &decoded.x);
+        CHECK(glm::dot(decoded, glm::normalize(direction)) > 0.99999f);
+    }
+
+    // Restores a quantized value the way vertex shaders do.
+    auto dequantize(uint16_t value, float offset, float scale) -> float {
+        return offset + scale * (static_cast<float>(value) / 65535.0f);
+    }
+
+    /**
+     * Checks that the quantized vertices of the mesh restore the positions and UVs of the full
+     * vertices to within the given number of quantization steps.
+     */
+    void checkQuantized(const ka::Mesh& mesh, const std::vector<std::vector<ka::Vertex>>& vertices, float steps) {
+        REQUIRE(mesh.primitives.size() == vertices.size());
+        for (std::size_t p = 0; p < vertices.size(); ++p) {
+            const auto& primitive = mesh.primitives[p];
+            REQUIRE(primitive.vertexLayout == ka::VertexLayout::Quantized);
+            REQUIRE(primitive.vertices.empty());
+            REQUIRE(primitive.quantizedVertices.size() == vertices[p].size());
+            for (std::size_t i = 0; i < vertices[p].size(); ++i) {
+                const auto& quantized = primitive.quantizedVertices[i];
+                const auto& vertex = vertices[p][i];
+                for (int c = 0; c < 3; ++c) {
+                    const auto position = dequantize(quantized.position[c], mesh.positionOffset[c], mesh.positionScale[c]);
+                    REQUIRE(std::abs(position - vertex.pos[c]) <= steps * mesh.positionScale[c] / 65535.0f);
+                }
+                for (int c = 0; c < 2; ++c) {
+                    const auto uv = dequantize(quantized.uv[c], mesh.uvOffset[c], mesh.uvScale[c]);
+                    REQUIRE(std::abs(uv - vertex.uv[c]) <= steps * mesh.uvScale[c] / 65535.0f);
+                }
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("splitPrimitive keeps every triangle and vertex attribute", "[assets][loader]") {
+    // 301 x 301 vertices, which is too many for 16-bit indices.
+    auto primitive = kt::createGrid(300);
+    addVertexIds(primitive);
+    const auto indices = primitive.indices.toUint32();
+    REQUIRE(primitive.indices.getType() == ka::IndexType::Uint32);
+
+    using Limits = std::pair<std::size_t, bool>;
+    for (auto [maxVertexCount, allowUint8] : { Limits { kal::maxUint16VertexCount, false }, Limits { 256, true } }) {
+        auto chunks = kal::splitPrimitive(primitive, maxVertexCount, allowUint8);
+        REQUIRE(chunks.size() > 1);
+
+        // The chunks, mapped back to the original vertices, draw the original triangles in the original order.
+        std::vector<uint32_t> chunkIndices;
+        for (const auto& chunk : chunks) {
+            REQUIRE(chunk.vertices.size() <= maxVertexCount);
+            REQUIRE(chunk.colors.size() == chunk.vertices.size());
+            CHECK(chunk.indices.getType() == ka::getNarrowestIndexType(chunk.vertices.size(), allowUint8));
+            CHECK(chunk.materialIndex == primitive.materialIndex);
+            CHECK(!chunk.boundingBox.empty());
+
+            for (std::size_t i = 0; i < chunk.vertices.size(); ++i) {
+                const auto& source = primitive.vertices[chunk.colors[i]];
+                REQUIRE(kt::toVec3(chunk.vertices[i].pos) == kt::toVec3(source.pos));
+                REQUIRE(chunk.vertices[i].uv.x == source.uv.x);
+                REQUIRE(chunk.vertices[i].uv.y == source.uv.y);
+            }
+            checkDeformation(chunk);
+
+            for (auto index : chunk.indices.toUint32()) {
+                REQUIRE(index < chunk.vertices.size());
+                chunkIndices.push_back(chunk.colors[index]);
+            }
+        }
+        CHECK(chunkIndices == indices);
+        CHECK(kt::getSortedTriangles(chunkIndices) == kt::getSortedTriangles(indices));
+    }
+}
+
+TEST_CASE("splitPrimitive returns small primitives and other topologies unchanged", "[assets][loader]") {
+    auto primitive = kt::createGrid(4);
+    addVertexIds(primitive);
+    const auto indices = primitive.indices.toUint32();
+    auto chunks = kal::splitPrimitive(primitive, kal::maxUint16VertexCount, false);
+    REQUIRE(chunks.size() == 1);
+    CHECK(chunks[0].vertices.size() == primitive.vertices.size());
+    std::vector<uint32_t> chunkIndices;
+    for (auto index : chunks[0].indices.toUint32())
+        chunkIndices.push_back(chunks[0].colors[index]);
+    CHECK(chunkIndices == indices);
+
+    primitive.topology = ka::PrimitiveTopology::Lines;
+    chunks = kal::splitPrimitive(primitive, 4, false);
+    REQUIRE(chunks.size() == 1);
+    CHECK(chunks[0].topology == ka::PrimitiveTopology::Lines);
+    CHECK(chunks[0].vertices.size() == primitive.vertices.size());
+    CHECK(chunks[0].indices.toUint32() == indices);
+}
+
+TEST_CASE("compactVertices converts to the compact and quantized layouts", "[assets][loader]") {
+    auto mesh = createLayoutMesh();
+    const auto vertices = getVertices(mesh);
+
+    SECTION("Compact") {
+        kal::compactVertices(mesh, ka::VertexLayout::Compact);
+        for (std::size_t p = 0; p < vertices.size(); ++p) {
+            const auto& primitive = mesh.primitives[p];
+            REQUIRE(primitive.vertexLayout == ka::VertexLayout::Compact);
+            REQUIRE(primitive.vertices.empty());
+            REQUIRE(primitive.compactVertices.size() == vertices[p].size());
+            for (std::size_t i = 0; i < vertices[p].size(); ++i) {
+                const auto& compact = primitive.compactVertices[i];
+                const auto& vertex = vertices[p][i];
+                for (int c = 0; c < 3; ++c)
+                    REQUIRE(compact.position[c] == vertex.pos[c]);
+                checkNormal(compact.normal, vertex.normals);
+                checkHalf(compact.uv[0], vertex.uv.x);
+                checkHalf(compact.uv[1], vertex.uv.y);
+            }
+        }
+    }
+
+    SECTION("Quantized") {
+        kal::compactVertices(mesh, ka::VertexLayout::Quantized);
+        CHECK(mesh.positionOffset == glm::fvec3(-1.0f));
+        CHECK(mesh.positionScale == glm::fvec3(5.0f, 2.0f, 2.0f));
+        CHECK(mesh.uvOffset == glm::fvec2(-1.0f));
+        CHECK(mesh.uvScale == glm::fvec2(4.0f));
+        checkQuantized(mesh, vertices, 1.0f);
+
+        // Vertices on the bounds map to the ends of the unorm16 range.
+        for (std::size_t p = 0; p < vertices.size(); ++p) {
+            for (std::size_t i = 0; i < vertices[p].size(); ++i) {
+                const auto& quantized = mesh.primitives[p].quantizedVertices[i];
+                const auto& vertex = vertices[p][i];
+                for (int c = 0; c < 3; ++c) {
+                    if (vertex.pos[c] == mesh.positionOffset[c])
+                        REQUIRE(quantized.position[c] == 0);
+                    if (vertex.pos[c] == mesh.positionOffset[c] + mesh.positionScale[c])
+                        REQUIRE(quantized.position[c] == 65535);
+                }
+                CHECK(quantized.position[3] == 0);
+                checkNormal(quantized.normal, vertex.normals);
+            }
+        }
+    }
+
+    SECTION("Flat meshes") {
+        mesh.primitives.erase(mesh.primitives.begin());
+        kal::compactVertices(mesh, ka::VertexLayout::Quantized);
+        CHECK(mesh.positionScale.z == 0.0f);
+        checkQuantized(mesh, { vertices[1] }, 1.0f);
+        for (const auto& quantized : mesh.primitives[0].quantizedVertices)
+            REQUIRE(quantized.position[2] == 0);
+    }
+}
+
+TEST_CASE("compactVertices keeps integer positions and UVs on their source grid", "[assets][loader]") {
+    // Two primitives of 64 vertices each, whose k-th vertex gets the position and UV the function returns for k.
+    auto createMesh = [](ka::SourceEncoding positionEncoding, ka::SourceEncoding uvEncoding, auto getValues) {
+        ka::Mesh mesh;
+        for (uint32_t p = 0; p < 2; ++p) {
+            auto& primitive = mesh.primitives.emplace_back(kt::createGrid(7));
+            primitive.positionEncoding = positionEncoding;
+            primitive.uvEncoding = uvEncoding;
+            for (uint32_t i = 0; i < primitive.vertices.size(); ++i) {
+                const auto [position, uv] = getValues(static_cast<float>(p * 64 + i));
+                primitive.vertices[i].pos = glm::fvec4(position, 1.0f);
+                primitive.vertices[i].uv = uv;
+            }
+        }
+        return mesh;
+    };
+    constexpr ka::SourceEncoding uint16 = { ku::ComponentType::Uint16, false };
+    constexpr ka::SourceEncoding unorm16 = { ku::ComponentType::Uint16, true };
+
+    SECTION("16-bit positions and normalized UVs") {
+        auto mesh = createMesh(uint16, unorm16, [](float k) {
+            return std::pair { glm::fvec3(k * 516.0f, 65535.0f - k * 516.0f, k * k), glm::fvec2(k * 516.0f, 65535.0f - k) / 65535.0f };
+        });
+        const auto vertices = getVertices(mesh);
+        kal::compactVertices(mesh, ka::VertexLayout::Quantized);
+        CHECK(mesh.positionOffset == glm::fvec3(0.0f));
+        CHECK(mesh.positionScale == glm::fvec3(65535.0f));
+        CHECK(mesh.uvOffset == glm::fvec2(0.0f));
+        CHECK(mesh.uvScale == glm::fvec2(1.0f));
+        checkQuantized(mesh, vertices, 0.0f);
+    }
+
+    SECTION("8-bit positions and UVs") {
+        // 8-bit values fill the upper byte of the unorm16.
+        constexpr ka::SourceEncoding int8 = { ku::ComponentType::Int8, false };
+        constexpr ka::SourceEncoding uint8 = { ku::ComponentType::Uint8, false };
+        auto mesh = createMesh(int8, uint8, [](float k) {
+            return std::pair { glm::fvec3(k * 2.0f - 128.0f, 127.0f - k * 2.0f, k - 64.0f), glm::fvec2(k * 2.0f, 255.0f - k) };
+        });
+        const auto vertices = getVertices(mesh);
+        kal::compactVertices(mesh, ka::VertexLayout::Quantized);
+        CHECK(mesh.positionOffset == glm::fvec3(-128.0f));
+        CHECK(mesh.positionScale == glm::fvec3(65535.0f / 256.0f));
+        CHECK(mesh.uvScale == glm::fvec2(65535.0f / 256.0f));
+        checkQuantized(mesh, vertices, 0.0f);
+    }
+
+    SECTION("Mixed source types") {
+        // The second primitive was stored as floats, so both fall back to the bounds of the mesh.
+        auto mesh = createMesh(uint16, unorm16, [](float k) {
+            return std::pair { glm::fvec3(k * 100.0f, k * 3.0f + 1000.0f, 7.0f), glm::fvec2(k / 127.0f, 0.5f) };
+        });
+        mesh.primitives[1].positionEncoding = {};
+        mesh.primitives[1].uvEncoding = {};
+        const auto vertices = getVertices(mesh);
+        kal::compactVertices(mesh, ka::VertexLayout::Quantized);
+        CHECK(mesh.positionOffset == glm::fvec3(0.0f, 1000.0f, 7.0f));
+        CHECK(mesh.positionScale == glm::fvec3(12700.0f, 381.0f, 0.0f));
+        CHECK(mesh.uvOffset == glm::fvec2(0.0f, 0.5f));
+        checkQuantized(mesh, vertices, 1.0f);
+    }
+}
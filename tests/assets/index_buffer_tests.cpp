@@ -0,0 +1,44 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <assets/index_buffer.hpp>
+
+namespace ka = krypton::assets;
+
+TEST_CASE("getNarrowestIndexType switches at the 256 and 65536 vertex boundaries", "[assets][indices]") {
+    CHECK(ka::getNarrowestIndexType(0, true) == ka::IndexType::Uint8);
+    CHECK(ka::getNarrowestIndexType(0x100, true) == ka::IndexType::Uint8);
+    CHECK(ka::getNarrowestIndexType(0x101, true) == ka::IndexType::Uint16);
+    // 8-bit indices are only used if they are allowed.
+    CHECK(ka::getNarrowestIndexType(0x100) == ka::IndexType::Uint16);
+    CHECK(ka::getNarrowestIndexType(0x10000) == ka::IndexType::Uint16);
+    CHECK(ka::getNarrowestIndexType(0x10000, true) == ka::IndexType::Uint16);
+    CHECK(ka::getNarrowestIndexType(0x10001) == ka::IndexType::Uint32);
+    CHECK(ka::getNarrowestIndexType(0x10001, true) == ka::IndexType::Uint32);
+}
+
+TEST_CASE("IndexBuffer stores the indices in the given type", "[assets][indices]") {
+    for (auto vertexCount : { 0x100u, 0x10000u, 0x10001u }) {
+        // Every index the type can represent at its boundary, in both directions.
+        std::vector<uint32_t> indices = { 0, vertexCount - 1, 1, vertexCount - 2, vertexCount / 2 };
+        auto type = ka::getNarrowestIndexType(vertexCount, true);
+
+        ka::IndexBuffer buffer;
+        buffer.assign(indices, type);
+        CHECK(buffer.getType() == type);
+        CHECK(buffer.size() == indices.size());
+        CHECK(buffer.getBytes().size() == indices.size() * ka::getIndexSize(type));
+        CHECK(buffer.toUint32() == indices);
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            CHECK(buffer[i] == indices[i]);
+    }
+
+    ka::IndexBuffer buffer;
+    buffer.assign(std::vector<uint32_t> { 1, 2, 3 }, ka::IndexType::Uint16);
+    CHECK(buffer.as<uint16_t>()[2] == 3);
+    buffer.clear();
+    CHECK(buffer.empty());
+    CHECK(buffer.toUint32().empty());
+}
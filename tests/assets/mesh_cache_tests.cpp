@@ -0,0 +1,319 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <assets/loader/mesh_cache.hpp>
+#include <assets/processing/meshlet_builder.hpp>
+
+#include "test_meshes.hpp"
+
+namespace ka = krypton::assets;
+namespace kal = krypton::assets::loader;
+namespace kap = krypton::assets::processing;
+namespace kt = krypton::tests;
+
+namespace {
+    constexpr uint64_t optionsHash = 0x1234;
+
+    // A single instance of a cube with every kind of data the cache stores for primitives.
+    void fillLoader(kal::FileLoader& loader) {
+        auto primitive = kt::createCube(2, false);
+        const auto vertexCount = static_cast<uint32_t>(primitive.vertices.size());
+        primitive.influences.assign(vertexCount, { { 0, 0, 0, 0 }, { 0xFFFF, 0, 0, 0 } });
+        auto& target = primitive.morphTargets.emplace_back();
+        target.vertices = { 1, 5, vertexCount - 1 };
+        target.positionDeltas.assign(target.vertices.size() * 3, 0.5f);
+        auto& lod = primitive.lods.emplace_back();
+        auto indices = primitive.indices.toUint32();
+        lod.indices.assign(std::span(indices).first(6), primitive.indices.getType());
+        lod.error = 0.5f;
+        kap::buildMeshlets(primitive, {});
+        kal::computeBounds(primitive);
+
+        auto mesh = std::make_shared<ka::Mesh>();
+        mesh->name = "Cube";
+        mesh->primitives.push_back(std::move(primitive));
+        kal::computeBounds(*mesh);
+        loader.meshes.push_back(mesh);
+
+        auto& material = loader.materials.emplace_back();
+        material.baseTextureIndex = 0;
+        auto& texture = loader.textures.emplace_back();
+        texture.name = "Checker";
+        texture.width = texture.height = 2;
+        texture.channels = 4;
+        texture.mipLevels = 1;
+        texture.pixels.resize(16);
+        std::fill(texture.pixels.begin(), texture.pixels.end(), std::byte { 0x7F });
+
+        const float translation[3] = { 1.0f, 2.0f, 3.0f }, rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f }, scale[3] = { 1.0f, 1.0f, 1.0f };
+        loader.hierarchy.nodes.addNode(krypton::util::TransformHierarchy::noParent, translation, rotation, scale);
+        loader.hierarchy.nodeNames.emplace_back("Root");
+        loader.hierarchy.instanceNodes = { 0 };
+        loader.hierarchy.instanceSkins = { ka::SceneHierarchy::noSkin };
+        loader.hierarchy.morphWeightOffsets = { 0, 0 };
+        loader.instances.push_back({ .meshIndex = 0 });
+    }
+
+    auto readFile(const std::filesystem::path& path) -> std::vector<char> {
+        std::ifstream file(path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::vector<char>& contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    template <typename T>
+    bool equalBytes(std::span<const T> a, std::span<const T> b) {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size_bytes()) == 0;
+    }
+
+    // Writes the cache of fillLoader for a small source file, whose path is returned.
+    auto writeTestCache(const kal::FileLoader& loader) -> std::filesystem::path {
+        auto source = std::filesystem::temp_directory_path() / "krypton_mesh_cache_tests.gltf";
+        writeFile(source, { '{', '}' });
+        std::vector<kal::CachedFileStamp> stamps;
+        uint64_t sourceHash = 0;
+        REQUIRE(kal::getSourceFileStamps(source, {}, stamps));
+        REQUIRE(kal::hashSourceFiles(source, {}, sourceHash));
+        REQUIRE(kal::writeMeshCache(kal::getMeshCachePath(source, {}), loader, {}, stamps, sourceHash, optionsHash));
+        return source;
+    }
+} // namespace
+
+TEST_CASE("Mesh caches restore everything that was written", "[assets][mesh_cache]") {
+    kal::FileLoader loader;
+    fillLoader(loader);
+    auto source = writeTestCache(loader);
+
+    kal::MeshCache cache;
+    REQUIRE(cache.open(kal::getMeshCachePath(source, {})));
+    REQUIRE(cache.isUpToDate(source, optionsHash));
+
+    for (bool mapPrimitives : { false, true }) {
+        kal::FileLoader loaded;
+        kal::readMeshCache(cache, loaded, false, mapPrimitives);
+
+        REQUIRE(loaded.meshes.size() == 1);
+        REQUIRE(loaded.meshes[0]->primitives.size() == 1);
+        CHECK(loaded.meshes[0]->name == "Cube");
+        const auto& expected = loader.meshes[0]->primitives[0];
+        const auto& primitive = loaded.meshes[0]->primitives[0];
+        CHECK(primitive.vertexLayout == expected.vertexLayout);
+        CHECK(primitive.topology == expected.topology);
+        CHECK(primitive.materialIndex == expected.materialIndex);
+        CHECK(primitive.indices.getType() == expected.indices.getType());
+        REQUIRE(primitive.lods.size() == 1);
+        CHECK(primitive.lods[0].error == expected.lods[0].error);
+        CHECK(primitive.lods[0].indices.getType() == expected.lods[0].indices.getType());
+
+        // The deformation data is always copied.
+        CHECK(equalBytes(std::span(primitive.influences), std::span(expected.influences)));
+        REQUIRE(primitive.morphTargets.size() == 1);
+        CHECK(primitive.morphTargets[0].vertices == expected.morphTargets[0].vertices);
+        CHECK(primitive.morphTargets[0].positionDeltas == expected.morphTargets[0].positionDeltas);
+
+        // The sources point at the data within the cache either way.
+        REQUIRE(loaded.primitiveSources.size() == 1);
+        REQUIRE(loaded.primitiveSources[0].size() == 1);
+        const auto& source0 = loaded.primitiveSources[0][0];
+        CHECK(equalBytes(source0.vertices, std::as_bytes(std::span(expected.vertices))));
+        CHECK(equalBytes(source0.indices, expected.indices.getBytes()));
+        REQUIRE(source0.lodIndices.size() == 1);
+        CHECK(equalBytes(source0.lodIndices[0], expected.lods[0].indices.getBytes()));
+        CHECK(equalBytes(source0.meshlets, std::span<const ka::Meshlet>(expected.meshlets.meshlets)));
+        CHECK(equalBytes(source0.meshletBounds, std::span<const ka::MeshletBounds>(expected.meshlets.bounds)));
+        CHECK(equalBytes(source0.meshletVertices, std::span<const uint32_t>(expected.meshlets.vertices)));
+        CHECK(equalBytes(source0.meshletTriangles, std::span<const uint8_t>(expected.meshlets.triangles)));
+        CHECK(source0.vertices.data() >= cache.getFile()->getData().data());
+
+        if (mapPrimitives) {
+            CHECK(primitive.vertices.empty());
+            CHECK(primitive.indices.empty());
+            CHECK(primitive.lods[0].indices.empty());
+            CHECK(primitive.meshlets.empty());
+        } else {
+            CHECK(equalBytes(std::span(primitive.vertices), std::span(expected.vertices)));
+            CHECK(primitive.indices.toUint32() == expected.indices.toUint32());
+            CHECK(primitive.lods[0].indices.toUint32() == expected.lods[0].indices.toUint32());
+            CHECK(primitive.meshlets.vertices == expected.meshlets.vertices);
+            CHECK(primitive.meshlets.triangles == expected.meshlets.triangles);
+        }
+
+        REQUIRE(loaded.materials.size() == 1);
+        CHECK(loaded.materials[0].baseTextureIndex == 0);
+        REQUIRE(loaded.textures.size() == 1);
+        CHECK(loaded.textures[0].name == "Checker");
+        CHECK(loaded.textures[0].pixels == loader.textures[0].pixels);
+        REQUIRE(loaded.instances.size() == 1);
+        CHECK(loaded.instances[0].meshIndex == 0);
+        CHECK(loaded.hierarchy.nodeNames == loader.hierarchy.nodeNames);
+        CHECK(loaded.hierarchy.instanceNodes == loader.hierarchy.instanceNodes);
+    }
+    std::filesystem::remove(kal::getMeshCachePath(source, {}));
+    std::filesystem::remove(source);
+}
+
+TEST_CASE("Mesh caches are rejected if they are invalid or outdated", "[assets][mesh_cache]") {
+    kal::FileLoader loader;
+    fillLoader(loader);
+    auto source = writeTestCache(loader);
+    auto path = kal::getMeshCachePath(source, {});
+    auto contents = readFile(path);
+    REQUIRE(contents.size() > sizeof(kal::MeshCacheHeader));
+    kal::MeshCacheHeader header;
+    std::memcpy(&header, contents.data(), sizeof(header));
+
+    // Overwrites a value at the given offset within the cache.
+    auto patch = [&contents](std::size_t offset, const auto& value) {
+        REQUIRE(offset + sizeof(value) <= contents.size());
+        std::memcpy(&contents[offset], &value, sizeof(value));
+    };
+    auto getSectionOffset = [&header](kal::MeshCacheSection section) {
+        return header.sections[static_cast<std::size_t>(section)].offset;
+    };
+
+    kal::MeshCache cache;
+    SECTION("Truncated file") {
+        contents.resize(contents.size() - kal::meshCacheAlignment);
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Truncated header") {
+        contents.resize(sizeof(kal::MeshCacheHeader) / 2);
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Wrong version") {
+        patch(offsetof(kal::MeshCacheHeader, version), kal::meshCacheVersion - 1);
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Changed options") {
+        REQUIRE(cache.open(path));
+        CHECK(cache.isUpToDate(source, optionsHash));
+        CHECK(!cache.isUpToDate(source, optionsHash + 1));
+    }
+
+    SECTION("Changed source") {
+        writeFile(source, { '{', ' ', '}' });
+        REQUIRE(cache.open(path));
+        CHECK(!cache.isUpToDate(source, optionsHash));
+    }
+
+    SECTION("Unchanged stamps") {
+        // The contents are only hashed if the stamps differ, so a wrong hash goes unnoticed.
+        patch(offsetof(kal::MeshCacheHeader, sourceHash), ~header.sourceHash);
+        writeFile(path, contents);
+        REQUIRE(cache.open(path));
+        CHECK(cache.isUpToDate(source, optionsHash));
+    }
+
+    SECTION("Changed stamps") {
+        // A touched source with the same contents is still up to date.
+        patch(getSectionOffset(kal::MeshCacheSection::FileStamps) + offsetof(kal::CachedFileStamp, modificationTime), int64_t { 1 });
+        writeFile(path, contents);
+        REQUIRE(cache.open(path));
+        CHECK(cache.isUpToDate(source, optionsHash));
+        cache.close();
+        patch(offsetof(kal::MeshCacheHeader, sourceHash), ~header.sourceHash);
+        writeFile(path, contents);
+        REQUIRE(cache.open(path));
+        CHECK(!cache.isUpToDate(source, optionsHash));
+    }
+
+    SECTION("Missing stamps") {
+        patch(offsetof(kal::MeshCacheHeader, sections) +
+                  static_cast<std::size_t>(kal::MeshCacheSection::FileStamps) * sizeof(kal::CachedRange) + offsetof(kal::CachedRange, size),
+              uint64_t { 0 });
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Truncated texture pixels") {
+        patch(getSectionOffset(kal::MeshCacheSection::Textures) + offsetof(kal::CachedTexture, pixels) + offsetof(kal::CachedRange, size),
+              uint64_t { 12 });
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Texture larger than its pixels") {
+        patch(getSectionOffset(kal::MeshCacheSection::Textures) + offsetof(kal::CachedTexture, mipLevels), uint32_t { 2 });
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+        patch(getSectionOffset(kal::MeshCacheSection::Textures) + offsetof(kal::CachedTexture, mipLevels), uint32_t { 1 });
+        patch(getSectionOffset(kal::MeshCacheSection::Textures) + offsetof(kal::CachedTexture, compression),
+              krypton::util::BlockCompression::BC1);
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Instance of a missing mesh") {
+        patch(getSectionOffset(kal::MeshCacheSection::Instances) + offsetof(ka::MeshInstance, meshIndex), uint32_t { 1 });
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Missing material") {
+        auto offset = getSectionOffset(kal::MeshCacheSection::Primitives) + offsetof(kal::CachedPrimitive, materialIndex);
+        patch(offset, ka::Index { 1 });
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Missing texture") {
+        patch(getSectionOffset(kal::MeshCacheSection::Materials) + offsetof(ka::Material, normalTextureIndex), ka::Index { 1 });
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    // The rest of the primitive data is referenced by the cached primitive.
+    kal::CachedPrimitive primitive;
+    std::memcpy(&primitive, &contents[getSectionOffset(kal::MeshCacheSection::Primitives)], sizeof(primitive));
+    const auto vertexCount = static_cast<uint32_t>(loader.meshes[0]->primitives[0].vertices.size());
+
+    SECTION("Index of a missing vertex") {
+        REQUIRE(primitive.indexType == ka::IndexType::Uint16);
+        patch(primitive.indices.offset + 2, static_cast<uint16_t>(vertexCount));
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Level of detail index of a missing vertex") {
+        kal::CachedLod lod;
+        std::memcpy(&lod, &contents[getSectionOffset(kal::MeshCacheSection::Lods)], sizeof(lod));
+        patch(lod.indices.offset, static_cast<uint16_t>(vertexCount));
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Morph target of a missing vertex") {
+        kal::CachedMorphTarget target;
+        std::memcpy(&target, &contents[getSectionOffset(kal::MeshCacheSection::MorphTargets)], sizeof(target));
+        patch(target.vertices.offset + target.vertices.size - sizeof(uint32_t), vertexCount);
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    SECTION("Meshlet vertex of a missing vertex") {
+        patch(primitive.meshletVertices.offset, vertexCount);
+        writeFile(path, contents);
+        CHECK(!cache.open(path));
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(source);
+}
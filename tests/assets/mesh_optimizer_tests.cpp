@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <assets/processing/mesh_optimizer.hpp>
+
+#include "test_meshes.hpp"
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+namespace kt = krypton::tests;
+
+namespace {
+    // Shuffles the triangles, which is about the worst case for the vertex cache.
+    void shuffleTriangles(std::vector<uint32_t>& indices) {
+        std::vector<uint32_t> order(indices.size() / 3);
+        for (uint32_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(1337));
+
+        std::vector<uint32_t> shuffled;
+        shuffled.reserve(indices.size());
+        for (auto triangle : order)
+            shuffled.insert(shuffled.end(), indices.begin() + triangle * 3, indices.begin() + triangle * 3 + 3);
+        indices = std::move(shuffled);
+    }
+} // namespace
+
+TEST_CASE("optimizeVertexCache improves the ACMR and keeps the triangles", "[assets][optimizer]") {
+    auto primitive = kt::createGrid(32);
+    auto indices = primitive.indices.toUint32();
+    shuffleTriangles(indices);
+    auto before = kap::analyzeVertexCache(indices, primitive.vertices.size());
+
+    std::vector<uint32_t> optimized(indices.size());
+    kap::optimizeVertexCache(indices, primitive.vertices.size(), optimized);
+    auto after = kap::analyzeVertexCache(optimized, primitive.vertices.size());
+
+    CHECK(before.getAcmr() > 1.5f);
+    CHECK(after.getAcmr() < 0.8f);
+    CHECK(after.triangleCount == before.triangleCount);
+    CHECK(kt::getSortedTriangles(optimized) == kt::getSortedTriangles(indices));
+}
+
+TEST_CASE("optimizePrimitive keeps the triangles", "[assets][optimizer]") {
+    auto primitive = kt::createGrid(32);
+    auto indices = primitive.indices.toUint32();
+    shuffleTriangles(indices);
+    primitive.indices.assign(indices, primitive.indices.getType());
+
+    // The padding survives every reordering of the vertices, so it identifies the original vertex.
+    for (std::size_t i = 0; i < primitive.vertices.size(); ++i)
+        primitive.vertices[i].padding.x = static_cast<float>(i);
+    const auto vertexCount = primitive.vertices.size();
+
+    auto statistics = kap::optimizePrimitive(primitive, {});
+    CHECK(statistics.after.getAcmr() < statistics.before.getAcmr());
+    CHECK(statistics.after.triangleCount == statistics.before.triangleCount);
+    REQUIRE(primitive.vertices.size() == vertexCount);
+
+    auto optimized = primitive.indices.toUint32();
+    for (auto& index : optimized)
+        index = static_cast<uint32_t>(primitive.vertices[index].padding.x);
+    CHECK(kt::getSortedTriangles(optimized) == kt::getSortedTriangles(indices));
+
+    // The vertices are stored in the order they are first used.
+    uint32_t nextVertex = 0;
+    for (auto index : primitive.indices.toUint32()) {
+        REQUIRE(index <= nextVertex);
+        if (index == nextVertex)
+            ++nextVertex;
+    }
+}
+
+TEST_CASE("optimizePrimitive welds duplicate vertices", "[assets][optimizer]") {
+    // Every triangle has its own vertices, which is what flat normals or unindexed files give us.
+    auto primitive = kt::createGrid(8);
+    auto indices = primitive.indices.toUint32();
+    std::vector<ka::Vertex> vertices;
+    for (auto& index : indices) {
+        vertices.push_back(primitive.vertices[index]);
+        index = static_cast<uint32_t>(vertices.size() - 1);
+    }
+    primitive.vertices = std::move(vertices);
+    primitive.indices.assign(indices, ka::getNarrowestIndexType(primitive.vertices.size()));
+
+    kap::optimizePrimitive(primitive, {});
+    CHECK(primitive.vertices.size() == 9 * 9);
+    CHECK(primitive.indices.size() == indices.size());
+    CHECK(primitive.indices.getType() == ka::IndexType::Uint16);
+}
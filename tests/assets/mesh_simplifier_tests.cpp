@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <assets/processing/mesh_simplifier.hpp>
+
+#include "test_meshes.hpp"
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+namespace kt = krypton::tests;
+
+TEST_CASE("generateLods reduces the triangle count with growing errors", "[assets][simplifier]") {
+    auto primitive = kt::createCube(16, true);
+    const auto triangleCount = primitive.indices.size() / 3;
+
+    kap::LodOptions options = {};
+    options.triangleRatios = { 0.5f, 0.25f };
+    kap::generateLods(primitive, options);
+    REQUIRE(primitive.lods.size() == options.triangleRatios.size());
+
+    auto previousTriangleCount = triangleCount;
+    auto previousError = 0.0f;
+    for (std::size_t i = 0; i < primitive.lods.size(); ++i) {
+        const auto& lod = primitive.lods[i];
+        REQUIRE(lod.indices.size() % 3 == 0);
+        const auto lodTriangleCount = lod.indices.size() / 3;
+        CHECK(lodTriangleCount < previousTriangleCount);
+        CHECK(static_cast<float>(lodTriangleCount) <= static_cast<float>(triangleCount) * options.triangleRatios[i]);
+        CHECK(lod.error > previousError);
+        CHECK(lod.indices.getType() == primitive.indices.getType());
+
+        // The levels share the vertex buffer of the full primitive.
+        for (auto index : lod.indices.toUint32())
+            REQUIRE(index < primitive.vertices.size());
+        previousTriangleCount = lodTriangleCount;
+        previousError = lod.error;
+    }
+
+    // The simplified sphere is inside the unit sphere, but never by more than the error.
+    for (const auto& lod : primitive.lods) {
+        auto indices = lod.indices.toUint32();
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            auto center = (kt::toVec3(primitive.vertices[indices[i]].pos) + kt::toVec3(primitive.vertices[indices[i + 1]].pos) +
+                           kt::toVec3(primitive.vertices[indices[i + 2]].pos)) /
+                          3.0f;
+            REQUIRE(1.0f - glm::length(center) <= lod.error * 1.01f);
+        }
+    }
+}
+
+TEST_CASE("generateLods stops at maxError", "[assets][simplifier]") {
+    auto primitive = kt::createCube(16, true);
+    kap::generateLods(primitive, {});
+    REQUIRE(primitive.lods.size() >= 2);
+
+    kap::LodOptions options = {};
+    options.simplify.maxError = primitive.lods[0].error;
+    auto limited = kt::createCube(16, true);
+    kap::generateLods(limited, options);
+    REQUIRE(!limited.lods.empty());
+    for (const auto& lod : limited.lods)
+        CHECK(lod.error <= options.simplify.maxError);
+}
+
+TEST_CASE("generateLods keeps flat surfaces exact", "[assets][simplifier]") {
+    // Without the cost of changing the attributes, the error is purely geometric.
+    kap::LodOptions options = {};
+    options.simplify.attributeWeight = 0.0f;
+    auto primitive = kt::createGrid(16);
+    kap::generateLods(primitive, options);
+    REQUIRE(!primitive.lods.empty());
+    for (const auto& lod : primitive.lods)
+        CHECK(lod.error == 0.0f);
+}
+
+TEST_CASE("selectLod picks the coarsest level below the error", "[assets][simplifier]") {
+    ka::Primitive primitive;
+    for (auto error : { 0.1f, 0.5f, 2.0f })
+        primitive.lods.emplace_back().error = error;
+
+    CHECK(kap::selectLod(primitive, 1.0f, 0.05f) == 0);
+    CHECK(kap::selectLod(primitive, 1.0f, 0.1f) == 1);
+    CHECK(kap::selectLod(primitive, 1.0f, 1.0f) == 2);
+    CHECK(kap::selectLod(primitive, 1.0f, 10.0f) == 3);
+    // Far away primitives have a smaller error scale and use coarser levels.
+    CHECK(kap::selectLod(primitive, 0.1f, 0.1f) == 2);
+    CHECK(kap::selectLod(ka::Primitive(), 1.0f, 10.0f) == 0);
+}
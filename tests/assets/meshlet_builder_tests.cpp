@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <assets/processing/meshlet_builder.hpp>
+
+#include "test_meshes.hpp"
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+namespace kt = krypton::tests;
+
+namespace {
+    // Checks the limits of every meshlet and returns the triangles of all meshlets as indices into the primitive.
+    auto getMeshletIndices(const ka::MeshletBuffer& buffer, std::size_t vertexCount, const kap::MeshletOptions& options)
+        -> std::vector<uint32_t> {
+        std::vector<uint32_t> indices;
+        for (const auto& meshlet : buffer.meshlets) {
+            REQUIRE(meshlet.vertexCount > 0);
+            REQUIRE(meshlet.vertexCount <= options.maxVertices);
+            REQUIRE(meshlet.triangleCount > 0);
+            REQUIRE(meshlet.triangleCount <= options.maxTriangles);
+            REQUIRE(meshlet.triangleOffset % 4 == 0);
+            REQUIRE(meshlet.vertexOffset + meshlet.vertexCount <= buffer.vertices.size());
+            REQUIRE(meshlet.triangleOffset + meshlet.triangleCount * 3 <= buffer.triangles.size());
+
+            for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+                REQUIRE(buffer.vertices[meshlet.vertexOffset + i] < vertexCount);
+            for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+                auto local = buffer.triangles[meshlet.triangleOffset + i];
+                REQUIRE(local < meshlet.vertexCount);
+                indices.push_back(buffer.vertices[meshlet.vertexOffset + local]);
+            }
+        }
+        return indices;
+    }
+} // namespace
+
+TEST_CASE("buildMeshlets respects the limits and keeps every triangle", "[assets][meshlets]") {
+    auto primitive = kt::createCube(16, true);
+    auto indices = primitive.indices.toUint32();
+
+    for (auto options : { kap::MeshletOptions {}, kap::MeshletOptions { .maxVertices = 32, .maxTriangles = 32 },
+                          kap::MeshletOptions { .maxVertices = 254, .maxTriangles = 256 } }) {
+        auto buffer = kap::buildMeshlets(indices, primitive.vertices.size(), options);
+        REQUIRE(!buffer.empty());
+        auto meshletIndices = getMeshletIndices(buffer, primitive.vertices.size(), options);
+        CHECK(kt::getSortedTriangles(meshletIndices) == kt::getSortedTriangles(indices));
+    }
+}
+
+TEST_CASE("buildMeshlets bounds contain every vertex and normal", "[assets][meshlets]") {
+    auto primitive = kt::createCube(16, true);
+    kap::buildMeshlets(primitive, {});
+    const auto& buffer = primitive.meshlets;
+    REQUIRE(!buffer.empty());
+    REQUIRE(buffer.bounds.size() == buffer.meshlets.size());
+
+    std::size_t culledMeshlets = 0;
+    for (std::size_t m = 0; m < buffer.meshlets.size(); ++m) {
+        const auto& meshlet = buffer.meshlets[m];
+        const auto& bounds = buffer.bounds[m];
+        auto center = glm::fvec3(bounds.center[0], bounds.center[1], bounds.center[2]);
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            auto position = kt::toVec3(primitive.vertices[buffer.vertices[meshlet.vertexOffset + i]].pos);
+            REQUIRE(glm::length(position - center) <= bounds.radius * 1.0001f);
+        }
+
+        // A cutoff of 1 disables culling, so there is nothing to contain.
+        if (bounds.coneCutoff >= 1.0f)
+            continue;
+        ++culledMeshlets;
+        auto axis = glm::fvec3(bounds.coneAxis[0], bounds.coneAxis[1], bounds.coneAxis[2]);
+        CHECK(std::abs(glm::length(axis) - 1.0f) < 1e-4f);
+        auto minDot = std::sqrt(1.0f - bounds.coneCutoff * bounds.coneCutoff);
+        const auto* triangles = &buffer.triangles[meshlet.triangleOffset];
+        for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+            glm::fvec3 corners[3];
+            for (uint32_t j = 0; j < 3; ++j)
+                corners[j] = kt::toVec3(primitive.vertices[buffer.vertices[meshlet.vertexOffset + triangles[i * 3 + j]]].pos);
+            auto normal = glm::normalize(glm::cross(corners[1] - corners[0], corners[2] - corners[0]));
+            REQUIRE(glm::dot(normal, axis) >= minDot - 1e-4f);
+
+            // Cameras in front of any triangle must never cull the meshlet.
+            auto position = corners[0] + normal * 0.01f;
+            const float camera[3] = { position.x, position.y, position.z };
+            REQUIRE(!ka::isMeshletBackfacing(bounds, camera));
+        }
+    }
+    // The meshlets of a finely tessellated sphere are nearly flat, so only the ones around the
+    // corners of the cube may have cones too wide for culling.
+    CHECK(culledMeshlets * 4 >= buffer.meshlets.size() * 3);
+}
@@ -0,0 +1,166 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <assets/processing/normal_generator.hpp>
+#include <util/numeric_conversion.hpp>
+
+#include "test_meshes.hpp"
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+namespace kt = krypton::tests;
+
+namespace {
+    constexpr float epsilon = 1e-4f;
+
+    bool isUnitLength(const glm::fvec3& vector) {
+        return std::abs(glm::length(vector) - 1.0f) < epsilon;
+    }
+
+    void clearNormals(ka::Primitive& primitive) {
+        for (auto& vertex : primitive.vertices)
+            vertex.normals = glm::fvec4(0.0f);
+    }
+
+    glm::fvec4 getTangent(const ka::Primitive& primitive, std::size_t vertex) {
+        const auto& tangent = primitive.tangents[vertex].tangent;
+        return glm::fvec4(krypton::util::snorm16ToFloat(tangent[0]), krypton::util::snorm16ToFloat(tangent[1]),
+                          krypton::util::snorm16ToFloat(tangent[2]), krypton::util::snorm16ToFloat(tangent[3]));
+    }
+
+    // Checks that every tangent is a unit vector orthogonal to the normal, with a valid bitangent sign.
+    void checkTangentFrames(const ka::Primitive& primitive) {
+        REQUIRE(primitive.tangents.size() == primitive.vertices.size());
+        for (std::size_t i = 0; i < primitive.vertices.size(); ++i) {
+            auto normal = kt::toVec3(primitive.vertices[i].normals);
+            auto tangent = getTangent(primitive, i);
+            REQUIRE(isUnitLength(normal));
+            REQUIRE(isUnitLength(kt::toVec3(tangent)));
+            REQUIRE(std::abs(glm::dot(normal, kt::toVec3(tangent))) < epsilon);
+            REQUIRE(std::abs(tangent.w) == 1.0f);
+        }
+    }
+} // namespace
+
+TEST_CASE("generateNormals with flat normals uses the face normals", "[assets][normals]") {
+    auto primitive = kt::createCube(2, false);
+    clearNormals(primitive);
+    kap::generateNormals(primitive, kap::NormalGeneration::Flat);
+
+    auto indices = primitive.indices.toUint32();
+    REQUIRE(primitive.vertices.size() == indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        const auto& vertex = primitive.vertices[indices[i]];
+        auto normal = kt::toVec3(vertex.normals);
+        REQUIRE(isUnitLength(normal));
+        // Every face of the cube lies on the plane at a distance of 1 along its normal.
+        REQUIRE(std::abs(glm::dot(normal, kt::toVec3(vertex.pos)) - 1.0f) < epsilon);
+    }
+}
+
+TEST_CASE("generateNormals with smooth normals averages around every position", "[assets][normals]") {
+    SECTION("Sphere") {
+        auto primitive = kt::createCube(8, true);
+        clearNormals(primitive);
+        kap::generateNormals(primitive, kap::NormalGeneration::Smooth);
+        for (const auto& vertex : primitive.vertices) {
+            auto normal = kt::toVec3(vertex.normals);
+            REQUIRE(isUnitLength(normal));
+            REQUIRE(glm::dot(normal, kt::toVec3(vertex.pos)) > 0.99f);
+        }
+    }
+
+    SECTION("Cube") {
+        // The faces don't share vertices, but they share positions along the edges.
+        auto primitive = kt::createCube(2, false);
+        clearNormals(primitive);
+        kap::generateNormals(primitive, kap::NormalGeneration::Smooth);
+        for (const auto& vertex : primitive.vertices) {
+            auto normal = kt::toVec3(vertex.normals);
+            auto position = kt::toVec3(vertex.pos);
+            REQUIRE(isUnitLength(normal));
+            // Every face meets the corners at a right angle, so they all have the same weight.
+            if (std::abs(position.x) == 1.0f && std::abs(position.y) == 1.0f && std::abs(position.z) == 1.0f)
+                REQUIRE(glm::length(normal - position / std::sqrt(3.0f)) < epsilon);
+        }
+    }
+}
+
+TEST_CASE("generateTangents follows the UVs", "[assets][normals]") {
+    SECTION("Quad") {
+        auto primitive = kt::createGrid(1);
+        kap::generateTangents(primitive);
+        REQUIRE(primitive.hasTangents);
+        checkTangentFrames(primitive);
+        for (std::size_t i = 0; i < primitive.vertices.size(); ++i) {
+            CHECK(glm::length(kt::toVec3(getTangent(primitive, i)) - glm::fvec3(1.0f, 0.0f, 0.0f)) < epsilon);
+            CHECK(getTangent(primitive, i).w == 1.0f);
+        }
+    }
+
+    SECTION("Mirrored quad") {
+        auto primitive = kt::createGrid(1);
+        for (auto& vertex : primitive.vertices)
+            vertex.uv.x = 1.0f - vertex.uv.x;
+        kap::generateTangents(primitive);
+        checkTangentFrames(primitive);
+        for (std::size_t i = 0; i < primitive.vertices.size(); ++i) {
+            CHECK(glm::length(kt::toVec3(getTangent(primitive, i)) - glm::fvec3(-1.0f, 0.0f, 0.0f)) < epsilon);
+            CHECK(getTangent(primitive, i).w == -1.0f);
+        }
+    }
+
+    SECTION("Cube") {
+        // The UVs of every face follow its u axis, and cross(normal, u) is the v axis.
+        auto primitive = kt::createCube(2, false);
+        kap::generateTangents(primitive);
+        checkTangentFrames(primitive);
+        for (std::size_t i = 0; i < primitive.vertices.size(); ++i)
+            CHECK(getTangent(primitive, i).w == 1.0f);
+    }
+
+    SECTION("Sphere with smooth normals") {
+        auto primitive = kt::createCube(8, true);
+        kap::generateNormals(primitive, kap::NormalGeneration::Smooth);
+        kap::generateTangents(primitive);
+        checkTangentFrames(primitive);
+    }
+}
+
+TEST_CASE("generateTangents splits vertices along mirrored UV seams", "[assets][normals]") {
+    // The UVs are mirrored at x = 0.5, so the left half has its u axis along -x.
+    auto primitive = kt::createGrid(2);
+    const auto vertexCount = primitive.vertices.size();
+    primitive.colors.resize(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        auto& vertex = primitive.vertices[i];
+        vertex.uv.x = std::abs(vertex.pos.x * 2.0f - 1.0f);
+        primitive.colors[i] = i;
+    }
+    kap::generateTangents(primitive);
+    checkTangentFrames(primitive);
+
+    // Only the three vertices on the seam are used by both halves.
+    REQUIRE(primitive.vertices.size() == vertexCount + 3);
+    REQUIRE(primitive.colors.size() == primitive.vertices.size());
+    for (std::size_t i = 0; i < primitive.vertices.size(); ++i) {
+        const auto& source = primitive.vertices[primitive.colors[i]];
+        CHECK(kt::toVec3(primitive.vertices[i].pos) == kt::toVec3(source.pos));
+    }
+
+    auto indices = primitive.indices.toUint32();
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        auto center = (primitive.vertices[indices[i]].pos.x + primitive.vertices[indices[i + 1]].pos.x +
+                       primitive.vertices[indices[i + 2]].pos.x) /
+                      3.0f;
+        auto sign = center < 0.5f ? -1.0f : 1.0f;
+        for (std::size_t j = 0; j < 3; ++j) {
+            const auto tangent = getTangent(primitive, indices[i + j]);
+            CHECK(glm::length(kt::toVec3(tangent) - glm::fvec3(sign, 0.0f, 0.0f)) < epsilon);
+            CHECK(tangent.w == sign);
+        }
+    }
+}
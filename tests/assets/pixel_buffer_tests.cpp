@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <utility>
+
+#include <assets/pixel_buffer.hpp>
+
+namespace ka = krypton::assets;
+
+TEST_CASE("PixelBuffer adopts memory from malloc", "[assets][pixels]") {
+    auto* memory = static_cast<std::byte*>(std::malloc(16));
+    REQUIRE(memory != nullptr);
+    for (std::size_t i = 0; i < 16; ++i)
+        memory[i] = static_cast<std::byte>(i);
+
+    ka::PixelBuffer buffer;
+    buffer.adopt(memory, 16);
+    CHECK(buffer.data() == memory);
+    CHECK(buffer.size() == 16);
+    CHECK(buffer[15] == std::byte { 15 });
+
+    // Growing keeps the contents and zeroes the rest.
+    buffer.resize(64);
+    REQUIRE(buffer.size() == 64);
+    for (std::size_t i = 0; i < 64; ++i)
+        REQUIRE(buffer[i] == (i < 16 ? static_cast<std::byte>(i) : std::byte { 0 }));
+
+    buffer.resize(8);
+    CHECK(buffer.size() == 8);
+    CHECK(buffer[7] == std::byte { 7 });
+    buffer.clear();
+    CHECK(buffer.empty());
+    CHECK(buffer.data() == nullptr);
+}
+
+TEST_CASE("PixelBuffer copies and moves like a vector", "[assets][pixels]") {
+    ka::PixelBuffer buffer;
+    buffer.resize(32);
+    std::memset(buffer.data(), 0x5A, buffer.size());
+
+    auto copy = buffer;
+    CHECK(copy == buffer);
+    CHECK(copy.data() != buffer.data());
+
+    const auto* data = buffer.data();
+    auto moved = std::move(buffer);
+    CHECK(moved.data() == data);
+    CHECK(moved == copy);
+    CHECK(buffer.empty());
+
+    auto span = std::span(moved);
+    CHECK(span.size() == 32);
+    ka::PixelBuffer assigned;
+    assigned.assign(span.first(4));
+    CHECK(assigned.size() == 4);
+    CHECK(assigned[3] == std::byte { 0x5A });
+}
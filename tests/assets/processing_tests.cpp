@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/generators/catch_generators_range.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <assets/processing/mesh_optimizer.hpp>
+#include <assets/processing/mesh_simplifier.hpp>
+#include <assets/processing/meshlet_builder.hpp>
+#include <assets/processing/normal_generator.hpp>
+
+#include "test_meshes.hpp"
+
+namespace ka = krypton::assets;
+namespace kap = krypton::assets::processing;
+namespace kt = krypton::tests;
+
+namespace {
+    struct ProcessingStage {
+        const char* name;
+        void (*process)(ka::Primitive& primitive);
+    };
+
+    // Every processing stage that only works on triangle lists.
+    const auto stages = std::to_array<ProcessingStage>({
+        { "optimizePrimitive", [](ka::Primitive& primitive) { kap::optimizePrimitive(primitive, {}); } },
+        { "generateLods", [](ka::Primitive& primitive) { kap::generateLods(primitive, {}); } },
+        { "buildMeshlets", [](ka::Primitive& primitive) { kap::buildMeshlets(primitive, {}); } },
+        { "generateNormals (flat)", [](ka::Primitive& primitive) { kap::generateNormals(primitive, kap::NormalGeneration::Flat); } },
+        { "generateNormals (smooth)", [](ka::Primitive& primitive) { kap::generateNormals(primitive, kap::NormalGeneration::Smooth); } },
+        { "generateTangents", [](ka::Primitive& primitive) { kap::generateTangents(primitive); } },
+    });
+} // namespace
+
+TEST_CASE("Processing stages leave other topologies unchanged", "[assets][processing]") {
+    const auto stage = GENERATE(from_range(stages));
+    const auto topology = GENERATE(ka::PrimitiveTopology::Points, ka::PrimitiveTopology::Lines);
+    INFO(stage.name);
+
+    // Without normals and in reverse order, so that every stage would have something to change.
+    auto primitive = kt::createCube(2, false);
+    primitive.topology = topology;
+    for (auto& vertex : primitive.vertices)
+        vertex.normals = glm::fvec4(0.0f);
+    auto indices = primitive.indices.toUint32();
+    std::reverse(indices.begin(), indices.end());
+    primitive.indices.assign(indices, primitive.indices.getType());
+    const auto original = primitive;
+
+    stage.process(primitive);
+    REQUIRE(primitive.vertices.size() == original.vertices.size());
+    CHECK(std::memcmp(primitive.vertices.data(), original.vertices.data(), primitive.vertices.size() * sizeof(ka::Vertex)) == 0);
+    CHECK(primitive.indices.getType() == original.indices.getType());
+    CHECK(primitive.indices.toUint32() == indices);
+    CHECK(primitive.lods.empty());
+    CHECK(primitive.meshlets.empty());
+    CHECK(!primitive.hasTangents);
+    CHECK(primitive.tangents.empty());
+}
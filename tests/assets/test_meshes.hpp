@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <assets/primitive.hpp>
+
+namespace krypton::tests {
+    /**
+     * A grid of size x size quads from (0, 0) to (1, 1) in the xy plane, facing +z. The UVs
+     * follow x and y, so the tangents are +x.
+     */
+    inline auto createGrid(uint32_t size) -> krypton::assets::Primitive {
+        krypton::assets::Primitive primitive;
+        for (uint32_t y = 0; y <= size; ++y) {
+            for (uint32_t x = 0; x <= size; ++x) {
+                auto& vertex = primitive.vertices.emplace_back();
+                auto u = static_cast<float>(x) / static_cast<float>(size);
+                auto v = static_cast<float>(y) / static_cast<float>(size);
+                vertex.pos = glm::fvec4(u, v, 0.0f, 1.0f);
+                vertex.normals = glm::fvec4(0.0f, 0.0f, 1.0f, 0.0f);
+                vertex.uv = glm::fvec2(u, v);
+            }
+        }
+
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                auto a = y * (size + 1) + x;
+                auto c = a + size + 1;
+                indices.insert(indices.end(), { a, a + 1, c + 1, a, c + 1, c });
+            }
+        }
+        primitive.indices.assign(indices, krypton::assets::getNarrowestIndexType(primitive.vertices.size()));
+        return primitive;
+    }
+
+    /**
+     * A cube from -1 to 1 with a grid of subdivisions x subdivisions quads on every face. The
+     * faces don't share their vertices, as every face has its own normal and UVs. If spherical
+     * is set, every vertex is projected onto the unit sphere, with its position as the normal.
+     */
+    inline auto createCube(uint32_t subdivisions, bool spherical) -> krypton::assets::Primitive {
+        // The normal and the directions of u and v of every face, where cross(u, v) is the normal.
+        static const std::array<std::array<glm::fvec3, 3>, 6> faces = { {
+            { glm::fvec3(1, 0, 0), glm::fvec3(0, 1, 0), glm::fvec3(0, 0, 1) },
+            { glm::fvec3(-1, 0, 0), glm::fvec3(0, 0, 1), glm::fvec3(0, 1, 0) },
+            { glm::fvec3(0, 1, 0), glm::fvec3(0, 0, 1), glm::fvec3(1, 0, 0) },
+            { glm::fvec3(0, -1, 0), glm::fvec3(1, 0, 0), glm::fvec3(0, 0, 1) },
+            { glm::fvec3(0, 0, 1), glm::fvec3(1, 0, 0), glm::fvec3(0, 1, 0) },
+            { glm::fvec3(0, 0, -1), glm::fvec3(0, 1, 0), glm::fvec3(1, 0, 0) },
+        } };
+
+        krypton::assets::Primitive primitive;
+        std::vector<uint32_t> indices;
+        for (const auto& [normal, uAxis, vAxis] : faces) {
+            auto first = static_cast<uint32_t>(primitive.vertices.size());
+            for (uint32_t y = 0; y <= subdivisions; ++y) {
+                for (uint32_t x = 0; x <= subdivisions; ++x) {
+                    auto u = static_cast<float>(x) / static_cast<float>(subdivisions);
+                    auto v = static_cast<float>(y) / static_cast<float>(subdivisions);
+                    auto position = normal + uAxis * (u * 2.0f - 1.0f) + vAxis * (v * 2.0f - 1.0f);
+                    if (spherical)
+                        position = glm::normalize(position);
+
+                    auto& vertex = primitive.vertices.emplace_back();
+                    vertex.pos = glm::fvec4(position, 1.0f);
+                    vertex.normals = glm::fvec4(spherical ? position : normal, 0.0f);
+                    vertex.uv = glm::fvec2(u, v);
+                }
+            }
+
+            for (uint32_t y = 0; y < subdivisions; ++y) {
+                for (uint32_t x = 0; x < subdivisions; ++x) {
+                    auto a = first + y * (subdivisions + 1) + x;
+                    auto c = a + subdivisions + 1;
+                    indices.insert(indices.end(), { a, a + 1, c + 1, a, c + 1, c });
+                }
+            }
+        }
+        primitive.indices.assign(indices, krypton::assets::getNarrowestIndexType(primitive.vertices.size()));
+        return primitive;
+    }
+
+    /**
+     * Returns the triangles of an index buffer, each rotated so that its smallest index comes
+     * first, in sorted order. This keeps the winding, so two index buffers with equal results
+     * draw exactly the same triangles.
+     */
+    inline auto getSortedTriangles(std::span<const uint32_t> indices) -> std::vector<std::array<uint32_t, 3>> {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        triangles.reserve(indices.size() / 3);
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            std::array<uint32_t, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    inline auto toVec3(const glm::fvec4& vector) -> glm::fvec3 {
+        return glm::fvec3(vector.x, vector.y, vector.z);
+    }
+} // namespace krypton::tests
@@ -0,0 +1,195 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <assets/loader/texture_streamer.hpp>
+
+namespace ka = krypton::assets;
+namespace kal = krypton::assets::loader;
+
+namespace {
+    // 256x256 RGBA8 with the full mip chain, whose levels 2 (64x64) and smaller are the tail.
+    constexpr uint32_t textureExtent = 256;
+    constexpr uint32_t tailLevel = 2;
+
+    auto createTexture() -> ka::Texture {
+        return {
+            .width = textureExtent,
+            .height = textureExtent,
+            .channels = 4,
+            .mipLevels = 9,
+        };
+    }
+
+    auto getLevelSize(uint32_t level) -> std::size_t {
+        return ka::getTextureLevelSize(createTexture(), level);
+    }
+
+    auto getTailSize() -> std::size_t {
+        std::size_t size = 0;
+        for (uint32_t level = tailLevel; level < createTexture().mipLevels; ++level)
+            size += getLevelSize(level);
+        return size;
+    }
+
+    /**
+     * Writes all levels of a texture into a file, every byte of a level holding the level index
+     * and the given tag, and maps it.
+     */
+    auto createSource(uint8_t tag) -> kal::TextureLevelSource {
+        static uint32_t fileIndex = 0;
+        const auto name = "krypton_texture_streamer_tests" + std::to_string(fileIndex++) + ".bin";
+        const auto path = std::filesystem::temp_directory_path() / name;
+        kal::TextureLevelSource source;
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            uint64_t offset = 0;
+            for (uint32_t level = 0; level < createTexture().mipLevels; ++level) {
+                const auto size = getLevelSize(level);
+                const std::vector<char> pixels(size, static_cast<char>(tag << 4 | level));
+                file.write(pixels.data(), static_cast<std::streamsize>(size));
+                source.levels.push_back({ offset, size });
+                offset += size;
+            }
+        }
+
+        // The mapping stays valid after the file is removed, where that is possible at all.
+        auto file = std::make_shared<krypton::util::MappedFile>();
+        REQUIRE(file->open(path));
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        source.file = std::move(file);
+        return source;
+    }
+
+    // Checks that the resident pixels are exactly the levels from firstLevel on.
+    void checkResidentPixels(const kal::ResidentTexture& resident, uint8_t tag) {
+        REQUIRE(resident.levelCount == createTexture().mipLevels - resident.firstLevel);
+        REQUIRE(resident.width == textureExtent >> resident.firstLevel);
+        std::size_t offset = 0;
+        for (auto level = resident.firstLevel; level < createTexture().mipLevels; ++level) {
+            const auto size = getLevelSize(level);
+            REQUIRE(offset + size <= resident.pixels->size());
+            for (std::size_t i = 0; i < size; ++i)
+                REQUIRE((*resident.pixels)[offset + i] == static_cast<std::byte>(tag << 4 | level));
+            offset += size;
+        }
+        REQUIRE(offset == resident.pixels->size());
+    }
+
+    void update(kal::TextureStreamer& streamer) {
+        streamer.update();
+        streamer.waitForPendingLoads();
+    }
+} // namespace
+
+TEST_CASE("Texture streamers read the tail when a texture is added", "[assets][texture_streamer]") {
+    kal::TextureStreamer streamer;
+    uint32_t index = 0;
+    REQUIRE(streamer.addTexture(createTexture(), createSource(1), index));
+    CHECK(index == 0);
+
+    const auto resident = streamer.getResidentTexture(index);
+    CHECK(resident.firstLevel == tailLevel);
+    checkResidentPixels(resident, 1);
+    CHECK(streamer.getResidentSize() == getTailSize());
+
+    SECTION("Invalid sources") {
+        auto source = createSource(1);
+        source.levels.pop_back();
+        CHECK(!streamer.addTexture(createTexture(), source, index));
+
+        source = createSource(1);
+        source.levels[3].size += 1;
+        CHECK(!streamer.addTexture(createTexture(), source, index));
+
+        source = createSource(1);
+        source.levels.back().offset = source.file->size();
+        CHECK(!streamer.addTexture(createTexture(), source, index));
+        CHECK(streamer.getResidentSize() == getTailSize());
+    }
+}
+
+TEST_CASE("Texture streamers read the largest deficit first", "[assets][texture_streamer]") {
+    kal::TextureStreamer streamer({ .maxPendingLoads = 1 });
+    uint32_t first = 0, second = 0;
+    REQUIRE(streamer.addTexture(createTexture(), createSource(1), first));
+    REQUIRE(streamer.addTexture(createTexture(), createSource(2), second));
+
+    // The first texture is one level short of its request, the second one two levels.
+    streamer.requestExtent(first, textureExtent / 2);
+    streamer.requestExtent(second, textureExtent);
+    update(streamer);
+    CHECK(streamer.getResidentTexture(first).firstLevel == tailLevel);
+    CHECK(streamer.getResidentTexture(second).firstLevel == tailLevel - 1);
+
+    // Both are one level short now, and one level is read per update.
+    update(streamer);
+    update(streamer);
+    CHECK(streamer.getResidentTexture(first).firstLevel == 1);
+    CHECK(streamer.getResidentTexture(second).firstLevel == 0);
+    checkResidentPixels(streamer.getResidentTexture(first), 1);
+    checkResidentPixels(streamer.getResidentTexture(second), 2);
+    CHECK(streamer.getResidentSize() == 2 * getTailSize() + 2 * getLevelSize(1) + getLevelSize(0));
+
+    // Requests within a frame are combined into the largest one.
+    streamer.requestExtent(first, textureExtent);
+    streamer.requestExtent(first, 1);
+    update(streamer);
+    CHECK(streamer.getResidentTexture(first).firstLevel == 0);
+}
+
+TEST_CASE("Texture streamers evict levels to stay within the budget", "[assets][texture_streamer]") {
+    // Room for both tails and a single 128x128 level.
+    kal::TextureStreamer streamer({ .memoryBudget = 2 * getTailSize() + getLevelSize(1) });
+    uint32_t first = 0, second = 0;
+    REQUIRE(streamer.addTexture(createTexture(), createSource(1), first));
+    REQUIRE(streamer.addTexture(createTexture(), createSource(2), second));
+
+    streamer.requestExtent(first, textureExtent / 2);
+    update(streamer);
+    REQUIRE(streamer.getResidentTexture(first).firstLevel == 1);
+    const auto version = streamer.getResidentTexture(first).version;
+
+    // The second texture was requested more recently, so the first one gives up its level.
+    streamer.requestExtent(second, textureExtent / 2);
+    update(streamer);
+    CHECK(streamer.getResidentTexture(first).firstLevel == tailLevel);
+    CHECK(streamer.getResidentTexture(first).version > version);
+    CHECK(streamer.getResidentTexture(second).firstLevel == 1);
+    checkResidentPixels(streamer.getResidentTexture(first), 1);
+    checkResidentPixels(streamer.getResidentTexture(second), 2);
+    CHECK(streamer.getResidentSize() == 2 * getTailSize() + getLevelSize(1));
+
+    // The full resolution level doesn't fit at all, and nothing else is evicted trying to make room for it.
+    streamer.requestExtent(second, textureExtent);
+    update(streamer);
+    CHECK(streamer.getResidentTexture(second).firstLevel == 1);
+    CHECK(streamer.getResidentSize() == 2 * getTailSize() + getLevelSize(1));
+}
+
+TEST_CASE("Texture streamers never evict the tails", "[assets][texture_streamer]") {
+    // The tails alone already exceed the budget.
+    kal::TextureStreamer streamer({ .memoryBudget = getTailSize() });
+    uint32_t first = 0, second = 0;
+    REQUIRE(streamer.addTexture(createTexture(), createSource(1), first));
+    REQUIRE(streamer.addTexture(createTexture(), createSource(2), second));
+    CHECK(streamer.getResidentSize() == 2 * getTailSize());
+
+    for (int i = 0; i < 3; ++i) {
+        streamer.requestExtent(second, textureExtent);
+        update(streamer);
+    }
+    for (const auto index : { first, second }) {
+        CHECK(streamer.getResidentTexture(index).firstLevel == tailLevel);
+        checkResidentPixels(streamer.getResidentTexture(index), index == first ? 1 : 2);
+    }
+    CHECK(streamer.getResidentSize() == 2 * getTailSize());
+}
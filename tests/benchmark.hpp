@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+#include <fmt/core.h>
+
+namespace krypton::tests {
+    /**
+     * Runs the given function a few times and prints the best throughput in elements per second.
+     * Benchmarks are tagged with [.benchmark] so that they don't run with the normal tests and
+     * have to be explicitly selected, e.g. with `tests "[.benchmark]"`.
+     */
+    template <typename Function>
+    void measureThroughput(std::string_view name, std::size_t elementCount, Function&& function, std::size_t iterations = 10) {
+        using clock = std::chrono::steady_clock;
+        auto best = clock::duration::max();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            auto start = clock::now();
+            function();
+            best = std::min(best, clock::now() - start);
+        }
+
+        auto seconds = std::chrono::duration<double>(best).count();
+        fmt::print("{:<48} {:>10.2f} M elements/s\n", name, static_cast<double>(elementCount) / seconds / 1e6);
+    }
+} // namespace krypton::tests
@@ -0,0 +1,164 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <util/block_compression.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+namespace {
+    // A smooth gradient with some noise, which is roughly what photos and albedo textures look like.
+    std::vector<std::byte> createTestImage(uint32_t width, uint32_t height) {
+        std::mt19937 rng(1337);
+        std::uniform_int_distribution<int> noise(-8, 8);
+        std::vector<std::byte> pixels(static_cast<std::size_t>(width) * height * 4);
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                const int values[4] = {
+                    static_cast<int>(x * 255 / width),
+                    static_cast<int>(y * 255 / height),
+                    static_cast<int>((x + y) * 127 / (width + height)) + 64,
+                    static_cast<int>(255 - x * 128 / width),
+                };
+                auto* pixel = &pixels[(static_cast<std::size_t>(y) * width + x) * 4];
+                for (std::size_t c = 0; c < 4; ++c)
+                    pixel[c] = static_cast<std::byte>(std::clamp(values[c] + noise(rng), 0, 255));
+            }
+        }
+        return pixels;
+    }
+
+    // The peak signal to noise ratio over the given channels, in dB.
+    double getPsnr(const std::vector<std::byte>& a, const std::vector<std::byte>& b, std::size_t channelCount) {
+        double error = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (i % 4 >= channelCount)
+                continue;
+            const auto difference = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+            error += difference * difference;
+        }
+        const auto meanError = error / static_cast<double>(a.size() / 4 * channelCount);
+        return meanError == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 / meanError);
+    }
+
+    std::size_t getEncodedChannelCount(ku::BlockCompression compression) {
+        switch (compression) {
+            case ku::BlockCompression::BC1:
+                return 3;
+            case ku::BlockCompression::BC4:
+                return 1;
+            case ku::BlockCompression::BC5:
+                return 2;
+            default:
+                return 4;
+        }
+    }
+
+    double compressAndMeasure(const std::vector<std::byte>& pixels, uint32_t width, uint32_t height, ku::BlockCompression compression) {
+        std::vector<std::byte> compressed(ku::getCompressedImageSize(width, height, compression));
+        ku::compressImage(pixels, width, height, compression, compressed, 0, ku::getCompressedBlockCount(height));
+        std::vector<std::byte> decompressed(pixels.size());
+        ku::decompressImage(compressed, width, height, compression, decompressed);
+        return getPsnr(pixels, decompressed, getEncodedChannelCount(compression));
+    }
+} // namespace
+
+TEST_CASE("Block compression sizes", "[block_compression]") {
+    REQUIRE(ku::getCompressedBlockSize(ku::BlockCompression::BC1) == 8);
+    REQUIRE(ku::getCompressedBlockSize(ku::BlockCompression::BC7) == 16);
+    REQUIRE(ku::getCompressedBlockCount(1) == 1);
+    REQUIRE(ku::getCompressedBlockCount(8) == 2);
+    REQUIRE(ku::getCompressedImageSize(13, 7, ku::BlockCompression::BC4) == 4 * 2 * 8);
+    REQUIRE(ku::getCompressedImageSize(13, 7, ku::BlockCompression::BC5) == 4 * 2 * 16);
+}
+
+TEST_CASE("Block encoding", "[block_compression]") {
+    SECTION("Uniform blocks") {
+        uint8_t pixels[64];
+        for (std::size_t i = 0; i < 64; ++i)
+            pixels[i] = static_cast<uint8_t>(i % 4 == 3 ? 200 : 96);
+
+        std::byte block[16];
+        uint8_t decoded[64];
+        for (auto compression : { ku::BlockCompression::BC4, ku::BlockCompression::BC5 }) {
+            ku::encodeBlock(compression, pixels, block);
+            ku::decodeBlock(compression, block, decoded);
+            for (std::size_t i = 0; i < 64; ++i)
+                if (i % 4 < getEncodedChannelCount(compression))
+                    REQUIRE(decoded[i] == pixels[i]);
+        }
+
+        // The alpha of BC3 is exact, the colors are rounded to 5 and 6 bits.
+        ku::encodeBlock(ku::BlockCompression::BC3, pixels, block);
+        ku::decodeBlock(ku::BlockCompression::BC3, block, decoded);
+        for (std::size_t i = 0; i < 64; ++i)
+            REQUIRE(std::abs(static_cast<int>(decoded[i]) - static_cast<int>(pixels[i])) <= (i % 4 == 3 ? 0 : 4));
+
+        // BC7 endpoints have 8 bits with the p-bits, so uniform colors are exact too.
+        ku::encodeBlock(ku::BlockCompression::BC7, pixels, block);
+        ku::decodeBlock(ku::BlockCompression::BC7, block, decoded);
+        for (std::size_t i = 0; i < 64; ++i)
+            REQUIRE(decoded[i] == pixels[i]);
+        // Mode 6 is a single bit at position 6.
+        REQUIRE((static_cast<uint8_t>(block[0]) & 0x7F) == 0x40);
+    }
+
+    SECTION("Two values") {
+        // Two values can always be represented exactly by the single channel formats.
+        uint8_t pixels[64] = {};
+        for (std::size_t i = 0; i < 16; ++i) {
+            pixels[i * 4] = static_cast<uint8_t>(i % 3 == 0 ? 17 : 230);
+            pixels[i * 4 + 1] = static_cast<uint8_t>(i % 2 == 0 ? 0 : 255);
+        }
+
+        std::byte block[16];
+        uint8_t decoded[64];
+        ku::encodeBlock(ku::BlockCompression::BC5, pixels, block);
+        ku::decodeBlock(ku::BlockCompression::BC5, block, decoded);
+        for (std::size_t i = 0; i < 16; ++i) {
+            REQUIRE(decoded[i * 4] == pixels[i * 4]);
+            REQUIRE(decoded[i * 4 + 1] == pixels[i * 4 + 1]);
+            REQUIRE(decoded[i * 4 + 2] == 0);
+            REQUIRE(decoded[i * 4 + 3] == 255);
+        }
+    }
+}
+
+TEST_CASE("Image compression quality", "[block_compression]") {
+    // Odd sizes, so that the edge blocks are only partially covered.
+    constexpr uint32_t width = 67, height = 45;
+    const auto pixels = createTestImage(width, height);
+
+    const auto bc1 = compressAndMeasure(pixels, width, height, ku::BlockCompression::BC1);
+    const auto bc3 = compressAndMeasure(pixels, width, height, ku::BlockCompression::BC3);
+    const auto bc4 = compressAndMeasure(pixels, width, height, ku::BlockCompression::BC4);
+    const auto bc5 = compressAndMeasure(pixels, width, height, ku::BlockCompression::BC5);
+    const auto bc7 = compressAndMeasure(pixels, width, height, ku::BlockCompression::BC7);
+    REQUIRE(bc1 > 30.0);
+    REQUIRE(bc3 > 30.0);
+    REQUIRE(bc4 > 35.0);
+    REQUIRE(bc5 > 35.0);
+    REQUIRE(bc7 > 35.0);
+    REQUIRE(bc7 > bc3);
+}
+
+TEST_CASE("Block compression benchmarks", "[.benchmark]") {
+    constexpr uint32_t size = 1024;
+    const auto pixels = createTestImage(size, size);
+    for (auto compression : { ku::BlockCompression::BC1, ku::BlockCompression::BC3, ku::BlockCompression::BC4, ku::BlockCompression::BC5,
+                              ku::BlockCompression::BC7 }) {
+        const auto name = fmt::format("BC{} encode", static_cast<uint32_t>(compression));
+        std::vector<std::byte> compressed(ku::getCompressedImageSize(size, size, compression));
+        krypton::tests::measureThroughput(
+            name, size * size, [&]() { ku::compressImage(pixels, size, size, compression, compressed, 0, size / 4); }, 3);
+        fmt::print("{:<48} {:>10.2f} dB PSNR\n", name, compressAndMeasure(pixels, size, size, compression));
+    }
+}
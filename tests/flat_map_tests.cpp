@@ -0,0 +1,154 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <util/flat_map.hpp>
+#include <util/hash.hpp>
+#include <util/string_interner.hpp>
+
+namespace ku = krypton::util;
+
+TEST_CASE("64-bit hash", "[hash]") {
+    // Reference values of XXH64 with a seed of 0.
+    REQUIRE(ku::hashString("") == 0xEF46DB3751D8E999ULL);
+    REQUIRE(ku::hashString("a") == 0xD24EC4F1A98C6E5BULL);
+
+    // Every length up to and beyond the 32 byte stripe should hash differently.
+    std::string text = "The quick brown fox jumps over the lazy dog, twice over.";
+    std::unordered_map<uint64_t, std::size_t> seen;
+    for (std::size_t i = 0; i <= text.size(); ++i) {
+        auto hash = ku::hashString(std::string_view(text).substr(0, i));
+        REQUIRE(seen.emplace(hash, i).second);
+    }
+    REQUIRE(ku::hashString(text, 1) != ku::hashString(text, 2));
+}
+
+TEST_CASE("Flat map", "[flat_map]") {
+    ku::FlatMap<uint64_t, uint32_t> map;
+
+    SECTION("Basic operations") {
+        REQUIRE(map.empty());
+        REQUIRE(map.find(5) == nullptr);
+        REQUIRE(!map.erase(5));
+
+        REQUIRE(map.insert(5, 10).second);
+        REQUIRE(!map.insert(5, 20).second);
+        REQUIRE(*map.find(5) == 10);
+
+        map[6] = 12;
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.contains(6));
+
+        REQUIRE(map.erase(5));
+        REQUIRE(!map.contains(5));
+        REQUIRE(map.size() == 1);
+    }
+
+    SECTION("Matches std::unordered_map") {
+        // Small keys collide a lot, which exercises the backward shift on erase.
+        std::unordered_map<uint64_t, uint32_t> reference;
+        std::mt19937_64 random(1234);
+        for (uint32_t i = 0; i < 100000; ++i) {
+            auto key = random() % 2048;
+            switch (random() % 3) {
+                case 0:
+                case 1:
+                    REQUIRE(map.insert(key, i).second == reference.emplace(key, i).second);
+                    break;
+                case 2:
+                    REQUIRE(map.erase(key) == (reference.erase(key) != 0));
+                    break;
+            }
+        }
+
+        REQUIRE(map.size() == reference.size());
+        for (auto& [key, value] : reference) {
+            auto* found = map.find(key);
+            REQUIRE(found != nullptr);
+            REQUIRE(*found == value);
+        }
+
+        std::size_t visited = 0;
+        map.forEach([&](uint64_t key, uint32_t value) {
+            REQUIRE(reference.at(key) == value);
+            ++visited;
+        });
+        REQUIRE(visited == reference.size());
+    }
+
+    SECTION("Reserve") {
+        map.reserve(1000);
+        auto capacity = map.capacity();
+        for (uint32_t i = 0; i < 1000; ++i)
+            map.insert(i, i);
+        REQUIRE(map.capacity() == capacity);
+    }
+}
+
+TEST_CASE("Flat set", "[flat_map]") {
+    ku::FlatSet<uint32_t> set;
+    REQUIRE(set.insert(1));
+    REQUIRE(!set.insert(1));
+    REQUIRE(set.contains(1));
+    REQUIRE(set.erase(1));
+    REQUIRE(set.empty());
+}
+
+TEST_CASE("String interner", "[string_interner]") {
+    ku::StringInterner interner;
+
+    SECTION("Ids") {
+        REQUIRE(interner.find("VK_KHR_swapchain") == ku::InternedString::Invalid);
+
+        auto swapchain = interner.intern("VK_KHR_swapchain");
+        auto portability = interner.intern("VK_KHR_portability_subset");
+        REQUIRE(swapchain != portability);
+        REQUIRE(interner.intern(std::string("VK_KHR_swapchain")) == swapchain);
+        REQUIRE(interner.find("VK_KHR_swapchain") == swapchain);
+        REQUIRE(interner.size() == 2);
+
+        REQUIRE(interner.getString(portability) == "VK_KHR_portability_subset");
+        REQUIRE(std::string_view(interner.getCString(swapchain)) == "VK_KHR_swapchain");
+
+        auto empty = interner.intern("");
+        REQUIRE(interner.getString(empty).empty());
+    }
+
+    SECTION("Stable storage") {
+        auto first = interner.intern("first");
+        const char* pointer = interner.getCString(first);
+
+        // Force multiple blocks and a large string that gets its own allocation.
+        for (uint32_t i = 0; i < 10000; ++i)
+            interner.intern("string number " + std::to_string(i));
+        auto large = interner.intern(std::string(64 * 1024, 'x'));
+
+        REQUIRE(interner.getCString(first) == pointer);
+        REQUIRE(interner.getString(large).size() == 64 * 1024);
+        REQUIRE(interner.find("string number 9999") != ku::InternedString::Invalid);
+        REQUIRE(interner.find("string number 10000") == ku::InternedString::Invalid);
+    }
+
+    SECTION("Concurrent interning") {
+        constexpr uint32_t threadCount = 4;
+        constexpr uint32_t stringCount = 2000;
+        std::vector<std::vector<ku::InternedString>> ids(threadCount);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t i = 0; i < stringCount; ++i)
+                    ids[t].emplace_back(interner.intern(std::to_string(i)));
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(interner.size() == stringCount);
+        for (uint32_t t = 1; t < threadCount; ++t)
+            REQUIRE(ids[t] == ids[0]);
+    }
+}
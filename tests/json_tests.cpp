@@ -0,0 +1,195 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <util/json.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+namespace {
+    // A byte by byte version of findJsonStructurals to compare the kernels against. Like the
+    // kernels, this resolves escapes everywhere, even though they are only valid in strings.
+    std::vector<uint32_t> referenceStructurals(std::string_view json) {
+        std::vector<bool> escaped(json.size() + 1, false);
+        for (std::size_t i = 0; i < json.size(); ++i)
+            if (json[i] == '\\' && !escaped[i])
+                escaped[i + 1] = true;
+
+        std::vector<uint32_t> positions;
+        bool inString = false, previousScalar = false;
+        for (std::size_t i = 0; i < json.size(); ++i) {
+            const char c = json[i];
+            const bool quote = c == '"' && !escaped[i];
+            if (inString || quote) {
+                if (quote && !inString)
+                    positions.push_back(static_cast<uint32_t>(i));
+                inString = quote ? !inString : inString;
+                previousScalar = false;
+                continue;
+            }
+            const bool structural = c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+            const bool scalar = !structural && c != ' ' && c != '\t' && c != '\n' && c != '\r' && c != '"';
+            if (structural || (scalar && !previousScalar))
+                positions.push_back(static_cast<uint32_t>(i));
+            previousScalar = scalar;
+        }
+        return positions;
+    }
+
+    // Roughly what the JSON of a large glTF looks like.
+    std::string createGltfLikeJson(std::size_t accessorCount) {
+        std::string json = R"({"asset":{"version":"2.0","generator":"krypton \"tests\""},"accessors":[)";
+        for (std::size_t i = 0; i < accessorCount; ++i) {
+            json += fmt::format(R"({{"bufferView":{},"byteOffset":{},"componentType":5126,"count":{},"type":"VEC3",)"
+                                R"("min":[-1.5,-0.25,-3e-2],"max":[1.5,0.25,3E2],"name":"accessor {}"}})",
+                                i / 4, i * 12, 1000 + i % 97, i);
+            json += i + 1 < accessorCount ? "," : "";
+        }
+        json += "]}";
+        return json;
+    }
+} // namespace
+
+TEST_CASE("JSON structurals", "[json]") {
+    SECTION("Strings hide their contents") {
+        const std::string json = R"({"a{b":[1, "c\"d", true], "e\\":null})";
+        std::vector<uint32_t> positions;
+        REQUIRE(ku::findJsonStructurals(json, positions));
+        REQUIRE(positions == referenceStructurals(json));
+    }
+
+    SECTION("Random documents") {
+        // Long runs of backslashes and strings crossing the 64 byte blocks are the interesting cases.
+        std::mt19937 rng(1337);
+        const char alphabet[] = "{}[]:, \n\"\\\\\\ab1-";
+        std::uniform_int_distribution<std::size_t> character(0, sizeof(alphabet) - 2);
+        std::uniform_int_distribution<std::size_t> length(0, 300);
+        for (int document = 0; document < 500; ++document) {
+            std::string json(length(rng), ' ');
+            for (auto& c : json)
+                c = alphabet[character(rng)];
+            std::vector<uint32_t> positions;
+            const bool closed = ku::findJsonStructurals(json, positions);
+            auto expected = referenceStructurals(json);
+            if (closed)
+                REQUIRE(positions == expected);
+        }
+    }
+
+    SECTION("Unterminated strings") {
+        std::vector<uint32_t> positions;
+        REQUIRE(!ku::findJsonStructurals(R"({"a": "b)", positions));
+        REQUIRE(!ku::findJsonStructurals(R"(["\"])", positions));
+        REQUIRE(ku::findJsonStructurals(R"(["\\"])", positions));
+    }
+}
+
+TEST_CASE("JSON parsing", "[json]") {
+    ku::JsonDocument document;
+
+    SECTION("Values") {
+        REQUIRE(document.parse(R"( {"name": "box", "count": 24, "scale": [1.5, -2e3, 0.25], "visible": true,
+                                    "parent": null, "empty": {}, "list": []} )"));
+        auto root = document.getRoot();
+        REQUIRE(root.isObject());
+        REQUIRE(root.size() == 7);
+        REQUIRE(root["name"].getString() == "box");
+        REQUIRE(root["count"].getUint() == 24);
+        REQUIRE(root["count"].getInt() == 24);
+        REQUIRE(root["scale"].size() == 3);
+        REQUIRE(root["scale"][1].getNumber() == -2000.0);
+        REQUIRE(root["scale"][2].getFloat() == 0.25f);
+        REQUIRE(root["visible"].getBool());
+        REQUIRE(root["parent"].exists());
+        REQUIRE(root["parent"].getType() == ku::JsonType::Null);
+        REQUIRE(root["empty"].isObject());
+        REQUIRE(root["empty"].size() == 0);
+        REQUIRE(root["list"].begin() == root["list"].end());
+
+        // Missing values and values of the wrong type return the fallback.
+        REQUIRE(!root["missing"].exists());
+        REQUIRE(root["missing"]["deeper"][3].getUint(7) == 7);
+        REQUIRE(root["name"].getNumber(-1.0) == -1.0);
+        REQUIRE(root["scale"][0].getUint(5) == 5);
+        REQUIRE(root["scale"][3].getFloat(1.0f) == 1.0f);
+
+        std::vector<std::string_view> keys;
+        for (auto member : root)
+            keys.push_back(member.getKey());
+        REQUIRE(keys == std::vector<std::string_view> { "name", "count", "scale", "visible", "parent", "empty", "list" });
+
+        float sum = 0.0f;
+        for (auto element : root["scale"])
+            sum += element.getFloat();
+        REQUIRE(sum == 1.5f - 2000.0f + 0.25f);
+    }
+
+    SECTION("Escapes") {
+        REQUIRE(document.parse(R"({"a\"b": "c\\d\/e\n", "u": "\u00e9\u20ac\ud83d\ude00", "plain": "no escapes"})"));
+        auto root = document.getRoot();
+        REQUIRE(root["a\"b"].getString() == "c\\d/e\n");
+        REQUIRE(root["u"].getString() == "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+        REQUIRE(root["plain"].getString() == "no escapes");
+    }
+
+    SECTION("Scalars at the root") {
+        REQUIRE(document.parse("-0.5"));
+        REQUIRE(document.getRoot().getNumber() == -0.5);
+        REQUIRE(document.parse(" \"text\" "));
+        REQUIRE(document.getRoot().getString() == "text");
+    }
+
+    SECTION("Large numbers") {
+        REQUIRE(document.parse("[12345678901234567890, 4294967296, -9007199254740993, 1e400]"));
+        auto root = document.getRoot();
+        REQUIRE(root[0].getNumber() == 12345678901234567890.0);
+        REQUIRE(root[1].getUint() == 4294967296ULL);
+        REQUIRE(root[2].getInt() == -9007199254740992LL);
+        REQUIRE(root[3].getUint(3) == 3);
+    }
+
+    SECTION("Invalid documents") {
+        for (const auto* json : { "", "   ", "{", "[1, 2", "[1 2]", "[1,]", "{\"a\" 1}", "{\"a\": 1,}", "{1: 2}", "[01]", "[1.]",
+                                  "[tru]", "[\"a\"b]", "{\"a\": 1}}", "[1] [2]", "[\"\\x\"]", "[\"\\u12\"]", "[-]", "[}" }) {
+            INFO(json);
+            REQUIRE(!document.parse(json));
+            REQUIRE(!document.getError().empty());
+            REQUIRE(!document.getRoot().exists());
+        }
+
+        std::string deep(2000, '[');
+        deep += std::string(2000, ']');
+        REQUIRE(!document.parse(deep));
+    }
+
+    SECTION("Large documents") {
+        const auto json = createGltfLikeJson(1000);
+        REQUIRE(document.parse(json));
+        auto accessors = document.getRoot()["accessors"];
+        REQUIRE(accessors.size() == 1000);
+        std::size_t i = 0;
+        for (auto accessor : accessors) {
+            REQUIRE(accessor["byteOffset"].getUint() == i * 12);
+            REQUIRE(accessor["max"][2].getNumber() == 300.0);
+            REQUIRE(accessor["name"].getString() == fmt::format("accessor {}", i));
+            ++i;
+        }
+        REQUIRE(document.getRoot()["asset"]["generator"].getString() == "krypton \"tests\"");
+    }
+}
+
+TEST_CASE("JSON benchmarks", "[.benchmark]") {
+    const auto json = createGltfLikeJson(100000);
+    std::vector<uint32_t> positions;
+    krypton::tests::measureThroughput("JSON structurals (bytes)", json.size(), [&]() { (void)ku::findJsonStructurals(json, positions); });
+
+    ku::JsonDocument document;
+    krypton::tests::measureThroughput("JSON parse (bytes)", json.size(), [&]() { (void)document.parse(json); });
+}
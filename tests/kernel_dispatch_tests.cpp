@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <numeric>
+#include <vector>
+
+#include <util/index_conversion.hpp>
+#include <util/kernel_dispatch.hpp>
+
+namespace ku = krypton::util;
+
+namespace {
+    int scalarVariant() {
+        return 0;
+    }
+
+    int avx2Variant() {
+        return 1;
+    }
+
+    int neonVariant() {
+        return 2;
+    }
+} // namespace
+
+TEST_CASE("Kernel dispatch tests", "[kernel_dispatch]") {
+    const ku::KernelDispatcher dispatcher(std::to_array<ku::KernelVariant<int()>>({
+        { ku::avx2TargetFeatures, avx2Variant },
+        { ku::CpuFeature::NEON, neonVariant },
+        { ku::CpuFeature::None, scalarVariant },
+    }));
+
+    SECTION("The best matching variant is selected") {
+        REQUIRE(dispatcher.select(ku::CpuFeature::None)() == 0);
+        REQUIRE(dispatcher.select(ku::CpuFeature::AVX2)() == 0); // FMA is also required
+        REQUIRE(dispatcher.select(ku::CpuFeature::AVX2 | ku::CpuFeature::FMA)() == 0); // And so is F16C
+        REQUIRE(dispatcher.select(ku::CpuFeature::AVX2 | ku::CpuFeature::FMA | ku::CpuFeature::F16C)() == 1);
+        REQUIRE(dispatcher.select(ku::CpuFeature::NEON)() == 2);
+    }
+
+    SECTION("The selected variant is supported by this CPU") {
+        REQUIRE(dispatcher.get() == dispatcher.select(ku::getCpuFeatures()));
+        REQUIRE(!ku::getCpuFeatureString(ku::getCpuFeatures()).empty());
+    }
+}
+
+TEST_CASE("Index widening tests", "[kernel_dispatch]") {
+    // We use an odd count so that the scalar tail of the vectorized kernels is also tested.
+    constexpr std::size_t count = 1031;
+
+    SECTION("16-bit indices") {
+        std::vector<uint16_t> indices(count);
+        for (std::size_t i = 0; i < count; ++i)
+            indices[i] = static_cast<uint16_t>(i * 61);
+
+        std::vector<uint32_t> widened(count);
+        ku::widenIndices(indices, widened);
+        for (std::size_t i = 0; i < count; ++i)
+            REQUIRE(widened[i] == indices[i]);
+    }
+
+    SECTION("8-bit indices") {
+        std::vector<uint8_t> indices(count);
+        for (std::size_t i = 0; i < count; ++i)
+            indices[i] = static_cast<uint8_t>(i * 7);
+
+        std::vector<uint32_t> widened(count);
+        ku::widenIndices(indices, widened);
+        for (std::size_t i = 0; i < count; ++i)
+            REQUIRE(widened[i] == indices[i]);
+    }
+
+    SECTION("8-bit to 16-bit indices") {
+        std::vector<uint8_t> indices(count);
+        for (std::size_t i = 0; i < count; ++i)
+            indices[i] = static_cast<uint8_t>(i * 13);
+
+        std::vector<uint16_t> widened(count);
+        ku::widenIndices(indices, widened);
+        for (std::size_t i = 0; i < count; ++i)
+            REQUIRE(widened[i] == indices[i]);
+    }
+
+    SECTION("32-bit to 16-bit indices") {
+        std::vector<uint32_t> indices(count);
+        for (std::size_t i = 0; i < count; ++i)
+            indices[i] = static_cast<uint32_t>((i * 40503) % 65536);
+
+        std::vector<uint16_t> narrowed(count);
+        ku::narrowIndices(indices, narrowed);
+        for (std::size_t i = 0; i < count; ++i)
+            REQUIRE(narrowed[i] == indices[i]);
+    }
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <util/latency_histogram.hpp>
+
+namespace ku = krypton::util;
+using namespace std::chrono_literals;
+
+TEST_CASE("Latency histogram", "[latency_histogram]") {
+    ku::LatencyHistogram histogram;
+
+    SECTION("Empty") {
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getPercentile(99.0) == 0ns);
+        REQUIRE(histogram.getMin() == 0ns);
+        REQUIRE(histogram.getMean() == 0ns);
+    }
+
+    SECTION("Small values are exact") {
+        for (int i = 1; i <= 100; ++i)
+            histogram.record(std::chrono::nanoseconds(i));
+
+        REQUIRE(histogram.getCount() == 100);
+        REQUIRE(histogram.getMin() == 1ns);
+        REQUIRE(histogram.getMax() == 100ns);
+        REQUIRE(histogram.getPercentile(50.0) == 50ns);
+        REQUIRE(histogram.getPercentile(99.0) == 99ns);
+        REQUIRE(histogram.getPercentile(100.0) == 100ns);
+        REQUIRE(histogram.getMean() == 50ns);
+    }
+
+    SECTION("Relative error is bounded") {
+        // Uniformly distributed values between 1µs and 100ms.
+        std::mt19937_64 random(42);
+        std::uniform_int_distribution<int64_t> distribution(1'000, 100'000'000);
+        std::vector<int64_t> values(100000);
+        for (auto& value : values) {
+            value = distribution(random);
+            histogram.record(std::chrono::nanoseconds(value));
+        }
+        std::sort(values.begin(), values.end());
+
+        for (double percentile : { 1.0, 50.0, 95.0, 99.0, 99.9 }) {
+            auto index = static_cast<std::size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size()))) - 1;
+            auto exact = static_cast<double>(values[index]);
+            auto reported = static_cast<double>(histogram.getPercentile(percentile).count());
+            REQUIRE(reported >= exact);
+            REQUIRE((reported - exact) / exact < 1.0 / 64.0);
+        }
+        REQUIRE(histogram.getMax().count() == values.back());
+
+        histogram.reset();
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getMax() == 0ns);
+    }
+
+    SECTION("Huge values") {
+        histogram.record(std::chrono::nanoseconds(INT64_MAX));
+        REQUIRE(histogram.getPercentile(50.0).count() == INT64_MAX);
+        histogram.record(-5ns); // Clamped to zero.
+        REQUIRE(histogram.getMin() == 0ns);
+    }
+
+    SECTION("Concurrent recording") {
+        constexpr uint32_t threadCount = 4;
+        constexpr uint32_t valuesPerThread = 100000;
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&histogram, t]() {
+                for (uint32_t i = 0; i < valuesPerThread; ++i)
+                    histogram.record(std::chrono::nanoseconds(t * 1000 + i % 1000));
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        auto summary = histogram.getSummary();
+        REQUIRE(summary.count == threadCount * valuesPerThread);
+        REQUIRE(summary.min == 0ns);
+        REQUIRE(summary.max == std::chrono::nanoseconds(threadCount * 1000 - 1));
+    }
+
+    SECTION("Scoped timer") {
+        {
+            ku::ScopedLatencyTimer timer(histogram);
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE(histogram.getCount() == 1);
+        REQUIRE(histogram.getMin() >= 1ms);
+    }
+}
@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <util/mapped_file.hpp>
+
+namespace ku = krypton::util;
+
+namespace {
+    auto writeTemporaryFile(const char* name, const std::vector<char>& contents) -> std::filesystem::path {
+        auto path = std::filesystem::temp_directory_path() / name;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        return path;
+    }
+} // namespace
+
+TEST_CASE("Mapped file tests", "[mapped_file]") {
+    SECTION("Mapping a file") {
+        std::vector<char> contents(100000);
+        for (std::size_t i = 0; i < contents.size(); ++i)
+            contents[i] = static_cast<char>(i * 31);
+        auto path = writeTemporaryFile("krypton_mapped_file_test.bin", contents);
+
+        ku::MappedFile file;
+        REQUIRE(file.open(path));
+        REQUIRE(file.isOpen());
+        REQUIRE(file.size() == contents.size());
+        REQUIRE(std::memcmp(file.getData().data(), contents.data(), contents.size()) == 0);
+
+        // Moving keeps the mapping alive.
+        ku::MappedFile moved = std::move(file);
+        REQUIRE(!file.isOpen());
+        REQUIRE(moved.size() == contents.size());
+        REQUIRE(std::memcmp(moved.getData().data(), contents.data(), contents.size()) == 0);
+
+        moved.close();
+        REQUIRE(!moved.isOpen());
+        REQUIRE(moved.getData().empty());
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Mapping an empty file") {
+        auto path = writeTemporaryFile("krypton_mapped_file_empty.bin", {});
+        ku::MappedFile file;
+        REQUIRE(file.open(path));
+        REQUIRE(file.isOpen());
+        REQUIRE(file.getData().empty());
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Mapping a missing file") {
+        ku::MappedFile file;
+        REQUIRE(!file.open(std::filesystem::temp_directory_path() / "krypton_mapped_file_missing.bin"));
+        REQUIRE(!file.isOpen());
+    }
+}
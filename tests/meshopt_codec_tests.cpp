@@ -0,0 +1,222 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <util/meshopt_codec.hpp>
+
+namespace ku = krypton::util;
+
+namespace {
+    void appendBytes(std::vector<std::byte>& out, std::initializer_list<uint8_t> bytes) {
+        for (const auto byte : bytes)
+            out.push_back(static_cast<std::byte>(byte));
+    }
+
+    auto zigzag8(uint8_t delta) -> uint8_t {
+        return static_cast<uint8_t>((delta << 1) ^ (static_cast<int8_t>(delta) >> 7));
+    }
+
+    auto getGroupSize(const uint8_t* group, uint32_t bits) -> std::size_t {
+        if (bits == 0)
+            return std::all_of(group, group + 16, [](uint8_t v) { return v == 0; }) ? 0 : SIZE_MAX;
+        if (bits == 8)
+            return 16;
+        const auto overflowCount = std::count_if(group, group + 16, [bits](uint8_t v) { return v >= (1u << bits) - 1; });
+        return 16 * bits / 8 + overflowCount;
+    }
+
+    /**
+     * A version 0 vertex encoder, which picks the smallest bit width for every group. It only
+     * needs to produce valid streams, so it is much simpler than meshoptimizer's.
+     */
+    auto encodeVertices(const std::vector<std::byte>& vertices, std::size_t stride) -> std::vector<std::byte> {
+        const auto count = vertices.size() / stride;
+        const auto blockSize = std::min<std::size_t>((8192 / stride) & ~std::size_t(15), 256);
+        std::vector<std::byte> out;
+        appendBytes(out, { 0xA0 });
+        std::vector<uint8_t> last(stride);
+        for (std::size_t k = 0; k < stride; ++k)
+            last[k] = static_cast<uint8_t>(vertices[k]);
+
+        for (std::size_t first = 0; first < count; first += blockSize) {
+            const auto blockCount = std::min(blockSize, count - first);
+            const auto alignedCount = (blockCount + 15) & ~std::size_t(15);
+            for (std::size_t k = 0; k < stride; ++k) {
+                std::vector<uint8_t> deltas(alignedCount, 0);
+                for (std::size_t i = 0; i < blockCount; ++i) {
+                    const auto value = static_cast<uint8_t>(vertices[(first + i) * stride + k]);
+                    deltas[i] = zigzag8(static_cast<uint8_t>(value - last[k]));
+                    last[k] = value;
+                }
+
+                const auto headerOffset = out.size();
+                out.resize(out.size() + (alignedCount / 16 + 3) / 4);
+                for (std::size_t group = 0; group < alignedCount / 16; ++group) {
+                    const auto* values = &deltas[group * 16];
+                    uint32_t bitsLog2 = 0;
+                    for (uint32_t candidate = 1; candidate < 4; ++candidate)
+                        if (getGroupSize(values, 1u << candidate) < getGroupSize(values, bitsLog2 == 0 ? 0 : 1u << bitsLog2))
+                            bitsLog2 = candidate;
+                    out[headerOffset + group / 4] |= static_cast<std::byte>(bitsLog2 << ((group % 4) * 2));
+
+                    if (bitsLog2 == 3) {
+                        for (std::size_t i = 0; i < 16; ++i)
+                            out.push_back(static_cast<std::byte>(values[i]));
+                    } else if (bitsLog2 != 0) {
+                        const uint32_t bits = 1u << bitsLog2, mask = (1u << bits) - 1;
+                        std::vector<std::byte> overflow;
+                        for (std::size_t i = 0; i < 16; i += 8 / bits) {
+                            uint32_t byte = 0;
+                            for (uint32_t j = 0; j < 8 / bits; ++j) {
+                                const auto value = values[i + j];
+                                byte = (byte << bits) | std::min<uint32_t>(value, mask);
+                                if (value >= mask)
+                                    overflow.push_back(static_cast<std::byte>(value));
+                            }
+                            out.push_back(static_cast<std::byte>(byte));
+                        }
+                        out.insert(out.end(), overflow.begin(), overflow.end());
+                    }
+                }
+            }
+        }
+
+        // The tail is padded to 32 bytes and ends with the first vertex.
+        if (stride < 32)
+            out.resize(out.size() + 32 - stride);
+        out.insert(out.end(), vertices.begin(), vertices.begin() + static_cast<std::ptrdiff_t>(stride));
+        return out;
+    }
+
+    void appendVByte(std::vector<std::byte>& out, uint32_t value) {
+        do {
+            out.push_back(static_cast<std::byte>((value & 127) | (value > 127 ? 128 : 0)));
+            value >>= 7;
+        } while (value != 0);
+    }
+
+    auto encodeIndexSequence(const std::vector<uint32_t>& indices) -> std::vector<std::byte> {
+        std::vector<std::byte> out;
+        appendBytes(out, { 0xD1 });
+        uint32_t last[2] = {};
+        for (const auto index : indices) {
+            // Alternate between the baselines, so that both are used.
+            const auto baseline = static_cast<uint32_t>(out.size() & 1);
+            const auto delta = static_cast<int32_t>(index - last[baseline]);
+            appendVByte(out, ((static_cast<uint32_t>(delta) << 1 ^ static_cast<uint32_t>(delta >> 31)) << 1) | baseline);
+            last[baseline] = index;
+        }
+        appendBytes(out, { 0, 0, 0, 0 });
+        return out;
+    }
+} // namespace
+
+TEST_CASE("Meshopt vertex codec", "[meshopt]") {
+    // Enough vertices for multiple blocks, with smooth and noisy bytes for every group size.
+    constexpr std::size_t stride = 16, count = 1000;
+    std::mt19937 rng(42);
+    std::vector<std::byte> vertices(count * stride);
+    for (std::size_t i = 0; i < count; ++i) {
+        const float position[3] = { static_cast<float>(i) * 0.25f, static_cast<float>(i % 7), -1.0f };
+        std::memcpy(&vertices[i * stride], position, sizeof(position));
+        vertices[i * stride + 12] = static_cast<std::byte>(rng());
+        vertices[i * stride + 13] = static_cast<std::byte>(i % 3);
+    }
+
+    const auto encoded = encodeVertices(vertices, stride);
+    std::vector<std::byte> decoded(vertices.size());
+    REQUIRE(ku::decodeMeshoptBuffer(encoded, count, stride, ku::MeshoptMode::Attributes, ku::MeshoptFilter::None, decoded));
+    REQUIRE(decoded == vertices);
+
+    SECTION("Malformed data is rejected") {
+        auto truncated = encoded;
+        truncated.pop_back();
+        REQUIRE(!ku::decodeMeshoptBuffer(truncated, count, stride, ku::MeshoptMode::Attributes, ku::MeshoptFilter::None, decoded));
+        auto wrongHeader = encoded;
+        wrongHeader[0] = std::byte { 0xA1 };
+        REQUIRE(!ku::decodeMeshoptBuffer(wrongHeader, count, stride, ku::MeshoptMode::Attributes, ku::MeshoptFilter::None, decoded));
+        REQUIRE(!ku::decodeMeshoptBuffer(encoded, count, 6, ku::MeshoptMode::Attributes, ku::MeshoptFilter::None, decoded));
+    }
+}
+
+TEST_CASE("Meshopt index codecs", "[meshopt]") {
+    SECTION("Triangles") {
+        // Uses every kind of triangle code: a reset, a shared edge with a new, cached, relative
+        // and explicit vertex, the code table and triangles with explicit and cached vertices.
+        std::vector<std::byte> encoded;
+        appendBytes(encoded, { 0xE1, 0xFE, 0x10, 0xF0, 0x03, 0x0E, 0x0F, 0xFF, 0xFE });
+        appendBytes(encoded, { 0x00, 0x0C, 0xFF, 0xBA, 0x01, 0xC8, 0x01, 0x81, 0x03, 0x12 });
+        encoded.resize(encoded.size() + 16);
+
+        const std::vector<uint32_t> expected = { 0, 1, 2, 2, 1, 3, 4, 5, 6, 4, 6, 3, 4, 3, 1, 4, 1, 7, 100, 200, 7, 7, 7, 200 };
+        std::vector<uint32_t> indices(expected.size());
+        REQUIRE(ku::decodeMeshoptBuffer(encoded, indices.size(), 4, ku::MeshoptMode::Triangles, ku::MeshoptFilter::None,
+                                        std::as_writable_bytes(std::span(indices))));
+        REQUIRE(indices == expected);
+
+        std::vector<uint16_t> narrowIndices(expected.size());
+        REQUIRE(ku::decodeMeshoptBuffer(encoded, narrowIndices.size(), 2, ku::MeshoptMode::Triangles, ku::MeshoptFilter::None,
+                                        std::as_writable_bytes(std::span(narrowIndices))));
+        REQUIRE(std::equal(narrowIndices.begin(), narrowIndices.end(), expected.begin()));
+
+        // The data has to end exactly at the code table.
+        encoded.push_back(std::byte { 0 });
+        REQUIRE(!ku::decodeMeshoptBuffer(encoded, indices.size(), 4, ku::MeshoptMode::Triangles, ku::MeshoptFilter::None,
+                                         std::as_writable_bytes(std::span(indices))));
+    }
+
+    SECTION("Index sequences") {
+        std::vector<uint32_t> expected(257);
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            expected[i] = static_cast<uint32_t>((i * 40503) % 100000);
+
+        const auto encoded = encodeIndexSequence(expected);
+        std::vector<uint32_t> indices(expected.size());
+        REQUIRE(ku::decodeMeshoptBuffer(encoded, indices.size(), 4, ku::MeshoptMode::Indices, ku::MeshoptFilter::None,
+                                        std::as_writable_bytes(std::span(indices))));
+        REQUIRE(indices == expected);
+        REQUIRE(!ku::decodeMeshoptBuffer(std::span(encoded).first(encoded.size() - 1), indices.size(), 4, ku::MeshoptMode::Indices,
+                                         ku::MeshoptFilter::None, std::as_writable_bytes(std::span(indices))));
+    }
+}
+
+TEST_CASE("Meshopt filters", "[meshopt]") {
+    const auto decodeFiltered = [](auto values, std::size_t stride, ku::MeshoptFilter filter) {
+        std::vector<std::byte> raw(sizeof(values));
+        std::memcpy(raw.data(), &values, sizeof(values));
+        const auto encoded = encodeVertices(raw, stride);
+        REQUIRE(ku::decodeMeshoptBuffer(encoded, raw.size() / stride, stride, ku::MeshoptMode::Attributes, filter, raw));
+        std::memcpy(&values, raw.data(), sizeof(values));
+        return values;
+    };
+
+    SECTION("Octahedral") {
+        // +Z, +X and -Z, which is folded into the corners.
+        const std::array<int8_t, 12> normals = { 0, 0, 127, 1, 127, 0, 127, 2, 127, 127, 127, 3 };
+        REQUIRE(decodeFiltered(normals, 4, ku::MeshoptFilter::Octahedral) == std::array<int8_t, 12> { 0, 0, 127, 1, 127, 0, 0, 2, 0, 0, -127, 3 });
+        const std::array<int16_t, 4> wideNormal = { 0, -32767, 32767, 7 };
+        REQUIRE(decodeFiltered(wideNormal, 8, ku::MeshoptFilter::Octahedral) == std::array<int16_t, 4> { 0, -32767, 0, 7 });
+    }
+
+    SECTION("Quaternion") {
+        // The identity with w dropped, and a rotation around x with x dropped.
+        const std::array<int16_t, 8> quaternions = { 0, 0, 0, (4095 << 2) | 3, 0, 0, 0, (4095 << 2) | 0 };
+        REQUIRE(decodeFiltered(quaternions, 8, ku::MeshoptFilter::Quaternion) ==
+                std::array<int16_t, 8> { 0, 0, 0, 32767, 32767, 0, 0, 0 });
+    }
+
+    SECTION("Exponential") {
+        const std::array<uint32_t, 2> values = { 0xFF000003, 0x02FFFFFB };
+        const auto decoded = decodeFiltered(values, 4, ku::MeshoptFilter::Exponential);
+        float floats[2];
+        std::memcpy(floats, decoded.data(), sizeof(floats));
+        REQUIRE(floats[0] == 1.5f);
+        REQUIRE(floats[1] == -20.0f);
+    }
+}
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <util/mip_filter.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+namespace {
+    std::vector<std::byte> createRandomImage(uint32_t width, uint32_t height, const ku::PixelFormat& format) {
+        std::mt19937 rng(1337);
+        std::uniform_int_distribution<int> distribution(0, 255);
+        std::vector<std::byte> pixels(width * height * format.getPixelSize());
+        for (auto& pixel : pixels)
+            pixel = static_cast<std::byte>(distribution(rng));
+        return pixels;
+    }
+
+    uint32_t readChannel(const std::vector<std::byte>& pixels, std::size_t index, uint32_t bytesPerChannel) {
+        if (bytesPerChannel == 1)
+            return static_cast<uint32_t>(pixels[index]);
+        uint16_t value;
+        std::memcpy(&value, &pixels[index * 2], sizeof(value));
+        return value;
+    }
+
+    float srgbToLinear(float value) {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float value) {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    // A straightforward 2x2 box filter to compare the kernels against.
+    uint32_t referenceDownsample(const std::vector<std::byte>& src, uint32_t width, uint32_t height, const ku::PixelFormat& format,
+                                 uint32_t x, uint32_t y, uint32_t channel) {
+        const auto maxValue = static_cast<float>((1U << (format.bytesPerChannel * 8)) - 1);
+        uint32_t sum = 0;
+        float linearSum = 0.0f;
+        for (uint32_t dy = 0; dy < 2; ++dy) {
+            for (uint32_t dx = 0; dx < 2; ++dx) {
+                const auto sx = std::min(x * 2 + dx, width - 1);
+                const auto sy = std::min(y * 2 + dy, height - 1);
+                const auto value = readChannel(src, (sy * width + sx) * format.channels + channel, format.bytesPerChannel);
+                sum += value;
+                linearSum += srgbToLinear(static_cast<float>(value) / maxValue);
+            }
+        }
+        if (format.srgb && channel < 3)
+            return static_cast<uint32_t>(std::lround(linearToSrgb(linearSum * 0.25f) * maxValue));
+        return (sum + 2) / 4;
+    }
+
+    void requireMatchesReference(uint32_t width, uint32_t height, const ku::PixelFormat& format, uint32_t tolerance) {
+        const auto src = createRandomImage(width, height, format);
+        const auto dstWidth = ku::getMipExtent(width, 1);
+        const auto dstHeight = ku::getMipExtent(height, 1);
+        std::vector<std::byte> dst(dstWidth * dstHeight * format.getPixelSize());
+
+        // Compute the rows in two separate calls, like the threads of the mip generator do.
+        const auto split = dstHeight / 2;
+        ku::downsampleImage(src, width, height, format, dst, 0, split);
+        ku::downsampleImage(src, width, height, format, dst, split, dstHeight - split);
+
+        for (uint32_t y = 0; y < dstHeight; ++y) {
+            for (uint32_t x = 0; x < dstWidth; ++x) {
+                for (uint32_t channel = 0; channel < format.channels; ++channel) {
+                    const auto expected = referenceDownsample(src, width, height, format, x, y, channel);
+                    const auto result = readChannel(dst, (y * dstWidth + x) * format.channels + channel, format.bytesPerChannel);
+                    REQUIRE(result + tolerance >= expected);
+                    REQUIRE(result <= expected + tolerance);
+                }
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("Mip chain layout", "[mip_filter]") {
+    REQUIRE(ku::getMipLevelCount(1, 1) == 1);
+    REQUIRE(ku::getMipLevelCount(256, 256) == 9);
+    REQUIRE(ku::getMipLevelCount(300, 17) == 9);
+    REQUIRE(ku::getMipExtent(300, 8) == 1);
+    REQUIRE(ku::getMipExtent(17, 3) == 2);
+    REQUIRE(ku::getMipChainSize(4, 2, 3, 4) == (8 + 2 + 1) * 4);
+}
+
+TEST_CASE("Box filter downsampling", "[mip_filter]") {
+    SECTION("Linear 8-bit") {
+        const ku::PixelFormat format = { .channels = 4, .bytesPerChannel = 1 };
+        requireMatchesReference(64, 32, format, 0);
+        requireMatchesReference(67, 13, format, 0);
+        requireMatchesReference(1, 7, format, 0);
+        requireMatchesReference(9, 1, format, 0);
+    }
+
+    SECTION("Linear 16-bit") {
+        const ku::PixelFormat format = { .channels = 4, .bytesPerChannel = 2 };
+        requireMatchesReference(64, 32, format, 0);
+        requireMatchesReference(33, 5, format, 0);
+    }
+
+    SECTION("Other channel counts") {
+        requireMatchesReference(31, 17, { .channels = 1, .bytesPerChannel = 1 }, 0);
+        requireMatchesReference(12, 6, { .channels = 3, .bytesPerChannel = 2 }, 0);
+    }
+
+    SECTION("sRGB") {
+        // A checkerboard of black and white averages to a linear 0.5, which isn't 128 in sRGB.
+        const ku::PixelFormat format = { .channels = 4, .bytesPerChannel = 1, .srgb = true };
+        std::vector<std::byte> src(2 * 2 * 4, std::byte(0));
+        for (std::size_t i : { 0, 1, 2, 3, 12, 13, 14, 15 })
+            src[i] = std::byte(255);
+        std::vector<std::byte> dst(4);
+        ku::downsampleImage(src, 2, 2, format, dst, 0, 1);
+        REQUIRE(dst[0] == std::byte(188));
+        // Alpha is averaged linearly.
+        REQUIRE(dst[3] == std::byte(128));
+
+        // The table-based kernels may round differently to the exact conversion.
+        requireMatchesReference(64, 32, format, 1);
+        requireMatchesReference(67, 13, format, 1);
+        requireMatchesReference(16, 8, { .channels = 4, .bytesPerChannel = 2, .srgb = true }, 1);
+    }
+}
+
+TEST_CASE("Mip filter benchmarks", "[.benchmark]") {
+    constexpr uint32_t size = 2048;
+    for (const bool srgb : { false, true }) {
+        const ku::PixelFormat format = { .channels = 4, .bytesPerChannel = 1, .srgb = srgb };
+        const auto src = createRandomImage(size, size, format);
+        std::vector<std::byte> dst(size * size / 4 * format.getPixelSize());
+        krypton::tests::measureThroughput(srgb ? "RGBA8 sRGB downsample" : "RGBA8 downsample", size * size / 4,
+                                          [&]() { ku::downsampleImage(src, size, size, format, dst, 0, size / 2); });
+    }
+}
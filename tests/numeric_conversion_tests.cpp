@@ -0,0 +1,188 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <util/numeric_conversion.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+TEST_CASE("Half float conversion tests", "[numeric_conversion]") {
+    SECTION("Known values") {
+        REQUIRE(ku::floatToHalf(0.0f) == 0x0000);
+        REQUIRE(ku::floatToHalf(-0.0f) == 0x8000);
+        REQUIRE(ku::floatToHalf(1.0f) == 0x3C00);
+        REQUIRE(ku::floatToHalf(-2.0f) == 0xC000);
+        REQUIRE(ku::floatToHalf(65504.0f) == 0x7BFF);
+        REQUIRE(ku::floatToHalf(65520.0f) == 0x7C00); // Rounds to infinity
+        REQUIRE(ku::floatToHalf(std::ldexp(1.0f, -24)) == 0x0001); // Smallest subnormal
+        REQUIRE(ku::floatToHalf(std::ldexp(1.0f, -26)) == 0x0000); // Rounds to zero
+        REQUIRE(ku::floatToHalf(std::numeric_limits<float>::infinity()) == 0x7C00);
+        REQUIRE((ku::floatToHalf(std::numeric_limits<float>::quiet_NaN()) & 0x7FFF) > 0x7C00);
+        // 1 + 2^-11 is exactly between two halfs and has to round to the even one.
+        REQUIRE(ku::floatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3C00);
+        REQUIRE(ku::floatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)) == 0x3C02);
+    }
+
+    // Every half value has to survive a round-trip through float exactly.
+    SECTION("Exhaustive round-trip") {
+        std::vector<uint16_t> halfs(1 << 16);
+        std::iota(halfs.begin(), halfs.end(), 0);
+
+        std::vector<float> floats(halfs.size());
+        ku::convertHalfToFloat(halfs, floats);
+
+        std::vector<uint16_t> roundTrip(halfs.size());
+        ku::convertFloatToHalf(floats, roundTrip);
+
+        for (std::size_t i = 0; i < halfs.size(); ++i) {
+            const bool isNaN = (halfs[i] & 0x7C00) == 0x7C00 && (halfs[i] & 0x3FF) != 0;
+            if (isNaN) {
+                REQUIRE(std::isnan(floats[i]));
+                REQUIRE((roundTrip[i] & 0x7FFF) > 0x7C00);
+                continue;
+            }
+            REQUIRE(ku::halfToFloat(halfs[i]) == floats[i]);
+            REQUIRE(roundTrip[i] == halfs[i]);
+        }
+    }
+
+    // The vector kernels have to round exactly like the scalar reference.
+    SECTION("Bulk conversion matches the scalar reference") {
+        std::vector<float> floats;
+        for (int32_t exponent = -30; exponent <= 17; ++exponent) {
+            for (float mantissa = 1.0f; mantissa < 2.0f; mantissa += 1.0f / 4096.0f) {
+                floats.push_back(std::ldexp(mantissa, exponent));
+                floats.push_back(-std::ldexp(mantissa, exponent));
+            }
+        }
+
+        std::vector<uint16_t> halfs(floats.size());
+        ku::convertFloatToHalf(floats, halfs);
+        for (std::size_t i = 0; i < floats.size(); ++i)
+            REQUIRE(halfs[i] == ku::floatToHalf(floats[i]));
+    }
+}
+
+TEST_CASE("Normalized integer conversion tests", "[numeric_conversion]") {
+    SECTION("Known values") {
+        REQUIRE(ku::floatToSnorm8(1.0f) == 127);
+        REQUIRE(ku::floatToSnorm8(-1.0f) == -127);
+        REQUIRE(ku::floatToSnorm8(-2.0f) == -127);
+        REQUIRE(ku::floatToSnorm16(0.5f) == 16384); // 16383.5 rounds to even
+        REQUIRE(ku::floatToUnorm8(0.5f) == 128);    // 127.5 rounds to even
+        REQUIRE(ku::floatToUnorm8(-1.0f) == 0);
+        REQUIRE(ku::floatToUnorm16(2.0f) == 65535);
+        REQUIRE(ku::floatToUnorm8(std::numeric_limits<float>::quiet_NaN()) == 0);
+        REQUIRE(ku::snorm8ToFloat(-128) == -1.0f);
+        REQUIRE(ku::unorm16ToFloat(65535) == 1.0f);
+    }
+
+    // Every integer value has to survive a round-trip through float. The only exception is the
+    // smallest signed value, which is clamped to -1.0 and then maps to -INT_MAX.
+    SECTION("Exhaustive round-trip") {
+        auto testRoundTrip = []<typename T>(auto toFloat, auto fromFloat) {
+            std::vector<T> values;
+            for (int32_t i = std::numeric_limits<T>::min(); i <= std::numeric_limits<T>::max(); ++i)
+                values.push_back(static_cast<T>(i));
+
+            std::vector<float> floats(values.size());
+            toFloat(std::span<const T>(values), std::span<float>(floats));
+            std::vector<T> roundTrip(values.size());
+            fromFloat(std::span<const float>(floats), std::span<T>(roundTrip));
+
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                REQUIRE(floats[i] >= -1.0f);
+                REQUIRE(floats[i] <= 1.0f);
+                if (std::is_signed_v<T> && values[i] == std::numeric_limits<T>::min()) {
+                    REQUIRE(roundTrip[i] == -std::numeric_limits<T>::max());
+                } else {
+                    REQUIRE(roundTrip[i] == values[i]);
+                }
+            }
+        };
+
+        testRoundTrip.operator()<int8_t>(ku::convertSnorm8ToFloat, ku::convertFloatToSnorm8);
+        testRoundTrip.operator()<int16_t>(ku::convertSnorm16ToFloat, ku::convertFloatToSnorm16);
+        testRoundTrip.operator()<uint8_t>(ku::convertUnorm8ToFloat, ku::convertFloatToUnorm8);
+        testRoundTrip.operator()<uint16_t>(ku::convertUnorm16ToFloat, ku::convertFloatToUnorm16);
+    }
+
+    SECTION("Bulk conversion matches the scalar reference") {
+        std::vector<float> floats;
+        for (float f = -1.5f; f <= 1.5f; f += 1.0f / 8192.0f)
+            floats.push_back(f);
+
+        std::vector<int8_t> snorm8(floats.size());
+        std::vector<int16_t> snorm16(floats.size());
+        std::vector<uint8_t> unorm8(floats.size());
+        std::vector<uint16_t> unorm16(floats.size());
+        ku::convertFloatToSnorm8(floats, snorm8);
+        ku::convertFloatToSnorm16(floats, snorm16);
+        ku::convertFloatToUnorm8(floats, unorm8);
+        ku::convertFloatToUnorm16(floats, unorm16);
+
+        for (std::size_t i = 0; i < floats.size(); ++i) {
+            REQUIRE(snorm8[i] == ku::floatToSnorm8(floats[i]));
+            REQUIRE(snorm16[i] == ku::floatToSnorm16(floats[i]));
+            REQUIRE(unorm8[i] == ku::floatToUnorm8(floats[i]));
+            REQUIRE(unorm16[i] == ku::floatToUnorm16(floats[i]));
+        }
+    }
+}
+
+TEST_CASE("Octahedral normal encoding tests", "[numeric_conversion]") {
+    // A fibonacci sphere gives us evenly distributed directions, including the lower hemisphere
+    // that gets folded over the diagonals.
+    constexpr std::size_t count = 10007;
+    std::vector<float> normals(count * 3);
+    for (std::size_t i = 0; i < count; ++i) {
+        const float z = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / static_cast<float>(count);
+        const float radius = std::sqrt(1.0f - z * z);
+        const float phi = static_cast<float>(i) * 2.39996323f;
+        normals[i * 3 + 0] = std::cos(phi) * radius;
+        normals[i * 3 + 1] = std::sin(phi) * radius;
+        normals[i * 3 + 2] = z;
+    }
+
+    std::vector<int16_t> encoded(count * 2);
+    ku::encodeOctahedralNormals(normals, encoded);
+    std::vector<float> decoded(count * 3);
+    ku::decodeOctahedralNormals(encoded, decoded);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        int16_t reference[2];
+        ku::encodeOctahedral(&normals[i * 3], reference);
+        REQUIRE(encoded[i * 2 + 0] == reference[0]);
+        REQUIRE(encoded[i * 2 + 1] == reference[1]);
+
+        const float dot = normals[i * 3 + 0] * decoded[i * 3 + 0] + normals[i * 3 + 1] * decoded[i * 3 + 1] +
+                          normals[i * 3 + 2] * decoded[i * 3 + 2];
+        REQUIRE(dot > 0.99999f);
+    }
+}
+
+TEST_CASE("Numeric conversion benchmarks", "[.benchmark]") {
+    constexpr std::size_t count = 16 * 1024 * 1024;
+    std::vector<float> floats(count);
+    for (std::size_t i = 0; i < count; ++i)
+        floats[i] = std::sin(static_cast<float>(i));
+
+    std::vector<uint16_t> u16(count);
+    std::vector<int16_t> i16(count);
+    std::vector<uint8_t> u8(count);
+    std::vector<float> out(count);
+
+    krypton::tests::measureThroughput("float -> half", count, [&]() { ku::convertFloatToHalf(floats, u16); });
+    krypton::tests::measureThroughput("half -> float", count, [&]() { ku::convertHalfToFloat(u16, out); });
+    krypton::tests::measureThroughput("float -> snorm16", count, [&]() { ku::convertFloatToSnorm16(floats, i16); });
+    krypton::tests::measureThroughput("snorm16 -> float", count, [&]() { ku::convertSnorm16ToFloat(i16, out); });
+    krypton::tests::measureThroughput("float -> unorm8", count, [&]() { ku::convertFloatToUnorm8(floats, u8); });
+    krypton::tests::measureThroughput("unorm8 -> float", count, [&]() { ku::convertUnorm8ToFloat(u8, out); });
+    krypton::tests::measureThroughput("octahedral encode", count / 3, [&]() { ku::encodeOctahedralNormals(floats, i16); });
+    krypton::tests::measureThroughput("octahedral decode", count / 3, [&]() { ku::decodeOctahedralNormals(i16, out); });
+}
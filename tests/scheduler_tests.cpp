@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <util/scheduler.hpp>
+
+namespace kt = krypton::threading;
+
+TEST_CASE("Scheduler parallelFor", "[scheduler]") {
+    auto& scheduler = kt::Scheduler::getInstance();
+
+    SECTION("Without running scheduler") {
+        std::vector<uint32_t> visits(1000, 0);
+        scheduler.parallelFor(visits.size(), 64, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+                ++visits[i];
+        });
+        REQUIRE(std::all_of(visits.begin(), visits.end(), [](uint32_t v) { return v == 1; }));
+    }
+
+    scheduler.start();
+
+    SECTION("Every index is visited once") {
+        for (std::size_t count : { 1, 7, 1000, 100003 }) {
+            // Catch2 assertions are not thread-safe, so we only check the ranges afterwards.
+            std::vector<std::atomic<uint32_t>> visits(count);
+            std::atomic<bool> validRanges = true;
+            scheduler.parallelFor(count, 100, [&](std::size_t begin, std::size_t end) {
+                if (begin >= end || end > count)
+                    validRanges = false;
+                for (auto i = begin; i < end; ++i)
+                    visits[i].fetch_add(1, std::memory_order_relaxed);
+            });
+            REQUIRE(validRanges);
+            for (auto& visit : visits)
+                REQUIRE(visit.load() == 1);
+        }
+    }
+
+    SECTION("Exceptions are rethrown") {
+        auto throwing = [](std::size_t begin, std::size_t end) {
+            if (begin <= 500 && 500 < end)
+                throw std::runtime_error("chunk failed");
+        };
+        REQUIRE_THROWS_AS(scheduler.parallelFor(1000, 10, throwing), std::runtime_error);
+    }
+
+    SECTION("Nested inside tasks") {
+        // Every worker blocks in a parallelFor, which can only finish because the calling
+        // threads work on their own chunks.
+        constexpr uint32_t taskCount = 16;
+        std::atomic<uint64_t> sum = 0;
+        std::atomic<uint32_t> finished = 0;
+        for (uint32_t t = 0; t < taskCount; ++t) {
+            scheduler.run([&]() {
+                scheduler.parallelFor(1000, 10, [&](std::size_t begin, std::size_t end) {
+                    uint64_t local = 0;
+                    for (auto i = begin; i < end; ++i)
+                        local += i;
+                    sum.fetch_add(local);
+                });
+                finished.fetch_add(1);
+                finished.notify_all();
+            });
+        }
+        for (auto value = finished.load(); value != taskCount; value = finished.load())
+            finished.wait(value);
+        REQUIRE(sum.load() == taskCount * (999 * 1000 / 2));
+    }
+
+    scheduler.shutdown();
+}
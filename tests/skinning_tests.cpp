@@ -0,0 +1,182 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <util/numeric_conversion.hpp>
+#include <util/skinning.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+namespace {
+    // Like CompactVertex, with the position and the normal at the start of every vertex.
+    struct SkinnedVertex {
+        float position[3];
+        int16_t normal[2];
+        uint16_t uv[2];
+    };
+
+    // Rotations around the y axis with a translation, so that normals stay unit length.
+    std::vector<ku::Matrix4> createJointMatrices(std::size_t count) {
+        std::vector<ku::Matrix4> joints(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto angle = static_cast<float>(i) * 0.3f;
+            auto& m = joints[i].m;
+            m[0] = std::cos(angle);
+            m[2] = -std::sin(angle);
+            m[8] = std::sin(angle);
+            m[10] = std::cos(angle);
+            m[12] = static_cast<float>(i);
+            m[13] = 1.0f;
+        }
+        return joints;
+    }
+
+    struct SkinningInput {
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<ku::VertexInfluences> influences;
+    };
+
+    SkinningInput createVertices(std::size_t count, std::size_t jointCount) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+        std::uniform_int_distribution<uint32_t> joint(0, static_cast<uint32_t>(jointCount - 1));
+        std::uniform_int_distribution<uint32_t> weight(0, 65535);
+
+        SkinningInput input;
+        input.positions.resize(count * 3);
+        input.normals.resize(count * 3);
+        input.influences.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            float length = 0.0f;
+            for (std::size_t c = 0; c < 3; ++c) {
+                input.positions[i * 3 + c] = position(rng);
+                input.normals[i * 3 + c] = position(rng) + (c == 1 ? 2.0f : 0.0f);
+                length += input.normals[i * 3 + c] * input.normals[i * 3 + c];
+            }
+            for (std::size_t c = 0; c < 3; ++c)
+                input.normals[i * 3 + c] /= std::sqrt(length);
+            for (std::size_t k = 0; k < 4; ++k) {
+                input.influences[i].joints[k] = static_cast<uint16_t>(joint(rng));
+                input.influences[i].weights[k] = static_cast<uint16_t>(k < 2 ? weight(rng) : 0);
+            }
+        }
+        return input;
+    }
+
+    void referenceSkin(const std::vector<ku::Matrix4>& joints, const float* position, const float* normal, const ku::VertexInfluences& vertex,
+                       float* skinnedPosition, float* skinnedNormal) {
+        double m[16] = {};
+        const double sum = vertex.weights[0] + vertex.weights[1] + vertex.weights[2] + vertex.weights[3];
+        for (std::size_t k = 0; k < 4; ++k)
+            for (std::size_t e = 0; e < 16; ++e)
+                m[e] += sum == 0.0 ? (e % 5 == 0 ? 0.25 : 0.0) : vertex.weights[k] / sum * joints[vertex.joints[k]].m[e];
+        for (std::size_t row = 0; row < 3; ++row) {
+            skinnedPosition[row] = static_cast<float>(m[row] * position[0] + m[4 + row] * position[1] + m[8 + row] * position[2] + m[12 + row]);
+            skinnedNormal[row] = static_cast<float>(m[row] * normal[0] + m[4 + row] * normal[1] + m[8 + row] * normal[2]);
+        }
+    }
+} // namespace
+
+TEST_CASE("Linear blend skinning", "[skinning]") {
+    constexpr std::size_t vertexCount = 1000, jointCount = 12;
+    const auto joints = createJointMatrices(jointCount);
+    auto input = createVertices(vertexCount, jointCount);
+    // A vertex without weights stays where it is, and joints out of range are clamped.
+    input.influences[3] = {};
+    input.influences[4] = { { 60000, 0, 0, 0 }, { 1, 0, 0, 0 } };
+
+    std::vector<SkinnedVertex> vertices(vertexCount);
+    ku::skinVertices(joints, input.positions.data(), input.normals.data(), input.influences.data(), vertexCount, vertices[0].position,
+                     vertices[0].normal, sizeof(SkinnedVertex));
+    input.influences[4].joints[0] = jointCount - 1;
+
+    for (std::size_t i = 0; i < vertexCount; ++i) {
+        float position[3], normal[3], decoded[3];
+        referenceSkin(joints, &input.positions[i * 3], &input.normals[i * 3], input.influences[i], position, normal);
+        ku::decodeOctahedral(vertices[i].normal, decoded);
+        // Blending rotations shortens the normals, but they are normalized by the encoding.
+        const auto length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        for (std::size_t c = 0; c < 3; ++c) {
+            REQUIRE(vertices[i].position[c] == Catch::Approx(position[c]).margin(1e-5));
+            REQUIRE(decoded[c] == Catch::Approx(normal[c] / length).margin(1e-3));
+        }
+    }
+    REQUIRE(vertices[3].position[0] == input.positions[9]);
+
+    // Without normals, only the positions are written.
+    std::vector<SkinnedVertex> positionsOnly(vertexCount, SkinnedVertex { {}, { 7, 7 }, {} });
+    ku::skinVertices(joints, input.positions.data(), nullptr, input.influences.data(), vertexCount, positionsOnly[0].position,
+                     positionsOnly[0].normal, sizeof(SkinnedVertex));
+    REQUIRE(positionsOnly[10].position[1] == vertices[10].position[1]);
+    REQUIRE(positionsOnly[10].normal[0] == 7);
+}
+
+TEST_CASE("Sparse morph targets", "[skinning]") {
+    ku::SparseMorphTarget target = {
+        .vertices = { 1, 4, 5 },
+        .positionDeltas = { 1, 0, 0, 0, 2, 0, 0, 0, 3 },
+        .normalDeltas = { 0, 1, 0, 0, 1, 0, 0, 1, 0 },
+    };
+    ku::SparseMorphTarget positionsOnly = { .vertices = { 0, 5 }, .positionDeltas = { 1, 1, 1, 2, 2, 2 }, .normalDeltas = {} };
+    const std::vector<ku::SparseMorphTarget> targets = { target, positionsOnly };
+
+    SECTION("Accumulation") {
+        // Only vertices [2, 6) are passed in.
+        std::vector<float> positions(4 * 3, 0.0f), normals(4 * 3, 0.0f);
+        const std::vector<float> weights = { 0.5f, 2.0f };
+        ku::accumulateMorphTargets(targets, weights, 2, 4, positions.data(), normals.data());
+        const std::vector<float> expectedPositions = { 0, 0, 0, 0, 0, 0, 0, 1, 0, 4, 4, 5.5f };
+        const std::vector<float> expectedNormals = { 0, 0, 0, 0, 0, 0, 0, 0.5f, 0, 0, 0.5f, 0 };
+        REQUIRE(positions == expectedPositions);
+        REQUIRE(normals == expectedNormals);
+
+        // Zero weights and missing weights don't change anything.
+        ku::accumulateMorphTargets(targets, std::vector<float> { 0.0f }, 0, 6, positions.data(), nullptr);
+        REQUIRE(positions == expectedPositions);
+    }
+
+    SECTION("Gathering vertices") {
+        // Reverses the vertices, drops vertex 4 and duplicates vertex 1.
+        const std::vector<uint32_t> sourceVertices = { 5, 3, 2, 1, 0, 1 };
+        const auto gathered = target.gatherVertices(sourceVertices);
+        REQUIRE(gathered.vertices == std::vector<uint32_t> { 0, 3, 5 });
+        REQUIRE(gathered.positionDeltas == std::vector<float> { 0, 0, 3, 1, 0, 0, 1, 0, 0 });
+        REQUIRE(gathered.normalDeltas.size() == 9);
+        REQUIRE(positionsOnly.gatherVertices(sourceVertices).normalDeltas.empty());
+    }
+}
+
+TEST_CASE("Skinning benchmarks", "[.benchmark]") {
+    constexpr std::size_t vertexCount = 256 * 1024, jointCount = 64;
+    const auto joints = createJointMatrices(jointCount);
+    auto input = createVertices(vertexCount, jointCount);
+    for (auto& vertex : input.influences)
+        vertex.weights[2] = vertex.weights[3] = 1000;
+    std::vector<SkinnedVertex> vertices(vertexCount);
+    krypton::tests::measureThroughput("Linear blend skinning", vertexCount, [&]() {
+        ku::skinVertices(joints, input.positions.data(), input.normals.data(), input.influences.data(), vertexCount,
+                         vertices[0].position, vertices[0].normal, sizeof(SkinnedVertex));
+    });
+
+    // Eight targets which each move every fourth vertex.
+    std::vector<ku::SparseMorphTarget> targets(8);
+    for (std::size_t t = 0; t < targets.size(); ++t) {
+        for (uint32_t v = static_cast<uint32_t>(t % 4); v < vertexCount; v += 4) {
+            targets[t].vertices.push_back(v);
+            targets[t].positionDeltas.insert(targets[t].positionDeltas.end(), { 0.1f, 0.2f, 0.3f });
+            targets[t].normalDeltas.insert(targets[t].normalDeltas.end(), { 0.01f, 0.02f, 0.03f });
+        }
+    }
+    const std::vector<float> weights(targets.size(), 0.5f);
+    krypton::tests::measureThroughput("Sparse morph targets", vertexCount, [&]() {
+        ku::accumulateMorphTargets(targets, weights, 0, vertexCount, input.positions.data(), input.normals.data());
+    });
+}
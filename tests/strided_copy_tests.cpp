@@ -0,0 +1,202 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <util/numeric_conversion.hpp>
+#include <util/strided_copy.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+namespace {
+    // The reference conversion of a single component, written independently of the kernels.
+    template <typename T>
+    float referenceComponent(T value, bool normalized) {
+        if (!normalized)
+            return static_cast<float>(value);
+        if constexpr (std::is_same_v<T, int8_t>)
+            return ku::snorm8ToFloat(value);
+        else if constexpr (std::is_same_v<T, uint8_t>)
+            return ku::unorm8ToFloat(value);
+        else if constexpr (std::is_same_v<T, int16_t>)
+            return ku::snorm16ToFloat(value);
+        else if constexpr (std::is_same_v<T, uint16_t>)
+            return ku::unorm16ToFloat(value);
+        else
+            return static_cast<float>(value);
+    }
+
+    template <typename T>
+    void testGather(ku::ComponentType type, bool normalized) {
+        constexpr std::size_t count = 1001;
+        constexpr float sentinel = -12345.0f;
+        constexpr float defaults[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+        for (uint32_t srcComponents = 1; srcComponents <= 4; ++srcComponents) {
+            // Interleave the elements with other data, and make the buffer end exactly after the
+            // last element to catch reads past the end.
+            const std::size_t stride = srcComponents * sizeof(T) + 5;
+            std::vector<std::byte> buffer(stride * (count - 1) + srcComponents * sizeof(T));
+            for (std::size_t i = 0; i < buffer.size(); ++i)
+                buffer[i] = static_cast<std::byte>((i * 2654435761U) >> 13);
+            if constexpr (std::is_same_v<T, float>) {
+                for (std::size_t i = 0; i < count; ++i)
+                    for (uint32_t c = 0; c < srcComponents; ++c) {
+                        float value = std::sin(static_cast<float>(i * 4 + c)) * 100.0f;
+                        std::memcpy(&buffer[i * stride + c * sizeof(float)], &value, sizeof(float));
+                    }
+            }
+
+            for (uint32_t dstComponents = 1; dstComponents <= 4; ++dstComponents) {
+                // The destination has room for five floats per element, the last one of which
+                // must never be touched.
+                std::vector<float> dst(count * 5, sentinel);
+                ku::StridedSource source = {
+                    .data = buffer.data(),
+                    .stride = stride,
+                    .count = count,
+                    .componentType = type,
+                    .componentCount = srcComponents,
+                    .normalized = normalized,
+                };
+                ku::gatherStrided(source, dst.data(), 5 * sizeof(float), dstComponents);
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    for (uint32_t c = 0; c < 5; ++c) {
+                        float expected = sentinel;
+                        if (c < dstComponents && c < srcComponents) {
+                            T value;
+                            std::memcpy(&value, &buffer[i * stride + c * sizeof(T)], sizeof(T));
+                            expected = referenceComponent(value, normalized);
+                        } else if (c < dstComponents) {
+                            expected = defaults[c];
+                        }
+                        REQUIRE(std::memcmp(&dst[i * 5 + c], &expected, sizeof(float)) == 0);
+                    }
+                }
+            }
+        }
+    }
+
+    // Gathers a tightly packed source that ends exactly at the end of its allocation, which
+    // leaves no room for the wide loads of the last elements.
+    template <typename T>
+    void testPackedGather(ku::ComponentType type, uint32_t components) {
+        for (std::size_t count = 1; count <= 20; ++count) {
+            auto buffer = std::make_unique<T[]>(count * components);
+            for (std::size_t i = 0; i < count * components; ++i)
+                buffer[i] = static_cast<T>(i * 37 + 11);
+
+            std::vector<float> dst(count * components);
+            ku::gatherStrided({ .data = buffer.get(),
+                                .stride = components * sizeof(T),
+                                .count = count,
+                                .componentType = type,
+                                .componentCount = components,
+                                .normalized = true },
+                              dst.data(), components * sizeof(float), components);
+            for (std::size_t i = 0; i < count * components; ++i)
+                REQUIRE(dst[i] == referenceComponent(buffer[i], true));
+        }
+    }
+} // namespace
+
+TEST_CASE("Strided gather", "[strided_copy]") {
+    testGather<float>(ku::ComponentType::Float, false);
+    testGather<uint32_t>(ku::ComponentType::Uint32, false);
+    for (bool normalized : { false, true }) {
+        testGather<int8_t>(ku::ComponentType::Int8, normalized);
+        testGather<uint8_t>(ku::ComponentType::Uint8, normalized);
+        testGather<int16_t>(ku::ComponentType::Int16, normalized);
+        testGather<uint16_t>(ku::ComponentType::Uint16, normalized);
+    }
+
+    SECTION("Tightly packed sources") {
+        for (uint32_t components : { 1U, 2U }) {
+            testPackedGather<uint8_t>(ku::ComponentType::Uint8, components);
+            testPackedGather<uint16_t>(ku::ComponentType::Uint16, components);
+        }
+    }
+
+    SECTION("Multiple attributes") {
+        // Positions and UVs of different lengths gathered into one interleaved array.
+        std::vector<float> positions(3 * 2000), uvs(2 * 1500);
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            positions[i] = static_cast<float>(i);
+        for (std::size_t i = 0; i < uvs.size(); ++i)
+            uvs[i] = -static_cast<float>(i);
+
+        std::vector<float> dst(2000 * 6, 5.0f);
+        ku::StridedGather gathers[] = {
+            { { .data = positions.data(), .stride = 12, .count = 2000, .componentCount = 3 }, &dst[0], 4 },
+            { { .data = uvs.data(), .stride = 8, .count = 1500, .componentCount = 2 }, &dst[4], 2 },
+        };
+        ku::gatherStrided(gathers, 6 * sizeof(float));
+
+        for (std::size_t i = 0; i < 2000; ++i) {
+            REQUIRE(dst[i * 6 + 0] == positions[i * 3 + 0]);
+            REQUIRE(dst[i * 6 + 2] == positions[i * 3 + 2]);
+            REQUIRE(dst[i * 6 + 3] == 1.0f);
+            REQUIRE(dst[i * 6 + 4] == (i < 1500 ? uvs[i * 2] : 5.0f));
+            REQUIRE(dst[i * 6 + 5] == (i < 1500 ? uvs[i * 2 + 1] : 5.0f));
+        }
+    }
+
+    SECTION("Empty source") {
+        ku::gatherStrided({ .data = nullptr, .stride = 12, .count = 0, .componentCount = 3 }, nullptr, 16, 4);
+    }
+}
+
+TEST_CASE("Strided gather benchmarks", "[.benchmark]") {
+    // A synthetic mesh with interleaved float3 positions, float3 normals and float2 UVs, gathered
+    // into a 64 byte vertex like assets::Vertex.
+    constexpr std::size_t vertexCount = 10'000'000;
+    constexpr std::size_t srcStride = 8 * sizeof(float);
+    constexpr std::size_t dstStride = 16 * sizeof(float);
+    std::vector<float> src(vertexCount * 8);
+    for (std::size_t i = 0; i < src.size(); ++i)
+        src[i] = static_cast<float>(i % 1024) * 0.25f;
+    std::vector<float> dst(vertexCount * 16);
+
+    krypton::tests::measureThroughput("per-vertex loop", vertexCount, [&]() {
+        for (std::size_t i = 0; i < vertexCount; ++i) {
+            const float* in = &src[i * 8];
+            float* out = &dst[i * 16];
+            out[0] = in[0], out[1] = in[1], out[2] = in[2], out[3] = 1.0f;
+            out[8] = in[3], out[9] = in[4], out[10] = in[5], out[11] = 1.0f;
+            out[12] = in[6], out[13] = in[7];
+        }
+    });
+
+    krypton::tests::measureThroughput("gatherStrided (3 attributes)", vertexCount, [&]() {
+        ku::gatherStrided({ .data = &src[0], .stride = srcStride, .count = vertexCount, .componentCount = 3 }, &dst[0], dstStride, 4);
+        ku::gatherStrided({ .data = &src[3], .stride = srcStride, .count = vertexCount, .componentCount = 3 }, &dst[8], dstStride, 4);
+        ku::gatherStrided({ .data = &src[6], .stride = srcStride, .count = vertexCount, .componentCount = 2 }, &dst[12], dstStride, 2);
+    });
+
+    krypton::tests::measureThroughput("gatherStrided (3 attributes, blocked)", vertexCount, [&]() {
+        ku::StridedGather gathers[] = {
+            { { .data = &src[0], .stride = srcStride, .count = vertexCount, .componentCount = 3 }, &dst[0], 4 },
+            { { .data = &src[3], .stride = srcStride, .count = vertexCount, .componentCount = 3 }, &dst[8], 4 },
+            { { .data = &src[6], .stride = srcStride, .count = vertexCount, .componentCount = 2 }, &dst[12], 2 },
+        };
+        ku::gatherStrided(gathers, dstStride);
+    });
+
+    std::vector<uint16_t> quantized(vertexCount * 4);
+    for (std::size_t i = 0; i < quantized.size(); ++i)
+        quantized[i] = static_cast<uint16_t>(i * 31);
+    krypton::tests::measureThroughput("gatherStrided (unorm16 positions)", vertexCount, [&]() {
+        ku::gatherStrided({ .data = quantized.data(),
+                            .stride = 4 * sizeof(uint16_t),
+                            .count = vertexCount,
+                            .componentType = ku::ComponentType::Uint16,
+                            .componentCount = 3,
+                            .normalized = true },
+                          &dst[0], dstStride, 4);
+    });
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <util/transform_hierarchy.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+namespace {
+    // Builds a tree breadth-first, in which every node has up to branching children.
+    ku::TransformHierarchy createRandomHierarchy(std::size_t count, std::size_t rootCount, std::size_t branching) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        ku::TransformHierarchy hierarchy;
+        hierarchy.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            float rotation[4] = { distribution(rng), distribution(rng), distribution(rng), distribution(rng) };
+            const float length = std::sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2] +
+                                           rotation[3] * rotation[3]);
+            for (auto& r : rotation)
+                r /= length;
+            const float translation[3] = { distribution(rng), distribution(rng), distribution(rng) };
+            const float scale[3] = { distribution(rng) * 0.1f + 1.0f, distribution(rng) * 0.1f + 1.0f, distribution(rng) * 0.1f + 1.0f };
+            const auto parent = i < rootCount ? ku::TransformHierarchy::noParent : static_cast<uint32_t>((i - rootCount) / branching);
+            hierarchy.addNode(parent, translation, rotation, scale);
+        }
+        return hierarchy;
+    }
+
+    // Computes the world matrix of a node by walking up to its root.
+    ku::Matrix4 computeWorldMatrix(const ku::TransformHierarchy& hierarchy, uint32_t node) {
+        ku::Matrix4 matrix;
+        ku::composeTransforms(hierarchy.getLocalTransforms(), node, { &matrix, 1 });
+        for (auto parent = hierarchy.getParents()[node]; parent != ku::TransformHierarchy::noParent;
+             parent = hierarchy.getParents()[parent]) {
+            ku::Matrix4 local;
+            ku::composeTransforms(hierarchy.getLocalTransforms(), parent, { &local, 1 });
+            matrix = ku::multiplyMatrix(local, matrix);
+        }
+        return matrix;
+    }
+
+    void requireWorldMatricesCorrect(const ku::TransformHierarchy& hierarchy) {
+        for (uint32_t i = 0; i < hierarchy.size(); ++i) {
+            const auto expected = computeWorldMatrix(hierarchy, i);
+            for (std::size_t j = 0; j < 16; ++j)
+                REQUIRE(hierarchy.getWorldMatrices()[i].m[j] == Catch::Approx(expected.m[j]).margin(1e-4));
+        }
+    }
+} // namespace
+
+TEST_CASE("Transform hierarchy tests", "[transform_hierarchy]") {
+    SECTION("Levels") {
+        auto hierarchy = createRandomHierarchy(3 + 6 + 12, 3, 2);
+        REQUIRE(hierarchy.getLevelCount() == 3);
+        REQUIRE(hierarchy.getLevel(0) == std::pair<uint32_t, uint32_t>(0, 3));
+        REQUIRE(hierarchy.getLevel(1) == std::pair<uint32_t, uint32_t>(3, 9));
+        REQUIRE(hierarchy.getLevel(2) == std::pair<uint32_t, uint32_t>(9, 21));
+    }
+
+    SECTION("World matrices") {
+        // Large enough for multiple chunks per level.
+        auto hierarchy = createRandomHierarchy(5000, 7, 3);
+        hierarchy.update();
+        requireWorldMatricesCorrect(hierarchy);
+    }
+
+    SECTION("Dirty subtrees") {
+        auto hierarchy = createRandomHierarchy(200, 2, 2);
+        hierarchy.update();
+        const std::vector<ku::Matrix4> before(hierarchy.getWorldMatrices().begin(), hierarchy.getWorldMatrices().end());
+
+        // Node 4 has the children 6 and 7, and their children 14 to 17 and so on.
+        const float translation[3] = { 5.0f, 0.0f, 0.0f };
+        const float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        const float scale[3] = { 1.0f, 1.0f, 1.0f };
+        hierarchy.setLocalTransform(4, translation, rotation, scale);
+        hierarchy.update();
+        requireWorldMatricesCorrect(hierarchy);
+
+        std::vector<bool> inSubtree(hierarchy.size(), false);
+        inSubtree[4] = true;
+        for (uint32_t i = 5; i < hierarchy.size(); ++i)
+            inSubtree[i] = inSubtree[hierarchy.getParents()[i]];
+        for (uint32_t i = 0; i < hierarchy.size(); ++i) {
+            const bool unchanged = std::equal(std::begin(before[i].m), std::end(before[i].m), hierarchy.getWorldMatrices()[i].m);
+            REQUIRE(unchanged == !inSubtree[i]);
+        }
+    }
+}
+
+TEST_CASE("Transform hierarchy benchmarks", "[.benchmark]") {
+    constexpr std::size_t count = 128 * 1024;
+    auto hierarchy = createRandomHierarchy(count, 16, 4);
+    krypton::tests::measureThroughput("Hierarchy update", count, [&]() {
+        for (uint32_t i = 0; i < 16; ++i)
+            hierarchy.markDirty(i);
+        hierarchy.update();
+    });
+}
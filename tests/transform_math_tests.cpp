@@ -0,0 +1,175 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <util/transform_math.hpp>
+
+#include "benchmark.hpp"
+
+namespace ku = krypton::util;
+
+namespace {
+    // Fills the SoA with random transforms using normalized quaternions.
+    ku::TransformSoA createRandomTransforms(std::size_t count) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        ku::TransformSoA transforms;
+        transforms.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            float rotation[4] = { distribution(rng), distribution(rng), distribution(rng), distribution(rng) };
+            const float length = std::sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2] +
+                                           rotation[3] * rotation[3]);
+            for (auto& r : rotation)
+                r /= length;
+            const float translation[3] = { distribution(rng) * 10.0f, distribution(rng) * 10.0f, distribution(rng) * 10.0f };
+            const float scale[3] = { distribution(rng) + 2.0f, distribution(rng) + 2.0f, distribution(rng) + 2.0f };
+            transforms.set(i, translation, rotation, scale);
+        }
+        return transforms;
+    }
+
+    void requireMatricesEqual(const ku::Matrix4& a, const ku::Matrix4& b) {
+        for (std::size_t i = 0; i < 16; ++i)
+            REQUIRE(a.m[i] == Catch::Approx(b.m[i]).margin(1e-5));
+    }
+} // namespace
+
+TEST_CASE("Transform math tests", "[transform_math]") {
+    // We use an odd count so that the scalar tail of the vectorized kernels is also tested.
+    constexpr std::size_t count = 1027;
+    auto transforms = createRandomTransforms(count);
+
+    std::vector<ku::Matrix4> matrices(count);
+    ku::composeTransforms(transforms, 0, matrices);
+
+    SECTION("Composing a known transform") {
+        // A rotation of 90 degrees around the Z axis.
+        const float translation[3] = { 1.0f, 2.0f, 3.0f };
+        const float rotation[4] = { 0.0f, 0.0f, std::sqrt(0.5f), std::sqrt(0.5f) };
+        const float scale[3] = { 2.0f, 3.0f, 4.0f };
+        transforms.set(0, translation, rotation, scale);
+
+        ku::Matrix4 result;
+        ku::composeTransforms(transforms, 0, { &result, 1 });
+        requireMatricesEqual(result, { { 0, 2, 0, 0, -3, 0, 0, 0, 0, 0, 4, 0, 1, 2, 3, 1 } });
+    }
+
+    SECTION("Composing equals T * R * S") {
+        for (std::size_t i = 0; i < count; ++i) {
+            ku::Matrix4 translation, scale;
+            translation.m[12] = transforms.translationX[i];
+            translation.m[13] = transforms.translationY[i];
+            translation.m[14] = transforms.translationZ[i];
+            scale.m[0] = transforms.scaleX[i];
+            scale.m[5] = transforms.scaleY[i];
+            scale.m[10] = transforms.scaleZ[i];
+
+            // A pure rotation is a composed transform with no translation and a scale of one.
+            ku::TransformSoA single;
+            single.resize(1);
+            const float zero[3] = { 0, 0, 0 }, one[3] = { 1, 1, 1 };
+            const float rotation[4] = { transforms.rotationX[i], transforms.rotationY[i], transforms.rotationZ[i],
+                                        transforms.rotationW[i] };
+            single.set(0, zero, rotation, one);
+            ku::Matrix4 rotationMatrix;
+            ku::composeTransforms(single, 0, { &rotationMatrix, 1 });
+
+            requireMatricesEqual(matrices[i], ku::multiplyMatrix(ku::multiplyMatrix(translation, rotationMatrix), scale));
+        }
+    }
+
+    SECTION("Batched multiplication matches the scalar reference") {
+        std::vector<ku::Matrix4> products(count);
+        ku::multiplyMatrices(matrices, matrices, products);
+
+        // Every matrix multiplied with its "parent", which we simply define as the previous one.
+        std::vector<uint32_t> parents(count);
+        for (std::size_t i = 0; i < count; ++i)
+            parents[i] = i == 0 ? 0 : static_cast<uint32_t>(i - 1);
+        std::vector<ku::Matrix4> indexedProducts(count);
+        ku::multiplyMatrices(matrices, parents, matrices, indexedProducts);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            requireMatricesEqual(products[i], ku::multiplyMatrix(matrices[i], matrices[i]));
+            requireMatricesEqual(indexedProducts[i], ku::multiplyMatrix(matrices[parents[i]], matrices[i]));
+        }
+    }
+
+    // The transformed AABB has to be exactly the bounds of the eight transformed corners.
+    SECTION("AABB transformation") {
+        ku::AabbSoA boxes;
+        boxes.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const float min[3] = { -1.0f, -2.0f, static_cast<float>(i) * 0.01f };
+            const float max[3] = { 3.0f, 1.0f, static_cast<float>(i) * 0.01f + 1.0f };
+            boxes.set(i, min, max);
+        }
+
+        ku::AabbSoA transformed;
+        transformed.resize(count);
+        ku::transformAabbs(boxes, 0, matrices, transformed);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            float min[3] = { INFINITY, INFINITY, INFINITY }, max[3] = { -INFINITY, -INFINITY, -INFINITY };
+            for (uint32_t corner = 0; corner < 8; ++corner) {
+                const float point[3] = { corner & 1 ? boxes.maxX[i] : boxes.minX[i], corner & 2 ? boxes.maxY[i] : boxes.minY[i],
+                                         corner & 4 ? boxes.maxZ[i] : boxes.minZ[i] };
+                const auto& m = matrices[i].m;
+                for (std::size_t row = 0; row < 3; ++row) {
+                    const float value = m[row] * point[0] + m[4 + row] * point[1] + m[8 + row] * point[2] + m[12 + row];
+                    min[row] = std::min(min[row], value);
+                    max[row] = std::max(max[row], value);
+                }
+            }
+            REQUIRE(transformed.minX[i] == Catch::Approx(min[0]).margin(1e-4));
+            REQUIRE(transformed.minY[i] == Catch::Approx(min[1]).margin(1e-4));
+            REQUIRE(transformed.minZ[i] == Catch::Approx(min[2]).margin(1e-4));
+            REQUIRE(transformed.maxX[i] == Catch::Approx(max[0]).margin(1e-4));
+            REQUIRE(transformed.maxY[i] == Catch::Approx(max[1]).margin(1e-4));
+            REQUIRE(transformed.maxZ[i] == Catch::Approx(max[2]).margin(1e-4));
+        }
+    }
+
+    // Uses the translations as points, with tightly packed, padded and interleaved strides.
+    SECTION("AABB of points") {
+        for (std::size_t floatStride : { 3, 4, 12 }) {
+            for (std::size_t pointCount : { 0, 1, 2, 3, 1027 }) {
+                std::vector<float> points(pointCount * floatStride);
+                float expectedMin[3] = { INFINITY, INFINITY, INFINITY }, expectedMax[3] = { -INFINITY, -INFINITY, -INFINITY };
+                for (std::size_t i = 0; i < pointCount; ++i) {
+                    const float point[3] = { transforms.translationX[i], transforms.translationY[i], transforms.translationZ[i] };
+                    for (std::size_t axis = 0; axis < 3; ++axis) {
+                        points[i * floatStride + axis] = point[axis];
+                        expectedMin[axis] = std::min(expectedMin[axis], point[axis]);
+                        expectedMax[axis] = std::max(expectedMax[axis], point[axis]);
+                    }
+                }
+
+                float min[3], max[3];
+                ku::computeAabb(points.data(), floatStride * sizeof(float), pointCount, min, max);
+                for (std::size_t axis = 0; axis < 3; ++axis) {
+                    REQUIRE(min[axis] == expectedMin[axis]);
+                    REQUIRE(max[axis] == expectedMax[axis]);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Transform math benchmarks", "[.benchmark]") {
+    constexpr std::size_t count = 1024 * 1024;
+    auto transforms = createRandomTransforms(count);
+    std::vector<ku::Matrix4> matrices(count), products(count);
+
+    krypton::tests::measureThroughput("TRS to matrix", count, [&]() { ku::composeTransforms(transforms, 0, matrices); });
+    krypton::tests::measureThroughput("matrix * matrix", count, [&]() { ku::multiplyMatrices(matrices, matrices, products); });
+
+    ku::AabbSoA boxes, transformed;
+    boxes.resize(count);
+    transformed.resize(count);
+    krypton::tests::measureThroughput("AABB transform", count, [&]() { ku::transformAabbs(boxes, 0, matrices, transformed); });
+}